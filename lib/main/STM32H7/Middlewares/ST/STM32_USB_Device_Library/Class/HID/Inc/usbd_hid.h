@@ -42,11 +42,11 @@ extern "C" {
   * @{
   */
 #define HID_EPIN_ADDR                 0x83U
-#define HID_EPIN_SIZE                 0x08U
+#define HID_EPIN_SIZE                 0x14U
 
 #define USB_HID_CONFIG_DESC_SIZ       34U
 #define USB_HID_DESC_SIZ              9U
-#define HID_MOUSE_REPORT_DESC_SIZE    38U
+#define HID_MOUSE_REPORT_DESC_SIZE    44U
 
 #define HID_DESCRIPTOR_TYPE           0x21U
 #define HID_REPORT_DESC               0x22U
@@ -56,7 +56,7 @@ extern "C" {
 #endif /* HID_HS_BINTERVAL */
 
 #ifndef HID_FS_BINTERVAL
-#define HID_FS_BINTERVAL            0x0AU
+#define HID_FS_BINTERVAL            0x01U
 #endif /* HID_FS_BINTERVAL */
 
 #define HID_REQ_SET_PROTOCOL          0x0BU
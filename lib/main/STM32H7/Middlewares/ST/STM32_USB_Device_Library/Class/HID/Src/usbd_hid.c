@@ -330,10 +330,12 @@ __ALIGN_BEGIN static uint8_t HID_MOUSE_ReportDesc[HID_MOUSE_REPORT_DESC_SIZE]  _
         0x09, 0x34,                    //     USAGE (Ry)
         0x09, 0x40,                    //     USAGE (Vx)
         0x09, 0x38,                    //     USAGE (Wheel)
-        0x15, 0x81,                    //     LOGICAL_MINIMUM (-127)
-        0x25, 0x7f,                    //     LOGICAL_MAXIMUM (127)
-        0x75, 0x08,                    //     REPORT_SIZE (8)
-        0x95, 0x08,                    //     REPORT_COUNT (8)
+        0x09, 0x36,                    //     USAGE (Slider)
+        0x09, 0x37,                    //     USAGE (Dial)
+        0x16, 0x01, 0x80,              //     LOGICAL_MINIMUM (-32767)
+        0x26, 0xff, 0x7f,              //     LOGICAL_MAXIMUM (32767)
+        0x75, 0x10,                    //     REPORT_SIZE (16)
+        0x95, 0x0a,                    //     REPORT_COUNT (10)
         0x81, 0x02,                    //     INPUT (Data,Var,Abs)
         0xc0,                          //   END_COLLECTION
         0xc0                           /*     END_COLLECTION                 */
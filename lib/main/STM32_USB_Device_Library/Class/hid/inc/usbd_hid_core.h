@@ -48,13 +48,13 @@
 #define USB_HID_CONFIG_DESC_SIZ       34
 #define USB_HID_DESC_SIZ              9
 
-#define HID_MOUSE_REPORT_DESC_SIZE    38
+#define HID_MOUSE_REPORT_DESC_SIZE    44
 
 #define HID_DESCRIPTOR_TYPE           0x21
 #define HID_REPORT_DESC               0x22
 
 #define HID_HS_BINTERVAL              0x07
-#define HID_FS_BINTERVAL              0x0A
+#define HID_FS_BINTERVAL              0x01
 
 #define HID_REQ_SET_PROTOCOL          0x0B
 #define HID_REQ_GET_PROTOCOL          0x03
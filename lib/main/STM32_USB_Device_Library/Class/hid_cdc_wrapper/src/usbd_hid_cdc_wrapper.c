@@ -205,9 +205,9 @@ __ALIGN_BEGIN static uint8_t USBD_HID_CDC_CfgDesc[USB_HID_CDC_CONFIG_DESC_SIZ] _
 
   HID_IN_EP,     /*bEndpointAddress: Endpoint Address (IN)*/
   0x03,          /*bmAttributes: Interrupt endpoint*/
-  HID_IN_PACKET, /*wMaxPacketSize: 8 Byte max */
+  HID_IN_PACKET, /*wMaxPacketSize: 20 Byte max */
   0x00,
-  0x0A,          /*bInterval: Polling Interval (10 ms)*/
+  0x01,          /*bInterval: Polling Interval (1 ms)*/
   /* 34 */
 
   /******** /IAD should be positioned just before the CDC interfaces ******
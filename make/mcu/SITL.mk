@@ -38,6 +38,17 @@ MCU_EXCLUDES = \
             telemetry/srxl.c \
             io/displayport_oled.c
 
+# Function level profile written on exit, input of src/utils/hot_code_placement.py
+ifneq ($(filter SITL_PROFILE,$(OPTIONS)),)
+ARCH_FLAGS  += \
+              -finstrument-functions \
+              -finstrument-functions-exclude-file-list=target/SITL/,lib/main/
+
+# without LTO the map file attributes the code to the source files
+OPTIMISATION_BASE := $(filter-out -flto -fuse-linker-plugin,$(OPTIMISATION_BASE))
+LTO_FLAGS   := $(filter-out -flto -fuse-linker-plugin,$(LTO_FLAGS))
+endif
+
 TARGET_MAP  = $(OBJECT_DIR)/$(FORKNAME)_$(TARGET).map
 
 LD_FLAGS    := \
@@ -265,7 +265,8 @@ ifneq ($(filter SDCARD_SDIO,$(FEATURES)),)
 MCU_COMMON_SRC += \
             drivers/sdio_h7xx.c
 MSC_SRC += \
-            msc/usbd_storage_sdio.c
+            msc/usbd_storage_sdio.c \
+            msc/usbd_storage_readahead.c
 endif
 
 #ifneq ($(filter SDCARD_SPI,$(FEATURES)),)
@@ -83,6 +83,7 @@ COMMON_SRC = \
             drivers/rx/rx_xn297.c \
             drivers/rx/rx_pwm.c \
             drivers/serial_softserial.c \
+            drivers/serial_softserial_decode.c \
             fc/core.c \
             fc/rc.c \
             fc/rc_adjustments.c \
@@ -95,12 +96,14 @@ COMMON_SRC = \
             flight/imu.c \
             flight/interpolated_setpoint.c \
             flight/mixer.c \
+            flight/mixer_allocation.c \
             flight/mixer_tricopter.c \
             flight/pid.c \
             flight/pid_init.c \
             flight/rpm_filter.c \
             flight/servos.c \
             flight/servos_tricopter.c \
+            flight/smith_predictor.c \
             io/serial_4way.c \
             io/serial_4way_avrootloader.c \
             io/serial_4way_stk500v2.c \
@@ -219,6 +222,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             common/encoding.c \
             common/filter.c \
             common/maths.c \
+            common/topic.c \
             common/typeconversion.c \
             drivers/accgyro/accgyro_mpu.c \
             drivers/accgyro/accgyro_mpu3050.c \
@@ -252,8 +256,10 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             flight/gyroanalyse.c \
             flight/imu.c \
             flight/mixer.c \
+            flight/mixer_allocation.c \
             flight/pid.c \
             flight/rpm_filter.c \
+            flight/smith_predictor.c \
             rx/ibus.c \
             rx/rx.c \
             rx/rx_spi.c \
@@ -378,6 +384,17 @@ SIZE_OPTIMISED_SRC := $(SIZE_OPTIMISED_SRC) \
 endif #!F3
 endif #!F1
 
+# Placement and optimisation classes from a SITL profile, generated by src/utils/hot_code_placement.py
+ifneq ($(HOT_CODE_PROFILE),)
+include $(HOT_CODE_PROFILE)
+
+SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
+            $(filter-out $(SPEED_OPTIMISED_SRC),$(PROFILED_SPEED_OPTIMISED_SRC))
+
+SIZE_OPTIMISED_SRC := $(filter-out $(PROFILED_SPEED_OPTIMISED_SRC),$(SIZE_OPTIMISED_SRC)) \
+            $(filter-out $(SPEED_OPTIMISED_SRC),$(PROFILED_SIZE_OPTIMISED_SRC))
+endif
+
 # check if target.mk supplied
 SRC := $(STARTUP_SRC) $(MCU_COMMON_SRC) $(TARGET_SRC) $(VARIANT_SRC)
 
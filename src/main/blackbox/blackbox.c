@@ -1394,6 +1394,11 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE("ff_max_rate_limit", "%d",               currentPidProfile->ff_max_rate_limit);
 #endif
         BLACKBOX_PRINT_HEADER_LINE("ff_boost", "%d",                        currentPidProfile->ff_boost);
+#ifdef USE_SMITH_PREDICTOR
+        BLACKBOX_PRINT_HEADER_LINE("smith_predictor_strength", "%d",        currentPidProfile->smith_predictor_strength);
+        BLACKBOX_PRINT_HEADER_LINE("smith_predictor_delay", "%d",           currentPidProfile->smith_predictor_delay);
+        BLACKBOX_PRINT_HEADER_LINE("smith_predictor_motor_tau", "%d",       currentPidProfile->smith_predictor_motor_tau);
+#endif
 
         BLACKBOX_PRINT_HEADER_LINE("acc_limit_yaw", "%d",                   currentPidProfile->yawRateAccelLimit);
         BLACKBOX_PRINT_HEADER_LINE("acc_limit", "%d",                       currentPidProfile->rateAccelLimit);
@@ -1452,6 +1457,8 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE("motor_pwm_protocol", "%d",              motorConfig()->dev.motorPwmProtocol);
         BLACKBOX_PRINT_HEADER_LINE("motor_pwm_rate", "%d",                  motorConfig()->dev.motorPwmRate);
         BLACKBOX_PRINT_HEADER_LINE("dshot_idle_value", "%d",                motorConfig()->digitalIdleOffsetValue);
+        BLACKBOX_PRINT_HEADER_LINE("mixer_allocation", "%d",                mixerConfig()->mixer_allocation);
+        BLACKBOX_PRINT_HEADER_LINE("mixer_yaw_priority", "%d",              mixerConfig()->mixer_yaw_priority);
         BLACKBOX_PRINT_HEADER_LINE("debug_mode", "%d",                      debugMode);
         BLACKBOX_PRINT_HEADER_LINE("features", "%d",                        featureConfig()->enabledFeatures);
 
@@ -97,4 +97,6 @@ const char * const debugModeNames[DEBUG_COUNT] = {
     "GYRO_SAMPLE",
     "RX_TIMING",
     "D_LPF",
+    "SMITH_PREDICTOR",
+    "MIXER_ALLOCATION",
 };
@@ -113,6 +113,8 @@ typedef enum {
     DEBUG_GYRO_SAMPLE,
     DEBUG_RX_TIMING,
     DEBUG_D_LPF,
+    DEBUG_SMITH_PREDICTOR,
+    DEBUG_MIXER_ALLOCATION,
     DEBUG_COUNT
 } debugType_e;
 
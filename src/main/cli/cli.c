@@ -1552,17 +1552,17 @@ static void cliSerialPassthrough(const char *cmdName, char *cmdline)
     // If no baud rate is specified allow to be set via USB
     if (enableBaudCb) {
         cliPrintLine("Port1 baud rate change over USB enabled.");
-        // Register the right side baud rate setting routine with the left side which allows setting of the UART
-        // baud rate over USB without setting it using the serialpassthrough command
-        serialSetBaudRateCb(ports[0].port, serialSetBaudRate, ports[1].port);
+        // Register the left side baud rate setting routine with the USB driver of the right side which allows setting
+        // of the UART baud rate over USB without setting it using the serialpassthrough command
+        serialSetBaudRateCb(ports[1].port, serialSetBaudRate, ports[0].port);
     }
 
     char *resetMessage = "";
     if (port1ResetOnDtr && ports[1].id == SERIAL_PORT_USB_VCP) {
-        resetMessage = "or drop DTR ";
+        resetMessage = ", drop DTR";
     }
 
-    cliPrintLinef("Forwarding, power cycle %sto exit.", resetMessage);
+    cliPrintLinef("Forwarding, send +++ between 1s pauses%s or power cycle to exit.", resetMessage);
 
     if ((ports[1].id == SERIAL_PORT_USB_VCP) && (port1ResetOnDtr
 #ifdef USE_PINIO
@@ -1570,7 +1570,7 @@ static void cliSerialPassthrough(const char *cmdName, char *cmdline)
 #endif /* USE_PINIO */
         )) {
         // Register control line state callback
-        serialSetCtrlLineStateCb(ports[0].port, cbCtrlLine, (void *)(intptr_t)(port1PinioDtr));
+        serialSetCtrlLineStateCb(ports[1].port, cbCtrlLine, (void *)(intptr_t)(port1PinioDtr));
     }
 
 // XXX Review ESC pass through under refactored motor handling
@@ -1600,6 +1600,12 @@ static void cliSerialPassthrough(const char *cmdName, char *cmdline)
 #endif
 
     serialPassthrough(ports[0].port, ports[1].port, NULL, NULL);
+
+    // left with the escape sequence, the USB line changes no longer go to port1
+    serialSetCtrlLineStateCb(ports[1].port, NULL, NULL);
+    serialSetBaudRateCb(ports[1].port, NULL, NULL);
+
+    cliPrintLine("Forwarding stopped.");
 }
 #endif
 
@@ -3628,6 +3634,25 @@ static int parseOutputIndex(const char *cmdName, char *pch, bool allowAllEscs) {
 }
 
 #if defined(USE_DSHOT)
+// Queued dshot commands go out with the motor update, which does not run while a cli command executes
+static void waitForDshotCommands(void)
+{
+    while (!dshotCommandQueueEmpty()) {
+        writeMotors();
+        delayMicroseconds(100);
+    }
+}
+
+// Only waits for the motor update to make room when the queue is full
+static void queueDshotCommand(uint8_t escIndex, uint8_t command)
+{
+    while (!dshotCommandWriteWithCallback(escIndex, getMotorCount(), command, DSHOT_CMD_TYPE_BLOCKING, NULL)
+        && !dshotCommandQueueEmpty()) {
+        writeMotors();
+        delayMicroseconds(100);
+    }
+}
+
 #if defined(USE_ESC_SENSOR) && defined(USE_ESC_SENSOR_INFO)
 
 #define ESC_INFO_KISS_V1_EXPECTED_FRAME_SIZE 15
@@ -3810,7 +3835,7 @@ static void executeEscInfoCommand(const char *cmdName, uint8_t escIndex)
 
     dshotCommandWrite(escIndex, getMotorCount(), DSHOT_CMD_ESC_INFO, DSHOT_CMD_TYPE_BLOCKING);
 
-    delay(10);
+    waitForDshotCommands();
 
     printEscInfo(cmdName, escInfoBuffer, getNumberEscBytesRead());
 }
@@ -3856,7 +3881,7 @@ static void cliDshotProg(const char *cmdName, char *cmdline)
                     }
 
                     if (command != DSHOT_CMD_ESC_INFO) {
-                        dshotCommandWrite(escIndex, getMotorCount(), command, DSHOT_CMD_TYPE_BLOCKING);
+                        queueDshotCommand(escIndex, command);
                     } else {
 #if defined(USE_ESC_SENSOR) && defined(USE_ESC_SENSOR_INFO)
                         if (featureIsEnabled(FEATURE_ESC_SENSOR)) {
@@ -3888,6 +3913,9 @@ static void cliDshotProg(const char *cmdName, char *cmdline)
         pch = strtok_r(NULL, " ", &saveptr);
     }
 
+    // All commands go out before returning, a save or reboot that follows must not drop them
+    waitForDshotCommands();
+
     motorEnable();
 }
 #endif // USE_DSHOT
@@ -4776,6 +4804,9 @@ static void cliStatus(const char *cmdName, char *cmdline)
     const int systemRate = getTaskDeltaTimeUs(TASK_SYSTEM) == 0 ? 0 : (int)(1000000.0f / ((float)getTaskDeltaTimeUs(TASK_SYSTEM)));
     cliPrintLinef("CPU:%d%%, cycle time: %d, GYRO rate: %d, RX rate: %d, System rate: %d",
             constrain(getAverageSystemLoadPercent(), 0, LOAD_PERCENTAGE_ONE), getTaskDeltaTimeUs(TASK_GYRO), gyroRate, rxRate, systemRate);
+    if (activePidLoopDenom != pidConfig()->pid_process_denom) {
+        cliPrintLinef("PID loop denom: %d, slowed down from %d by the task timing calibration", activePidLoopDenom, pidConfig()->pid_process_denom);
+    }
 
     // Battery meter
 
@@ -4807,11 +4838,31 @@ static void cliStatus(const char *cmdName, char *cmdline)
 #if defined(USE_TASK_STATISTICS)
 static void cliTasks(const char *cmdName, char *cmdline)
 {
-    UNUSED(cmdName);
-    UNUSED(cmdline);
     int maxLoadSum = 0;
     int averageLoadSum = 0;
 
+#if defined(USE_PERSISTENT_OBJECTS)
+    if (strcasecmp(cmdline, "calibrate") == 0) {
+        if (!systemConfig()->task_statistics) {
+            cliPrintErrorLinef(cmdName, "TASK STATISTICS ARE DISABLED");
+        } else {
+            schedulerStartTimingProfileCalibration(micros());
+            cliPrintLine("Measuring task timing, the task rates are chosen from it after the next reboot");
+        }
+        return;
+    } else if (strcasecmp(cmdline, "clear") == 0) {
+        schedulerClearTimingProfile();
+        cliPrintLine("Task timing profile cleared, the configured rates are used after the next reboot");
+        return;
+    } else if (!isEmpty(cmdline)) {
+        cliShowParseError(cmdName);
+        return;
+    }
+#else
+    UNUSED(cmdName);
+    UNUSED(cmdline);
+#endif
+
 #ifndef MINIMAL_CLI
     if (systemConfig()->task_statistics) {
         cliPrintLine("Task list             rate/hz  max/us  avg/us maxload avgload  total/ms");
@@ -4849,6 +4900,11 @@ static void cliTasks(const char *cmdName, char *cmdline)
         cliPrintLinef("Total (excluding SERIAL) %25d.%1d%% %4d.%1d%%", maxLoadSum/10, maxLoadSum%10, averageLoadSum/10, averageLoadSum%10);
         schedulerResetCheckFunctionMaxExecutionTime();
     }
+#if defined(USE_PERSISTENT_OBJECTS)
+    if (schedulerIsTimingProfileCalibrating()) {
+        cliPrintLine("Task timing calibration in progress");
+    }
+#endif
 }
 #endif
 
@@ -6497,8 +6553,12 @@ const clicmd_t cmdTable[] = {
 #endif
     CLI_COMMAND_DEF("status", "show status", NULL, cliStatus),
 #if defined(USE_TASK_STATISTICS)
+#if defined(USE_PERSISTENT_OBJECTS)
+    CLI_COMMAND_DEF("tasks", "show task stats", "[calibrate|clear]", cliTasks),
+#else
     CLI_COMMAND_DEF("tasks", "show task stats", NULL, cliTasks),
 #endif
+#endif
 #ifdef USE_TIMER_MGMT
     CLI_COMMAND_DEF("timer", "show/set timers", "<> | <pin> list | <pin> [af<alternate function>|none|<option(deprecated)>] | list | show", cliTimer),
 #endif
@@ -6684,6 +6744,9 @@ void cliProcess(void)
 
         processCharacterInteractive(c);
     }
+
+    // The serial task only runs again when more data arrives, so send the echo and command output now
+    cliWriterFlush();
 }
 
 #if defined(USE_CUSTOM_DEFAULTS)
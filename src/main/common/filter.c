@@ -108,8 +108,12 @@ void biquadFilterInit(biquadFilter_t *filter, float filterFreq, uint32_t refresh
 {
     // setup variables
     const float omega = 2.0f * M_PI_FLOAT * filterFreq * refreshRate * 0.000001f;
-    const float sn = sin_approx(omega);
-    const float cs = cos_approx(omega);
+    // notches are updated every loop by the RPM filter and the dynamic notch, the table error moves
+    // their center by well under 1Hz. The low pass coefficients use 1 - cos, which needs the polynomial
+    // accuracy at low cutoffs.
+    const bool tableTrigonometry = (filterType == FILTER_NOTCH);
+    const float sn = tableTrigonometry ? sin_approx_table(omega) : sin_approx(omega);
+    const float cs = tableTrigonometry ? cos_approx_table(omega) : cos_approx(omega);
     const float alpha = sn / (2.0f * Q);
 
     float b0 = 0, b1 = 0, b2 = 0, a0 = 0, a1 = 0, a2 = 0;
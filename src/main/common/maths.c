@@ -104,8 +104,121 @@ float acos_approx(float x)
     else
         return result;
 }
+
+// Table tier: linear interpolation in a quarter wave sine table and an atan table on 0..1.
+// Cheaper than the polynomials above, for the high rate call sites that can take the error.
+// sin_approx_table maximum absolute error = 1.901388e-05
+// cos_approx_table maximum absolute error = 1.901388e-05
+// atan2_approx_table maximum absolute error = 2.002716e-05 rads (1.147472e-03 degree)
+#define SIN_TABLE_STEPS 128     // steps per quarter turn, power of 2
+#define ATAN_TABLE_STEPS 64
+
+static const float sinTable[SIN_TABLE_STEPS + 1] = {
+    0.000000000f, 0.012271538f, 0.024541229f, 0.036807223f, 0.049067674f, 0.061320736f,
+    0.073564564f, 0.085797312f, 0.098017140f, 0.110222207f, 0.122410675f, 0.134580709f,
+    0.146730474f, 0.158858143f, 0.170961889f, 0.183039888f, 0.195090322f, 0.207111376f,
+    0.219101240f, 0.231058108f, 0.242980180f, 0.254865660f, 0.266712757f, 0.278519689f,
+    0.290284677f, 0.302005949f, 0.313681740f, 0.325310292f, 0.336889853f, 0.348418680f,
+    0.359895037f, 0.371317194f, 0.382683432f, 0.393992040f, 0.405241314f, 0.416429560f,
+    0.427555093f, 0.438616239f, 0.449611330f, 0.460538711f, 0.471396737f, 0.482183772f,
+    0.492898192f, 0.503538384f, 0.514102744f, 0.524589683f, 0.534997620f, 0.545324988f,
+    0.555570233f, 0.565731811f, 0.575808191f, 0.585797857f, 0.595699304f, 0.605511041f,
+    0.615231591f, 0.624859488f, 0.634393284f, 0.643831543f, 0.653172843f, 0.662415778f,
+    0.671558955f, 0.680600998f, 0.689540545f, 0.698376249f, 0.707106781f, 0.715730825f,
+    0.724247083f, 0.732654272f, 0.740951125f, 0.749136395f, 0.757208847f, 0.765167266f,
+    0.773010453f, 0.780737229f, 0.788346428f, 0.795836905f, 0.803207531f, 0.810457198f,
+    0.817584813f, 0.824589303f, 0.831469612f, 0.838224706f, 0.844853565f, 0.851355193f,
+    0.857728610f, 0.863972856f, 0.870086991f, 0.876070094f, 0.881921264f, 0.887639620f,
+    0.893224301f, 0.898674466f, 0.903989293f, 0.909167983f, 0.914209756f, 0.919113852f,
+    0.923879533f, 0.928506080f, 0.932992799f, 0.937339012f, 0.941544065f, 0.945607325f,
+    0.949528181f, 0.953306040f, 0.956940336f, 0.960430519f, 0.963776066f, 0.966976471f,
+    0.970031253f, 0.972939952f, 0.975702130f, 0.978317371f, 0.980785280f, 0.983105487f,
+    0.985277642f, 0.987301418f, 0.989176510f, 0.990902635f, 0.992479535f, 0.993906970f,
+    0.995184727f, 0.996312612f, 0.997290457f, 0.998118113f, 0.998795456f, 0.999322385f,
+    0.999698819f, 0.999924702f, 1.000000000f
+};
+
+static const float atanTable[ATAN_TABLE_STEPS + 1] = {
+    0.000000000f, 0.015623729f, 0.031239833f, 0.046840713f, 0.062418810f, 0.077966634f,
+    0.093476781f, 0.108941957f, 0.124354995f, 0.139708874f, 0.154996742f, 0.170211925f,
+    0.185347950f, 0.200398554f, 0.215357700f, 0.230219587f, 0.244978663f, 0.259629629f,
+    0.274167451f, 0.288587362f, 0.302884868f, 0.317055753f, 0.331096077f, 0.345002177f,
+    0.358770670f, 0.372398447f, 0.385882669f, 0.399220770f, 0.412410442f, 0.425449637f,
+    0.438336560f, 0.451069656f, 0.463647609f, 0.476069330f, 0.488333951f, 0.500440813f,
+    0.512389460f, 0.524179629f, 0.535811238f, 0.547284381f, 0.558599315f, 0.569756453f,
+    0.580756354f, 0.591599710f, 0.602287346f, 0.612820202f, 0.623199330f, 0.633425883f,
+    0.643501109f, 0.653426341f, 0.663202993f, 0.672832548f, 0.682316555f, 0.691656622f,
+    0.700854408f, 0.709911618f, 0.718830000f, 0.727611333f, 0.736257429f, 0.744770126f,
+    0.753151281f, 0.761402770f, 0.769526480f, 0.777524310f, 0.785398163f
+};
+
+static float sinTableInterpolate(float position)
+{
+    int32_t step = position;
+    if (position < step) {
+        step--;
+    }
+    const float fraction = position - step;
+    const uint32_t turnStep = (uint32_t)step & (4 * SIN_TABLE_STEPS - 1);
+    const uint32_t index = turnStep & (SIN_TABLE_STEPS - 1);
+
+    float a, b;
+    if (turnStep & SIN_TABLE_STEPS) {
+        a = sinTable[SIN_TABLE_STEPS - index];
+        b = sinTable[SIN_TABLE_STEPS - index - 1];
+    } else {
+        a = sinTable[index];
+        b = sinTable[index + 1];
+    }
+    const float result = a + (b - a) * fraction;
+    return (turnStep & (2 * SIN_TABLE_STEPS)) ? -result : result;
+}
+
+float sin_approx_table(float x)
+{
+    int32_t xint = x;
+    if (xint < -32 || xint > 32) return 0.0f;                               // Stop here on error input (5 * 360 Deg)
+    return sinTableInterpolate(x * (2.0f * SIN_TABLE_STEPS / M_PIf));
+}
+
+float cos_approx_table(float x)
+{
+    int32_t xint = x;
+    if (xint < -32 || xint > 32) return 0.0f;
+    return sinTableInterpolate(x * (2.0f * SIN_TABLE_STEPS / M_PIf) + SIN_TABLE_STEPS);
+}
+
+float atan2_approx_table(float y, float x)
+{
+    float res, absX, absY;
+    absX = fabsf(x);
+    absY = fabsf(y);
+    res  = MAX(absX, absY);
+    if (res) res = MIN(absX, absY) / res;
+    else res = 0.0f;
+    const float position = res * ATAN_TABLE_STEPS;
+    const int index = MIN((int)position, ATAN_TABLE_STEPS - 1);
+    res = atanTable[index] + (atanTable[index + 1] - atanTable[index]) * (position - index);
+    if (absY > absX) res = (M_PIf / 2.0f) - res;
+    if (x < 0) res = M_PIf - res;
+    if (y < 0) res = -res;
+    return res;
+}
 #endif
 
+// Fast reciprocal square root tier, the bit level initial guess with one Newton-Raphson step
+// for normalising vectors whose direction is used, not their length.
+// invSqrt_approx maximum relative error = 1.752155e-03
+float invSqrt_approx(float x)
+{
+    union {
+        float f;
+        int32_t i;
+    } conversion = { .f = x };
+    conversion.i = 0x5f3759df - (conversion.i >> 1);
+    return conversion.f * (1.5f - 0.5f * x * sq(conversion.f));
+}
+
 int gcd(int num, int denom)
 {
     if (denom == 0) {
@@ -127,6 +127,11 @@ float quickMedianFilter5f(float * v);
 float quickMedianFilter7f(float * v);
 float quickMedianFilter9f(float * v);
 
+// Accuracy tiers, call sites use the cheapest one that meets their error budget:
+//   sin_approx, cos_approx, atan2_approx    polynomial, about 3e-6 absolute error
+//   sin_approx_table, cos_approx_table,
+//   atan2_approx_table                      table with linear interpolation, about 2e-5 absolute error
+//   invSqrt_approx                          one Newton-Raphson step, about 2e-3 relative error
 #if defined(FAST_MATH) || defined(VERY_FAST_MATH)
 float sin_approx(float x);
 float cos_approx(float x);
@@ -136,6 +141,9 @@ float acos_approx(float x);
 float exp_approx(float val);
 float log_approx(float val);
 float pow_approx(float a, float b);
+float sin_approx_table(float x);
+float cos_approx_table(float x);
+float atan2_approx_table(float y, float x);
 #else
 #define sin_approx(x)   sinf(x)
 #define cos_approx(x)   cosf(x)
@@ -145,7 +153,11 @@ float pow_approx(float a, float b);
 #define exp_approx(x)       expf(x)
 #define log_approx(x)       logf(x)
 #define pow_approx(a, b)    powf(b, a)
+#define sin_approx_table(x) sinf(x)
+#define cos_approx_table(x) cosf(x)
+#define atan2_approx_table(y,x) atan2f(y,x)
 #endif
+float invSqrt_approx(float x);
 
 void arraySubInt32(int32_t *dest, int32_t *array1, int32_t *array2, int count);
 
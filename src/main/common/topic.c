@@ -0,0 +1,100 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "platform.h"
+
+#include "common/time.h"
+
+#include "topic.h"
+
+void topicPublish(topic_t *topic, timeUs_t sampleTimeUs)
+{
+    topic->sampleTimeUs = sampleTimeUs;
+    topic->sequence++;
+
+    for (topicSubscriber_t *subscriber = topic->callbacks; subscriber; subscriber = subscriber->next) {
+        subscriber->callback(topic->sample, sampleTimeUs);
+    }
+}
+
+// Samples published before subscribing are not new to the subscriber. A subscriber with a callback
+// is unsubscribed before it is subscribed again.
+void topicSubscribe(topicSubscriber_t *subscriber, topic_t *topic, topicCallbackFn *callback)
+{
+    subscriber->topic = topic;
+    subscriber->sequence = topic->sequence;
+    subscriber->callback = callback;
+    subscriber->next = NULL;
+    if (callback) {
+        subscriber->next = topic->callbacks;
+        topic->callbacks = subscriber;
+    }
+}
+
+void topicUnsubscribe(topicSubscriber_t *subscriber)
+{
+    if (!subscriber->topic || !subscriber->callback) {
+        return;
+    }
+    for (topicSubscriber_t **link = &subscriber->topic->callbacks; *link; link = &(*link)->next) {
+        if (*link == subscriber) {
+            *link = subscriber->next;
+            break;
+        }
+    }
+    subscriber->callback = NULL;
+    subscriber->next = NULL;
+}
+
+// NULL before the first sample is published
+const void *topicLatest(const topic_t *topic)
+{
+    return topic->sequence ? topic->sample : NULL;
+}
+
+timeDelta_t topicSampleAgeUs(const topic_t *topic, timeUs_t currentTimeUs)
+{
+    return cmpTimeUs(currentTimeUs, topic->sampleTimeUs);
+}
+
+bool topicHasNew(const topicSubscriber_t *subscriber)
+{
+    return subscriber->sequence != subscriber->topic->sequence;
+}
+
+uint32_t topicUnreadCount(const topicSubscriber_t *subscriber)
+{
+    return subscriber->topic->sequence - subscriber->sequence;
+}
+
+// Returns the latest sample and marks it read, or NULL if nothing was published since the last read
+const void *topicReadNew(topicSubscriber_t *subscriber)
+{
+    const topic_t *topic = subscriber->topic;
+    if (subscriber->sequence == topic->sequence) {
+        return NULL;
+    }
+    subscriber->sequence = topic->sequence;
+    return topic->sample;
+}
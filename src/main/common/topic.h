@@ -0,0 +1,78 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+#include "common/utils.h"
+
+// Latest value topics for sensor samples shared between modules.
+// The publisher owns the sample storage, the topic only points to it and adds the sample time and a
+// sequence counter, so publishing and reading copy nothing. Topics are published and read from task
+// context, a subscriber always sees the latest sample and counts the ones it missed.
+
+typedef void topicCallbackFn(const void *sample, timeUs_t sampleTimeUs);
+
+typedef struct topicSubscriber_s topicSubscriber_t;
+
+typedef struct topic_s {
+    const void *sample;             // latest value slot, the publisher's own storage
+    timeUs_t sampleTimeUs;          // time the latest sample was taken
+    uint32_t sequence;              // samples published, 0 before the first one
+    topicSubscriber_t *callbacks;   // subscribers called on every publish
+} topic_t;
+
+struct topicSubscriber_s {
+    topic_t *topic;
+    uint32_t sequence;              // sequence of the last sample read
+    topicCallbackFn *callback;
+    topicSubscriber_t *next;
+};
+
+// Declares a topic for samples of _type, with typed accessors to its latest sample
+#define TOPIC_DECLARE(_type, _name)                                     \
+    extern topic_t _name ## Topic;                                      \
+    static inline const _type *_name ## TopicLatest(void) { return (const _type *)topicLatest(&_name ## Topic); } \
+    static inline const _type *_name ## TopicReadNew(topicSubscriber_t *subscriber) { return (const _type *)topicReadNew(subscriber); } \
+    struct _dummy                                                       \
+    /**/
+
+// Defines a topic whose samples are stored in *_sample
+#define TOPIC_DEFINE(_type, _name, _sample)                             \
+    STATIC_ASSERT(__builtin_types_compatible_p(__typeof__(_sample), _type *), _name ## _topic_type); \
+    topic_t _name ## Topic = { .sample = (_sample) }                    \
+    /**/
+
+// A subscriber that only polls needs no call to topicSubscribe()
+#define TOPIC_SUBSCRIBER(_name) { .topic = &_name ## Topic }
+
+void topicPublish(topic_t *topic, timeUs_t sampleTimeUs);
+void topicSubscribe(topicSubscriber_t *subscriber, topic_t *topic, topicCallbackFn *callback);
+void topicUnsubscribe(topicSubscriber_t *subscriber);
+
+const void *topicLatest(const topic_t *topic);
+timeDelta_t topicSampleAgeUs(const topic_t *topic, timeUs_t currentTimeUs);
+
+bool topicHasNew(const topicSubscriber_t *subscriber);
+uint32_t topicUnreadCount(const topicSubscriber_t *subscriber);
+const void *topicReadNew(topicSubscriber_t *subscriber);
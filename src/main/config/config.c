@@ -390,7 +390,12 @@ static void validateAndFixConfig(void)
     }
 
 #if defined(USE_ESC_SENSOR)
-    if (!findSerialPortConfig(FUNCTION_ESC_SENSOR)) {
+    // Without a serial port the data can still come from extended DShot telemetry
+    if (!findSerialPortConfig(FUNCTION_ESC_SENSOR)
+#if defined(USE_DSHOT_TELEMETRY)
+        && !(motorConfig()->dev.useDshotEdt && motorConfig()->dev.useDshotTelemetry)
+#endif
+        ) {
         featureDisableImmediate(FEATURE_ESC_SENSOR);
     }
 #endif
@@ -43,6 +43,15 @@
 
 static uint16_t eepromConfigSize;
 
+#ifndef CONFIG_RECORD_INDEX_SIZE
+#define CONFIG_RECORD_INDEX_SIZE 256    // PGs registered beyond this are found by scanning the stored config
+#endif
+
+// Offset of the stored record of each registered PG, indexed by the position of the PG in the registry,
+// 0 if there is no record. Built while the stored config is validated, so the PGs are loaded in a single pass.
+static uint16_t configRecordIndex[CONFIG_RECORD_INDEX_SIZE];
+static bool configRecordIndexValid = false;
+
 typedef enum {
     CR_CLASSICATION_SYSTEM   = 0,
     CR_CLASSICATION_PROFILE_LAST = CR_CLASSICATION_SYSTEM,
@@ -281,16 +290,45 @@ bool isEEPROMVersionValid(void)
     return true;
 }
 
-// Scan the EEPROM config. Returns true if the config is valid.
+// Returns the position of the PG in the registry, -1 if the PG is not registered
+static int findRegistryIndex(pgn_t pgn, int expectedIndex)
+{
+    // The records are stored in registry order, so the PG following the previous record is checked first
+    if (expectedIndex < PG_REGISTRY_SIZE && pgN(&__pg_registry_start[expectedIndex]) == pgn) {
+        return expectedIndex;
+    }
+
+    for (int i = 0; i < PG_REGISTRY_SIZE; i++) {
+        if (pgN(&__pg_registry_start[i]) == pgn) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static void indexConfigRecord(const configRecord_t *record, int registryIndex)
+{
+    if (registryIndex < CONFIG_RECORD_INDEX_SIZE && configRecordIndex[registryIndex] == 0) {
+        configRecordIndex[registryIndex] = (const uint8_t *)record - &__config_start;
+    }
+}
+
+// Scan the EEPROM config and index the stored records. Returns true if the config is valid.
 bool isEEPROMStructureValid(void)
 {
     const uint8_t *p = &__config_start;
     const configHeader_t *header = (const configHeader_t *)p;
 
+    configRecordIndexValid = false;
+
     if (header->magic_be != 0xBE) {
         return false;
     }
 
+    memset(configRecordIndex, 0, sizeof(configRecordIndex));
+    int registryIndex = 0;
+
     uint16_t crc = CRC_START_VALUE;
     crc = crc16_ccitt_update(crc, header, sizeof(*header));
     p += sizeof(*header);
@@ -310,6 +348,14 @@ bool isEEPROMStructureValid(void)
 
         crc = crc16_ccitt_update(crc, p, record->size);
 
+        if ((record->flags & CR_CLASSIFICATION_MASK) == CR_CLASSICATION_SYSTEM) {
+            const int index = findRegistryIndex(record->pgn, registryIndex);
+            if (index >= 0) {
+                indexConfigRecord(record, index);
+                registryIndex = index + 1;
+            }
+        }
+
         p += record->size;
     }
 
@@ -325,7 +371,10 @@ bool isEEPROMStructureValid(void)
     eepromConfigSize = p - &__config_start;
 
     // CRC has the property that if the CRC itself is included in the calculation the resulting CRC will have constant value
-    return crc == CRC_CHECK_VALUE;
+    // The index is only used if the config it points into is intact
+    configRecordIndexValid = crc == CRC_CHECK_VALUE;
+
+    return configRecordIndexValid;
 }
 
 uint16_t getEEPROMConfigSize(void)
@@ -369,15 +418,30 @@ static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFla
     return NULL;
 }
 
+static const configRecord_t *findIndexedEEPROM(const pgRegistry_t *reg)
+{
+    const int registryIndex = reg - __pg_registry_start;
+    if (registryIndex >= CONFIG_RECORD_INDEX_SIZE) {
+        return findEEPROM(reg, CR_CLASSICATION_SYSTEM);
+    }
+
+    const uint16_t offset = configRecordIndex[registryIndex];
+    return offset ? (const configRecord_t *)(&__config_start + offset) : NULL;
+}
+
 // Initialize all PG records from EEPROM.
-// This functions processes all PGs sequentially, scanning EEPROM for each one. This is suboptimal,
-//   but each PG is loaded/initialized exactly once and in defined order.
+// This functions processes all PGs sequentially, the records are found through the index built by
+//   isEEPROMStructureValid(), so each PG is loaded/initialized exactly once and in defined order.
 bool loadEEPROM(void)
 {
     bool success = true;
 
+    if (!configRecordIndexValid) {
+        isEEPROMStructureValid();
+    }
+
     PG_FOREACH(reg) {
-        const configRecord_t *rec = findEEPROM(reg, CR_CLASSICATION_SYSTEM);
+        const configRecord_t *rec = configRecordIndexValid ? findIndexedEEPROM(reg) : findEEPROM(reg, CR_CLASSICATION_SYSTEM);
         if (rec) {
             // config from EEPROM is available, use it to initialize PG. pgLoad will handle version mismatch
             if (!pgLoad(reg, rec->pg, rec->size - offsetof(configRecord_t, pg), rec->version)) {
@@ -395,6 +459,9 @@ bool loadEEPROM(void)
 
 static bool writeSettingsToEEPROM(void)
 {
+    // the stored records are about to move
+    configRecordIndexValid = false;
+
     config_streamer_t streamer;
     config_streamer_init(&streamer);
 
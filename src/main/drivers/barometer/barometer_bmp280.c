@@ -20,6 +20,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <math.h>
 
 #include "platform.h"
 
@@ -97,7 +98,9 @@ typedef struct bmp280_calib_param_s {
 
 STATIC_ASSERT(sizeof(bmp280_calib_param_t) == BMP280_PRESSURE_TEMPERATURE_CALIB_DATA_LENGTH, bmp280_calibration_structure_incorrectly_packed);
 
+#if !defined(USE_BARO_FLOAT_COMPENSATION) || defined(UNIT_TEST)
 STATIC_UNIT_TESTED int32_t t_fine; /* calibration t_fine data */
+#endif
 
 static uint8_t bmp280_chip_id = 0;
 STATIC_UNIT_TESTED bmp280_calib_param_t bmp280_cal;
@@ -113,7 +116,12 @@ static void bmp280StartUP(baroDev_t *baro);
 static bool bmp280ReadUP(baroDev_t *baro);
 static bool bmp280GetUP(baroDev_t *baro);
 
+#if !defined(USE_BARO_FLOAT_COMPENSATION) || defined(UNIT_TEST)
 STATIC_UNIT_TESTED void bmp280Calculate(int32_t *pressure, int32_t *temperature);
+#endif
+#ifdef USE_BARO_FLOAT_COMPENSATION
+STATIC_UNIT_TESTED void bmp280CalculateFloat(int32_t *pressure, int32_t *temperature);
+#endif
 
 void bmp280BusInit(busDevice_t *busdev)
 {
@@ -188,7 +196,11 @@ bool bmp280Detect(baroDev_t *baro)
     baro->get_up = bmp280GetUP;
     baro->read_up = bmp280ReadUP;
     baro->up_delay = ((T_INIT_MAX + T_MEASURE_PER_OSRS_MAX * (((1 << BMP280_TEMPERATURE_OSR) >> 1) + ((1 << BMP280_PRESSURE_OSR) >> 1)) + (BMP280_PRESSURE_OSR ? T_SETUP_PRESSURE_MAX : 0) + 15) / 16) * 1000;
+#ifdef USE_BARO_FLOAT_COMPENSATION
+    baro->calculate = bmp280CalculateFloat;
+#else
     baro->calculate = bmp280Calculate;
+#endif
 
     return true;
 }
@@ -244,6 +256,7 @@ static bool bmp280GetUP(baroDev_t *baro)
     return true;
 }
 
+#if !defined(USE_BARO_FLOAT_COMPENSATION) || defined(UNIT_TEST)
 // Returns temperature in DegC, resolution is 0.01 DegC. Output value of "5123" equals 51.23 DegC
 // t_fine carries fine temperature as global value
 static int32_t bmp280CompensateTemperature(int32_t adc_T)
@@ -292,5 +305,38 @@ STATIC_UNIT_TESTED void bmp280Calculate(int32_t *pressure, int32_t *temperature)
     if (temperature)
         *temperature = t;
 }
+#endif
+
+#ifdef USE_BARO_FLOAT_COMPENSATION
+// Floating point compensation from the datasheet 8.1, in single precision it is within 1Pa of the integer code
+STATIC_UNIT_TESTED void bmp280CalculateFloat(int32_t *pressure, int32_t *temperature)
+{
+    const float adcT = bmp280_ut;
+    const float dT = adcT / 16384.0f - bmp280_cal.dig_T1 / 1024.0f;
+    const float dT8 = adcT / 131072.0f - bmp280_cal.dig_T1 / 8192.0f;
+    const float tFine = dT * bmp280_cal.dig_T2 + dT8 * dT8 * bmp280_cal.dig_T3;
+
+    float var1 = tFine / 2.0f - 64000.0f;
+    float var2 = var1 * var1 * bmp280_cal.dig_P6 / 32768.0f;
+    var2 = var2 + var1 * bmp280_cal.dig_P5 * 2.0f;
+    var2 = var2 / 4.0f + bmp280_cal.dig_P4 * 65536.0f;
+    var1 = (bmp280_cal.dig_P3 * var1 * var1 / 524288.0f + bmp280_cal.dig_P2 * var1) / 524288.0f;
+    var1 = (1.0f + var1 / 32768.0f) * bmp280_cal.dig_P1;
+
+    float p = 0.0f;
+    if (var1 != 0.0f) {
+        p = 1048576.0f - bmp280_up;
+        p = (p - var2 / 4096.0f) * 6250.0f / var1;
+        var1 = bmp280_cal.dig_P9 * p * p / 2147483648.0f;
+        var2 = p * bmp280_cal.dig_P8 / 32768.0f;
+        p = p + (var1 + var2 + bmp280_cal.dig_P7) / 16.0f;
+    }
+
+    if (pressure)
+        *pressure = (int32_t)p;
+    if (temperature)
+        *temperature = lrintf(tFine / 51.2f);
+}
+#endif
 
 #endif
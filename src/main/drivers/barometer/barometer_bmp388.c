@@ -22,6 +22,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <math.h>
 
 #include "platform.h"
 
@@ -100,6 +101,12 @@
 #define BMP388_TEMP_XLSB_7_0_REG                        BMP388_DATA_3_REG
 
 #define BMP388_DATA_FRAME_SIZE                          ((BMP388_DATA_5_REG - BMP388_DATA_0_REG) + 1) // +1 for inclusive
+// the status register is read in the same burst as the data, see datasheet 4.3.4
+#define BMP388_STATUS_DATA_FRAME_SIZE                   ((BMP388_DATA_5_REG - BMP388_STATUS_REG) + 1)
+
+// STATUS register
+#define BMP388_STATUS_DRDY_PRESS_BIT                    5
+#define BMP388_STATUS_DRDY_TEMP_BIT                     6
 
 // from Datasheet 3.3
 #define BMP388_MODE_SLEEP                               (0x00)
@@ -136,9 +143,19 @@
 #define BMP388_OSR_P_MASK                   (0x03)  // -----111
 #define BMP388_OSR4_T_MASK                  (0x38)  // --111---
 
-// configure pressure and temperature oversampling, forced sampling mode
+// ODR register, from datasheet 4.3.20
+#define BMP388_ODR_200_HZ                (0x00)
+#define BMP388_ODR_100_HZ                (0x01)
+#define BMP388_ODR_50_HZ                 (0x02)
+#define BMP388_ODR_25_HZ                 (0x03)
+
+// configure pressure and temperature oversampling, continuous sampling in normal mode
 #define BMP388_PRESSURE_OSR              (BMP388_OVERSAMP_8X)
 #define BMP388_TEMPERATURE_OSR           (BMP388_OVERSAMP_1X)
+// the output data rate period has to be longer than a measurement, see datasheet 3.9.2
+// 234 + (392 + 8 * 2000) + (313 + 1 * 2000) = 18939us, so 50Hz
+#define BMP388_ODR                       (BMP388_ODR_50_HZ)
+#define BMP388_ODR_PERIOD_US             (5000 << BMP388_ODR)
 
 // see Datasheet 3.11.1 Memory Map Trimming Coefficients
 typedef struct bmp388_calib_param_s {
@@ -160,14 +177,38 @@ typedef struct bmp388_calib_param_s {
 
 STATIC_ASSERT(sizeof(bmp388_calib_param_t) == BMP388_TRIMMING_DATA_LENGTH, bmp388_calibration_structure_incorrectly_packed);
 
+#ifdef USE_BARO_FLOAT_COMPENSATION
+// calibration coefficients scaled for the floating point compensation, see BMP3-Sensor-API bmp3_quantized_calib_data
+typedef struct bmp388_calib_param_float_s {
+    float T1;
+    float T2;
+    float T3;
+    float P1;
+    float P2;
+    float P3;
+    float P4;
+    float P5;
+    float P6;
+    float P7;
+    float P8;
+    float P9;
+    float P10;
+    float P11;
+} bmp388_calib_param_float_t;
+
+static bmp388_calib_param_float_t bmp388_cal_float;
+#endif
+
 static uint8_t bmp388_chip_id = 0;
 STATIC_UNIT_TESTED bmp388_calib_param_t bmp388_cal;
 // uncompensated pressure and temperature
 uint32_t bmp388_up = 0;
 uint32_t bmp388_ut = 0;
-static uint8_t sensor_data[BMP388_DATA_FRAME_SIZE];
+static uint8_t sensor_data[BMP388_STATUS_DATA_FRAME_SIZE];
 
+#if !defined(USE_BARO_FLOAT_COMPENSATION) || defined(UNIT_TEST)
 STATIC_UNIT_TESTED int64_t t_lin = 0;
+#endif
 
 static void bmp388StartUT(baroDev_t *baro);
 static bool bmp388GetUT(baroDev_t *baro);
@@ -176,7 +217,13 @@ static void bmp388StartUP(baroDev_t *baro);
 static bool bmp388GetUP(baroDev_t *baro);
 static bool bmp388ReadUP(baroDev_t *baro);
 
+#if !defined(USE_BARO_FLOAT_COMPENSATION) || defined(UNIT_TEST)
 STATIC_UNIT_TESTED void bmp388Calculate(int32_t *pressure, int32_t *temperature);
+#endif
+#ifdef USE_BARO_FLOAT_COMPENSATION
+STATIC_UNIT_TESTED void bmp388PrecomputeFloatCalibration(void);
+STATIC_UNIT_TESTED void bmp388CalculateFloat(int32_t *pressure, int32_t *temperature);
+#endif
 
 #ifdef USE_EXTI
 void bmp388_extiHandler(extiCallbackRec_t* cb)
@@ -219,11 +266,11 @@ void bmp388BusDeinit(busDevice_t *busdev)
 #endif
 }
 
-void bmp388BeginForcedMeasurement(busDevice_t *busdev)
+static void bmp388BeginContinuousMeasurement(busDevice_t *busdev)
 {
-    // enable pressure measurement, temperature measurement, set power mode and start sampling
-    uint8_t mode = BMP388_MODE_FORCED << 4 | 1 << 1 | 1 << 0;
-    busWriteRegisterStart(busdev, BMP388_PWR_CTRL_REG, mode);
+    // enable pressure measurement, temperature measurement, set normal power mode and start sampling at the output data rate
+    uint8_t mode = BMP388_MODE_NORMAL << 4 | 1 << 1 | 1 << 0;
+    busWriteRegister(busdev, BMP388_PWR_CTRL_REG, mode);
 }
 
 bool bmp388Detect(const bmp388Config_t *config, baroDev_t *baro)
@@ -277,7 +324,9 @@ bool bmp388Detect(const bmp388Config_t *config, baroDev_t *baro)
 
     // read calibration
     busReadRegisterBuffer(busdev, BMP388_TRIMMING_NVM_PAR_T1_LSB_REG, (uint8_t *)&bmp388_cal, sizeof(bmp388_calib_param_t));
-
+#ifdef USE_BARO_FLOAT_COMPENSATION
+    bmp388PrecomputeFloatCalibration();
+#endif
 
     // set oversampling
     busWriteRegister(busdev, BMP388_OSR_REG,
@@ -285,9 +334,12 @@ bool bmp388Detect(const bmp388Config_t *config, baroDev_t *baro)
         ((BMP388_TEMPERATURE_OSR << BMP388_OSR4_T_BIT) & BMP388_OSR4_T_MASK)
     );
 
-    bmp388BeginForcedMeasurement(busdev);
+    busWriteRegister(busdev, BMP388_ODR_REG, BMP388_ODR);
+
+    bmp388BeginContinuousMeasurement(busdev);
 
     // these are dummy as temperature is measured as part of pressure
+    baro->combined_read = true;
     baro->ut_delay = 0;
     baro->start_ut = bmp388StartUT;
     baro->get_ut = bmp388GetUT;
@@ -297,12 +349,14 @@ bool bmp388Detect(const bmp388Config_t *config, baroDev_t *baro)
     baro->get_up = bmp388GetUP;
     baro->read_up = bmp388ReadUP;
 
-    // See datasheet 3.9.2 "Measurement rate in forced mode and normal mode"
-    baro->up_delay = 234 +
-        (392 + (powerf(2, BMP388_PRESSURE_OSR + 1) * 2000)) +
-        (313 + (powerf(2, BMP388_TEMPERATURE_OSR + 1) * 2000));
+    // the sensor samples continuously, a new measurement is available every output data rate period
+    baro->up_delay = BMP388_ODR_PERIOD_US;
 
+#ifdef USE_BARO_FLOAT_COMPENSATION
+    baro->calculate = bmp388CalculateFloat;
+#else
     baro->calculate = bmp388Calculate;
+#endif
 
     while (busBusy(&baro->busdev, NULL));
 
@@ -331,8 +385,8 @@ static bool bmp388GetUT(baroDev_t *baro)
 
 static void bmp388StartUP(baroDev_t *baro)
 {
-    // start measurement
-    bmp388BeginForcedMeasurement(&baro->busdev);
+    UNUSED(baro);
+    // dummy, the sensor is sampling continuously
 }
 
 static bool bmp388ReadUP(baroDev_t *baro)
@@ -341,8 +395,8 @@ static bool bmp388ReadUP(baroDev_t *baro)
         return false;
     }
 
-    // read data from sensor
-    busReadRegisterBufferStart(&baro->busdev, BMP388_DATA_0_REG, sensor_data, BMP388_DATA_FRAME_SIZE);
+    // read status and data from sensor
+    busReadRegisterBufferStart(&baro->busdev, BMP388_STATUS_REG, sensor_data, BMP388_STATUS_DATA_FRAME_SIZE);
 
     return true;
 }
@@ -353,11 +407,18 @@ static bool bmp388GetUP(baroDev_t *baro)
         return false;
     }
 
-    bmp388_up = sensor_data[0] << 0 | sensor_data[1] << 8 | sensor_data[2] << 16;
-    bmp388_ut = sensor_data[3] << 0 | sensor_data[4] << 8 | sensor_data[5] << 16;
+    // reading the data clears the data ready flags, poll again until the next measurement is complete
+    if (!(sensor_data[0] & (1 << BMP388_STATUS_DRDY_PRESS_BIT))) {
+        busReadRegisterBufferStart(&baro->busdev, BMP388_STATUS_REG, sensor_data, BMP388_STATUS_DATA_FRAME_SIZE);
+        return false;
+    }
+
+    bmp388_up = sensor_data[1] << 0 | sensor_data[2] << 8 | sensor_data[3] << 16;
+    bmp388_ut = sensor_data[4] << 0 | sensor_data[5] << 8 | sensor_data[6] << 16;
     return true;
 }
 
+#if !defined(USE_BARO_FLOAT_COMPENSATION) || defined(UNIT_TEST)
 // Returns temperature in DegC, resolution is 0.01 DegC. Output value of "5123" equals 51.23 DegC
 static int64_t bmp388CompensateTemperature(uint32_t uncomp_temperature)
 {
@@ -369,7 +430,7 @@ static int64_t bmp388CompensateTemperature(uint32_t uncomp_temperature)
     int64_t partial_data6;
     int64_t comp_temp;
 
-    partial_data1 = uncomp_temperature - (256 * bmp388_cal.T1);
+    partial_data1 = (uint64_t)uncomp_temperature - (256 * bmp388_cal.T1);
     partial_data2 = bmp388_cal.T2 * partial_data1;
     partial_data3 = partial_data1 * partial_data1;
     partial_data4 = (int64_t)partial_data3 * bmp388_cal.T3;
@@ -382,6 +443,7 @@ static int64_t bmp388CompensateTemperature(uint32_t uncomp_temperature)
     return comp_temp;
 }
 
+// Returns pressure in Pa with a resolution of 0.01 Pa. Output value of "9638620" equals 96386.2 Pa
 static uint64_t bmp388CompensatePressure(uint32_t uncomp_pressure)
 {
     int64_t partial_data1;
@@ -412,7 +474,9 @@ static uint64_t bmp388CompensatePressure(uint32_t uncomp_pressure)
     partial_data2 = bmp388_cal.P10 * t_lin;
     partial_data3 = partial_data2 + (65536 * bmp388_cal.P9);
     partial_data4 = (partial_data3 * uncomp_pressure) / 8192;
-    partial_data5 = (partial_data4 * uncomp_pressure) / 512;
+    // dividing by 10 before the multiplication avoids an overflow with the high pressure values
+    partial_data5 = (uncomp_pressure * (partial_data4 / 10)) / 512;
+    partial_data5 = partial_data5 * 10;
     partial_data6 = (int64_t)((uint64_t)uncomp_pressure * (uint64_t)uncomp_pressure);
     partial_data2 = (bmp388_cal.P11 * partial_data6) / 65536;
     partial_data3 = (partial_data2 * uncomp_pressure) / 128;
@@ -436,9 +500,51 @@ STATIC_UNIT_TESTED void bmp388Calculate(int32_t *pressure, int32_t *temperature)
     p = bmp388CompensatePressure(bmp388_up);
 
     if (pressure)
-        *pressure = (int32_t)(p / 256);
+        *pressure = (int32_t)(p / 100);
     if (temperature)
         *temperature = t;
 }
+#endif
+
+#ifdef USE_BARO_FLOAT_COMPENSATION
+// See BMP3-Sensor-API parse_calib_data(), the divisors are powers of two so they are exact in single precision
+STATIC_UNIT_TESTED void bmp388PrecomputeFloatCalibration(void)
+{
+    bmp388_cal_float.T1 = bmp388_cal.T1 * 256.0f;
+    bmp388_cal_float.T2 = bmp388_cal.T2 / 1073741824.0f;                        // 2^30
+    bmp388_cal_float.T3 = bmp388_cal.T3 / 281474976710656.0f;                   // 2^48
+    bmp388_cal_float.P1 = (bmp388_cal.P1 - 16384) / 1048576.0f;                 // 2^14, 2^20
+    bmp388_cal_float.P2 = (bmp388_cal.P2 - 16384) / 536870912.0f;               // 2^14, 2^29
+    bmp388_cal_float.P3 = bmp388_cal.P3 / 4294967296.0f;                        // 2^32
+    bmp388_cal_float.P4 = bmp388_cal.P4 / 137438953472.0f;                      // 2^37
+    bmp388_cal_float.P5 = bmp388_cal.P5 * 8.0f;
+    bmp388_cal_float.P6 = bmp388_cal.P6 / 64.0f;
+    bmp388_cal_float.P7 = bmp388_cal.P7 / 256.0f;
+    bmp388_cal_float.P8 = bmp388_cal.P8 / 32768.0f;
+    bmp388_cal_float.P9 = bmp388_cal.P9 / 281474976710656.0f;                   // 2^48
+    bmp388_cal_float.P10 = bmp388_cal.P10 / 281474976710656.0f;                 // 2^48
+    bmp388_cal_float.P11 = bmp388_cal.P11 / 36893488147419103232.0f;            // 2^65
+}
+
+// See BMP3-Sensor-API compensate_temperature() and compensate_pressure() for the floating point version
+STATIC_UNIT_TESTED void bmp388CalculateFloat(int32_t *pressure, int32_t *temperature)
+{
+    const float dT = (float)bmp388_ut - bmp388_cal_float.T1;
+    const float tLin = dT * bmp388_cal_float.T2 + dT * dT * bmp388_cal_float.T3;
+    const float tLin2 = tLin * tLin;
+    const float tLin3 = tLin2 * tLin;
+
+    const float up = bmp388_up;
+    const float up2 = up * up;
+    const float offset = bmp388_cal_float.P5 + bmp388_cal_float.P6 * tLin + bmp388_cal_float.P7 * tLin2 + bmp388_cal_float.P8 * tLin3;
+    const float sensitivity = bmp388_cal_float.P1 + bmp388_cal_float.P2 * tLin + bmp388_cal_float.P3 * tLin2 + bmp388_cal_float.P4 * tLin3;
+    const float p = offset + up * sensitivity + up2 * (bmp388_cal_float.P9 + bmp388_cal_float.P10 * tLin) + up2 * up * bmp388_cal_float.P11;
+
+    if (pressure)
+        *pressure = (int32_t)p;
+    if (temperature)
+        *temperature = lrintf(tLin * 100.0f);
+}
+#endif
 
 #endif
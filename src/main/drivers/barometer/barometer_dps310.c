@@ -375,6 +375,8 @@ bool baroDPS310Detect(baroDev_t *baro)
 
     const uint32_t baroDelay = 1000000 / 32 / 2;      // twice the sample rate to capture all new data
 
+    // the sensor measures continuously and the temperature is read with the pressure
+    baro->combined_read = true;
     baro->ut_delay = 0;
     baro->start_ut = dps310StartUT;
     baro->read_ut = dps310ReadUT;
@@ -20,6 +20,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <math.h>
 
 #include "platform.h"
 
@@ -193,6 +194,7 @@ static bool ms5611GetUP(baroDev_t *baro)
     return true;
 }
 
+#if !defined(USE_BARO_FLOAT_COMPENSATION) || defined(UNIT_TEST)
 STATIC_UNIT_TESTED void ms5611Calculate(int32_t *pressure, int32_t *temperature)
 {
     uint32_t press;
@@ -224,6 +226,38 @@ STATIC_UNIT_TESTED void ms5611Calculate(int32_t *pressure, int32_t *temperature)
     if (temperature)
         *temperature = temp;
 }
+#endif
+
+#ifdef USE_BARO_FLOAT_COMPENSATION
+// Same first and second order compensation as ms5611Calculate(), in single precision it is within 1Pa
+STATIC_UNIT_TESTED void ms5611CalculateFloat(int32_t *pressure, int32_t *temperature)
+{
+    const float dT = (float)ms5611_ut - ms5611_c[5] * 256.0f;
+    float off = ms5611_c[2] * 65536.0f + ms5611_c[4] * dT / 128.0f;
+    float sens = ms5611_c[1] * 32768.0f + ms5611_c[3] * dT / 256.0f;
+    // the second order compensation is calibrated for whole centidegrees
+    float temp = 2000.0f + floorf(dT * ms5611_c[6] / 8388608.0f);
+
+    if (temp < 2000.0f) { // temperature lower than 20degC
+        float delt = temp - 2000.0f;
+        delt = 5.0f * delt * delt;
+        off -= delt / 2.0f;
+        sens -= delt / 4.0f;
+        if (temp < -1500.0f) { // temperature lower than -15degC
+            delt = temp + 1500.0f;
+            delt = delt * delt;
+            off -= 7.0f * delt;
+            sens -= 11.0f * delt / 2.0f;
+        }
+        temp -= dT * dT / 2147483648.0f;
+    }
+
+    if (pressure)
+        *pressure = lrintf((ms5611_up * sens / 2097152.0f - off) / 32768.0f);
+    if (temperature)
+        *temperature = lrintf(temp);
+}
+#endif
 
 bool ms5611Detect(baroDev_t *baro)
 {
@@ -267,7 +301,11 @@ bool ms5611Detect(baroDev_t *baro)
     baro->start_up = ms5611StartUP;
     baro->read_up = ms5611ReadUP;
     baro->get_up = ms5611GetUP;
+#ifdef USE_BARO_FLOAT_COMPENSATION
+    baro->calculate = ms5611CalculateFloat;
+#else
     baro->calculate = ms5611Calculate;
+#endif
 
     return true;
 
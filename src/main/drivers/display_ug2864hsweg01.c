@@ -20,9 +20,13 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
+#include "build/build_config.h"
+
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/bus_i2c.h"
@@ -36,6 +40,22 @@
 
 unsigned char CHAR_FORMAT = NORMAL_CHAR_FORMAT;
 
+// Each flush transaction addresses the page and column then sends the dirty columns of that page
+#define FLUSH_CHUNK_SIZE SCREEN_WIDTH
+#define FLUSH_HEADER_SIZE 6
+
+// Rendering happens in RAM, the display is brought up to date from the dirty regions by i2c_OLED_flush()
+STATIC_UNIT_TESTED uint8_t framebuffer[SCREEN_PAGE_COUNT][SCREEN_WIDTH];
+// Dirty columns of each page are [dirtyStart, dirtyEnd), the page is clean when dirtyStart >= dirtyEnd
+STATIC_UNIT_TESTED uint8_t dirtyStart[SCREEN_PAGE_COUNT];
+STATIC_UNIT_TESTED uint8_t dirtyEnd[SCREEN_PAGE_COUNT];
+
+static uint8_t cursorPage;
+static uint8_t cursorColumn;
+
+// Must persist until the asynchronous transfer completes
+static uint8_t flushBuffer[FLUSH_HEADER_SIZE + FLUSH_CHUNK_SIZE];
+
 static const uint8_t multiWiiFont[][5] = { // Refer to "Times New Roman" Font Database... 5 x 7 font
         { 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x4F, 0x00, 0x00 }, //   (  1)  ! - 0x0021 Exclamation Mark
                 { 0x00, 0x07, 0x00, 0x07, 0x00 }, //   (  2)  " - 0x0022 Quotation Mark
@@ -175,6 +195,11 @@ static const uint8_t multiWiiFont[][5] = { // Refer to "Times New Roman" Font Da
 
 static bool i2c_OLED_send_cmd(busDevice_t *bus, uint8_t command)
 {
+    // A framebuffer transfer may still be in progress, fail rather than wait for it
+    if (i2cBusy(bus->busdev_u.i2c.device, NULL)) {
+        return false;
+    }
+
     return i2cWrite(bus->busdev_u.i2c.device, bus->busdev_u.i2c.address, 0x80, command);
 }
 
@@ -189,27 +214,54 @@ static bool i2c_OLED_send_cmdarray(busDevice_t *bus, const uint8_t *commands, si
     return true;
 }
 
-static bool i2c_OLED_send_byte(busDevice_t *bus, uint8_t val)
+static void markDirty(uint8_t page, uint8_t startColumn, uint8_t endColumn)
 {
-    return i2cWrite(bus->busdev_u.i2c.device, bus->busdev_u.i2c.address, 0x40, val);
+    if (dirtyStart[page] >= dirtyEnd[page]) {
+        dirtyStart[page] = startColumn;
+        dirtyEnd[page] = endColumn;
+    } else {
+        dirtyStart[page] = MIN(dirtyStart[page], startColumn);
+        dirtyEnd[page] = MAX(dirtyEnd[page], endColumn);
+    }
 }
 
-void i2c_OLED_clear_display_quick(busDevice_t *bus)
+static void framebufferWrite(uint8_t value)
 {
-    static const uint8_t i2c_OLED_cmd_clear_display_quick[] = {
-        0xb0, // set page address to 0
-        0x40, // Display start line register to 0
-        0,    // Set low col address to 0
-        0x10, // Set high col address to 0
-    };
+    if (cursorPage >= SCREEN_PAGE_COUNT || cursorColumn >= SCREEN_WIDTH) {
+        return;
+    }
 
-    i2c_OLED_send_cmdarray(bus, i2c_OLED_cmd_clear_display_quick, ARRAYLEN(i2c_OLED_cmd_clear_display_quick));
+    // Unchanged pixels are not sent again, so redrawing identical text costs no bus time
+    if (framebuffer[cursorPage][cursorColumn] != value) {
+        framebuffer[cursorPage][cursorColumn] = value;
+        markDirty(cursorPage, cursorColumn, cursorColumn + 1);
+    }
+    cursorColumn++;
+}
 
-    for (uint16_t i = 0; i < 1024; i++) {      // fill the display's RAM with graphic... 128*64 pixel picture
-        i2c_OLED_send_byte(bus, 0x00);  // clear
+static void framebufferInvalidate(void)
+{
+    for (unsigned page = 0; page < SCREEN_PAGE_COUNT; page++) {
+        markDirty(page, 0, SCREEN_WIDTH);
     }
 }
 
+void i2c_OLED_clear_display_quick(busDevice_t *bus)
+{
+    UNUSED(bus);
+
+    for (uint8_t page = 0; page < SCREEN_PAGE_COUNT; page++) {
+        cursorPage = page;
+        cursorColumn = 0;
+        for (unsigned i = 0; i < SCREEN_WIDTH; i++) {
+            framebufferWrite(0x00);
+        }
+    }
+
+    cursorPage = 0;
+    cursorColumn = 0;
+}
+
 void i2c_OLED_clear_display(busDevice_t *bus)
 {
     static const uint8_t i2c_OLED_cmd_clear_display_pre[] = {
@@ -221,7 +273,9 @@ void i2c_OLED_clear_display(busDevice_t *bus)
 
     i2c_OLED_send_cmdarray(bus, i2c_OLED_cmd_clear_display_pre, ARRAYLEN(i2c_OLED_cmd_clear_display_pre));
 
+    // The display RAM content is unknown, so the whole screen is sent on the following flushes
     i2c_OLED_clear_display_quick(bus);
+    framebufferInvalidate();
 
     static const uint8_t i2c_OLED_cmd_clear_display_post[] = {
         0x81, // Setup CONTRAST CONTROL, following byte is the contrast Value... always a 2 byte instruction
@@ -234,13 +288,10 @@ void i2c_OLED_clear_display(busDevice_t *bus)
 
 void i2c_OLED_set_xy(busDevice_t *bus, uint8_t col, uint8_t row)
 {
-    uint8_t i2c_OLED_cmd_set_xy[] = {
-        0xb0 + row,                                            //set page address
-        0x00 + ((CHARACTER_WIDTH_TOTAL * col) & 0x0f),         //set low col address
-        0x10 + (((CHARACTER_WIDTH_TOTAL * col) >> 4) & 0x0f)   //set high col address
-    };
+    UNUSED(bus);
 
-    i2c_OLED_send_cmdarray(bus, i2c_OLED_cmd_set_xy, ARRAYLEN(i2c_OLED_cmd_set_xy));
+    cursorPage = row;
+    cursorColumn = CHARACTER_WIDTH_TOTAL * col;
 }
 
 void i2c_OLED_set_line(busDevice_t *bus, uint8_t row)
@@ -250,14 +301,12 @@ void i2c_OLED_set_line(busDevice_t *bus, uint8_t row)
 
 void i2c_OLED_send_char(busDevice_t *bus, unsigned char ascii)
 {
-    unsigned char i;
-    uint8_t buffer;
-    for (i = 0; i < 5; i++) {
-        buffer = multiWiiFont[ascii - 32][i];
-        buffer ^= CHAR_FORMAT;  // apply
-        i2c_OLED_send_byte(bus, buffer);
+    UNUSED(bus);
+
+    for (unsigned i = 0; i < FONT_WIDTH; i++) {
+        framebufferWrite(multiWiiFont[ascii - 32][i] ^ CHAR_FORMAT);
     }
-    i2c_OLED_send_byte(bus, CHAR_FORMAT);    // the gap
+    framebufferWrite(CHAR_FORMAT);    // the gap
 }
 
 void i2c_OLED_send_string(busDevice_t *bus, const char *string)
@@ -269,6 +318,44 @@ void i2c_OLED_send_string(busDevice_t *bus, const char *string)
     }
 }
 
+bool i2c_OLED_flush(busDevice_t *bus)
+{
+    uint8_t page = 0;
+    while (page < SCREEN_PAGE_COUNT && dirtyStart[page] >= dirtyEnd[page]) {
+        page++;
+    }
+
+    if (page == SCREEN_PAGE_COUNT) {
+        return false;
+    }
+
+    // The previous page is still being sent, the next dashboard run continues from the dirty pages
+    if (i2cBusy(bus->busdev_u.i2c.device, NULL)) {
+        return true;
+    }
+
+    const uint8_t column = dirtyStart[page];
+    const uint8_t length = MIN(dirtyEnd[page] - column, FLUSH_CHUNK_SIZE);
+
+    // The page and column address commands and the pixel data share one transaction, the first
+    // control byte is sent as the register and each command is preceded by a continuation control byte
+    flushBuffer[0] = 0xb0 + page;                   // set page address
+    flushBuffer[1] = 0x80;
+    flushBuffer[2] = 0x00 + (column & 0x0f);        // set low col address
+    flushBuffer[3] = 0x80;
+    flushBuffer[4] = 0x10 + ((column >> 4) & 0x0f); // set high col address
+    flushBuffer[5] = 0x40;                          // the remaining bytes are data
+    memcpy(&flushBuffer[FLUSH_HEADER_SIZE], &framebuffer[page][column], length);
+
+    if (!i2cWriteBuffer(bus->busdev_u.i2c.device, bus->busdev_u.i2c.address, 0x80, FLUSH_HEADER_SIZE + length, flushBuffer)) {
+        return true;
+    }
+
+    dirtyStart[page] = column + length;
+
+    return true;
+}
+
 /**
 * according to http://www.adafruit.com/datasheets/UG-2864HSWEG01.pdf Chapter 4.4 Page 15
 */
@@ -24,6 +24,7 @@
 
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
+#define SCREEN_PAGE_COUNT (SCREEN_HEIGHT / 8)
 
 #define FONT_WIDTH 5
 #define FONT_HEIGHT 7
@@ -47,3 +48,4 @@ void i2c_OLED_send_char(busDevice_t *bus, unsigned char ascii);
 void i2c_OLED_send_string(busDevice_t *bus, const char *string);
 void i2c_OLED_clear_display(busDevice_t *bus);
 void i2c_OLED_clear_display_quick(busDevice_t *bus);
+bool i2c_OLED_flush(busDevice_t *bus);
@@ -29,6 +29,7 @@
 #ifdef USE_DSHOT
 
 #include "build/atomic.h"
+#include "build/debug.h"
 
 #include "common/maths.h"
 #include "common/time.h"
@@ -42,6 +43,7 @@
 #include "drivers/dshot_command.h"
 #include "drivers/nvic.h"
 #include "drivers/pwm_output.h" // for PWM_TYPE_* and others
+#include "drivers/time.h"
 
 #include "fc/rc_controls.h" // for flight3DConfig_t
 
@@ -139,6 +141,68 @@ uint16_t getDshotTelemetry(uint8_t index)
     return dshotTelemetryState.motorState[index].telemetryValue;
 }
 
+// Decode the 12 bit value "eeem mmmm mmmm" of a GCR telemetry frame. An eRPM period is normalised
+// so the mantissa msb is set whenever the exponent is non-zero, which leaves the even codes
+// pppp = 0x2..0xe free for extended telemetry frames "pppp vvvv vvvv".
+bool dshotDecodeTelemetryValue(uint16_t value, dshotTelemetryType_e *type, uint16_t *decoded)
+{
+    if ((value & 0x0100) == 0 && (value & 0x0e00)) {
+        *type = (dshotTelemetryType_e)((value >> 9) - 1);
+        *decoded = value & 0x00ff;
+        return true;
+    }
+
+    *type = DSHOT_TELEMETRY_TYPE_ERPM;
+    if (value == 0x0fff) {
+        *decoded = 0;
+        return true;
+    }
+    // Convert value to 16 bit from the GCR telemetry format (eeem mmmm mmmm)
+    const uint32_t period = (value & 0x01ff) << ((value & 0x0e00) >> 9);
+    if (!period) {
+        return false;
+    }
+    // Convert period to erpm * 100
+    *decoded = (1000000 * 60 / 100 + period / 2) / period;
+    return true;
+}
+
+// Store a checksummed frame value for the motor, false if it doesn't decode
+FAST_CODE bool dshotUpdateTelemetryData(uint8_t motorIndex, uint16_t value)
+{
+    dshotTelemetryType_e type;
+    uint16_t decoded;
+    if (!dshotDecodeTelemetryValue(value, &type, &decoded)) {
+        return false;
+    }
+
+    dshotTelemetryMotorState_t *motorState = &dshotTelemetryState.motorState[motorIndex];
+    if (type == DSHOT_TELEMETRY_TYPE_ERPM) {
+        motorState->telemetryValue = decoded;
+        if (motorIndex < 4) {
+            DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, motorIndex, decoded);
+        }
+    } else {
+        motorState->extendedValue[type] = decoded;
+        motorState->extendedTimestampMs[type] = millis();
+    }
+    motorState->telemetryActive = true;
+
+    return true;
+}
+
+bool getDshotExtendedTelemetry(uint8_t motorIndex, dshotTelemetryType_e type, timeMs_t currentTimeMs, uint16_t *value)
+{
+    const dshotTelemetryMotorState_t *motorState = &dshotTelemetryState.motorState[motorIndex];
+    const timeMs_t timestampMs = motorState->extendedTimestampMs[type];
+    if (!timestampMs || currentTimeMs - timestampMs > DSHOT_EXTENDED_TELEMETRY_TIMEOUT_MS) {
+        return false;
+    }
+
+    *value = motorState->extendedValue[type];
+    return true;
+}
+
 #endif
 
 #ifdef USE_DSHOT_TELEMETRY_STATS
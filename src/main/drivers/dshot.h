@@ -64,9 +64,27 @@ uint16_t prepareDshotPacket(dshotProtocolControl_t *pcb);
 #ifdef USE_DSHOT_TELEMETRY
 extern bool useDshotTelemetry;
 
+// Extended telemetry frames "pppp vvvv vvvv" carry these types in place of an eRPM value
+typedef enum {
+    DSHOT_TELEMETRY_TYPE_TEMPERATURE = 0,   // degrees C
+    DSHOT_TELEMETRY_TYPE_VOLTAGE,           // 0.25V
+    DSHOT_TELEMETRY_TYPE_CURRENT,           // A
+    DSHOT_TELEMETRY_TYPE_DEBUG1,
+    DSHOT_TELEMETRY_TYPE_DEBUG2,
+    DSHOT_TELEMETRY_TYPE_STRESS_LEVEL,
+    DSHOT_TELEMETRY_TYPE_STATE_EVENTS,
+    DSHOT_TELEMETRY_TYPE_COUNT,
+    DSHOT_TELEMETRY_TYPE_ERPM = DSHOT_TELEMETRY_TYPE_COUNT  // stored as telemetryValue
+} dshotTelemetryType_e;
+
+#define DSHOT_TELEMETRY_INVALID 0xffff
+#define DSHOT_EXTENDED_TELEMETRY_TIMEOUT_MS 2000
+
 typedef struct dshotTelemetryMotorState_s {
     uint16_t telemetryValue;
     bool telemetryActive;
+    uint16_t extendedValue[DSHOT_TELEMETRY_TYPE_COUNT];
+    timeMs_t extendedTimestampMs[DSHOT_TELEMETRY_TYPE_COUNT];   // 0 until the first frame of the type
 } dshotTelemetryMotorState_t;
 
 
@@ -80,6 +98,10 @@ typedef struct dshotTelemetryState_s {
 
 extern dshotTelemetryState_t dshotTelemetryState;
 
+bool dshotDecodeTelemetryValue(uint16_t value, dshotTelemetryType_e *type, uint16_t *decoded);
+bool dshotUpdateTelemetryData(uint8_t motorIndex, uint16_t value);
+bool getDshotExtendedTelemetry(uint8_t motorIndex, dshotTelemetryType_e type, timeMs_t currentTimeMs, uint16_t *value);
+
 #ifdef USE_DSHOT_TELEMETRY_STATS
 void updateDshotTelemetryQuality(dshotTelemetryQuality_t *qualityStats, bool packetValid, timeMs_t currentTimeMs);
 #endif
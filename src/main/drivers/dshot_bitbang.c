@@ -473,17 +473,12 @@ static bool bbUpdateStart(void)
             }
             dshotTelemetryState.readCount++;
 
-            if (value != BB_INVALID) {
-                dshotTelemetryState.motorState[motorIndex].telemetryValue = value;
-                dshotTelemetryState.motorState[motorIndex].telemetryActive = true;
-                if (motorIndex < 4) {
-                    DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, motorIndex, value);
-                }
-            } else {
+            const bool validTelemetryPacket = value != BB_INVALID && dshotUpdateTelemetryData(motorIndex, value);
+            if (!validTelemetryPacket) {
                 dshotTelemetryState.invalidPacketCount++;
             }
 #ifdef USE_DSHOT_TELEMETRY_STATS
-            updateDshotTelemetryQuality(&dshotTelemetryQuality[motorIndex], value != BB_INVALID, currentTimeMs);
+            updateDshotTelemetryQuality(&dshotTelemetryQuality[motorIndex], validTelemetryPacket, currentTimeMs);
 #endif
         }
     }
@@ -53,15 +53,14 @@ typedef enum {
 
 typedef struct dshotCommandControl_s {
     dshotCommandState_e state;
-    uint32_t nextCommandCycleDelay;
+    timeUs_t nextCommandAtUs;       // no output before this time in the delay and repeat states
     timeUs_t delayAfterCommandUs;
     uint8_t repeats;
     uint8_t command[MAX_SUPPORTED_MOTORS];
+    dshotCommandCallbackFn *callback;
+    uint8_t callbackIndex;
 } dshotCommandControl_t;
 
-static timeUs_t dshotCommandPidLoopTimeUs = 125; // default to 8KHz (125us) loop to prevent possible div/0
-                                                 // gets set to the actual value when the PID loop is initialized
-
 // XXX Optimization opportunity here.
 // https://github.com/betaflight/betaflight/pull/8534#pullrequestreview-258947278
 // @ledvinap: queue entry is quite large - it may be better to handle empty/full queue using different mechanism (magic value for Head or Tail / explicit element count)
@@ -71,11 +70,6 @@ static dshotCommandControl_t commandQueue[DSHOT_MAX_COMMANDS + 1];
 static uint8_t commandQueueHead;
 static uint8_t commandQueueTail;
 
-void dshotSetPidLoopTime(uint32_t pidLoopTime)
-{
-    dshotCommandPidLoopTimeUs = pidLoopTime;
-}
-
 static FAST_CODE bool dshotCommandQueueFull()
 {
     return (commandQueueHead + 1) % (DSHOT_MAX_COMMANDS + 1) == commandQueueTail;
@@ -103,31 +97,34 @@ FAST_CODE bool dshotCommandIsProcessing(void)
     return commandIsProcessing;
 }
 
-static FAST_CODE bool dshotCommandQueueUpdate(void)
+static FAST_CODE bool dshotCommandQueueUpdate(timeUs_t currentTimeUs)
 {
     if (!dshotCommandQueueEmpty()) {
+        const dshotCommandControl_t *completedCommand = &commandQueue[commandQueueTail];
+        dshotCommandCallbackFn *callback = completedCommand->callback;
+        const uint8_t callbackIndex = completedCommand->callbackIndex;
+        const uint8_t callbackCommand = completedCommand->command[callbackIndex == ALL_MOTORS ? 0 : callbackIndex];
+
         commandQueueTail = (commandQueueTail + 1) % (DSHOT_MAX_COMMANDS + 1);
+
+        // The slot is free by now, so the callback may queue the next command
+        if (callback) {
+            callback(callbackIndex, callbackCommand);
+        }
+
         if (!dshotCommandQueueEmpty()) {
             // There is another command in the queue so update it so it's ready to output in
             // sequence. It can go directly to the DSHOT_COMMAND_STATE_ACTIVE state and bypass
             // the DSHOT_COMMAND_STATE_IDLEWAIT and DSHOT_COMMAND_STATE_STARTDELAY states.
             dshotCommandControl_t* nextCommand = &commandQueue[commandQueueTail];
             nextCommand->state = DSHOT_COMMAND_STATE_ACTIVE;
-            nextCommand->nextCommandCycleDelay = 0;
+            nextCommand->nextCommandAtUs = currentTimeUs;
             return true;
         }
     }
     return false;
 }
 
-static FAST_CODE uint32_t dshotCommandCyclesFromTime(timeUs_t delayUs)
-{
-    // Find the minimum number of motor output cycles needed to
-    // provide at least delayUs time delay
-
-    return (delayUs + dshotCommandPidLoopTimeUs - 1) / dshotCommandPidLoopTimeUs;
-}
-
 static dshotCommandControl_t* addCommand()
 {
     int newHead = (commandQueueHead + 1) % (DSHOT_MAX_COMMANDS + 1);
@@ -139,6 +136,23 @@ static dshotCommandControl_t* addCommand()
     return control;
 }
 
+// A command for other motors than an entry that has not started yet with the same timing is sent along with it
+static dshotCommandControl_t* findCommandToJoin(uint8_t index, uint8_t motorCount, uint8_t repeats, timeUs_t delayAfterCommandUs, dshotCommandCallbackFn *callback)
+{
+    if (dshotCommandQueueEmpty() || index == ALL_MOTORS || callback) {
+        return NULL;
+    }
+
+    dshotCommandControl_t* control = &commandQueue[(commandQueueHead + DSHOT_MAX_COMMANDS) % (DSHOT_MAX_COMMANDS + 1)];
+    const bool notStarted = control->state == DSHOT_COMMAND_STATE_IDLEWAIT || control->state == DSHOT_COMMAND_STATE_STARTDELAY;
+    if (!notStarted || control->callback || control->repeats != repeats || control->delayAfterCommandUs != delayAfterCommandUs
+        || index >= motorCount || control->command[index] != DSHOT_CMD_MOTOR_STOP) {
+        return NULL;
+    }
+
+    return control;
+}
+
 static bool allMotorsAreIdle(void)
 {
     for (unsigned i = 0; i < dshotPwmDevice.count; i++) {
@@ -165,10 +179,10 @@ bool dshotCommandsAreEnabled(dshotCommandType_e commandType)
     return ret;
 }
 
-void dshotCommandWrite(uint8_t index, uint8_t motorCount, uint8_t command, dshotCommandType_e commandType)
+bool dshotCommandWriteWithCallback(uint8_t index, uint8_t motorCount, uint8_t command, dshotCommandType_e commandType, dshotCommandCallbackFn *callback)
 {
-    if (!isMotorProtocolDshot() || !dshotCommandsAreEnabled(commandType) || (command > DSHOT_MAX_COMMAND) || dshotCommandQueueFull()) {
-        return;
+    if (!isMotorProtocolDshot() || !dshotCommandsAreEnabled(commandType) || (command > DSHOT_MAX_COMMAND)) {
+        return false;
     }
 
     uint8_t repeats = 1;
@@ -180,6 +194,8 @@ void dshotCommandWrite(uint8_t index, uint8_t motorCount, uint8_t command, dshot
     case DSHOT_CMD_3D_MODE_OFF:
     case DSHOT_CMD_3D_MODE_ON:
     case DSHOT_CMD_SAVE_SETTINGS:
+    case DSHOT_CMD_EXTENDED_TELEMETRY_ENABLE:
+    case DSHOT_CMD_EXTENDED_TELEMETRY_DISABLE:
     case DSHOT_CMD_SPIN_DIRECTION_NORMAL:
     case DSHOT_CMD_SPIN_DIRECTION_REVERSED:
     case DSHOT_CMD_SIGNAL_LINE_TELEMETRY_DISABLE:
@@ -193,53 +209,50 @@ void dshotCommandWrite(uint8_t index, uint8_t motorCount, uint8_t command, dshot
     case DSHOT_CMD_BEACON5:
         delayAfterCommandUs = DSHOT_BEEP_DELAY_US;
         break;
+    case DSHOT_CMD_ESC_INFO:
+        delayAfterCommandUs = DSHOT_ESCINFO_DELAY_US;
+        break;
     default:
         break;
     }
 
-    if (commandType == DSHOT_CMD_TYPE_BLOCKING) {
-        delayMicroseconds(DSHOT_INITIAL_DELAY_US - DSHOT_COMMAND_DELAY_US);
-        for (; repeats; repeats--) {
-            delayMicroseconds(DSHOT_COMMAND_DELAY_US);
-
-#ifdef USE_DSHOT_TELEMETRY
-            timeUs_t timeoutUs = micros() + 1000;
-            while (!pwmStartDshotMotorUpdate() &&
-                   cmpTimeUs(timeoutUs, micros()) > 0);
-#endif
-            for (uint8_t i = 0; i < dshotPwmDevice.count; i++) {
-                if ((i == index) || (index == ALL_MOTORS)) {
-                    motorDmaOutput_t *const motor = getMotorDmaOutput(i);
-                    motor->protocolControl.requestTelemetry = true;
-                    dshotPwmDevice.vTable.writeInt(i, command);
-                }
-            }
-
-            dshotPwmDevice.vTable.updateComplete();
-        }
-        delayMicroseconds(delayAfterCommandUs);
-    } else if (commandType == DSHOT_CMD_TYPE_INLINE) {
-        dshotCommandControl_t *commandControl = addCommand();
-        if (commandControl) {
-            commandControl->repeats = repeats;
-            commandControl->delayAfterCommandUs = delayAfterCommandUs;
-            for (unsigned i = 0; i < motorCount; i++) {
-                if (index == i || index == ALL_MOTORS) {
-                    commandControl->command[i] = command;
-                } else {
-                    commandControl->command[i] = DSHOT_CMD_MOTOR_STOP;
-                }
-            }
-            if (allMotorsAreIdle()) {
-                // we can skip the motors idle wait state
-                commandControl->state = DSHOT_COMMAND_STATE_STARTDELAY;
-                commandControl->nextCommandCycleDelay = dshotCommandCyclesFromTime(DSHOT_INITIAL_DELAY_US);
-            } else {
-                commandControl->state = DSHOT_COMMAND_STATE_IDLEWAIT;
-                commandControl->nextCommandCycleDelay = 0;  // will be set after idle wait completes
-            }
+    dshotCommandControl_t *commandControl = findCommandToJoin(index, motorCount, repeats, delayAfterCommandUs, callback);
+    if (commandControl) {
+        commandControl->command[index] = command;
+        return true;
+    }
+
+    if (dshotCommandQueueFull()) {
+        return false;
+    }
+
+    commandControl = addCommand();
+    commandControl->repeats = repeats;
+    commandControl->delayAfterCommandUs = delayAfterCommandUs;
+    commandControl->callback = callback;
+    commandControl->callbackIndex = index;
+    for (unsigned i = 0; i < motorCount; i++) {
+        if (index == i || index == ALL_MOTORS) {
+            commandControl->command[i] = command;
+        } else {
+            commandControl->command[i] = DSHOT_CMD_MOTOR_STOP;
         }
     }
+    if (commandType == DSHOT_CMD_TYPE_BLOCKING || allMotorsAreIdle()) {
+        // we can skip the motors idle wait state, disabled motors are not spinning
+        commandControl->state = DSHOT_COMMAND_STATE_STARTDELAY;
+        commandControl->nextCommandAtUs = micros() + DSHOT_INITIAL_DELAY_US;
+    } else {
+        commandControl->state = DSHOT_COMMAND_STATE_IDLEWAIT;
+        commandControl->nextCommandAtUs = 0;  // will be set after idle wait completes
+    }
+
+    return true;
+}
+
+void dshotCommandWrite(uint8_t index, uint8_t motorCount, uint8_t command, dshotCommandType_e commandType)
+{
+    dshotCommandWriteWithCallback(index, motorCount, command, commandType, NULL);
 }
 
 uint8_t dshotCommandGetCurrent(uint8_t index)
@@ -248,58 +261,51 @@ uint8_t dshotCommandGetCurrent(uint8_t index)
 }
 
 // This function is used to synchronize the dshot command output timing with
-// the normal motor output timing tied to the PID loop frequency. A "true" result
-// allows the motor output to be sent, "false" means delay until next loop. So take
-// the example of a dshot command that needs to repeat 10 times at 1ms intervals.
-// If we have a 8KHz PID loop we'll end up sending the dshot command every 8th motor output.
+// the normal motor output timing. A "true" result allows the motor output to be
+// sent, "false" means delay until next loop. So take the example of a dshot command
+// that needs to repeat 10 times at 1ms intervals. If we have a 8KHz PID loop we'll
+// end up sending the dshot command on the first motor output at least 1ms after the
+// previous one, so every 8th motor output.
 FAST_CODE_NOINLINE bool dshotCommandOutputIsEnabled(uint8_t motorCount)
 {
     UNUSED(motorCount);
 
+    const timeUs_t currentTimeUs = micros();
     dshotCommandControl_t* command = &commandQueue[commandQueueTail];
     switch (command->state) {
     case DSHOT_COMMAND_STATE_IDLEWAIT:
         if (allMotorsAreIdle()) {
             command->state = DSHOT_COMMAND_STATE_STARTDELAY;
-            command->nextCommandCycleDelay = dshotCommandCyclesFromTime(DSHOT_INITIAL_DELAY_US);
+            command->nextCommandAtUs = currentTimeUs + DSHOT_INITIAL_DELAY_US;
         }
         break;
 
     case DSHOT_COMMAND_STATE_STARTDELAY:
-        if (command->nextCommandCycleDelay) {
-            --command->nextCommandCycleDelay;
+        if (cmpTimeUs(command->nextCommandAtUs, currentTimeUs) > 0) {
             return false;  // Delay motor output until the start of the command seequence
         }
         command->state = DSHOT_COMMAND_STATE_ACTIVE;
-        command->nextCommandCycleDelay = 0;  // first iteration of the repeat happens now
         FALLTHROUGH;
 
     case DSHOT_COMMAND_STATE_ACTIVE:
-        if (command->nextCommandCycleDelay) {
-            --command->nextCommandCycleDelay;
+        if (cmpTimeUs(command->nextCommandAtUs, currentTimeUs) > 0) {
             return false;  // Delay motor output until the next command repeat
         }
 
         command->repeats--;
         if (command->repeats) {
-            command->nextCommandCycleDelay = dshotCommandCyclesFromTime(DSHOT_COMMAND_DELAY_US);
+            command->nextCommandAtUs = currentTimeUs + DSHOT_COMMAND_DELAY_US;
         } else {
             command->state = DSHOT_COMMAND_STATE_POSTDELAY;
-            command->nextCommandCycleDelay = dshotCommandCyclesFromTime(command->delayAfterCommandUs);
-            if (!isLastDshotCommand() && command->nextCommandCycleDelay > 0) {
-                // Account for the 1 extra motor output loop between commands.
-                // Otherwise the inter-command delay will be DSHOT_COMMAND_DELAY_US + 1 loop.
-                command->nextCommandCycleDelay--;
-            }
+            command->nextCommandAtUs = currentTimeUs + command->delayAfterCommandUs;
         }
         break;
 
     case DSHOT_COMMAND_STATE_POSTDELAY:
-        if (command->nextCommandCycleDelay) {
-            --command->nextCommandCycleDelay;
+        if (cmpTimeUs(command->nextCommandAtUs, currentTimeUs) > 0) {
             return false;  // Delay motor output until the end of the post-command delay
         }
-        if (dshotCommandQueueUpdate()) {
+        if (dshotCommandQueueUpdate(currentTimeUs)) {
             // Will be true if the command queue is not empty and we
             // want to wait for the next command to start in sequence.
             return false;
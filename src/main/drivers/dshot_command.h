@@ -45,6 +45,8 @@ typedef enum {
     DSHOT_CMD_3D_MODE_ON,
     DSHOT_CMD_SETTINGS_REQUEST, // Currently not implemented
     DSHOT_CMD_SAVE_SETTINGS,
+    DSHOT_CMD_EXTENDED_TELEMETRY_ENABLE,
+    DSHOT_CMD_EXTENDED_TELEMETRY_DISABLE,
     DSHOT_CMD_SPIN_DIRECTION_NORMAL = 20,
     DSHOT_CMD_SPIN_DIRECTION_REVERSED = 21,
     DSHOT_CMD_LED0_ON, // BLHeli32 only
@@ -64,11 +66,14 @@ typedef enum {
 
 typedef enum {
     DSHOT_CMD_TYPE_INLINE = 0,    // dshot commands sent inline with motor signal (motors must be enabled)
-    DSHOT_CMD_TYPE_BLOCKING       // dshot commands sent in blocking method (motors must be disabled)
+    DSHOT_CMD_TYPE_BLOCKING       // dshot commands sent while the motors are disabled (motors must be disabled)
 } dshotCommandType_e;
 
+// Called from the motor update once the command and the delay after it have completed
+typedef void dshotCommandCallbackFn(uint8_t index, uint8_t command);
+
 void dshotCommandWrite(uint8_t index, uint8_t motorCount, uint8_t command, dshotCommandType_e commandType);
-void dshotSetPidLoopTime(uint32_t pidLoopTime);
+bool dshotCommandWriteWithCallback(uint8_t index, uint8_t motorCount, uint8_t command, dshotCommandType_e commandType, dshotCommandCallbackFn *callback);
 bool dshotCommandQueueEmpty(void);
 bool dshotCommandIsProcessing(void);
 uint8_t dshotCommandGetCurrent(uint8_t index);
@@ -223,6 +223,24 @@ static uint8_t  vosRegValue; // VOS (Vertical offset register) value
 
 static bool fontIsLoading       = false;
 
+// Characters are queued by max7456WriteNvm() and written from the OSD task, each character
+// goes to the character memory in one transfer and then the NVM busy state is polled
+// once per OSD pass instead of waiting the ~12ms of the NVM write.
+typedef struct max7456FontUpload_s {
+    uint8_t address[MAX7456_FONT_UPLOAD_QUEUE_SIZE];
+    uint8_t data[MAX7456_FONT_UPLOAD_QUEUE_SIZE][NVM_RAM_SIZE];
+    uint8_t head;               // character being written or next to write
+    uint8_t count;              // characters in the queue, including the one being written
+    bool nvmBusy;               // the character at head is being copied to the NVM
+    uint16_t charsWritten;
+} max7456FontUpload_t;
+
+static max7456FontUpload_t fontUpload;
+
+// The health checks read a register, they wait for the screen to be idle unless overdue.
+#define MAX7456_CHECK_OVERDUE_FACTOR    2
+static uint16_t unchangedChars  = 0; // characters found equal to the shadow buffer since the last change
+
 static uint8_t max7456DeviceType;
 
 // previous states initialized outside the valid range to force update on first call
@@ -374,6 +392,7 @@ uint8_t max7456GetRowsCount(void)
 static void max7456ClearShadowBuffer(void)
 {
     memset(shadowBuffer, 0, maxScreenSize);
+    unchangedChars = 0;
 }
 
 // Buffer is filled with the whitespace character (0x20)
@@ -676,6 +695,19 @@ bool max7456BuffersSynced(void)
     return true;
 }
 
+static bool max7456ScreenIdle(void)
+{
+    return unchangedChars >= maxScreenSize && !max7456DmaInProgress();
+}
+
+static bool max7456CheckDue(timeMs_t nowMs, timeMs_t lastCheckMs, timeMs_t intervalMs, bool idle)
+{
+    return (lastCheckMs + intervalMs < nowMs)
+        && (idle || lastCheckMs + MAX7456_CHECK_OVERDUE_FACTOR * intervalMs < nowMs);
+}
+
+// Outside of a forced check at most one register is read per call, preferably
+// when there is nothing to draw.
 void max7456ReInitIfRequired(bool forceStallCheck)
 {
     static timeMs_t lastSigCheckMs = 0;
@@ -684,19 +716,25 @@ void max7456ReInitIfRequired(bool forceStallCheck)
     static timeMs_t lastStallCheckMs = MAX7456_STALL_CHECK_INTERVAL_MS / 2; // offset so that it doesn't coincide with the signal check
 
     const timeMs_t nowMs = millis();
+    const bool idle = forceStallCheck || max7456ScreenIdle();
 
-    bool stalled = false;
-    if (forceStallCheck || (lastStallCheckMs + MAX7456_STALL_CHECK_INTERVAL_MS < nowMs)) {
+    if (forceStallCheck || max7456CheckDue(nowMs, lastStallCheckMs, MAX7456_STALL_CHECK_INTERVAL_MS, idle)) {
         lastStallCheckMs = nowMs;
         __spiBusTransactionBegin(busdev);
-        stalled = (max7456Send(MAX7456ADD_VM0|MAX7456ADD_READ, 0x00) != videoSignalReg);
+        const bool stalled = (max7456Send(MAX7456ADD_VM0|MAX7456ADD_READ, 0x00) != videoSignalReg);
         __spiBusTransactionEnd(busdev);
+
+        if (stalled) {
+            max7456ReInit();
+            return;
+        }
+        if (!forceStallCheck) {
+            return;
+        }
     }
 
-    if (stalled) {
-        max7456ReInit();
-    } else if ((videoSignalCfg == VIDEO_SYSTEM_AUTO)
-              && ((nowMs - lastSigCheckMs) > MAX7456_SIGNAL_CHECK_INTERVAL_MS)) {
+    if ((videoSignalCfg == VIDEO_SYSTEM_AUTO)
+        && max7456CheckDue(nowMs, lastSigCheckMs, MAX7456_SIGNAL_CHECK_INTERVAL_MS, idle)) {
 
         // Adjust output format based on the current input format.
 
@@ -735,7 +773,9 @@ void max7456DrawScreen(void)
 {
     static uint16_t pos = 0;
 
-    if (!fontIsLoading) {
+    if (fontIsLoading) {
+        max7456FontUploadProcess();
+    } else {
 
         // (Re)Initialize MAX7456 at startup or stall is detected.
 
@@ -753,6 +793,9 @@ void max7456DrawScreen(void)
                 spiBuff[buff_len++] = MAX7456ADD_DMDI;
                 spiBuff[buff_len++] = buffer[pos];
                 shadowBuffer[pos] = buffer[pos];
+                unchangedChars = 0;
+            } else if (unchangedChars < maxScreenSize) {
+                unchangedChars++;
             }
 
             if (++pos >= maxScreenSize) {
@@ -818,6 +861,11 @@ static void max7456DrawScreenSlow(void)
 // should not be used when armed
 void max7456RefreshAll(void)
 {
+    if (fontIsLoading) {
+        // the display is re-initialised when the font upload is done
+        return;
+    }
+
 #ifdef MAX7456_DMA_CHANNEL_TX
     while (dmaTransactionInProgress);
 #endif
@@ -826,44 +874,113 @@ void max7456RefreshAll(void)
     max7456DrawScreenSlow();
 }
 
-bool max7456WriteNvm(uint8_t char_address, const uint8_t *font_data)
+static void max7456FontUploadWriteChar(void)
 {
-    if (!max7456DeviceDetected) {
-        return false;
+    const uint8_t *fontData = fontUpload.data[fontUpload.head];
+    int len = 0;
+
+    // disable display
+    spiBuff[len++] = MAX7456ADD_VM0;
+    spiBuff[len++] = 0;
+
+    spiBuff[len++] = MAX7456ADD_CMAH; // set start address high
+    spiBuff[len++] = fontUpload.address[fontUpload.head];
+
+    for (int x = 0; x < NVM_RAM_SIZE; x++) {
+        spiBuff[len++] = MAX7456ADD_CMAL; //set start address low
+        spiBuff[len++] = x;
+        spiBuff[len++] = MAX7456ADD_CMDI;
+        spiBuff[len++] = fontData[x];
     }
-#ifdef MAX7456_DMA_CHANNEL_TX
-    while (dmaTransactionInProgress);
-#endif
 
+    // Transfer 54 bytes from shadow ram to NVM
+    spiBuff[len++] = MAX7456ADD_CMM;
+    spiBuff[len++] = WRITE_NVR;
+
+#ifdef MAX7456_DMA_CHANNEL_TX
+    max7456SendDma(spiBuff, NULL, len);
+#else
     __spiBusTransactionBegin(busdev);
-    // disable display
-    fontIsLoading = true;
-    max7456Send(MAX7456ADD_VM0, 0);
+    spiTransfer(busdev->busdev_u.spi.instance, spiBuff, NULL, len);
+    __spiBusTransactionEnd(busdev);
+#endif
 
-    max7456Send(MAX7456ADD_CMAH, char_address); // set start address high
+    fontUpload.nvmBusy = true;
 
-    for (int x = 0; x < 54; x++) {
-        max7456Send(MAX7456ADD_CMAL, x); //set start address low
-        max7456Send(MAX7456ADD_CMDI, font_data[x]);
 #ifdef LED0_TOGGLE
-        LED0_TOGGLE;
+    LED0_TOGGLE;
 #else
-        LED1_TOGGLE;
+    LED1_TOGGLE;
 #endif
+}
+
+// Advances the font upload without waiting. Called from the OSD task while the font is loading,
+// and when the upload progress is read, so that it also finishes with the OSD task off.
+void max7456FontUploadProcess(void)
+{
+    if (max7456DmaInProgress()) {
+        return;
     }
 
-    // Transfer 54 bytes from shadow ram to NVM
+    if (fontUpload.nvmBusy) {
+        // Bit 5 in the status register returns to 0 when the NVM write is done (12ms)
+        __spiBusTransactionBegin(busdev);
+        const uint8_t stat = max7456Send(MAX7456ADD_STAT, 0x00);
+        __spiBusTransactionEnd(busdev);
 
-    max7456Send(MAX7456ADD_CMM, WRITE_NVR);
+        if (stat & STAT_NVR_BUSY) {
+            return;
+        }
 
-    // Wait until bit 5 in the status register returns to 0 (12ms)
+        fontUpload.nvmBusy = false;
+        fontUpload.head = (fontUpload.head + 1) % MAX7456_FONT_UPLOAD_QUEUE_SIZE;
+        fontUpload.count--;
+        fontUpload.charsWritten++;
+    }
 
-    while ((max7456Send(MAX7456ADD_STAT, 0x00) & STAT_NVR_BUSY) != 0x00);
+    if (fontUpload.count) {
+        max7456FontUploadWriteChar();
+    } else if (fontIsLoading) {
+        // Re-enable the display with the new font
+        fontIsLoading = false;
+        max7456ReInit();
+    }
+}
+
+// Queues the character and returns, the NVM write is finished in the background.
+// Only when the queue is full this waits for the oldest character to be written.
+bool max7456WriteNvm(uint8_t char_address, const uint8_t *font_data)
+{
+    if (!max7456DeviceDetected) {
+        return false;
+    }
+
+    while (fontUpload.count == MAX7456_FONT_UPLOAD_QUEUE_SIZE) {
+        max7456FontUploadProcess();
+    }
+
+    const uint8_t index = (fontUpload.head + fontUpload.count) % MAX7456_FONT_UPLOAD_QUEUE_SIZE;
+    fontUpload.address[index] = char_address;
+    memcpy(fontUpload.data[index], font_data, NVM_RAM_SIZE);
+    fontUpload.count++;
+    fontIsLoading = true;
+
+    // start the transfer right away when the NVM is idle
+    max7456FontUploadProcess();
 
-    __spiBusTransactionEnd(busdev);
     return true;
 }
 
+uint8_t max7456FontUploadPending(void)
+{
+    return fontUpload.count;
+}
+
+uint16_t max7456FontUploadCharsWritten(void)
+{
+    return fontUpload.charsWritten;
+}
+
 #ifdef MAX7456_NRST_PIN
 static IO_t max7456ResetPin        = IO_NONE;
 #endif
@@ -30,6 +30,8 @@
 #define VIDEO_LINES_NTSC          13
 #define VIDEO_LINES_PAL           16
 
+#define MAX7456_FONT_UPLOAD_QUEUE_SIZE  4 // characters waiting for the NVM write
+
 typedef enum {
     // IO defined and MAX7456 was detected
     MAX7456_INIT_OK = 0,
@@ -51,6 +53,9 @@ void    max7456Invert(bool invert);
 void    max7456Brightness(uint8_t black, uint8_t white);
 void    max7456DrawScreen(void);
 bool    max7456WriteNvm(uint8_t char_address, const uint8_t *font_data);
+void    max7456FontUploadProcess(void);
+uint8_t max7456FontUploadPending(void);
+uint16_t max7456FontUploadCharsWritten(void);
 uint8_t max7456GetRowsCount(void);
 void    max7456Write(uint8_t x, uint8_t y, const char *buff);
 void    max7456WriteChar(uint8_t x, uint8_t y, uint8_t c);
@@ -36,6 +36,7 @@
 #include "drivers/pwm_output.h" // for PWM_TYPE_* and others
 #include "drivers/time.h"
 #include "drivers/dshot_bitbang.h"
+#include "drivers/dshot_command.h"
 #include "drivers/dshot_dpwm.h"
 
 #include "fc/rc_controls.h" // for flight3DConfig_t
@@ -70,6 +71,20 @@ void motorWriteAll(float *values)
         }
         motorDevice->vTable.updateComplete();
     }
+#ifdef USE_DSHOT
+    else if (motorProtocolDshot && !dshotCommandQueueEmpty()) {
+        // Commands queued while the motors are disabled, the driver substitutes them for the stop value
+#if defined(USE_DSHOT_TELEMETRY)
+        if (!motorDevice->vTable.updateStart()) {
+            return;
+        }
+#endif
+        for (int i = 0; i < motorDevice->count; i++) {
+            motorDevice->vTable.writeInt(i, DSHOT_CMD_MOTOR_STOP);
+        }
+        motorDevice->vTable.updateComplete();
+    }
+#endif
 #endif
 }
 
@@ -32,6 +32,9 @@ typedef enum {
     PERSISTENT_OBJECT_RESET_REASON,
     PERSISTENT_OBJECT_RTC_HIGH,           // high 32 bits of rtcTime_t
     PERSISTENT_OBJECT_RTC_LOW,            // low 32 bits of rtcTime_t
+    PERSISTENT_OBJECT_SCHEDULER_PROFILE,  // scheduler timing profile, 3 words
+    PERSISTENT_OBJECT_SCHEDULER_PROFILE_END = PERSISTENT_OBJECT_SCHEDULER_PROFILE + 2,
+    PERSISTENT_OBJECT_SCHEDULER_PROFILE_CHECK, // magic and checksum of the scheduler timing profile
     PERSISTENT_OBJECT_COUNT,
 } persistentObjectId_e;
 
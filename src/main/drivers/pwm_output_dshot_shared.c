@@ -160,7 +160,7 @@ static uint32_t decodeTelemetryPacket(uint32_t buffer[], uint32_t count)
         bits += len;
     }
     if (bits != 21) {
-        return 0xffff;
+        return DSHOT_TELEMETRY_INVALID;
     }
 
     static const uint32_t decode[32] = {
@@ -177,19 +177,10 @@ static uint32_t decodeTelemetryPacket(uint32_t buffer[], uint32_t count)
     csum = csum ^ (csum >> 4); // xor nibbles
 
     if ((csum & 0xf) != 0xf) {
-        return 0xffff;
+        return DSHOT_TELEMETRY_INVALID;
     }
-    decodedValue >>= 4;
-
-    if (decodedValue == 0x0fff) {
-        return 0;
-    }
-    decodedValue = (decodedValue & 0x000001ff) << ((decodedValue & 0xfffffe00) >> 9);
-    if (!decodedValue) {
-        return 0xffff;
-    }
-    uint32_t ret = (1000000 * 60 / 100 + decodedValue / 2) / decodedValue;
-    return ret;
+    // eRPM period or extended telemetry, decoded by dshotUpdateTelemetryData()
+    return decodedValue >> 4;
 }
 
 #endif
@@ -231,12 +222,7 @@ FAST_CODE_NOINLINE bool pwmStartDshotMotorUpdate(void)
 #ifdef USE_DSHOT_TELEMETRY_STATS
                 bool validTelemetryPacket = false;
 #endif
-                if (value != 0xffff) {
-                    dshotTelemetryState.motorState[i].telemetryValue = value;
-                    dshotTelemetryState.motorState[i].telemetryActive = true;
-                    if (i < 4) {
-                        DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, i, value);
-                    }
+                if (value != DSHOT_TELEMETRY_INVALID && dshotUpdateTelemetryData(i, value)) {
 #ifdef USE_DSHOT_TELEMETRY_STATS
                     validTelemetryPacket = true;
 #endif
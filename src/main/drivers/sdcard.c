@@ -141,6 +141,11 @@ bool sdcard_readBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_operationComp
     return sdcardVTable->sdcard_readBlock(blockIndex, buffer, callback, callbackData);
 }
 
+bool sdcard_readBlocks(uint32_t blockIndex, uint8_t *buffer, uint16_t blockCount, sdcard_operationCompleteCallback_c callback, uint32_t callbackData)
+{
+    return sdcardVTable->sdcard_readBlocks(blockIndex, buffer, blockCount, callback, callbackData);
+}
+
 sdcardOperationStatus_e sdcard_beginWriteBlocks(uint32_t blockIndex, uint32_t blockCount)
 {
     return sdcardVTable->sdcard_beginWriteBlocks(blockIndex, blockCount);
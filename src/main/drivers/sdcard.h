@@ -61,6 +61,7 @@ void sdcard_preInit(const sdcardConfig_t *config);
 void sdcard_init(const sdcardConfig_t *config);
 
 bool sdcard_readBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_operationCompleteCallback_c callback, uint32_t callbackData);
+bool sdcard_readBlocks(uint32_t blockIndex, uint8_t *buffer, uint16_t blockCount, sdcard_operationCompleteCallback_c callback, uint32_t callbackData);
 
 sdcardOperationStatus_e sdcard_beginWriteBlocks(uint32_t blockIndex, uint32_t blockCount);
 sdcardOperationStatus_e sdcard_writeBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_operationCompleteCallback_c callback, uint32_t callbackData);
@@ -58,6 +58,8 @@ typedef struct sdcard_t {
         uint8_t *buffer;
         uint32_t blockIndex;
         uint8_t chunkIndex;
+        uint16_t blockCount;        // number of blocks requested by a read
+        uint16_t blocksTransferred; // number of blocks of that read received so far
 
         sdcard_operationCompleteCallback_c callback;
         uint32_t callbackData;
@@ -113,6 +115,7 @@ typedef struct sdcardVTable_s {
     void (*sdcard_preInit)(const sdcardConfig_t *config);
     void (*sdcard_init)(const sdcardConfig_t *config, const spiPinConfig_t *spiConfig);
     bool (*sdcard_readBlock)(uint32_t blockIndex, uint8_t *buffer, sdcard_operationCompleteCallback_c callback, uint32_t callbackData);
+    bool (*sdcard_readBlocks)(uint32_t blockIndex, uint8_t *buffer, uint16_t blockCount, sdcard_operationCompleteCallback_c callback, uint32_t callbackData);
     sdcardOperationStatus_e (*sdcard_beginWriteBlocks)(uint32_t blockIndex, uint32_t blockCount);
     sdcardOperationStatus_e (*sdcard_writeBlock)(uint32_t blockIndex, uint8_t *buffer, sdcard_operationCompleteCallback_c callback, uint32_t callbackData);
     bool (*sdcard_poll)(void);
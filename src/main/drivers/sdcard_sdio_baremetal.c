@@ -572,10 +572,11 @@ static sdcardOperationStatus_e sdcardSdio_beginWriteBlocks(uint32_t blockIndex,
 }
 
 /**
- * Read the 512-byte block with the given index into the given 512-byte buffer.
+ * Read blockCount consecutive 512-byte blocks starting at the given index into the given buffer, which must be
+ * blockCount * 512 bytes long. The whole range is fetched by a single DMA transfer (CMD18 for more than one block).
  *
- * When the read completes, your callback will be called. If the read was successful, the buffer pointer will be the
- * same buffer you originally passed in, otherwise the buffer will be set to NULL.
+ * When the read completes, your callback will be called once for the whole transfer. If the read was successful, the
+ * buffer pointer will be the same buffer you originally passed in, otherwise the buffer will be set to NULL.
  *
  * You must keep the pointer to the buffer valid until the operation completes!
  *
@@ -583,8 +584,12 @@ static sdcardOperationStatus_e sdcardSdio_beginWriteBlocks(uint32_t blockIndex,
  *     true - The operation was successfully queued for later completion, your callback will be called later
  *     false - The operation could not be started due to the card being busy (try again later).
  */
-static bool sdcardSdio_readBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_operationCompleteCallback_c callback, uint32_t callbackData)
+static bool sdcardSdio_readBlocks(uint32_t blockIndex, uint8_t *buffer, uint16_t blockCount, sdcard_operationCompleteCallback_c callback, uint32_t callbackData)
 {
+    if (blockCount == 0) {
+        return false;
+    }
+
     if (sdcard.state != SDCARD_STATE_READY) {
 		if (sdcard.state == SDCARD_STATE_WRITING_MULTIPLE_BLOCKS) {
 			if (sdcard_endWriteBlocks() != SDCARD_OPERATION_SUCCESS) {
@@ -600,11 +605,13 @@ static bool sdcardSdio_readBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_op
 #endif
 
     // Standard size cards use byte addressing, high capacity cards use block addressing
-    uint8_t status = SD_ReadBlocks_DMA(blockIndex, (uint32_t*) buffer, 512, 1);
+    uint8_t status = SD_ReadBlocks_DMA(blockIndex, (uint32_t*) buffer, 512, blockCount);
 
     if (status == SD_OK) {
         sdcard.pendingOperation.buffer = buffer;
         sdcard.pendingOperation.blockIndex = blockIndex;
+        sdcard.pendingOperation.blockCount = blockCount;
+        sdcard.pendingOperation.blocksTransferred = 0;
         sdcard.pendingOperation.callback = callback;
         sdcard.pendingOperation.callbackData = callbackData;
 
@@ -627,6 +634,17 @@ static bool sdcardSdio_readBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_op
     }
 }
 
+/**
+ * Read the 512-byte block with the given index into the given 512-byte buffer.
+ *
+ * When the read completes, your callback will be called. If the read was successful, the buffer pointer will be the
+ * same buffer you originally passed in, otherwise the buffer will be set to NULL.
+ */
+static bool sdcardSdio_readBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_operationCompleteCallback_c callback, uint32_t callbackData)
+{
+    return sdcardSdio_readBlocks(blockIndex, buffer, 1, callback, callbackData);
+}
+
 /**
  * Returns true if the SD card has successfully completed its startup procedures.
  */
@@ -653,6 +671,7 @@ sdcardVTable_t sdcardSdioVTable = {
     NULL,
     sdcardSdio_init,
     sdcardSdio_readBlock,
+    sdcardSdio_readBlocks,
     sdcardSdio_beginWriteBlocks,
     sdcardSdio_writeBlock,
     sdcardSdio_poll,
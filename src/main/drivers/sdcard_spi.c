@@ -46,6 +46,8 @@
 
 #define SDCARD_INIT_NUM_DUMMY_BYTES                 10
 #define SDCARD_MAXIMUM_BYTE_DELAY_FOR_CMD_REPLY     8
+// The card may signal busy for a little while after stopping a multi-block read
+#define SDCARD_MAXIMUM_BYTE_DELAY_FOR_READ_STOP     64
 // Chosen so that CMD8 will have the same CRC as CMD0:
 #define SDCARD_IF_COND_CHECK_PATTERN                0xAB
 
@@ -591,6 +593,33 @@ static bool sdcard_isReady(void)
     return sdcard.state == SDCARD_STATE_READY || sdcard.state == SDCARD_STATE_WRITING_MULTIPLE_BLOCKS;
 }
 
+/**
+ * Send CMD12 to terminate a multi-block read once the last requested block has been received.
+ *
+ * The card is still streaming data when the command goes out, so unlike sdcard_sendCommand() we don't wait for the bus
+ * to go idle first. Returns true if the card acknowledged the stop and released its busy signal.
+ */
+static bool sdcard_stopMultipleBlockRead(void)
+{
+    const uint8_t command[6] = {
+        0x40 | SDCARD_COMMAND_STOP_TRANSMISSION,
+        0, 0, 0, 0,
+        0x01 // CRC is ignored in SPI mode, but the end bit must be set
+    };
+
+    spiBusRawTransfer(&sdcard.busdev, command, NULL, sizeof(command));
+
+    // Discard the stuff byte that follows CMD12
+    spiBusTransferByte(&sdcard.busdev, 0xFF);
+
+    if (sdcard_waitForNonIdleByte(SDCARD_MAXIMUM_BYTE_DELAY_FOR_CMD_REPLY) != 0) {
+        return false;
+    }
+
+    // R1b response, the card holds the line low until it is ready again
+    return sdcard_waitForIdle(SDCARD_MAXIMUM_BYTE_DELAY_FOR_READ_STOP);
+}
+
 /**
  * Send the stop-transmission token to complete a multi-block write.
  *
@@ -851,8 +880,33 @@ static bool sdcardSpi_poll(void)
             }
         break;
         case SDCARD_STATE_READING:
-            switch (sdcard_receiveDataBlock(sdcard.pendingOperation.buffer, SDCARD_BLOCK_SIZE)) {
+            switch (sdcard_receiveDataBlock(sdcard.pendingOperation.buffer + SDCARD_BLOCK_SIZE * sdcard.pendingOperation.blocksTransferred, SDCARD_BLOCK_SIZE)) {
                 case SDCARD_RECEIVE_SUCCESS:
+                    sdcard.pendingOperation.blocksTransferred++;
+
+                    if (sdcard.pendingOperation.blocksTransferred < sdcard.pendingOperation.blockCount) {
+                        // The card streams the following block of a multi-block read without another command
+                        sdcard.operationStartTime = millis();
+                        break;
+                    }
+
+                    if (sdcard.pendingOperation.blockCount > 1 && !sdcard_stopMultipleBlockRead()) {
+                        sdcard_deselect();
+
+                        sdcard_reset();
+
+                        if (sdcard.pendingOperation.callback) {
+                            sdcard.pendingOperation.callback(
+                                SDCARD_BLOCK_OPERATION_READ,
+                                sdcard.pendingOperation.blockIndex,
+                                NULL,
+                                sdcard.pendingOperation.callbackData
+                            );
+                        }
+
+                        goto doMore;
+                    }
+
                     sdcard_deselect();
 
                     sdcard.state = SDCARD_STATE_READY;
@@ -1046,10 +1100,12 @@ static sdcardOperationStatus_e sdcardSpi_beginWriteBlocks(uint32_t blockIndex, u
 }
 
 /**
- * Read the 512-byte block with the given index into the given 512-byte buffer.
+ * Read blockCount consecutive 512-byte blocks starting at the given index into the given buffer, which must be
+ * blockCount * 512 bytes long. A single block is fetched with CMD17, anything longer is streamed with CMD18 and
+ * terminated with CMD12 once the last block has arrived.
  *
- * When the read completes, your callback will be called. If the read was successful, the buffer pointer will be the
- * same buffer you originally passed in, otherwise the buffer will be set to NULL.
+ * When the read completes, your callback will be called once for the whole transfer. If the read was successful, the
+ * buffer pointer will be the same buffer you originally passed in, otherwise the buffer will be set to NULL.
  *
  * You must keep the pointer to the buffer valid until the operation completes!
  *
@@ -1057,8 +1113,12 @@ static sdcardOperationStatus_e sdcardSpi_beginWriteBlocks(uint32_t blockIndex, u
  *     true - The operation was successfully queued for later completion, your callback will be called later
  *     false - The operation could not be started due to the card being busy (try again later).
  */
-static bool sdcardSpi_readBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_operationCompleteCallback_c callback, uint32_t callbackData)
+static bool sdcardSpi_readBlocks(uint32_t blockIndex, uint8_t *buffer, uint16_t blockCount, sdcard_operationCompleteCallback_c callback, uint32_t callbackData)
 {
+    if (blockCount == 0) {
+        return false;
+    }
+
     if (sdcard.state != SDCARD_STATE_READY) {
         if (sdcard.state == SDCARD_STATE_WRITING_MULTIPLE_BLOCKS) {
             if (sdcard_endWriteBlocks() != SDCARD_OPERATION_SUCCESS) {
@@ -1076,11 +1136,14 @@ static bool sdcardSpi_readBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_ope
     sdcard_select();
 
     // Standard size cards use byte addressing, high capacity cards use block addressing
-    uint8_t status = sdcard_sendCommand(SDCARD_COMMAND_READ_SINGLE_BLOCK, sdcard.highCapacity ? blockIndex : blockIndex * SDCARD_BLOCK_SIZE);
+    uint8_t status = sdcard_sendCommand(blockCount > 1 ? SDCARD_COMMAND_READ_MULTIPLE_BLOCK : SDCARD_COMMAND_READ_SINGLE_BLOCK,
+        sdcard.highCapacity ? blockIndex : blockIndex * SDCARD_BLOCK_SIZE);
 
     if (status == 0) {
         sdcard.pendingOperation.buffer = buffer;
         sdcard.pendingOperation.blockIndex = blockIndex;
+        sdcard.pendingOperation.blockCount = blockCount;
+        sdcard.pendingOperation.blocksTransferred = 0;
         sdcard.pendingOperation.callback = callback;
         sdcard.pendingOperation.callbackData = callbackData;
 
@@ -1098,6 +1161,17 @@ static bool sdcardSpi_readBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_ope
     }
 }
 
+/**
+ * Read the 512-byte block with the given index into the given 512-byte buffer.
+ *
+ * When the read completes, your callback will be called. If the read was successful, the buffer pointer will be the
+ * same buffer you originally passed in, otherwise the buffer will be set to NULL.
+ */
+static bool sdcardSpi_readBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_operationCompleteCallback_c callback, uint32_t callbackData)
+{
+    return sdcardSpi_readBlocks(blockIndex, buffer, 1, callback, callbackData);
+}
+
 /**
  * Returns true if the SD card has successfully completed its startup procedures.
  */
@@ -1124,6 +1198,7 @@ sdcardVTable_t sdcardSpiVTable = {
     sdcardSpi_preInit,
     sdcardSpi_init,
     sdcardSpi_readBlock,
+    sdcardSpi_readBlocks,
     sdcardSpi_beginWriteBlocks,
     sdcardSpi_writeBlock,
     sdcardSpi_poll,
@@ -40,6 +40,8 @@
 #include "drivers/nvic.h"
 #include "drivers/io.h"
 #include "drivers/serial.h"
+#include "drivers/serial_softserial_decode.h"
+#include "drivers/system.h"
 #include "drivers/timer.h"
 
 #include "serial_softserial.h"
@@ -94,6 +96,13 @@ typedef struct softSerial_s {
     uint8_t          softSerialPortIndex;
     timerMode_e      timerMode;
 
+    // Ports without a receive callback decode the bytes from the time and new level of each edge,
+    // so the bit clock interrupt only runs while transmitting
+    bool             rxEdgeDecode;
+    volatile bool    bitClockActive;
+    uint32_t         cyclesPerTimerTick;
+    softSerialDecoder_t rxDecoder;
+
     timerOvrHandlerRec_t overCb;
     timerCCHandlerRec_t edgeCb;
 } softSerial_t;
@@ -218,6 +227,36 @@ static void serialTimerConfigureTimebase(const timerHardware_t *timerHardwarePtr
     timerConfigure(timerHardwarePtr, timerPeriod, baseClock);
 }
 
+// The edge times are dated back by the timer counter, which counts after the prescaler
+static void updateCyclesPerTimerTick(softSerial_t *softSerial)
+{
+    TIM_TypeDef *tim = softSerial->timerHardware->tim;
+    softSerial->cyclesPerTimerTick = (uint32_t)((uint64_t)SystemCoreClock * (tim->PSC + 1) / timerClock(tim));
+}
+
+static void serialSetBitClock(softSerial_t *softSerial, bool enable)
+{
+    const timerHardware_t *bitTimer = (softSerial->timerMode == TIMER_MODE_DUAL) ? softSerial->exTimerHardware : softSerial->timerHardware;
+
+    ATOMIC_BLOCK(NVIC_PRIO_TIMER) {
+        if (enable && !(bitTimer->tim->DIER & TIM_DIER_UIE)) {
+            // The timer kept running, drop the stale overflow so the first bit gets its full period
+            bitTimer->tim->SR = ~TIM_SR_UIF;
+        }
+        if (softSerial->timerMode == TIMER_MODE_DUAL) {
+            timerChConfigCallbacks(softSerial->exTimerHardware, NULL, enable ? &softSerial->overCb : NULL);
+        } else {
+            timerChConfigCallbacks(softSerial->timerHardware, &softSerial->edgeCb, enable ? &softSerial->overCb : NULL);
+        }
+        softSerial->bitClockActive = enable;
+    }
+}
+
+static bool rxNeedsBitClock(const softSerial_t *softSerial)
+{
+    return (softSerial->port.mode & MODE_RX) && !softSerial->rxEdgeDecode;
+}
+
 static void resetBuffers(softSerial_t *softSerial)
 {
     softSerial->port.rxBufferSize = SOFTSERIAL_BUFFER_SIZE;
@@ -309,9 +348,13 @@ serialPort_t *openSoftSerial(softSerialPortIndex_e portIndex, serialReceiveCallb
     softSerial->rxActive = false;
     softSerial->isTransmittingData = false;
 
+    softSerial->rxEdgeDecode = (mode & MODE_RX) && !rxCallback;
+    softSerialDecoderInit(&softSerial->rxDecoder, SystemCoreClock / baud);
+
     // Configure master timer (on RX); time base and input capture
 
     serialTimerConfigureTimebase(softSerial->timerHardware, baud);
+    updateCyclesPerTimerTick(softSerial);
     timerChConfigIC(softSerial->timerHardware, (options & SERIAL_INVERTED) ? ICPOLARITY_RISING : ICPOLARITY_FALLING, 0);
 
     // Initialize callbacks
@@ -332,6 +375,11 @@ serialPort_t *openSoftSerial(softSerialPortIndex_e portIndex, serialReceiveCallb
         softSerial->timerMode = TIMER_MODE_SINGLE;
         timerChConfigCallbacks(softSerial->timerHardware, &softSerial->edgeCb, &softSerial->overCb);
     }
+    softSerial->bitClockActive = true;
+
+    if (!rxNeedsBitClock(softSerial)) {
+        serialSetBitClock(softSerial, false);
+    }
 
 #ifdef USE_HAL_DRIVER
     softSerial->timerHandle = timerFindTimerHandle(softSerial->timerHardware->tim);
@@ -364,6 +412,9 @@ void processTxState(softSerial_t *softSerial)
                 serialOutputPortDeActivate(softSerial);
                 serialInputPortActivate(softSerial);
             }
+            if (!rxNeedsBitClock(softSerial)) {
+                serialSetBitClock(softSerial, false);
+            }
             return;
         }
 
@@ -434,6 +485,16 @@ void prepareForNextRxByte(softSerial_t *softSerial)
 #define STOP_BIT_MASK (1 << 0)
 #define START_BIT_MASK (1 << (RX_TOTAL_BITS - 1))
 
+static void storeRxByte(softSerial_t *softSerial, uint8_t rxByte)
+{
+    if (softSerial->port.rxCallback) {
+        softSerial->port.rxCallback(rxByte, softSerial->port.rxCallbackData);
+    } else {
+        softSerial->port.rxBuffer[softSerial->port.rxBufferHead] = rxByte;
+        softSerial->port.rxBufferHead = (softSerial->port.rxBufferHead + 1) % softSerial->port.rxBufferSize;
+    }
+}
+
 void extractAndStoreRxByte(softSerial_t *softSerial)
 {
     if ((softSerial->port.mode & MODE_RX) == 0) {
@@ -450,11 +511,26 @@ void extractAndStoreRxByte(softSerial_t *softSerial)
 
     uint8_t rxByte = (softSerial->internalRxBuffer >> 1) & 0xFF;
 
-    if (softSerial->port.rxCallback) {
-        softSerial->port.rxCallback(rxByte, softSerial->port.rxCallbackData);
-    } else {
-        softSerial->port.rxBuffer[softSerial->port.rxBufferHead] = rxByte;
-        softSerial->port.rxBufferHead = (softSerial->port.rxBufferHead + 1) % softSerial->port.rxBufferSize;
+    storeRxByte(softSerial, rxByte);
+}
+
+static void storeDecodeResult(softSerial_t *softSerial, int result)
+{
+    if (result >= 0) {
+        storeRxByte(softSerial, result);
+    } else if (result == SOFTSERIAL_DECODE_ERROR) {
+        softSerial->receiveErrors++;
+    }
+}
+
+// A byte ending in high bits has no edge after its last bits, it is completed when the port is polled
+static void decodeRxIdle(softSerial_t *softSerial)
+{
+    ATOMIC_BLOCK(NVIC_PRIO_TIMER) {
+        // Edges up to half a bit ago have been decoded, unless their interrupt is held off for that long
+        const uint32_t idleAt = getCycleCounter() - softSerial->rxDecoder.bitPeriod / 2;
+
+        storeDecodeResult(softSerial, softSerialDecodeIdle(&softSerial->rxDecoder, idleAt));
     }
 }
 
@@ -490,14 +566,45 @@ void onSerialTimerOverflow(timerOvrHandlerRec_t *cbRec, captureCompare_t capture
     if (self->port.mode & MODE_TX)
         processTxState(self);
 
-    if (self->port.mode & MODE_RX)
+    if ((self->port.mode & MODE_RX) && !self->rxEdgeDecode)
         processRxState(self);
 }
 
-void onSerialRxPinChange(timerCCHandlerRec_t *cbRec, captureCompare_t capture)
+static void armForNextRxEdge(softSerial_t *self)
 {
-    UNUSED(capture);
+    bool inverted = self->port.options & SERIAL_INVERTED;
+
+    if (self->rxEdge == TRAILING) {
+        self->rxEdge = LEADING;
+        timerChConfigIC(self->timerHardware, inverted ? ICPOLARITY_FALLING : ICPOLARITY_RISING, 0);
+    } else {
+        self->rxEdge = TRAILING;
+        timerChConfigIC(self->timerHardware, inverted ? ICPOLARITY_RISING : ICPOLARITY_FALLING, 0);
+    }
+#if defined(STM32F7) || defined(STM32H7) || defined(STM32G4)
+    serialEnableCC(self);
+#endif
+}
+
+// Decoding each edge as it is captured keeps the capacity of the port at its byte buffer,
+// whatever the rate the port is polled at
+static void decodeRxEdge(softSerial_t *self, captureCompare_t capture)
+{
+    // Date the edge back to its capture, the interrupt may be served a while later
+    const uint32_t now = getCycleCounter();
+    TIM_TypeDef *tim = self->timerHardware->tim;
+    const uint32_t period = tim->ARR + 1;
+    const uint32_t ticksSinceCapture = (tim->CNT + period - capture) % period;
+    const uint32_t at = now - ticksSinceCapture * self->cyclesPerTimerTick;
+
+    // The polarity that was armed tells the new line level
+    const bool level = self->rxEdge == LEADING;
+
+    storeDecodeResult(self, softSerialDecodeEdge(&self->rxDecoder, at, level));
+}
 
+void onSerialRxPinChange(timerCCHandlerRec_t *cbRec, captureCompare_t capture)
+{
     softSerial_t *self = container_of(cbRec, softSerial_t, edgeCb);
     bool inverted = self->port.options & SERIAL_INVERTED;
 
@@ -505,6 +612,12 @@ void onSerialRxPinChange(timerCCHandlerRec_t *cbRec, captureCompare_t capture)
         return;
     }
 
+    if (self->rxEdgeDecode) {
+        decodeRxEdge(self, capture);
+        armForNextRxEdge(self);
+        return;
+    }
+
     if (self->isSearchingForStartBit) {
         // Synchronize the bit timing so that it will interrupt at the center
         // of the bit period.
@@ -543,16 +656,7 @@ void onSerialRxPinChange(timerCCHandlerRec_t *cbRec, captureCompare_t capture)
 
     applyChangedBits(self);
 
-    if (self->rxEdge == TRAILING) {
-        self->rxEdge = LEADING;
-        timerChConfigIC(self->timerHardware, inverted ? ICPOLARITY_FALLING : ICPOLARITY_RISING, 0);
-    } else {
-        self->rxEdge = TRAILING;
-        timerChConfigIC(self->timerHardware, inverted ? ICPOLARITY_RISING : ICPOLARITY_FALLING, 0);
-    }
-#if defined(STM32F7) || defined(STM32H7) || defined(STM32G4)
-    serialEnableCC(self);
-#endif
+    armForNextRxEdge(self);
 }
 
 
@@ -568,6 +672,10 @@ uint32_t softSerialRxBytesWaiting(const serialPort_t *instance)
 
     softSerial_t *s = (softSerial_t *)instance;
 
+    if (s->rxEdgeDecode) {
+        decodeRxIdle(s);
+    }
+
     return (s->port.rxBufferHead - s->port.rxBufferTail) & (s->port.rxBufferSize - 1);
 }
 
@@ -609,6 +717,11 @@ void softSerialWriteByte(serialPort_t *s, uint8_t ch)
 
     s->txBuffer[s->txBufferHead] = ch;
     s->txBufferHead = (s->txBufferHead + 1) % s->txBufferSize;
+
+    softSerial_t *softSerial = (softSerial_t *)s;
+    if (!softSerial->bitClockActive) {
+        serialSetBitClock(softSerial, true);
+    }
 }
 
 void softSerialSetBaudRate(serialPort_t *s, uint32_t baudRate)
@@ -618,6 +731,8 @@ void softSerialSetBaudRate(serialPort_t *s, uint32_t baudRate)
     softSerial->port.baudRate = baudRate;
 
     serialTimerConfigureTimebase(softSerial->timerHardware, baudRate);
+    updateCyclesPerTimerTick(softSerial);
+    softSerialDecoderInit(&softSerial->rxDecoder, SystemCoreClock / baudRate);
 }
 
 void softSerialSetMode(serialPort_t *instance, portMode_e mode)
@@ -0,0 +1,98 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#if defined(USE_SOFTSERIAL1) || defined(USE_SOFTSERIAL2)
+
+#include "drivers/serial_softserial_decode.h"
+
+#define FRAME_BITS 10
+#define STOP_BIT (FRAME_BITS - 1)
+
+void softSerialDecoderInit(softSerialDecoder_t *decoder, uint32_t bitPeriod)
+{
+    decoder->bitPeriod = bitPeriod;
+    decoder->frameStartAt = 0;
+    decoder->frame = 0;
+    decoder->bitIndex = 0;
+    decoder->inFrame = false;
+    decoder->level = true;
+}
+
+// Sample the bits whose centre lies before the given time, the line held the current level over all of them
+static int sampleBitsBefore(softSerialDecoder_t *decoder, uint32_t at)
+{
+    while (decoder->inFrame) {
+        const uint32_t sampleAt = decoder->frameStartAt + decoder->bitIndex * decoder->bitPeriod + decoder->bitPeriod / 2;
+        if ((int32_t)(at - sampleAt) <= 0) {
+            return SOFTSERIAL_DECODE_NONE;
+        }
+
+        if (decoder->level) {
+            decoder->frame |= 1 << decoder->bitIndex;
+        }
+
+        if (decoder->bitIndex == 0 && decoder->level) {
+            // A glitch rather than a start bit
+            decoder->inFrame = false;
+            return SOFTSERIAL_DECODE_ERROR;
+        }
+
+        if (decoder->bitIndex == STOP_BIT) {
+            decoder->inFrame = false;
+            if (!decoder->level) {
+                return SOFTSERIAL_DECODE_ERROR;
+            }
+            return (decoder->frame >> 1) & 0xFF;
+        }
+
+        decoder->bitIndex++;
+    }
+
+    return SOFTSERIAL_DECODE_NONE;
+}
+
+// Returns the byte completed by this edge, SOFTSERIAL_DECODE_NONE or SOFTSERIAL_DECODE_ERROR
+int softSerialDecodeEdge(softSerialDecoder_t *decoder, uint32_t at, bool level)
+{
+    const int result = sampleBitsBefore(decoder, at);
+
+    decoder->level = level;
+
+    if (!decoder->inFrame && !level) {
+        decoder->inFrame = true;
+        decoder->frameStartAt = at;
+        decoder->frame = 0;
+        decoder->bitIndex = 0;
+    }
+
+    return result;
+}
+
+// Completes a frame whose last bits have no edges, once no edge up to the given time can be pending
+int softSerialDecodeIdle(softSerialDecoder_t *decoder, uint32_t now)
+{
+    return sampleBitsBefore(decoder, now);
+}
+
+#endif
@@ -0,0 +1,41 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SOFTSERIAL_DECODE_NONE  -1
+#define SOFTSERIAL_DECODE_ERROR -2
+
+// Turns timestamped line transitions of an 8N1 frame into bytes. The line level is logical,
+// high when idle, and times are in any unit that wraps at 32 bits (e.g. cpu cycles).
+typedef struct softSerialDecoder_s {
+    uint32_t bitPeriod;
+    uint32_t frameStartAt;  // time of the leading edge of the start bit
+    uint16_t frame;         // sampled bits, start bit in bit 0
+    uint8_t bitIndex;       // next bit to sample
+    bool inFrame;
+    bool level;             // line level since the last edge
+} softSerialDecoder_t;
+
+void softSerialDecoderInit(softSerialDecoder_t *decoder, uint32_t bitPeriod);
+int softSerialDecodeEdge(softSerialDecoder_t *decoder, uint32_t at, bool level);
+int softSerialDecodeIdle(softSerialDecoder_t *decoder, uint32_t now);
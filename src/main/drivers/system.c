@@ -264,6 +264,14 @@ void initialiseMemorySections(void)
     memcpy(&ccm_code_start, &ccm_code, (size_t) (&ccm_code_end - &ccm_code_start));
 #endif
 
+#if defined(USE_ITCM_RAM) || defined(USE_CCM_CODE)
+    /* Load functions placed from a profile, only linked in when built with HOT_CODE_PROFILE */
+    extern uint8_t hot_code_start __attribute__((weak));
+    extern uint8_t hot_code_end __attribute__((weak));
+    extern uint8_t hot_code __attribute__((weak));
+    memcpy(&hot_code_start, &hot_code, (size_t) (&hot_code_end - &hot_code_start));
+#endif
+
 #ifdef USE_FAST_RAM
     /* Load FAST_RAM variable intializers into DTCM RAM */
     extern uint8_t _sfastram_data;
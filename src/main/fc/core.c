@@ -79,6 +79,7 @@
 #include "io/servos.h"
 #include "io/statusindicator.h"
 #include "io/transponder_ir.h"
+#include "io/usb_cdc_hid.h"
 #include "io/vtx_control.h"
 #include "io/vtx_rtc6705.h"
 
@@ -151,6 +152,21 @@ static bool flipOverAfterCrashActive = false;
 static timeUs_t disarmAt;     // Time of automatic disarm when "Don't spin the motors when armed" is enabled and auto_disarm_delay is nonzero
 
 static int lastArmingDisabledReason = 0;
+
+// Arming conditions that only change with the mode activation conditions and the configuration,
+// updateArmingStatus() runs for every RX frame and reads them instead of scanning the modes each time
+typedef struct armingConfigConditions_s {
+    bool prearmConfigured;
+#ifdef USE_GPS_RESCUE
+    bool gpsRescueConfigured;
+#endif
+#ifdef USE_ACC
+    bool accModeConfigured;         // a mode that needs a calibrated accelerometer
+    bool launchControlConfigured;
+#endif
+} armingConfigConditions_t;
+
+static armingConfigConditions_t armingConfigConditions;
 static timeUs_t lastDisarmTimeUs;
 static int tryingToArm = ARMING_DELAYED_DISARMED;
 
@@ -214,6 +230,24 @@ void resetArmingDisabled(void)
     lastArmingDisabledReason = 0;
 }
 
+// Called when the mode activation conditions or the configuration change
+void updateArmingConfigConditions(void)
+{
+    armingConfigConditions.prearmConfigured = isModeActivationConditionPresent(BOXPREARM);
+#ifdef USE_GPS_RESCUE
+    armingConfigConditions.gpsRescueConfigured = gpsRescueIsConfigured();
+#endif
+#ifdef USE_ACC
+    armingConfigConditions.accModeConfigured = isModeActivationConditionPresent(BOXANGLE) ||
+        isModeActivationConditionPresent(BOXHORIZON) ||
+        isModeActivationConditionPresent(BOXGPSRESCUE) ||
+        isModeActivationConditionPresent(BOXCAMSTAB) ||
+        isModeActivationConditionPresent(BOXCALIB) ||
+        isModeActivationConditionPresent(BOXACROTRAINER);
+    armingConfigConditions.launchControlConfigured = isModeActivationConditionPresent(BOXLAUNCHCONTROL);
+#endif
+}
+
 #ifdef USE_ACC
 static bool accNeedsCalibration(void)
 {
@@ -229,18 +263,12 @@ static bool accNeedsCalibration(void)
         // ACC that would be affected by the lack of calibration.
 
         // Check for any configured modes that use the ACC
-        if (isModeActivationConditionPresent(BOXANGLE) ||
-            isModeActivationConditionPresent(BOXHORIZON) ||
-            isModeActivationConditionPresent(BOXGPSRESCUE) ||
-            isModeActivationConditionPresent(BOXCAMSTAB) ||
-            isModeActivationConditionPresent(BOXCALIB) ||
-            isModeActivationConditionPresent(BOXACROTRAINER)) {
-
+        if (armingConfigConditions.accModeConfigured) {
             return true;
         }
 
         // Launch Control only requires the ACC if a angle limit is set
-        if (isModeActivationConditionPresent(BOXLAUNCHCONTROL) && currentPidProfile->launchControlAngleLimit) {
+        if (armingConfigConditions.launchControlConfigured && currentPidProfile->launchControlAngleLimit) {
             return true;
         }
 
@@ -334,7 +362,7 @@ void updateArmingStatus(void)
             unsetArmingDisabled(ARMING_DISABLED_CALIBRATING);
         }
 
-        if (isModeActivationConditionPresent(BOXPREARM)) {
+        if (armingConfigConditions.prearmConfigured) {
             if (IS_RC_MODE_ACTIVE(BOXPREARM) && !ARMING_FLAG(WAS_ARMED_WITH_PREARM)) {
                 unsetArmingDisabled(ARMING_DISABLED_NOPREARM);
             } else {
@@ -343,7 +371,7 @@ void updateArmingStatus(void)
         }
 
 #ifdef USE_GPS_RESCUE
-        if (gpsRescueIsConfigured()) {
+        if (armingConfigConditions.gpsRescueConfigured) {
             if (gpsRescueConfig()->allowArmingWithoutFix || STATE(GPS_FIX) || ARMING_FLAG(WAS_EVER_ARMED) || IS_RC_MODE_ACTIVE(BOXFLIPOVERAFTERCRASH)) {
                 unsetArmingDisabled(ARMING_DISABLED_GPS);
             } else {
@@ -468,6 +496,8 @@ void disarm(flightLogDisarmReason_e reason)
         statsOnDisarm();
 #endif
 
+        gyroBiasModelOnDisarm();
+
         // if ARMING_DISABLED_RUNAWAY_TAKEOFF is set then we want to play it's beep pattern instead
         if (!(getArmingDisableFlags() & (ARMING_DISABLED_RUNAWAY_TAKEOFF | ARMING_DISABLED_CRASH_DETECTED))) {
             beeper(BEEPER_DISARMING);      // emit disarm tone
@@ -506,6 +536,13 @@ void tryArm(void)
             return;
         }
 
+#ifdef USE_DSHOT_TELEMETRY
+        // ESCs forget the setting when they lose power, so ask again on every arm
+        if (isMotorProtocolDshot() && useDshotTelemetry && motorConfig()->dev.useDshotEdt) {
+            dshotCommandWrite(ALL_MOTORS, getMotorCount(), DSHOT_CMD_EXTENDED_TELEMETRY_ENABLE, DSHOT_CMD_TYPE_INLINE);
+        }
+#endif
+
         if (isMotorProtocolDshot() && isModeActivationConditionPresent(BOXFLIPOVERAFTERCRASH)) {
             if (!(IS_RC_MODE_ACTIVE(BOXFLIPOVERAFTERCRASH) || (tryingToArm == ARMING_DELAYED_CRASHFLIP))) {
                 flipOverAfterCrashActive = false;
@@ -543,7 +580,7 @@ void tryArm(void)
         pidAcroTrainerInit();
 #endif // USE_ACRO_TRAINER
 
-        if (isModeActivationConditionPresent(BOXPREARM)) {
+        if (armingConfigConditions.prearmConfigured) {
             ENABLE_ARMING_FLAG(WAS_ARMED_WITH_PREARM);
         }
         imuQuaternionHeadfreeOffsetSet();
@@ -757,6 +794,13 @@ bool processRx(timeUs_t currentTimeUs)
         return false;
     }
 
+#ifdef USE_USB_CDC_HID
+    // Forward the new frame to the simulator joystick before any further rx processing
+    if (!ARMING_FLAG(ARMED)) {
+        sendRcDataToHid();
+    }
+#endif
+
     updateRcRefreshRate(currentTimeUs);
 
     // in 3D mode, we need to be able to disarm by switch at any time
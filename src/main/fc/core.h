@@ -71,6 +71,7 @@ union rollAndPitchTrims_u;
 void handleInflightCalibrationStickPosition(void);
 
 void resetArmingDisabled(void);
+void updateArmingConfigConditions(void);
 
 void disarm(flightLogDisarmReason_e reason);
 void tryArm(void);
@@ -728,8 +728,14 @@ void init(void)
     // Validate and correct the gyro config or PID loop time if needed
     validateAndFixGyroConfig();
 
-    // Now reset the targetLooptime as it's possible for the validation to change the pid_process_denom
-    gyroSetTargetLooptime(pidConfig()->pid_process_denom);
+    // Now reset the targetLooptime as it's possible for the validation to change the pid_process_denom.
+    // If the task timing was calibrated before a warm reset, slow the PID loop down if it would overload the CPU
+    uint8_t pidDenom = pidConfig()->pid_process_denom;
+    schedulerTimingProfile_t timingProfile;
+    if (schedulerRestoreTimingProfile(&timingProfile)) {
+        pidDenom = schedulerSelectPidDenom(&timingProfile, gyro.sampleLooptime, pidDenom, MAX_PID_PROCESS_DENOM);
+    }
+    gyroSetTargetLooptime(pidDenom);
 
     // Finally initialize the gyro filtering
     gyroInitFilters();
@@ -400,4 +400,5 @@ void rcControlsInit(void)
 {
     analyzeModeActivationConditions();
     isUsingSticksToArm = !isModeActivationConditionPresent(BOXARM) && systemConfig()->enableStickArming;
+    updateArmingConfigConditions();
 }
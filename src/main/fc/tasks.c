@@ -68,7 +68,6 @@
 #include "io/transponder_ir.h"
 #include "io/vtx_tramp.h" // Will be gone
 #include "io/rcdevice_cam.h"
-#include "io/usb_cdc_hid.h"
 #include "io/vtx.h"
 
 #include "msp/msp.h"
@@ -93,6 +92,7 @@
 
 #include "scheduler/scheduler.h"
 
+#include "telemetry/hott.h"
 #include "telemetry/telemetry.h"
 
 #ifdef USE_BST
@@ -114,11 +114,35 @@
 
 static void taskMain(timeUs_t currentTimeUs)
 {
-    UNUSED(currentTimeUs);
-
 #ifdef USE_SDCARD
     afatfs_poll();
 #endif
+
+    gyroUpdateBiasRefinement(currentTimeUs);
+}
+
+// Serial ports are still serviced this often when no data arrives, so the USB debug values are kept
+// up to date and deferred MSP requests (CLI entry, bootloader reboot) are acted upon
+#define TASK_SERIAL_IDLE_PERIOD_US TASK_PERIOD_HZ(10)
+// Checking the MSP ports is a call into the driver of each port, the scheduler would otherwise make
+// it on every pass of the main loop
+#define TASK_SERIAL_CHECK_INTERVAL_US TASK_PERIOD_HZ(1000)
+
+static bool taskSerialCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    static timeUs_t lastCheckUs = 0;
+
+    if (currentDeltaTimeUs >= TASK_SERIAL_IDLE_PERIOD_US) {
+        return true;
+    }
+
+    if (cmpTimeUs(currentTimeUs, lastCheckUs) < TASK_SERIAL_CHECK_INTERVAL_US) {
+        return false;
+    }
+    lastCheckUs = currentTimeUs;
+
+    // The CLI port is always one of the MSP ports, so this also covers CLI mode
+    return mspSerialWaiting();
 }
 
 static void taskHandleSerial(timeUs_t currentTimeUs)
@@ -167,21 +191,13 @@ static void taskUpdateRxMain(timeUs_t currentTimeUs)
     // updateRcCommands sets rcCommand, which is needed by updateAltHoldState and updateSonarAltHoldState
     updateRcCommands();
     updateArmingStatus();
-
-#ifdef USE_USB_CDC_HID
-    if (!ARMING_FLAG(ARMED)) {
-        sendRcDataToHid();
-    }
-#endif
 }
 
 #ifdef USE_BARO
 static void taskUpdateBaro(timeUs_t currentTimeUs)
 {
-    UNUSED(currentTimeUs);
-
     if (sensors(SENSOR_BARO)) {
-        const uint32_t newDeadline = baroUpdate();
+        const uint32_t newDeadline = baroUpdate(currentTimeUs);
         if (newDeadline != 0) {
             rescheduleTask(TASK_SELF, newDeadline);
         }
@@ -233,6 +249,17 @@ static void taskCameraControl(uint32_t currentTime)
 }
 #endif
 
+#if defined(USE_OSD) || defined(USE_TELEMETRY)
+// Slow the task down if it doesn't fit into the CPU time measured before the last warm reset
+static void rescheduleTaskForTimingProfile(taskId_e taskId, schedulerProfileTask_e profileTask)
+{
+    schedulerTimingProfile_t timingProfile;
+    if (schedulerRestoreTimingProfile(&timingProfile)) {
+        rescheduleTask(taskId, schedulerSelectTaskPeriod(&timingProfile, gyro.sampleLooptime, activePidLoopDenom, profileTask, getTask(taskId)->desiredPeriodUs));
+    }
+}
+#endif
+
 void tasksInit(void)
 {
     schedulerInit();
@@ -322,6 +349,8 @@ void tasksInit(void)
         } else if (rxRuntimeState.serialrxProvider == SERIALRX_CRSF) {
             // Reschedule telemetry to 500hz, 2ms for CRSF
             rescheduleTask(TASK_TELEMETRY, TASK_PERIOD_HZ(500));
+        } else {
+            rescheduleTaskForTimingProfile(TASK_TELEMETRY, SCHEDULER_PROFILE_TELEMETRY);
         }
     }
 #endif
@@ -336,6 +365,7 @@ void tasksInit(void)
 
 #ifdef USE_OSD
     setTaskEnabled(TASK_OSD, featureIsEnabled(FEATURE_OSD) && osdInitialized());
+    rescheduleTaskForTimingProfile(TASK_OSD, SCHEDULER_PROFILE_OSD);
 #endif
 
 #ifdef USE_BST
@@ -399,7 +429,7 @@ void tasksInit(void)
 task_t tasks[TASK_COUNT] = {
     [TASK_SYSTEM] = DEFINE_TASK("SYSTEM", "LOAD", NULL, taskSystemLoad, TASK_PERIOD_HZ(10), TASK_PRIORITY_MEDIUM_HIGH),
     [TASK_MAIN] = DEFINE_TASK("SYSTEM", "UPDATE", NULL, taskMain, TASK_PERIOD_HZ(1000), TASK_PRIORITY_MEDIUM_HIGH),
-    [TASK_SERIAL] = DEFINE_TASK("SERIAL", NULL, NULL, taskHandleSerial, TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW), // 100 Hz should be enough to flush up to 115 bytes @ 115200 baud
+    [TASK_SERIAL] = DEFINE_TASK("SERIAL", NULL, taskSerialCheck, taskHandleSerial, TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW), // Runs when data arrives, the period only ages the pending event
     [TASK_BATTERY_ALERTS] = DEFINE_TASK("BATTERY_ALERTS", NULL, NULL, taskBatteryAlerts, TASK_PERIOD_HZ(5), TASK_PRIORITY_MEDIUM),
     [TASK_BATTERY_VOLTAGE] = DEFINE_TASK("BATTERY_VOLTAGE", NULL, NULL, batteryUpdateVoltage, TASK_PERIOD_HZ(SLOW_VOLTAGE_TASK_FREQ_HZ), TASK_PRIORITY_MEDIUM), // Freq may be updated in tasksInit
     [TASK_BATTERY_CURRENT] = DEFINE_TASK("BATTERY_CURRENT", NULL, NULL, batteryUpdateCurrentMeter, TASK_PERIOD_HZ(50), TASK_PRIORITY_MEDIUM),
@@ -443,7 +473,7 @@ task_t tasks[TASK_COUNT] = {
 #endif
 
 #ifdef USE_DASHBOARD
-    [TASK_DASHBOARD] = DEFINE_TASK("DASHBOARD", NULL, NULL, dashboardUpdate, TASK_PERIOD_HZ(10), TASK_PRIORITY_LOW),
+    [TASK_DASHBOARD] = DEFINE_TASK("DASHBOARD", NULL, NULL, dashboardUpdate, TASK_PERIOD_HZ(50), TASK_PRIORITY_LOW),
 #endif
 
 #ifdef USE_OSD
@@ -454,6 +484,10 @@ task_t tasks[TASK_COUNT] = {
     [TASK_TELEMETRY] = DEFINE_TASK("TELEMETRY", NULL, NULL, taskTelemetry, TASK_PERIOD_HZ(250), TASK_PRIORITY_LOW),
 #endif
 
+#ifdef USE_TELEMETRY_HOTT
+    [TASK_HOTT_TX] = DEFINE_TASK("HOTT_TX", NULL, NULL, handleHoTTTransmit, TASK_PERIOD_US(HOTT_TX_DELAY_US), TASK_PRIORITY_HIGH),
+#endif
+
 #ifdef USE_LED_STRIP
     [TASK_LEDSTRIP] = DEFINE_TASK("LEDSTRIP", NULL, NULL, ledStripUpdate, TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW),
 #endif
@@ -26,6 +26,7 @@
 
 #include "common/axis.h"
 #include "common/maths.h"
+#include "common/topic.h"
 #include "common/utils.h"
 
 #include "drivers/time.h"
@@ -190,20 +191,12 @@ float         altitudeError = 0.0;
 uint32_t      throttleSamples = 0;
 bool          magForceDisable = false;
 
+static topicSubscriber_t gpsSolSubscriber = TOPIC_SUBSCRIBER(gpsSol);
 static bool newGPSData = false;
 
 rescueState_s rescueState;
 throttle_s throttle;
 
-/*
- If we have new GPS data, update home heading
- if possible and applicable.
-*/
-void rescueNewGpsData(void)
-{
-    newGPSData = true;
-}
-
 static void rescueStart()
 {
     rescueState.phase = RESCUE_INITIALIZE;
@@ -549,6 +542,8 @@ void updateGPSRescueState(void)
     static int32_t newAltitude;
     float magnitudeTrigger;
 
+    newGPSData = gpsSolTopicReadNew(&gpsSolSubscriber) != NULL;
+
     if (!FLIGHT_MODE(GPS_RESCUE_MODE)) {
         rescueStop();
     } else if (FLIGHT_MODE(GPS_RESCUE_MODE) && rescueState.phase == RESCUE_IDLE) {
@@ -705,8 +700,6 @@ void updateGPSRescueState(void)
     if (rescueState.phase != RESCUE_IDLE) {
         rescueAttainPosition();
     }
-
-    newGPSData = false;
 }
 
 float gpsRescueGetYawRate(void)
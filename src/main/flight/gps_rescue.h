@@ -50,7 +50,6 @@ PG_DECLARE(gpsRescueConfig_t, gpsRescueConfig);
 extern int32_t gpsRescueAngle[ANGLE_INDEX_COUNT]; //NOTE: ANGLES ARE IN CENTIDEGREES
 
 void updateGPSRescueState(void);
-void rescueNewGpsData(void);
 
 float gpsRescueGetYawRate(void);
 float gpsRescueGetThrottle(void);
@@ -249,8 +249,8 @@ static void imuMahonyAHRSupdate(float dt, float gx, float gy, float gz,
     float mz = mag.magADC[Z];
     float recipMagNorm = sq(mx) + sq(my) + sq(mz);
     if (useMag && recipMagNorm > 0.01f) {
-        // Normalise magnetometer measurement
-        recipMagNorm = invSqrt(recipMagNorm);
+        // Normalise magnetometer measurement, only its direction is used
+        recipMagNorm = invSqrt_approx(recipMagNorm);
         mx *= recipMagNorm;
         my *= recipMagNorm;
         mz *= recipMagNorm;
@@ -279,8 +279,8 @@ static void imuMahonyAHRSupdate(float dt, float gx, float gy, float gz,
     // Use measured acceleration vector
     float recipAccNorm = sq(ax) + sq(ay) + sq(az);
     if (useAcc && recipAccNorm > 0.01f) {
-        // Normalise accelerometer measurement
-        recipAccNorm = invSqrt(recipAccNorm);
+        // Normalise accelerometer measurement, only its direction is used
+        recipAccNorm = invSqrt_approx(recipAccNorm);
         ax *= recipAccNorm;
         ay *= recipAccNorm;
         az *= recipAccNorm;
@@ -347,13 +347,13 @@ STATIC_UNIT_TESTED void imuUpdateEulerAngles(void)
     if (FLIGHT_MODE(HEADFREE_MODE)) {
        imuQuaternionComputeProducts(&headfree, &buffer);
 
-       attitude.values.roll = lrintf(atan2_approx((+2.0f * (buffer.wx + buffer.yz)), (+1.0f - 2.0f * (buffer.xx + buffer.yy))) * (1800.0f / M_PIf));
+       attitude.values.roll = lrintf(atan2_approx_table((+2.0f * (buffer.wx + buffer.yz)), (+1.0f - 2.0f * (buffer.xx + buffer.yy))) * (1800.0f / M_PIf));
        attitude.values.pitch = lrintf(((0.5f * M_PIf) - acos_approx(+2.0f * (buffer.wy - buffer.xz))) * (1800.0f / M_PIf));
-       attitude.values.yaw = lrintf((-atan2_approx((+2.0f * (buffer.wz + buffer.xy)), (+1.0f - 2.0f * (buffer.yy + buffer.zz))) * (1800.0f / M_PIf)));
+       attitude.values.yaw = lrintf((-atan2_approx_table((+2.0f * (buffer.wz + buffer.xy)), (+1.0f - 2.0f * (buffer.yy + buffer.zz))) * (1800.0f / M_PIf)));
     } else {
-       attitude.values.roll = lrintf(atan2_approx(rMat[2][1], rMat[2][2]) * (1800.0f / M_PIf));
+       attitude.values.roll = lrintf(atan2_approx_table(rMat[2][1], rMat[2][2]) * (1800.0f / M_PIf));
        attitude.values.pitch = lrintf(((0.5f * M_PIf) - acos_approx(-rMat[2][0])) * (1800.0f / M_PIf));
-       attitude.values.yaw = lrintf((-atan2_approx(rMat[1][0], rMat[0][0]) * (1800.0f / M_PIf)));
+       attitude.values.yaw = lrintf((-atan2_approx_table(rMat[1][0], rMat[0][0]) * (1800.0f / M_PIf)));
     }
 
     if (attitude.values.yaw < 0) {
@@ -54,6 +54,7 @@
 #include "flight/imu.h"
 #include "flight/gps_rescue.h"
 #include "flight/mixer.h"
+#include "flight/mixer_allocation.h"
 #include "flight/mixer_tricopter.h"
 #include "flight/pid.h"
 #include "flight/rpm_filter.h"
@@ -63,7 +64,7 @@
 #include "sensors/battery.h"
 #include "sensors/gyro.h"
 
-PG_REGISTER_WITH_RESET_TEMPLATE(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 0);
+PG_REGISTER_WITH_RESET_TEMPLATE(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 1);
 
 #define DYN_LPF_THROTTLE_STEPS           100
 #define DYN_LPF_THROTTLE_UPDATE_DELAY_US 5000 // minimum of 5ms between updates
@@ -72,7 +73,9 @@ PG_RESET_TEMPLATE(mixerConfig_t, mixerConfig,
     .mixerMode = DEFAULT_MIXER,
     .yaw_motors_reversed = false,
     .crashflip_motor_percent = 0,
-    .crashflip_expo = 35
+    .crashflip_expo = 35,
+    .mixer_allocation = MIXER_ALLOCATION_LEGACY,
+    .mixer_yaw_priority = 30,
 );
 
 PG_REGISTER_ARRAY(motorMixer_t, MAX_SUPPORTED_MOTORS, customMotorMixer, PG_MOTOR_MIXER, 0);
@@ -310,6 +313,11 @@ float getMotorMixRange(void)
     return motorMixRange;
 }
 
+const motorMixer_t *mixerGetMotorMix(void)
+{
+    return currentMixer;
+}
+
 bool areMotorsRunning(void)
 {
     bool motorsRunning = false;
@@ -825,6 +833,15 @@ static void updateDynLpfCutoffs(timeUs_t currentTimeUs, float throttle)
 }
 #endif
 
+static void updateMixerAllocationDebug(float rollPitchScale, float yawScale, float roll, float pitch, float yaw)
+{
+    DEBUG_SET(DEBUG_MIXER_ALLOCATION, 0, lrintf(rollPitchScale * 1000));
+    DEBUG_SET(DEBUG_MIXER_ALLOCATION, 1, lrintf(yawScale * 1000));
+    // the roll/pitch and yaw demand that could not be allocated, per mille of the motor range
+    DEBUG_SET(DEBUG_MIXER_ALLOCATION, 2, lrintf((1.0f - rollPitchScale) * (fabsf(roll) + fabsf(pitch)) * 1000));
+    DEBUG_SET(DEBUG_MIXER_ALLOCATION, 3, lrintf((1.0f - yawScale) * fabsf(yaw) * 1000));
+}
+
 FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs)
 {
     // Find min and max throttle based on conditions. Throttle has to be known before mixing
@@ -942,7 +959,23 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs)
     mixerThrottle = throttle;
 
     motorMixRange = motorMixMax - motorMixMin;
-    if (motorMixRange > 1.0f) {
+
+    // the prioritised mix always fits in the motor range, only throttle is adjusted below
+    const bool mixPrioritised = mixerConfig()->mixer_allocation == MIXER_ALLOCATION_PRIORITY && motorMixRange > 1.0f;
+    if (mixPrioritised) {
+        mixerAllocation_t allocation;
+        mixerAllocateByPriority(motorMix, activeMixer, motorCount, scaledAxisPidRoll, scaledAxisPidPitch, scaledAxisPidYaw,
+            mixerConfig()->mixer_yaw_priority / 100.0f, &allocation);
+        motorMixMin = allocation.motorMixMin;
+        motorMixMax = allocation.motorMixMax;
+
+        updateMixerAllocationDebug(allocation.rollPitchScale, allocation.yawScale, scaledAxisPidRoll, scaledAxisPidPitch, scaledAxisPidYaw);
+    } else if (debugMode == DEBUG_MIXER_ALLOCATION) {
+        const float scale = (motorMixRange > 1.0f) ? 1.0f / motorMixRange : 1.0f;
+        updateMixerAllocationDebug(scale, scale, scaledAxisPidRoll, scaledAxisPidPitch, scaledAxisPidYaw);
+    }
+
+    if (motorMixRange > 1.0f && !mixPrioritised) {
         for (int i = 0; i < motorCount; i++) {
             motorMix[i] /= motorMixRange;
         }
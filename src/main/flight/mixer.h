@@ -77,11 +77,18 @@ typedef struct mixer_s {
     const motorMixer_t *motor;
 } mixer_t;
 
+typedef enum {
+    MIXER_ALLOCATION_LEGACY = 0,
+    MIXER_ALLOCATION_PRIORITY,
+} mixerAllocationMode_e;
+
 typedef struct mixerConfig_s {
     uint8_t mixerMode;
     bool yaw_motors_reversed;
     uint8_t crashflip_motor_percent;
     uint8_t crashflip_expo;
+    uint8_t mixer_allocation;           // how a saturated roll/pitch/yaw demand is fitted to the motors, see mixerAllocationMode_e
+    uint8_t mixer_yaw_priority;         // percentage of the yaw demand allocated together with roll and pitch in priority allocation
 } mixerConfig_t;
 
 PG_DECLARE(mixerConfig_t, mixerConfig);
@@ -96,6 +103,7 @@ struct rxConfig_s;
 
 uint8_t getMotorCount(void);
 float getMotorMixRange(void);
+const motorMixer_t *mixerGetMotorMix(void);
 bool areMotorsRunning(void);
 
 void mixerLoadMix(int index, motorMixer_t *customMixers);
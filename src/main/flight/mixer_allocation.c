@@ -0,0 +1,89 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "flight/mixer.h"
+
+#include "mixer_allocation.h"
+
+// Allocates a saturated roll, pitch and yaw demand to the motors in priority order.
+// The roll and pitch demand, together with the yawPriority fraction of the yaw demand, is
+// scaled down until its range fits the motors. The rest of the yaw demand then gets the
+// largest scale that keeps the range within 1. Throttle is left to the caller, the mix
+// always fits in the motor range so throttle can be moved as without saturation.
+// yawPriority 1 scales all axes together as the legacy mixer does.
+FAST_CODE void mixerAllocateByPriority(float *motorMix, const motorMixer_t *activeMixer, int motorCount,
+    float roll, float pitch, float yaw, float yawPriority, mixerAllocation_t *allocation)
+{
+    const float yawFirst = yaw * yawPriority;
+    const float yawSecond = yaw - yawFirst;
+
+    float firstMix[MAX_SUPPORTED_MOTORS];
+    float firstMixMax = 0, firstMixMin = 0;
+    for (int i = 0; i < motorCount; i++) {
+        const float mix = roll * activeMixer[i].roll + pitch * activeMixer[i].pitch + yawFirst * activeMixer[i].yaw;
+        firstMixMax = MAX(firstMixMax, mix);
+        firstMixMin = MIN(firstMixMin, mix);
+        firstMix[i] = mix;
+    }
+
+    const float firstMixRange = firstMixMax - firstMixMin;
+    const float firstScale = (firstMixRange > 1.0f) ? 1.0f / firstMixRange : 1.0f;
+
+    // the range of firstScale * firstMix + secondScale * yawSecond * yawMix stays within 1 when
+    // it does for every pair of motors, each pair with a different yaw mix bounds secondScale.
+    // As in the legacy mixer the range always includes 0, so every motor is paired with 0 too.
+    float secondScale = (yawSecond != 0.0f) ? 1.0f : 0.0f;
+    for (int i = 0; i < motorCount && secondScale > 0.0f; i++) {
+        for (int j = i + 1; j <= motorCount; j++) {
+            const float otherFirstMix = (j < motorCount) ? firstMix[j] : 0.0f;
+            const float otherYawMix = (j < motorCount) ? activeMixer[j].yaw : 0.0f;
+            float firstDifference = firstScale * (firstMix[i] - otherFirstMix);
+            float secondDifference = yawSecond * (activeMixer[i].yaw - otherYawMix);
+            if (secondDifference < 0.0f) {
+                firstDifference = -firstDifference;
+                secondDifference = -secondDifference;
+            }
+            const float headroom = MAX(1.0f - firstDifference, 0.0f);
+            if (headroom < secondScale * secondDifference) {
+                secondScale = headroom / secondDifference;
+            }
+        }
+    }
+
+    float motorMixMax = 0, motorMixMin = 0;
+    for (int i = 0; i < motorCount; i++) {
+        const float mix = firstScale * firstMix[i] + secondScale * yawSecond * activeMixer[i].yaw;
+        motorMixMax = MAX(motorMixMax, mix);
+        motorMixMin = MIN(motorMixMin, mix);
+        motorMix[i] = mix;
+    }
+
+    allocation->motorMixMin = motorMixMin;
+    allocation->motorMixMax = motorMixMax;
+    allocation->rollPitchScale = firstScale;
+    allocation->yawScale = (yaw != 0.0f) ? (firstScale * yawFirst + secondScale * yawSecond) / yaw : 1.0f;
+}
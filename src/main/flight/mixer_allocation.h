@@ -0,0 +1,33 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "flight/mixer.h"
+
+typedef struct mixerAllocation_s {
+    float motorMixMin;
+    float motorMixMax;
+    float rollPitchScale;   // fraction of the roll and pitch demand that is allocated
+    float yawScale;         // fraction of the yaw demand that is allocated
+} mixerAllocation_t;
+
+void mixerAllocateByPriority(float *motorMix, const motorMixer_t *activeMixer, int motorCount,
+    float roll, float pitch, float yaw, float yawPriority, mixerAllocation_t *allocation);
@@ -201,6 +201,9 @@ typedef struct pidProfile_s {
     uint8_t dyn_lpf_curve_expo;             // set the curve for dynamic dterm lowpass filter
     uint8_t level_race_mode;                // NFE race mode - when true pitch setpoint calcualtion is gyro based in level mode
     uint8_t vbat_sag_compensation;          // Reduce motor output by this percentage of the maximum compensation amount
+    uint8_t smith_predictor_strength;       // Percentage of the rate change expected over the filter delay that is added to the gyro for P and D, 0 is off
+    uint8_t smith_predictor_delay;          // Delay of the gyro filters in 0.1ms steps, 0 estimates it from the gyro lowpass settings
+    uint8_t smith_predictor_motor_tau;      // Motor time constant in ms used until it is identified from the RPM telemetry
 } pidProfile_t;
 
 PG_DECLARE_ARRAY(pidProfile_t, PID_PROFILE_COUNT, pidProfiles);
@@ -32,14 +32,13 @@
 #include "common/filter.h"
 #include "common/maths.h"
 
-#include "drivers/dshot_command.h"
-
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
 
 #include "flight/interpolated_setpoint.h"
 #include "flight/pid.h"
 #include "flight/rpm_filter.h"
+#include "flight/smith_predictor.h"
 
 #include "sensors/gyro.h"
 #include "sensors/sensors.h"
@@ -60,9 +59,6 @@ static void pidSetTargetLooptime(uint32_t pidLooptime)
     targetPidLooptime = pidLooptime;
     pidRuntime.dT = targetPidLooptime * 1e-6f;
     pidRuntime.pidFrequency = 1.0f / pidRuntime.dT;
-#ifdef USE_DSHOT
-    dshotSetPidLoopTime(targetPidLooptime);
-#endif
 }
 
 void pidInitFilters(const pidProfile_t *pidProfile)
@@ -215,6 +211,9 @@ void pidInit(const pidProfile_t *pidProfile)
 #ifdef USE_RPM_FILTER
     rpmFilterInit(rpmFilterConfig());
 #endif
+#ifdef USE_SMITH_PREDICTOR
+    smithPredictorResetModel();
+#endif
 }
 
 #ifdef USE_RC_SMOOTHING_FILTER
@@ -398,6 +397,9 @@ void pidInitConfig(const pidProfile_t *pidProfile)
     pidRuntime.ffSmoothFactor = 1.0f - ((float)pidProfile->ff_smooth_factor) / 100.0f;
     interpolatedSpInit(pidProfile);
 #endif
+#ifdef USE_SMITH_PREDICTOR
+    smithPredictorInit(pidProfile);
+#endif
 
     pidRuntime.levelRaceMode = pidProfile->level_race_mode;
 }
@@ -29,6 +29,7 @@
 #include "build/debug.h"
 
 #include "common/maths.h"
+#include "common/topic.h"
 
 #include "fc/runtime_config.h"
 
@@ -86,6 +87,10 @@ int16_t calculateEstimatedVario(int32_t baroAlt, const uint32_t dTime) {
 #if defined(USE_BARO) || defined(USE_GPS)
 static bool altitudeOffsetSet = false;
 
+#ifdef USE_BARO
+static topicSubscriber_t baroSubscriber = TOPIC_SUBSCRIBER(baro);
+#endif
+
 void calculateEstimatedAltitude(timeUs_t currentTimeUs)
 {
     static timeUs_t previousTimeUs = 0;
@@ -112,7 +117,11 @@ void calculateEstimatedAltitude(timeUs_t currentTimeUs)
         if (!baroIsCalibrationComplete()) {
             performBaroCalibrationCycle();
         } else {
-            baroAlt = baroCalculateAltitude();
+            // the noise filter in baroCalculateAltitude() runs once per pressure sample
+            if (baroTopicReadNew(&baroSubscriber)) {
+                baroCalculateAltitude();
+            }
+            baroAlt = baro.BaroAlt;
             haveBaroAlt = true;
         }
     }
@@ -0,0 +1,468 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Smith predictor for the delay of the gyro and D term filters.
+//
+// The response of every motor to its output is modelled as a first order lag
+// with separate spin up and spin down time constants, identified from the RPM
+// telemetry when it is available. The modelled motor outputs are mixed back into
+// a torque per axis, and the angular acceleration per unit of torque is identified
+// from the filtered gyro. The rate change the model expects over the filter delay
+// is the sum of the torque over that delay, which is added to the filtered gyro
+// for the P and D terms so they react to the rate the quad has now.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_SMITH_PREDICTOR
+
+#include "build/debug.h"
+
+#include "common/axis.h"
+#include "common/filter.h"
+#include "common/maths.h"
+
+#include "drivers/dshot.h"
+
+#include "fc/runtime_config.h"
+
+#include "flight/mixer.h"
+#include "flight/pid.h"
+
+#include "pg/motor.h"
+
+#include "sensors/gyro.h"
+
+#include "smith_predictor.h"
+
+#define DELAY_BUFFER_MASK               (SMITH_PREDICTOR_MAX_DELAY_SAMPLES - 1)
+
+#define MOTOR_TIME_CONSTANT_MIN_S       0.002f
+#define MOTOR_TIME_CONSTANT_MAX_S       0.2f
+#define RPM_SAMPLE_INTERVAL_S           0.001f  // RPM telemetry quantisation needs a few loops between samples
+#define RPM_MIN_RESPONSE                0.005f  // difference of command and modelled output that is enough to identify the response
+#define RPM_ESTIMATOR_FORGETTING        0.998f
+#define RPM_ESTIMATOR_COVARIANCE_INIT   100.0f
+#define RPM_ESTIMATOR_COVARIANCE_MAX    1000.0f
+#define RPM_ESTIMATOR_PARAMETERS        3
+
+#define AXIS_GAIN_LPF_HZ                40.0f
+#define AXIS_GAIN_MIN_TORQUE            0.02f   // differential motor output that is enough to identify the gain
+#define AXIS_GAIN_ADAPTATION_TIME_S     0.2f
+#define AXIS_GAIN_MAX                   200000.0f
+
+typedef enum {
+    MOTOR_SPIN_DOWN = 0,
+    MOTOR_SPIN_UP,
+    MOTOR_DIRECTION_COUNT
+} motorDirection_e;
+
+// recursive least squares fit of erpm = a * previousErpm + b * command + c, with erpm
+// and command relative to the first sample after arming to keep the fit well conditioned.
+// a is the decay of the first order response over one RPM sample interval, b and c
+// follow the static response around the operating point.
+typedef struct motorResponseEstimator_s {
+    float theta[RPM_ESTIMATOR_PARAMETERS];
+    float p[RPM_ESTIMATOR_PARAMETERS][RPM_ESTIMATOR_PARAMETERS];
+} motorResponseEstimator_t;
+
+typedef struct motorModel_s {
+    float output;                               // modelled response, fraction of the motor output range
+    float responseGain[MOTOR_DIRECTION_COUNT];  // per PID loop gain of the first order response
+    float timeConstant[MOTOR_DIRECTION_COUNT];  // seconds
+#ifdef USE_DSHOT_TELEMETRY
+    motorResponseEstimator_t estimator[MOTOR_DIRECTION_COUNT];
+    float commandSum;
+    float commandOrigin;
+    float erpmOrigin;
+    bool originValid;
+    float previousErpm;
+    bool previousErpmValid;
+#endif
+} motorModel_t;
+
+typedef struct axisModel_s {
+    float gain;                                 // angular acceleration in deg/s^2 per unit of torque
+    float previousGyroRate;
+    pt1Filter_t accelerationLpf;
+    pt1Filter_t torqueLpf;
+    float torque[SMITH_PREDICTOR_MAX_DELAY_SAMPLES];
+    float ptermTorqueSum;
+    float dtermTorqueSum;
+    float ptermCorrection;
+    float dtermCorrection;
+} axisModel_t;
+
+FAST_RAM_ZERO_INIT static motorModel_t motorModels[MAX_SUPPORTED_MOTORS];
+FAST_RAM_ZERO_INIT static axisModel_t axisModels[XYZ_AXIS_COUNT];
+
+FAST_RAM_ZERO_INIT static float strength;
+FAST_RAM_ZERO_INIT static float dT;
+FAST_RAM_ZERO_INIT static float defaultTimeConstant;
+FAST_RAM_ZERO_INIT static float gainAdaptationRate;
+FAST_RAM_ZERO_INIT static uint8_t ptermDelaySamples;
+FAST_RAM_ZERO_INIT static uint8_t dtermDelaySamples;
+FAST_RAM_ZERO_INIT static uint8_t torqueIndex;
+FAST_RAM_ZERO_INIT static bool modelRunning;
+#ifdef USE_DSHOT_TELEMETRY
+FAST_RAM_ZERO_INIT static bool useRpmTelemetry;
+FAST_RAM_ZERO_INIT static uint8_t rpmSampleInterval;
+FAST_RAM_ZERO_INIT static uint8_t rpmSampleCount;
+#endif
+
+// low frequency group delay of a PT1 or 2nd order Butterworth lowpass, 0 if the filter is off
+STATIC_UNIT_TESTED float smithPredictorLowpassDelay(uint8_t type, uint16_t cutoffHz, float nyquistHz)
+{
+    if (cutoffHz == 0 || cutoffHz > nyquistHz) {
+        return 0.0f;
+    }
+    const float rc = 1.0f / (2.0f * M_PIf * cutoffHz);
+    return (type == FILTER_BIQUAD) ? 1.41421356f * rc : rc;
+}
+
+static float gyroFilterDelay(void)
+{
+    const float nyquistHz = 1e6f / (2.0f * gyro.targetLooptime);
+    uint16_t lowpassHz = gyroConfig()->gyro_lowpass_hz;
+#ifdef USE_DYN_LPF
+    if (gyroConfig()->dyn_lpf_gyro_min_hz > 0) {
+        lowpassHz = gyroConfig()->dyn_lpf_gyro_min_hz;
+    }
+#endif
+    return smithPredictorLowpassDelay(gyroConfig()->gyro_lowpass_type, lowpassHz, nyquistHz)
+        + smithPredictorLowpassDelay(gyroConfig()->gyro_lowpass2_type, gyroConfig()->gyro_lowpass2_hz, nyquistHz);
+}
+
+static float dtermFilterDelay(const pidProfile_t *pidProfile)
+{
+    const float nyquistHz = 0.5f / dT;
+    uint16_t lowpassHz = pidProfile->dterm_lowpass_hz;
+#ifdef USE_DYN_LPF
+    if (pidProfile->dyn_lpf_dterm_min_hz > 0) {
+        lowpassHz = pidProfile->dyn_lpf_dterm_min_hz;
+    }
+#endif
+    return smithPredictorLowpassDelay(pidProfile->dterm_filter_type, lowpassHz, nyquistHz)
+        + smithPredictorLowpassDelay(pidProfile->dterm_filter2_type, pidProfile->dterm_lowpass2_hz, nyquistHz);
+}
+
+static uint8_t delaySamples(float delayS)
+{
+    return constrain(lrintf(delayS / dT), 1, SMITH_PREDICTOR_MAX_DELAY_SAMPLES);
+}
+
+static void sumTorque(axisModel_t *axisModel)
+{
+    axisModel->ptermTorqueSum = 0.0f;
+    axisModel->dtermTorqueSum = 0.0f;
+    for (int i = 0; i < dtermDelaySamples; i++) {
+        const float torque = axisModel->torque[(torqueIndex - i) & DELAY_BUFFER_MASK];
+        if (i < ptermDelaySamples) {
+            axisModel->ptermTorqueSum += torque;
+        }
+        axisModel->dtermTorqueSum += torque;
+    }
+}
+
+static void resetState(void)
+{
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        motorModels[i].output = 0.0f;
+#ifdef USE_DSHOT_TELEMETRY
+        motorModels[i].commandSum = 0.0f;
+        motorModels[i].previousErpmValid = false;
+#endif
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        axisModel_t *axisModel = &axisModels[axis];
+        for (int i = 0; i < SMITH_PREDICTOR_MAX_DELAY_SAMPLES; i++) {
+            axisModel->torque[i] = 0.0f;
+        }
+        axisModel->ptermTorqueSum = 0.0f;
+        axisModel->dtermTorqueSum = 0.0f;
+        axisModel->ptermCorrection = 0.0f;
+        axisModel->dtermCorrection = 0.0f;
+        axisModel->previousGyroRate = gyro.gyroADCf[axis];
+        axisModel->accelerationLpf.state = 0.0f;
+        axisModel->torqueLpf.state = 0.0f;
+    }
+#ifdef USE_DSHOT_TELEMETRY
+    rpmSampleCount = 0;
+#endif
+    torqueIndex = 0;
+}
+
+void smithPredictorInit(const pidProfile_t *pidProfile)
+{
+    dT = pidGetDT();
+    strength = pidProfile->smith_predictor_strength / 100.0f;
+    defaultTimeConstant = constrainf(pidProfile->smith_predictor_motor_tau * 1e-3f, MOTOR_TIME_CONSTANT_MIN_S, MOTOR_TIME_CONSTANT_MAX_S);
+    gainAdaptationRate = dT / AXIS_GAIN_ADAPTATION_TIME_S;
+
+    const float gyroDelay = pidProfile->smith_predictor_delay ? pidProfile->smith_predictor_delay * 1e-4f : gyroFilterDelay();
+    ptermDelaySamples = delaySamples(gyroDelay);
+    dtermDelaySamples = delaySamples(gyroDelay + dtermFilterDelay(pidProfile));
+
+#ifdef USE_DSHOT_TELEMETRY
+    useRpmTelemetry = motorConfig()->dev.useDshotTelemetry;
+    rpmSampleInterval = constrain(lrintf(RPM_SAMPLE_INTERVAL_S / dT), 1, UINT8_MAX);
+#endif
+
+    // also called for in flight adjustments, so the model keeps running with the new delays
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        pt1FilterInit(&axisModels[axis].accelerationLpf, pt1FilterGain(AXIS_GAIN_LPF_HZ, dT));
+        pt1FilterInit(&axisModels[axis].torqueLpf, pt1FilterGain(AXIS_GAIN_LPF_HZ, dT));
+        sumTorque(&axisModels[axis]);
+    }
+    if (strength == 0.0f) {
+        resetState();
+        modelRunning = false;
+    }
+}
+
+static void setMotorTimeConstant(motorModel_t *model, motorDirection_e direction, float timeConstant)
+{
+    model->timeConstant[direction] = timeConstant;
+    model->responseGain[direction] = dT / (timeConstant + dT);
+}
+
+#ifdef USE_DSHOT_TELEMETRY
+static void motorResponseEstimatorInit(motorResponseEstimator_t *estimator, float timeConstant)
+{
+    for (int i = 0; i < RPM_ESTIMATOR_PARAMETERS; i++) {
+        estimator->theta[i] = 0.0f;
+        for (int j = 0; j < RPM_ESTIMATOR_PARAMETERS; j++) {
+            estimator->p[i][j] = (i == j) ? RPM_ESTIMATOR_COVARIANCE_INIT : 0.0f;
+        }
+    }
+    estimator->theta[0] = expf(-rpmSampleInterval * dT / timeConstant);
+}
+
+static void motorResponseEstimatorApply(motorResponseEstimator_t *estimator, const float x[RPM_ESTIMATOR_PARAMETERS], float y)
+{
+    float px[RPM_ESTIMATOR_PARAMETERS];
+    float trace = 0.0f;
+    float error = y;
+    for (int i = 0; i < RPM_ESTIMATOR_PARAMETERS; i++) {
+        px[i] = 0.0f;
+        for (int j = 0; j < RPM_ESTIMATOR_PARAMETERS; j++) {
+            px[i] += estimator->p[i][j] * x[j];
+        }
+        trace += estimator->p[i][i];
+        error -= estimator->theta[i] * x[i];
+    }
+    // stop forgetting when the covariance gets large, it winds up while a direction isn't excited
+    const float forgetting = (trace < RPM_ESTIMATOR_COVARIANCE_MAX) ? RPM_ESTIMATOR_FORGETTING : 1.0f;
+    float denominator = forgetting;
+    for (int i = 0; i < RPM_ESTIMATOR_PARAMETERS; i++) {
+        denominator += x[i] * px[i];
+    }
+
+    for (int i = 0; i < RPM_ESTIMATOR_PARAMETERS; i++) {
+        estimator->theta[i] += px[i] / denominator * error;
+        for (int j = 0; j < RPM_ESTIMATOR_PARAMETERS; j++) {
+            estimator->p[i][j] = (estimator->p[i][j] - px[i] * px[j] / denominator) / forgetting;
+        }
+    }
+}
+
+// called every RPM sample interval with the average command over the interval
+static void motorModelIdentify(motorModel_t *model, int motor)
+{
+    const float command = model->commandSum / rpmSampleInterval;
+    model->commandSum = 0.0f;
+
+    const uint16_t telemetry = isDshotMotorTelemetryActive(motor) ? getDshotTelemetry(motor) : 0;
+    if (telemetry == 0) {
+        model->previousErpmValid = false;
+        return;
+    }
+
+    if (!model->originValid) {
+        model->erpmOrigin = telemetry;
+        model->commandOrigin = command;
+        model->originValid = true;
+    }
+    const float erpm = telemetry - model->erpmOrigin;
+
+    if (model->previousErpmValid && fabsf(command - model->output) > RPM_MIN_RESPONSE) {
+        const motorDirection_e direction = (command > model->output) ? MOTOR_SPIN_UP : MOTOR_SPIN_DOWN;
+        motorResponseEstimator_t *estimator = &model->estimator[direction];
+        const float x[RPM_ESTIMATOR_PARAMETERS] = { model->previousErpm, command - model->commandOrigin, 1.0f };
+        motorResponseEstimatorApply(estimator, x, erpm);
+
+        const float sampleIntervalS = rpmSampleInterval * dT;
+        const float a = constrainf(estimator->theta[0],
+            expf(-sampleIntervalS / MOTOR_TIME_CONSTANT_MIN_S), expf(-sampleIntervalS / MOTOR_TIME_CONSTANT_MAX_S));
+        setMotorTimeConstant(model, direction, -sampleIntervalS / logf(a));
+    }
+
+    model->previousErpm = erpm;
+    model->previousErpmValid = true;
+}
+#endif
+
+// forget the identified motor time constants and axis gains
+void smithPredictorResetModel(void)
+{
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        motorModel_t *model = &motorModels[i];
+        for (int direction = 0; direction < MOTOR_DIRECTION_COUNT; direction++) {
+            setMotorTimeConstant(model, direction, defaultTimeConstant);
+#ifdef USE_DSHOT_TELEMETRY
+            motorResponseEstimatorInit(&model->estimator[direction], defaultTimeConstant);
+#endif
+        }
+#ifdef USE_DSHOT_TELEMETRY
+        model->originValid = false;
+#endif
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        axisModels[axis].gain = 0.0f;
+    }
+    modelRunning = false;
+}
+
+static void updateAxisGain(axisModel_t *axisModel, float gyroRate, float delayedTorque)
+{
+    const float acceleration = pt1FilterApply(&axisModel->accelerationLpf, (gyroRate - axisModel->previousGyroRate) / dT);
+    const float torque = pt1FilterApply(&axisModel->torqueLpf, delayedTorque);
+    axisModel->previousGyroRate = gyroRate;
+
+    if (fabsf(torque) > AXIS_GAIN_MIN_TORQUE) {
+        const float error = acceleration - axisModel->gain * torque;
+        axisModel->gain += gainAdaptationRate * error * torque / (sq(torque) + sq(AXIS_GAIN_MIN_TORQUE));
+        axisModel->gain = constrainf(axisModel->gain, -AXIS_GAIN_MAX, AXIS_GAIN_MAX);
+    }
+}
+
+FAST_CODE_NOINLINE void smithPredictorUpdate(void)
+{
+    if (strength == 0.0f) {
+        return;
+    }
+    if (!ARMING_FLAG(ARMED)) {
+        if (modelRunning) {
+            resetState();
+            modelRunning = false;
+        }
+        return;
+    }
+    if (!modelRunning) {
+        resetState();
+        modelRunning = true;
+    }
+
+    const int motorCount = getMotorCount();
+    const motorMixer_t *motorMix = mixerGetMotorMix();
+    const float outputScale = 1.0f / (motorOutputHigh - motorOutputLow);
+    float torque[XYZ_AXIS_COUNT] = { 0 };
+
+    for (int i = 0; i < motorCount; i++) {
+        motorModel_t *model = &motorModels[i];
+        const float command = constrainf((motor[i] - motorOutputLow) * outputScale, 0.0f, 1.0f);
+        const motorDirection_e direction = (command > model->output) ? MOTOR_SPIN_UP : MOTOR_SPIN_DOWN;
+        model->output += model->responseGain[direction] * (command - model->output);
+
+        torque[FD_ROLL] += motorMix[i].roll * model->output;
+        torque[FD_PITCH] += motorMix[i].pitch * model->output;
+        torque[FD_YAW] += motorMix[i].yaw * model->output;
+#ifdef USE_DSHOT_TELEMETRY
+        model->commandSum += command;
+#endif
+    }
+
+#ifdef USE_DSHOT_TELEMETRY
+    if (++rpmSampleCount >= rpmSampleInterval) {
+        rpmSampleCount = 0;
+        if (useRpmTelemetry) {
+            for (int i = 0; i < motorCount; i++) {
+                motorModelIdentify(&motorModels[i], i);
+            }
+        } else {
+            for (int i = 0; i < motorCount; i++) {
+                motorModels[i].commandSum = 0.0f;
+            }
+        }
+    }
+#endif
+
+    torqueIndex = (torqueIndex + 1) & DELAY_BUFFER_MASK;
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        axisModel_t *axisModel = &axisModels[axis];
+        // the torque that leaves the prediction horizon is the one the filtered gyro shows now
+        const float ptermDelayedTorque = axisModel->torque[(torqueIndex - ptermDelaySamples) & DELAY_BUFFER_MASK];
+        const float dtermDelayedTorque = axisModel->torque[(torqueIndex - dtermDelaySamples) & DELAY_BUFFER_MASK];
+
+        updateAxisGain(axisModel, gyro.gyroADCf[axis], ptermDelayedTorque);
+
+        axisModel->torque[torqueIndex] = torque[axis];
+        if (torqueIndex == 0) {
+            // sum again once per buffer so the running sums don't accumulate rounding errors
+            sumTorque(axisModel);
+        } else {
+            axisModel->ptermTorqueSum += torque[axis] - ptermDelayedTorque;
+            axisModel->dtermTorqueSum += torque[axis] - dtermDelayedTorque;
+        }
+
+        const float rateChangePerTorque = strength * axisModel->gain * dT;
+        axisModel->ptermCorrection = rateChangePerTorque * axisModel->ptermTorqueSum;
+        axisModel->dtermCorrection = rateChangePerTorque * axisModel->dtermTorqueSum;
+    }
+
+    DEBUG_SET(DEBUG_SMITH_PREDICTOR, 0, lrintf(axisModels[FD_ROLL].ptermCorrection));
+    DEBUG_SET(DEBUG_SMITH_PREDICTOR, 1, lrintf(axisModels[FD_ROLL].gain / 10.0f));
+    DEBUG_SET(DEBUG_SMITH_PREDICTOR, 2, lrintf(motorModels[0].timeConstant[MOTOR_SPIN_UP] * 1e4f));
+    DEBUG_SET(DEBUG_SMITH_PREDICTOR, 3, lrintf(motorModels[0].timeConstant[MOTOR_SPIN_DOWN] * 1e4f));
+}
+
+// rate change in deg/s that the filtered gyro doesn't show yet
+float smithPredictorPtermCorrection(int axis)
+{
+    return axisModels[axis].ptermCorrection;
+}
+
+// as above, over the delay of the gyro and the D term filters
+float smithPredictorDtermCorrection(int axis)
+{
+    return axisModels[axis].dtermCorrection;
+}
+
+float smithPredictorGetMotorTimeConstant(int motor, bool spinUp)
+{
+    return motorModels[motor].timeConstant[spinUp ? MOTOR_SPIN_UP : MOTOR_SPIN_DOWN];
+}
+
+float smithPredictorGetAxisGain(int axis)
+{
+    return axisModels[axis].gain;
+}
+
+#ifdef UNIT_TEST
+uint8_t smithPredictorGetDelaySamples(bool dterm)
+{
+    return dterm ? dtermDelaySamples : ptermDelaySamples;
+}
+#endif
+
+#endif // USE_SMITH_PREDICTOR
@@ -0,0 +1,42 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "flight/pid.h"
+
+// power of 2, the longest prediction in PID loops. Holds the 10ms maximum of smith_predictor_delay
+// at 8kHz with room for the D term filter delay on top.
+#define SMITH_PREDICTOR_MAX_DELAY_SAMPLES 128
+
+void smithPredictorInit(const pidProfile_t *pidProfile);
+void smithPredictorResetModel(void);
+void smithPredictorUpdate(void);
+float smithPredictorPtermCorrection(int axis);
+float smithPredictorDtermCorrection(int axis);
+float smithPredictorGetMotorTimeConstant(int motor, bool spinUp);
+float smithPredictorGetAxisGain(int axis);
+
+#ifdef UNIT_TEST
+float smithPredictorLowpassDelay(uint8_t type, uint16_t cutoffHz, float nyquistHz);
+uint8_t smithPredictorGetDelaySamples(bool dterm);
+#endif
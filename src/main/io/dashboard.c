@@ -75,6 +75,7 @@
 
 #define MICROSECONDS_IN_A_SECOND (1000 * 1000)
 
+// The task runs faster than this to flush the rendered pages to the display one page at a time
 #define DISPLAY_UPDATE_FREQUENCY (MICROSECONDS_IN_A_SECOND / 5)
 #define PAGE_CYCLE_FREQUENCY (MICROSECONDS_IN_A_SECOND * 5)
 
@@ -615,6 +616,11 @@ void dashboardUpdate(timeUs_t currentTimeUs)
 {
     static uint8_t previousArmedState = 0;
 
+    // Also flushes what the CMS has drawn, as it shares the framebuffer
+    if (dashboardPresent) {
+        i2c_OLED_flush(bus);
+    }
+
 #ifdef USE_CMS
     if (displayIsGrabbed(displayPort)) {
         return;
@@ -50,7 +50,7 @@ static int oledClearScreen(displayPort_t *displayPort)
 
 static int oledDrawScreen(displayPort_t *displayPort)
 {
-    UNUSED(displayPort);
+    i2c_OLED_flush(displayPort->device);
     return 0;
 }
 
@@ -34,6 +34,7 @@
 #include "common/axis.h"
 #include "common/gps_conversion.h"
 #include "common/maths.h"
+#include "common/topic.h"
 #include "common/utils.h"
 
 #include "config/feature.h"
@@ -85,6 +86,7 @@ int16_t nav_takeoff_bearing;
 #define GPS_DISTANCE_FLOWN_MIN_SPEED_THRESHOLD_CM_S 15 // 5.4Km/h 3.35mph
 
 gpsSolutionData_t gpsSol;
+TOPIC_DEFINE(gpsSolutionData_t, gpsSol, &gpsSol);
 uint32_t GPS_packetCount = 0;
 uint32_t GPS_svInfoReceivedCount = 0; // SV = Space Vehicle, counter increments each time SV info is received.
 uint8_t GPS_update = 0;             // toogle to distinct a GPS position update (directly or via MSP)
@@ -1580,9 +1582,7 @@ void onGpsNewData(void)
         GPS_calculateDistanceFlownVerticalSpeed(false);
     }
 
-#ifdef USE_GPS_RESCUE
-    rescueNewGpsData();
-#endif
+    topicPublish(&gpsSolTopic, micros());
 }
 
 #endif
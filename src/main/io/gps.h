@@ -22,6 +22,7 @@
 
 #include "common/axis.h"
 #include "common/time.h"
+#include "common/topic.h"
 
 #include "pg/pg.h"
 
@@ -166,6 +167,9 @@ typedef enum {
 extern gpsData_t gpsData;
 extern gpsSolutionData_t gpsSol;
 
+// published for every navigation solution with a fix and at least 5 satellites
+TOPIC_DECLARE(gpsSolutionData_t, gpsSol);
+
 extern uint8_t GPS_update;       // toogle to distinct a GPS position update (directly or via MSP)
 extern uint32_t GPS_packetCount;
 extern uint32_t GPS_svInfoReceivedCount;
@@ -64,13 +64,55 @@ static uint8_t runcamDeviceGetRespLen(uint8_t command)
     return 0;
 }
 
-static bool rcdeviceRespCtxQueuePush(rcdeviceWaitingResponseQueue *queue, rcdeviceResponseParseContext_t *respCtx)
+// the time to wait for a response, derived from the measured response time of
+// the device and bounded by the timeout of the request
+static timeMs_t runcamDeviceResponseTimeout(const rcdeviceResponseParseContext_t *ctx)
+{
+    const runcamDevice_t *device = ctx->device;
+    if (!device->isResponseTimeMeasured) {
+        return ctx->timeout;
+    }
+
+    // twice the average response time, plus some margin for the serial latency
+    const timeMs_t timeout = (device->responseTimeAvgX8 >> 2) + RCDEVICE_RESPONSE_TIMEOUT_MARGIN_MS;
+    return MIN(MAX(timeout, RCDEVICE_MIN_RESPONSE_TIMEOUT_MS), ctx->timeout);
+}
+
+// called when the request reaches the head of the queue, the device answers in order
+static void runcamDeviceStartWaiting(rcdeviceResponseParseContext_t *ctx, timeMs_t currentTimeMs)
+{
+    ctx->startTimestamp = currentTimeMs;
+    ctx->timeoutTimestamp = ctx->timeout ? currentTimeMs + runcamDeviceResponseTimeout(ctx) : 0;
+}
+
+static void runcamDeviceUpdateResponseTime(const rcdeviceResponseParseContext_t *ctx, timeMs_t currentTimeMs)
+{
+    // a response to a retransmitted request can't be related to one of the transmissions
+    if (ctx->isRetransmitted) {
+        return;
+    }
+
+    runcamDevice_t *device = ctx->device;
+    const uint16_t responseTimeMs = MIN(currentTimeMs - ctx->startTimestamp, (timeMs_t)UINT16_MAX >> 3);
+    if (device->isResponseTimeMeasured) {
+        device->responseTimeAvgX8 += responseTimeMs - (device->responseTimeAvgX8 >> 3);
+    } else {
+        device->responseTimeAvgX8 = responseTimeMs << 3;
+        device->isResponseTimeMeasured = true;
+    }
+}
+
+static bool rcdeviceRespCtxQueuePush(rcdeviceWaitingResponseQueue *queue, rcdeviceResponseParseContext_t *respCtx, timeMs_t currentTimeMs)
 {
     if (queue == NULL || (queue->itemCount + 1) > MAX_WAITING_RESPONSES) {
         return false;
     }
 
-    queue->buffer[queue->tailPos] = *respCtx;
+    rcdeviceResponseParseContext_t *ctx = &queue->buffer[queue->tailPos];
+    *ctx = *respCtx;
+    if (queue->itemCount == 0) {
+        runcamDeviceStartWaiting(ctx, currentTimeMs);
+    }
 
     int newTailPos = queue->tailPos + 1;
     if (newTailPos >= MAX_WAITING_RESPONSES) {
@@ -109,6 +151,17 @@ STATIC_UNIT_TESTED rcdeviceResponseParseContext_t* rcdeviceRespCtxQueueShift(rcd
     return ctx;
 }
 
+// remove the head of the queue, and start waiting for the response of the next request
+static void rcdeviceRespCtxQueueAdvance(rcdeviceWaitingResponseQueue *queue, timeMs_t currentTimeMs)
+{
+    rcdeviceRespCtxQueueShift(queue);
+
+    rcdeviceResponseParseContext_t *ctx = rcdeviceRespCtxQueuePeekFront(queue);
+    if (ctx != NULL) {
+        runcamDeviceStartWaiting(ctx, currentTimeMs);
+    }
+}
+
 // every time send packet to device, and want to get something from device,
 // it'd better call the method to clear the rx buffer before the packet send,
 // else may be the useless data in rx buffer will cause the response decoding
@@ -120,8 +173,33 @@ static void runcamDeviceFlushRxBuffer(runcamDevice_t *device)
     }
 }
 
+// append a packet to the buffer, several packets can be sent in one burst
+static void runcamDeviceWritePacket(sbuf_t *buf, uint8_t command, const uint8_t *paramData, int paramDataLen)
+{
+    uint8_t *packet = sbufPtr(buf);
+
+    sbufWriteU8(buf, RCDEVICE_PROTOCOL_HEADER);
+    sbufWriteU8(buf, command);
+
+    if (paramData) {
+        sbufWriteData(buf, paramData, paramDataLen);
+    }
+
+    // add crc over (all) data of the packet
+    sbufWriteU8(buf, crc8_dvb_s2_update(0, packet, sbufPtr(buf) - packet));
+}
+
+static void runcamDeviceWriteBuffer(runcamDevice_t *device, sbuf_t *buf)
+{
+    // switch to reader
+    sbufSwitchToReader(buf, device->buffer);
+
+    // send data if possible
+    serialWriteBuf(device->serialPort, sbufPtr(buf), sbufBytesRemaining(buf));
+}
+
 // a common way to send packet to device
-static void runcamDeviceSendPacket(runcamDevice_t *device, uint8_t command, uint8_t *paramData, int paramDataLen)
+static void runcamDeviceSendPacket(runcamDevice_t *device, uint8_t command, const uint8_t *paramData, int paramDataLen)
 {
     // is this device open?
     if (!device->serialPort) {
@@ -133,46 +211,42 @@ static void runcamDeviceSendPacket(runcamDevice_t *device, uint8_t command, uint
     buf.ptr = device->buffer;
     buf.end = ARRAYEND(device->buffer);
 
-    sbufWriteU8(&buf, RCDEVICE_PROTOCOL_HEADER);
-    sbufWriteU8(&buf, command);
+    runcamDeviceWritePacket(&buf, command, paramData, paramDataLen);
+    runcamDeviceWriteBuffer(device, &buf);
+}
 
-    if (paramData) {
-        sbufWriteData(&buf, paramData, paramDataLen);
+static void runcamDeviceInitRequest(rcdeviceResponseParseContext_t *responseCtx, runcamDevice_t *device, uint8_t commandID, const uint8_t *paramData, uint8_t paramDataLen, timeMs_t tiemout, int maxRetryTimes, void *userInfo, rcdeviceRespParseFunc parseFunc)
+{
+    memset(responseCtx, 0, sizeof(rcdeviceResponseParseContext_t));
+    responseCtx->recvBuf = recvBuf;
+    responseCtx->command = commandID;
+    responseCtx->maxRetryTimes = maxRetryTimes;
+    responseCtx->expectedRespLen = runcamDeviceGetRespLen(commandID);
+    responseCtx->timeout = tiemout;
+    responseCtx->parserFunc = parseFunc;
+    responseCtx->device = device;
+    responseCtx->protocolVersion = RCDEVICE_PROTOCOL_VERSION_1_0;
+    if (paramData != NULL) {
+        memcpy(responseCtx->paramData, paramData, paramDataLen);
+        responseCtx->paramDataLen = paramDataLen;
     }
 
-    // add crc over (all) data
-    crc8_dvb_s2_sbuf_append(&buf, device->buffer);
-
-    // switch to reader
-    sbufSwitchToReader(&buf, device->buffer);
-
-    // send data if possible
-    serialWriteBuf(device->serialPort, sbufPtr(&buf), sbufBytesRemaining(&buf));
+    responseCtx->userInfo = userInfo;
 }
 
 // a common way to send a packet to device, and get response from the device.
+// the request is sent right away, the responses are matched to the requests
+// in the order they were sent.
 static void runcamDeviceSendRequestAndWaitingResp(runcamDevice_t *device, uint8_t commandID, uint8_t *paramData, uint8_t paramDataLen, timeMs_t tiemout, int maxRetryTimes, void *userInfo, rcdeviceRespParseFunc parseFunc)
 {
-    runcamDeviceFlushRxBuffer(device);
-
-    rcdeviceResponseParseContext_t responseCtx;
-    memset(&responseCtx, 0, sizeof(rcdeviceResponseParseContext_t));
-    responseCtx.recvBuf = recvBuf;
-    responseCtx.command = commandID;
-    responseCtx.maxRetryTimes = maxRetryTimes;
-    responseCtx.expectedRespLen = runcamDeviceGetRespLen(commandID);
-    responseCtx.timeout = tiemout;
-    responseCtx.timeoutTimestamp = millis() + tiemout;
-    responseCtx.parserFunc = parseFunc;
-    responseCtx.device = device;
-    responseCtx.protocolVersion = RCDEVICE_PROTOCOL_VERSION_1_0;
-    if (paramData != NULL) {
-        memcpy(responseCtx.paramData, paramData, paramDataLen);
-        responseCtx.paramDataLen = paramDataLen;
+    // anything received while no request is pending is stale
+    if (waitingResponseQueue.itemCount == 0) {
+        runcamDeviceFlushRxBuffer(device);
     }
 
-    responseCtx.userInfo = userInfo;
-    if (rcdeviceRespCtxQueuePush(&waitingResponseQueue, &responseCtx)) {
+    rcdeviceResponseParseContext_t responseCtx;
+    runcamDeviceInitRequest(&responseCtx, device, commandID, paramData, paramDataLen, tiemout, maxRetryTimes, userInfo, parseFunc);
+    if (rcdeviceRespCtxQueuePush(&waitingResponseQueue, &responseCtx, millis())) {
         // send packet
         runcamDeviceSendPacket(device, commandID, paramData, paramDataLen);
     }
@@ -190,21 +264,6 @@ static void runcamDeviceParseV1DeviceInfo(rcdeviceResponseParseContext_t *ctx)
     device->isReady = true;
 }
 
-static uint8_t crc8HighFirst(uint8_t *ptr, uint8_t len)
-{
-    uint8_t crc = 0x00;
-    while (len--) {
-        crc ^= *ptr++;
-        for (unsigned i = 8; i > 0; --i) {
-            if (crc & 0x80)
-                crc = (crc << 1) ^ 0x31;
-            else
-                crc = (crc << 1);
-        }
-    }
-    return (crc);
-}
-
 // for the rcsplits that firmware <= 1.1.0
 static void runcamSplitSendCommand(runcamDevice_t *device, uint8_t argument)
 {
@@ -219,7 +278,7 @@ static void runcamSplitSendCommand(runcamDevice_t *device, uint8_t argument)
     uart_buffer[1] = RCSPLIT_PACKET_CMD_CTRL;
     uart_buffer[2] = argument;
     uart_buffer[3] = RCSPLIT_PACKET_TAIL;
-    crc = crc8HighFirst(uart_buffer, 4);
+    crc = crc8_poly_0x31_update(0, uart_buffer, 4);
 
     // build up a full request [header]+[command]+[argument]+[crc]+[tail]
     uart_buffer[3] = crc;
@@ -241,11 +300,10 @@ static void runcamDeviceParseV2DeviceInfo(rcdeviceResponseParseContext_t *ctx)
         responseCtx.maxRetryTimes = rcdeviceConfig()->initDeviceAttempts;
         responseCtx.expectedRespLen = 5;
         responseCtx.timeout = rcdeviceConfig()->initDeviceAttemptInterval;
-        responseCtx.timeoutTimestamp = millis() + rcdeviceConfig()->initDeviceAttemptInterval;
         responseCtx.parserFunc = runcamDeviceParseV1DeviceInfo;
         responseCtx.device = ctx->device;
         responseCtx.protocolVersion = RCDEVICE_PROTOCOL_RCSPLIT_VERSION;
-        rcdeviceRespCtxQueuePush(&waitingResponseQueue, &responseCtx);
+        rcdeviceRespCtxQueuePush(&waitingResponseQueue, &responseCtx, millis());
 
         runcamSplitSendCommand(ctx->device, 0xFF);
         return;
@@ -271,6 +329,8 @@ static void runcamDeviceGetDeviceInfo(runcamDevice_t *device)
 void runcamDeviceInit(runcamDevice_t *device)
 {
     device->isReady = false;
+    device->isResponseTimeMeasured = false;
+    device->responseTimeAvgX8 = 0;
     serialPortFunction_e portID = FUNCTION_RCDEVICE;
     const serialPortConfig_t *portConfig = findSerialPortConfig(portID);
     if (portConfig != NULL) {
@@ -327,18 +387,78 @@ void runcamDeviceSimulate5KeyOSDCableButtonRelease(runcamDevice_t *device, rcdev
     runcamDeviceSendRequestAndWaitingResp(device, RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_RELEASE, NULL, 0, 400, 2, NULL, parseFunc);
 }
 
+// simulate a sequence of button clicks of 5 key osd cable, the press and
+// release packets of all the clicks are sent in one burst without waiting for
+// the responses in between. returns the number of clicks that were sent, it's
+// less than count if the waiting queue or the packet buffer is full.
+uint8_t runcamDeviceSimulate5KeyOSDCableButtonSequence(runcamDevice_t *device, const uint8_t *operations, uint8_t count, rcdeviceRespParseFunc parseFunc)
+{
+    if (!device->serialPort) {
+        return 0;
+    }
+
+    if (waitingResponseQueue.itemCount == 0) {
+        runcamDeviceFlushRxBuffer(device);
+    }
+
+    sbuf_t buf;
+    buf.ptr = device->buffer;
+    buf.end = ARRAYEND(device->buffer);
+
+    const timeMs_t currentTimeMs = millis();
+    uint8_t clickCount = 0;
+    while (clickCount < count) {
+        const uint8_t operation = operations[clickCount];
+        // header, command, operation and crc of the press, header, command and crc of the release
+        const int clickPacketsSize = 7;
+        if (operation == RCDEVICE_PROTOCOL_5KEY_SIMULATION_NONE || waitingResponseQueue.itemCount + 2 > MAX_WAITING_RESPONSES || sbufBytesRemaining(&buf) < clickPacketsSize) {
+            break;
+        }
+
+        rcdeviceResponseParseContext_t responseCtx;
+        runcamDeviceInitRequest(&responseCtx, device, RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_PRESS, &operation, sizeof(uint8_t), 400, 2, NULL, parseFunc);
+        rcdeviceRespCtxQueuePush(&waitingResponseQueue, &responseCtx, currentTimeMs);
+        runcamDeviceWritePacket(&buf, RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_PRESS, &operation, sizeof(uint8_t));
+
+        runcamDeviceInitRequest(&responseCtx, device, RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_RELEASE, NULL, 0, 400, 2, NULL, parseFunc);
+        rcdeviceRespCtxQueuePush(&waitingResponseQueue, &responseCtx, currentTimeMs);
+        runcamDeviceWritePacket(&buf, RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_RELEASE, NULL, 0);
+
+        clickCount++;
+    }
+
+    if (clickCount > 0) {
+        runcamDeviceWriteBuffer(device, &buf);
+    }
+
+    return clickCount;
+}
+
+static void runcamDeviceResendRequest(rcdeviceResponseParseContext_t *ctx)
+{
+    if (ctx->protocolVersion == RCDEVICE_PROTOCOL_VERSION_1_0) {
+        runcamDeviceSendPacket(ctx->device, ctx->command, ctx->paramData, ctx->paramDataLen);
+    } else if (ctx->protocolVersion == RCDEVICE_PROTOCOL_RCSPLIT_VERSION) {
+        runcamSplitSendCommand(ctx->device, ctx->command);
+    }
+
+    ctx->recvRespLen = 0;
+    ctx->isRetransmitted = true;
+}
+
 static rcdeviceResponseParseContext_t* getWaitingResponse(timeMs_t currentTimeMs)
 {
     rcdeviceResponseParseContext_t *respCtx = rcdeviceRespCtxQueuePeekFront(&waitingResponseQueue);
     while (respCtx != NULL && respCtx->timeoutTimestamp != 0 && currentTimeMs > respCtx->timeoutTimestamp) {
         if (respCtx->maxRetryTimes > 0) {
-            if (respCtx->protocolVersion == RCDEVICE_PROTOCOL_VERSION_1_0) {
-                runcamDeviceSendPacket(respCtx->device, respCtx->command, respCtx->paramData, respCtx->paramDataLen);
-            } else if (respCtx->protocolVersion == RCDEVICE_PROTOCOL_RCSPLIT_VERSION) {
-                runcamSplitSendCommand(respCtx->device, respCtx->command);
+            // the responses are matched by their order, so once one is missing
+            // the requests behind it have to be sent again as well
+            runcamDeviceFlushRxBuffer(respCtx->device);
+            for (unsigned i = 0; i < waitingResponseQueue.itemCount; i++) {
+                runcamDeviceResendRequest(&waitingResponseQueue.buffer[(waitingResponseQueue.headPos + i) % MAX_WAITING_RESPONSES]);
             }
 
-            respCtx->recvRespLen = 0;
+            respCtx->startTimestamp = currentTimeMs;
             respCtx->timeoutTimestamp = currentTimeMs + respCtx->timeout;
             respCtx->maxRetryTimes -= 1;
             respCtx = NULL;
@@ -350,7 +470,7 @@ static rcdeviceResponseParseContext_t* getWaitingResponse(timeMs_t currentTimeMs
             }
 
             // dequeue and get next waiting response context
-            rcdeviceRespCtxQueueShift(&waitingResponseQueue);
+            rcdeviceRespCtxQueueAdvance(&waitingResponseQueue, currentTimeMs);
             respCtx = rcdeviceRespCtxQueuePeekFront(&waitingResponseQueue);
         }
     }
@@ -362,13 +482,19 @@ void rcdeviceReceive(timeUs_t currentTimeUs)
 {
     UNUSED(currentTimeUs);
 
+    const timeMs_t currentTimeMs = millis();
     rcdeviceResponseParseContext_t *respCtx = NULL;
-    while ((respCtx = getWaitingResponse(millis())) != NULL) {
+    while ((respCtx = getWaitingResponse(currentTimeMs)) != NULL) {
         if (!serialRxBytesWaiting(respCtx->device->serialPort)) {
             break;
         }
 
         const uint8_t c = serialRead(respCtx->device->serialPort);
+        if (respCtx->recvRespLen >= respCtx->expectedRespLen) {
+            // a broken response was received, discard everything until the request is retransmitted
+            continue;
+        }
+
         if (respCtx->recvRespLen == 0) {
             // Only start receiving packet when we found a header
             if ((respCtx->protocolVersion == RCDEVICE_PROTOCOL_VERSION_1_0 && c != RCDEVICE_PROTOCOL_HEADER) || (respCtx->protocolVersion == RCDEVICE_PROTOCOL_RCSPLIT_VERSION && c != RCSPLIT_PACKET_HEADER)) {
@@ -382,17 +508,13 @@ void rcdeviceReceive(timeUs_t currentTimeUs)
         // if data received done, trigger callback to parse response data, and update rcdevice state
         if (respCtx->recvRespLen == respCtx->expectedRespLen) {
             if (respCtx->protocolVersion == RCDEVICE_PROTOCOL_VERSION_1_0) {
-                uint8_t crc = 0;
-                for (int i = 0; i < respCtx->recvRespLen; i++) {
-                    crc = crc8_dvb_s2(crc, respCtx->recvBuf[i]);
-                }
-
+                const uint8_t crc = crc8_dvb_s2_update(0, respCtx->recvBuf, respCtx->recvRespLen);
                 respCtx->result = (crc == 0) ? RCDEVICE_RESP_SUCCESS : RCDEVICE_RESP_INCORRECT_CRC;
             } else if (respCtx->protocolVersion == RCDEVICE_PROTOCOL_RCSPLIT_VERSION) {
                 if (respCtx->recvBuf[0] == RCSPLIT_PACKET_HEADER && respCtx->recvBuf[1] == RCSPLIT_PACKET_CMD_CTRL && respCtx->recvBuf[2] == 0xFF && respCtx->recvBuf[4] == RCSPLIT_PACKET_TAIL) {
                     uint8_t crcFromPacket = respCtx->recvBuf[3];
                     respCtx->recvBuf[3] = respCtx->recvBuf[4]; // move packet tail field to crc field, and calc crc with first 4 bytes
-                    uint8_t crc = crc8HighFirst(respCtx->recvBuf, 4);
+                    uint8_t crc = crc8_poly_0x31_update(0, respCtx->recvBuf, 4);
 
                     respCtx->result = crc == crcFromPacket ? RCDEVICE_RESP_SUCCESS : RCDEVICE_RESP_INCORRECT_CRC;
                 } else {
@@ -400,12 +522,16 @@ void rcdeviceReceive(timeUs_t currentTimeUs)
                 }
             }
 
+            if (respCtx->result == RCDEVICE_RESP_SUCCESS) {
+                runcamDeviceUpdateResponseTime(respCtx, currentTimeMs);
+            }
+
             if (respCtx->parserFunc != NULL) {
                 respCtx->parserFunc(respCtx);
             }
 
             if (respCtx->result == RCDEVICE_RESP_SUCCESS) {
-                rcdeviceRespCtxQueueShift(&waitingResponseQueue);
+                rcdeviceRespCtxQueueAdvance(&waitingResponseQueue, currentTimeMs);
             }
         }
     }
@@ -113,9 +113,15 @@ typedef struct runcamDevice_s {
     uint8_t buffer[RCDEVICE_PROTOCOL_MAX_PACKET_SIZE];
     runcamDeviceInfo_t info;
     bool isReady;
+    bool isResponseTimeMeasured;
+    uint16_t responseTimeAvgX8; // smoothed response time of the device in ms, scaled by 8
 } runcamDevice_t;
 
-#define MAX_WAITING_RESPONSES 1
+#define MAX_WAITING_RESPONSES 8
+
+// limits of the response timeout derived from the measured response time
+#define RCDEVICE_MIN_RESPONSE_TIMEOUT_MS 50U
+#define RCDEVICE_RESPONSE_TIMEOUT_MARGIN_MS 20U
 
 typedef enum {
     RCDEVICE_RESP_SUCCESS = 0,
@@ -130,7 +136,8 @@ struct rcdeviceResponseParseContext_s {
     uint8_t expectedRespLen; // total length of response data
     uint8_t recvRespLen; // length of the data received
     uint8_t *recvBuf; // response data buffer
-    timeMs_t timeout;
+    timeMs_t timeout; // upper bound of the time to wait for the response
+    timeMs_t startTimestamp; // when the request became the head of the queue
     timeMs_t timeoutTimestamp; // if zero, it's means keep waiting for the response
     rcdeviceRespParseFunc parserFunc;
     runcamDevice_t *device;
@@ -138,6 +145,7 @@ struct rcdeviceResponseParseContext_s {
     uint8_t paramDataLen;
     uint8_t protocolVersion;
     int maxRetryTimes;
+    bool isRetransmitted;
     void *userInfo;
     rcdeviceResponseStatus_e result;
 };
@@ -160,4 +168,5 @@ bool runcamDeviceSimulateCameraButton(runcamDevice_t *device, uint8_t operation)
 void runcamDeviceOpen5KeyOSDCableConnection(runcamDevice_t *device, rcdeviceRespParseFunc parseFunc);
 void runcamDeviceClose5KeyOSDCableConnection(runcamDevice_t *device, rcdeviceRespParseFunc parseFunc);
 void runcamDeviceSimulate5KeyOSDCableButtonPress(runcamDevice_t *device, uint8_t operation, rcdeviceRespParseFunc parseFunc);
-void runcamDeviceSimulate5KeyOSDCableButtonRelease(runcamDevice_t *device, rcdeviceRespParseFunc parseFunc);
\ No newline at end of file
+void runcamDeviceSimulate5KeyOSDCableButtonRelease(runcamDevice_t *device, rcdeviceRespParseFunc parseFunc);
+uint8_t runcamDeviceSimulate5KeyOSDCableButtonSequence(runcamDevice_t *device, const uint8_t *operations, uint8_t count, rcdeviceRespParseFunc parseFunc);
@@ -53,6 +53,7 @@ rcdeviceSwitchState_t switchStates[BOXCAMERA3 - BOXCAMERA1 + 1];
 bool rcdeviceInMenu = false;
 bool isButtonPressed = false;
 bool waitingDeviceResponse = false;
+static bool waitingSticksCentered = false;
 
 
 static bool isFeatureSupported(uint8_t feature)
@@ -173,7 +174,17 @@ static void rcdeviceSimulationRespHandle(rcdeviceResponseParseContext_t *ctx)
     waitingDeviceResponse = false;
 }
 
-static void rcdeviceCamSimulate5KeyCablePress(rcdeviceCamSimulationKeyEvent_e key)
+// a click is the press and the release of the key, their responses are not
+// waited for, so the camera OSD can be navigated as fast as the sticks move
+static void rcdeviceSimulationClickRespHandle(rcdeviceResponseParseContext_t *ctx)
+{
+    if (ctx->result == RCDEVICE_RESP_TIMEOUT && ctx->command == RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_RELEASE) {
+        // the button may still be pressed, release it again when the sticks are centered
+        isButtonPressed = true;
+    }
+}
+
+static uint8_t rcdeviceCamKeyToOperation(rcdeviceCamSimulationKeyEvent_e key)
 {
     uint8_t operation = RCDEVICE_PROTOCOL_5KEY_SIMULATION_NONE;
     switch (key) {
@@ -198,7 +209,18 @@ static void rcdeviceCamSimulate5KeyCablePress(rcdeviceCamSimulationKeyEvent_e ke
         break;
     }
 
-    runcamDeviceSimulate5KeyOSDCableButtonPress(camDevice, operation, rcdeviceSimulationRespHandle);
+    return operation;
+}
+
+static void rcdeviceCamSimulate5KeyCablePress(rcdeviceCamSimulationKeyEvent_e key)
+{
+    runcamDeviceSimulate5KeyOSDCableButtonPress(camDevice, rcdeviceCamKeyToOperation(key), rcdeviceSimulationRespHandle);
+}
+
+static bool rcdeviceCamSimulate5KeyCableClick(rcdeviceCamSimulationKeyEvent_e key)
+{
+    const uint8_t operation = rcdeviceCamKeyToOperation(key);
+    return runcamDeviceSimulate5KeyOSDCableButtonSequence(camDevice, &operation, 1, rcdeviceSimulationClickRespHandle) == 1;
 }
 
 void rcdeviceSend5KeyOSDCableSimualtionEvent(rcdeviceCamSimulationKeyEvent_e key)
@@ -245,6 +267,11 @@ static void rcdevice5KeySimulationProcess(timeUs_t currentTimeUs)
             rcdeviceSend5KeyOSDCableSimualtionEvent(RCDEVICE_CAM_KEY_RELEASE);
             waitingDeviceResponse = true;
         }
+    } else if (waitingSticksCentered) {
+        // one click per stick movement
+        if (IS_MID(YAW) && IS_MID(PITCH) && IS_MID(ROLL)) {
+            waitingSticksCentered = false;
+        }
     } else {
         if (waitingDeviceResponse) {
             return;
@@ -276,7 +303,14 @@ static void rcdevice5KeySimulationProcess(timeUs_t currentTimeUs)
             }
         }
 
-        if (key != RCDEVICE_CAM_KEY_NONE) {
+        if (key == RCDEVICE_CAM_KEY_NONE) {
+            return;
+        }
+
+        if (key != RCDEVICE_CAM_KEY_CONNECTION_OPEN && key != RCDEVICE_CAM_KEY_CONNECTION_CLOSE) {
+            // if the click can't be queued now it's tried again on the next update
+            waitingSticksCentered = rcdeviceCamSimulate5KeyCableClick(key);
+        } else {
             rcdeviceSend5KeyOSDCableSimualtionEvent(key);
             isButtonPressed = true;
             waitingDeviceResponse = true;
@@ -28,6 +28,7 @@
 
 #include "cli/cli.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/time.h"
@@ -532,10 +533,77 @@ static void nopConsumer(uint8_t data)
     UNUSED(data);
 }
 
+// Escape sequence to leave the passthrough, the characters are sent by the host
+// after a pause of the guard time and followed by another pause.
+// https://en.wikipedia.org/wiki/Escape_sequence#Modem_control
+#define PASSTHROUGH_ESCAPE_CHAR         '+'
+#define PASSTHROUGH_ESCAPE_COUNT        3
+#define PASSTHROUGH_ESCAPE_GUARD_MS     1000
+
+#define PASSTHROUGH_CHUNK_SIZE          64U
+
+typedef struct passthroughEscape_s {
+    timeMs_t lastRxMs;
+    uint8_t count;          // escape characters held back
+} passthroughEscape_t;
+
+static int passthroughReleaseEscapeChars(passthroughEscape_t *escape, uint8_t *buf)
+{
+    const int count = escape->count;
+    memset(buf, PASSTHROUGH_ESCAPE_CHAR, count);
+    escape->count = 0;
+    return count;
+}
+
+// Moves the received data of one port to the other with a single write, returns the number of bytes moved
+static uint32_t passthroughForward(serialPort_t *from, serialPort_t *to, serialConsumer *consumer, passthroughEscape_t *escape)
+{
+    uint8_t buf[PASSTHROUGH_CHUNK_SIZE + PASSTHROUGH_ESCAPE_COUNT];
+
+    // keep room for the escape characters that are released with the data
+    const uint32_t txFree = serialTxBytesFree(to);
+    const uint32_t txReserved = escape ? PASSTHROUGH_ESCAPE_COUNT : 0;
+    if (txFree <= txReserved) {
+        return 0;
+    }
+    const uint32_t count = MIN(MIN(serialRxBytesWaiting(from), txFree - txReserved), PASSTHROUGH_CHUNK_SIZE);
+    if (count == 0) {
+        return 0;
+    }
+
+    const timeMs_t nowMs = millis();
+    int len = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t c = serialRead(from);
+        consumer(c);
+
+        if (escape) {
+            if (c == PASSTHROUGH_ESCAPE_CHAR && escape->count < PASSTHROUGH_ESCAPE_COUNT
+                && (escape->count || nowMs - escape->lastRxMs >= PASSTHROUGH_ESCAPE_GUARD_MS)) {
+                escape->count++;
+                escape->lastRxMs = nowMs;
+                continue;
+            }
+            // not an escape sequence, the held back characters are data
+            len += passthroughReleaseEscapeChars(escape, &buf[len]);
+            escape->lastRxMs = nowMs;
+        }
+        buf[len++] = c;
+    }
+
+    if (len) {
+        serialWriteBuf(to, buf, len);
+    }
+
+    return count;
+}
+
 /*
  A high-level serial passthrough implementation. Used by cli to start an
  arbitrary serial passthrough "proxy". Optional callbacks can be given to allow
  for specialized data processing.
+ The data waiting in each port is moved in bulk, the right port is the one of the
+ host and the passthrough returns when it sends the escape sequence.
  */
 void serialPassthrough(serialPort_t *left, serialPort_t *right, serialConsumer *leftC, serialConsumer *rightC)
 {
@@ -550,32 +618,37 @@ void serialPassthrough(serialPort_t *left, serialPort_t *right, serialConsumer *
     LED0_OFF;
     LED1_OFF;
 
+    passthroughEscape_t escape = { .lastRxMs = millis(), .count = 0 };
+    bool active = false;
+
     // Either port might be open in a mode other than MODE_RXTX. We rely on
     // serialRxBytesWaiting() to do the right thing for a TX only port. No
     // special handling is necessary OR performed.
     while (1) {
-        // TODO: maintain a timestamp of last data received. Use this to
-        // implement a guard interval and check for `+++` as an escape sequence
-        // to return to CLI command mode.
-        // https://en.wikipedia.org/wiki/Escape_sequence#Modem_control
-        if (serialRxBytesWaiting(left)) {
+        const uint32_t moved = passthroughForward(left, right, leftC, NULL)
+            + passthroughForward(right, left, rightC, &escape);
+
+        if (moved && !active) {
             LED0_ON;
-            uint8_t c = serialRead(left);
-            // Make sure there is space in the tx buffer
-            while (!serialTxBytesFree(right));
-            serialWrite(right, c);
-            leftC(c);
+        } else if (!moved && active) {
             LED0_OFF;
-         }
-         if (serialRxBytesWaiting(right)) {
-             LED0_ON;
-             uint8_t c = serialRead(right);
-             // Make sure there is space in the tx buffer
-             while (!serialTxBytesFree(left));
-             serialWrite(left, c);
-             rightC(c);
-             LED0_OFF;
-         }
-     }
- }
+        }
+        active = moved;
+
+        if (escape.count && millis() - escape.lastRxMs >= PASSTHROUGH_ESCAPE_GUARD_MS) {
+            if (escape.count == PASSTHROUGH_ESCAPE_COUNT) {
+                break;
+            }
+            // an incomplete sequence is data
+            if (serialTxBytesFree(left) >= escape.count) {
+                uint8_t buf[PASSTHROUGH_ESCAPE_COUNT];
+                const int len = passthroughReleaseEscapeChars(&escape, buf);
+                serialWriteBuf(left, buf, len);
+            }
+        }
+    }
+
+    LED0_OFF;
+    waitForSerialPortToFinishTransmitting(left);
+}
  #endif
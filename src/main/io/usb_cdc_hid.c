@@ -26,8 +26,13 @@
 
 #include "fc/rc_controls.h"
 
+#include "pg/usb.h"
+
 #include "rx/rx.h"
 
+#include "usb_cdc_hid.h"
+
+#ifndef UNIT_TEST
 //TODO: Make it platform independent in the future
 #if defined(STM32F4)
 #include "vcpf4/usbd_cdc_vcp.h"
@@ -37,42 +42,41 @@
 #include "usbd_hid.h"
 #include "vcp_hal/usbd_cdc_interface.h"
 #endif
+#endif
 
-#define USB_CDC_HID_NUM_AXES 8
-
-#define USB_CDC_HID_RANGE_MIN -127
-#define USB_CDC_HID_RANGE_MAX 127
-
-// In the windows joystick driver, the axes are defined as shown in the second column.
+uint8_t usbHidBuildReport(uint8_t *report, const int16_t *channelData, uint8_t channelCount, const uint8_t *channelMap)
+{
+    for (unsigned i = 0; i < USB_HID_AXIS_COUNT; i++) {
+        const uint8_t channel = channelMap[i];
+        int16_t value = 0;
+        if (channel < channelCount) {
+            value = scaleRange(constrain(channelData[channel], PWM_RANGE_MIN, PWM_RANGE_MAX), PWM_RANGE_MIN, PWM_RANGE_MAX, USB_CDC_HID_RANGE_MIN, USB_CDC_HID_RANGE_MAX);
+            if (i == 1) {
+                // For some reason ROLL is inverted in Windows
+                value = -value;
+            }
+        }
+        report[2 * i] = value & 0xff;
+        report[2 * i + 1] = (value >> 8) & 0xff;
+    }
 
-const uint8_t hidChannelMapping[] = {
-    ROLL,     // X
-    PITCH,    // Y
-    AUX3,
-    YAW,      // X Rotation
-    AUX1,     // Z Rotation
-    THROTTLE, // Y Rotation
-    AUX4,
-    AUX2,     // Wheel
-};
+    return USB_CDC_HID_REPORT_SIZE;
+}
 
+#ifndef UNIT_TEST
 void sendRcDataToHid(void)
 {
-    int8_t report[8];
-    for (unsigned i = 0; i < USB_CDC_HID_NUM_AXES; i++) {
-        const uint8_t channel = hidChannelMapping[i];
-        report[i] = scaleRange(constrain(rcData[channel], PWM_RANGE_MIN, PWM_RANGE_MAX), PWM_RANGE_MIN, PWM_RANGE_MAX, USB_CDC_HID_RANGE_MIN, USB_CDC_HID_RANGE_MAX);
-        if (i == 1) {
-            // For some reason ROLL is inverted in Windows
-            report[i] = -report[i];
-        }
-    }
+    // The report is transmitted asynchronously by the USB core, so it must outlive this call
+    static uint8_t report[USB_CDC_HID_REPORT_SIZE];
+
+    const uint8_t reportSize = usbHidBuildReport(report, rcData, MAX_SUPPORTED_RC_CHANNEL_COUNT, usbDevConfig()->hidChannelMap);
 #if defined(STM32F4)
-    USBD_HID_SendReport(&USB_OTG_dev, (uint8_t*)report, sizeof(report));
+    USBD_HID_SendReport(&USB_OTG_dev, report, reportSize);
 #elif defined(STM32F7) || defined(STM32H7)
-    USBD_HID_SendReport(&USBD_Device, (uint8_t*)report, sizeof(report));
+    USBD_HID_SendReport(&USBD_Device, report, reportSize);
 #else
 # error "MCU does not support USB HID."
 #endif
 }
 #endif
+#endif
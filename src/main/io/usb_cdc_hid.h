@@ -20,4 +20,15 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#include "pg/usb.h"
+
+// Each axis is reported as a signed 16 bit little endian value
+#define USB_CDC_HID_REPORT_SIZE (USB_HID_AXIS_COUNT * sizeof(int16_t))
+
+#define USB_CDC_HID_RANGE_MIN -32767
+#define USB_CDC_HID_RANGE_MAX 32767
+
+uint8_t usbHidBuildReport(uint8_t *report, const int16_t *channelData, uint8_t channelCount, const uint8_t *channelMap);
 void sendRcDataToHid(void);
@@ -30,6 +30,7 @@
 
 #include "platform.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "emfat.h"
@@ -331,6 +332,7 @@ bool emfat_init(emfat_t *emfat, const char *label, emfat_entry_t *entries)
     emfat->priv.root_lba = emfat->priv.fat2_lba + sect_per_fat;
     emfat->priv.entries = entries;
     emfat->priv.last_entry = entries;
+    emfat->priv.cache_lba = 0;
     emfat->disk_sectors = clust * SECT_PER_CLUST + emfat->priv.root_lba;
     emfat->vol_size = (uint64_t)emfat->disk_sectors * SECT;
     /* calc cyl number */
@@ -467,13 +469,10 @@ void read_fat_sector(emfat_t *emfat, uint8_t *sect, uint32_t index)
                 continue;
             }
         }
-        if (le->dir) {
-            if (curr == le->priv.last_clust) {
-                *values = CLUST_EOF;
-            } else {
-                *values = curr + 1;
-            }
-        } else {
+        // Emit the rest of this entry's cluster chain without looking it up again
+        uint32_t run = MIN(count, le->priv.last_reserved - curr + 1);
+        count -= run;
+        while (run-- != 0) {
             if (curr == le->priv.last_clust) {
                 *values = CLUST_EOF;
             } else if (curr > le->priv.last_clust) {
@@ -481,10 +480,9 @@ void read_fat_sector(emfat_t *emfat, uint8_t *sect, uint32_t index)
             } else {
                 *values = curr + 1;
             }
+            values++;
+            curr++;
         }
-        values++;
-        count--;
-        curr++;
     }
     emfat->priv.last_entry = le;
 }
@@ -600,12 +598,14 @@ void fill_dir_sector(emfat_t *emfat, uint8_t *data, emfat_entry_t *entry, uint32
     }
 }
 
-void read_data_sector(emfat_t *emfat, uint8_t *data, uint32_t rel_sect)
+// Reads as many of the requested data sectors as belong to a single entry and returns how many were read.
+// Runs of file sectors are handed to the entry's readcb as one request so that backing storage such as
+// the onboard flash sees a single large transfer rather than one per sector.
+int read_data_sectors(emfat_t *emfat, uint8_t *data, uint32_t rel_sect, int num_sectors)
 {
     emfat_entry_t *le;
     uint32_t cluster;
-    cluster = rel_sect / 8 + 2;
-    rel_sect = rel_sect % 8;
+    cluster = rel_sect / SECT_PER_CLUST + 2;
 
     le = emfat->priv.last_entry;
     if (!IS_CLUST_OF(cluster, le)) {
@@ -614,48 +614,80 @@ void read_data_sector(emfat_t *emfat, uint8_t *data, uint32_t rel_sect)
             int i;
             for (i = 0; i < SECT / 4; i++)
                 ((uint32_t *)data)[i] = 0xEFBEADDE;
-            return;
+            return 1;
         }
         emfat->priv.last_entry = le;
     }
 
     if (le->dir) {
-        fill_dir_sector(emfat, data, le, rel_sect);
-        return;
+        fill_dir_sector(emfat, data, le, rel_sect - (le->priv.first_clust - 2) * SECT_PER_CLUST);
+        return 1;
     }
 
+    const uint32_t entry_end_sect = (le->priv.last_reserved + 1 - 2) * SECT_PER_CLUST;
+    const int count = MIN((uint32_t)num_sectors, entry_end_sect - rel_sect);
+
     if (le->readcb == NULL) {
-        memset(data, 0, SECT);
+        memset(data, 0, count * SECT);
     } else {
-        uint32_t offset = cluster - le->priv.first_clust;
-        offset = offset * CLUST + rel_sect * SECT;
-        le->readcb(data, SECT, offset + le->offset, le);
+        uint32_t offset = (rel_sect - (le->priv.first_clust - 2) * SECT_PER_CLUST) * SECT;
+        le->readcb(data, count * SECT, offset + le->offset, le);
     }
 
-    return;
+    return count;
+}
+
+static bool is_cacheable_sector(const emfat_t *emfat, uint32_t sector)
+{
+    if (sector >= emfat->priv.fat1_lba && sector < emfat->priv.root_lba) {
+        return true;
+    }
+
+    if (sector >= emfat->priv.root_lba) {
+        const emfat_entry_t *le = emfat->priv.last_entry;
+        return le->dir && IS_CLUST_OF((sector - emfat->priv.root_lba) / SECT_PER_CLUST + 2, le);
+    }
+
+    return false;
 }
 
 void emfat_read(emfat_t *emfat, uint8_t *data, uint32_t sector, int num_sectors)
 {
     while (num_sectors > 0) {
-        if (sector >= emfat->priv.root_lba) {
-            read_data_sector(emfat, data, sector - emfat->priv.root_lba);
-        } else if (sector == 0) {
-            read_mbr_sector(emfat, data);
-        } else if (sector == emfat->priv.fsinfo_lba) {
-            read_fsinfo_sector(emfat, data);
-        } else if (sector == emfat->priv.boot_lba) {
-            read_boot_sector(emfat, data);
-        } else if (sector >= emfat->priv.fat1_lba && sector < emfat->priv.fat2_lba) {
-            read_fat_sector(emfat, data, sector - emfat->priv.fat1_lba);
-        } else if (sector >= emfat->priv.fat2_lba && sector < emfat->priv.root_lba) {
-            read_fat_sector(emfat, data, sector - emfat->priv.fat2_lba);
+        // FAT2 is an exact copy of FAT1, so both share the cache entry of the FAT1 sector
+        const uint32_t cache_lba = (sector >= emfat->priv.fat2_lba && sector < emfat->priv.root_lba)
+            ? sector - emfat->priv.fat2_lba + emfat->priv.fat1_lba : sector;
+        int count = 1;
+
+        if (cache_lba != 0 && cache_lba == emfat->priv.cache_lba) {
+            memcpy(data, emfat->priv.cache, SECT);
         } else {
-            memset(data, 0, SECT);
+            if (sector >= emfat->priv.root_lba) {
+                count = read_data_sectors(emfat, data, sector - emfat->priv.root_lba, num_sectors);
+            } else if (sector == 0) {
+                read_mbr_sector(emfat, data);
+            } else if (sector == emfat->priv.fsinfo_lba) {
+                read_fsinfo_sector(emfat, data);
+            } else if (sector == emfat->priv.boot_lba) {
+                read_boot_sector(emfat, data);
+            } else if (sector >= emfat->priv.fat1_lba && sector < emfat->priv.fat2_lba) {
+                read_fat_sector(emfat, data, sector - emfat->priv.fat1_lba);
+            } else if (sector >= emfat->priv.fat2_lba && sector < emfat->priv.root_lba) {
+                read_fat_sector(emfat, data, sector - emfat->priv.fat2_lba);
+            } else {
+                memset(data, 0, SECT);
+            }
+
+            // Generated metadata never changes after emfat_init(), so keep the last sector around
+            // for hosts that read the FAT copies and directories repeatedly
+            if (count == 1 && is_cacheable_sector(emfat, sector)) {
+                memcpy(emfat->priv.cache, data, SECT);
+                emfat->priv.cache_lba = cache_lba;
+            }
         }
-        data += SECT;
-        num_sectors--;
-        sector++;
+        data += count * SECT;
+        num_sectors -= count;
+        sector += count;
     }
 }
 
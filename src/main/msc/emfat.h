@@ -82,6 +82,8 @@ typedef struct emfat_s {
         emfat_entry_t *entries;
         emfat_entry_t *last_entry;
         int            num_entries;
+        uint32_t       cache_lba;    /**< sector held in cache, 0 when empty (MBR is never cached) */
+        uint8_t        cache[512];   /**< last generated FAT or directory sector */
     } priv;
 } emfat_t;
 
@@ -26,6 +26,8 @@
 #include "emfat.h"
 #include "emfat_file.h"
 
+#include "build/version.h"
+
 #include "common/printf.h"
 #include "common/strtol.h"
 #include "common/time.h"
@@ -40,8 +42,6 @@
 
 #include "pg/flash.h"
 
-#include "msc/usbd_storage.h"
-
 #define FILESYSTEM_SIZE_MB 256
 #define HDR_BUF_SIZE 32
 
@@ -252,7 +252,18 @@ static void bblog_read_proc(uint8_t *dest, int size, uint32_t offset, emfat_entr
 {
     UNUSED(entry);
 
-    flashfsReadAbs(offset, dest, size);
+    // A read may come back short, e.g. the W25N01G stops at the end of each page
+    while (size > 0) {
+        const int bytesRead = flashfsReadAbs(offset, dest, size);
+        if (bytesRead <= 0) {
+            // Past the end of the flash or a timeout, don't hand out stale buffer contents
+            memset(dest, 0, size);
+            break;
+        }
+        dest += bytesRead;
+        offset += bytesRead;
+        size -= bytesRead;
+    }
 }
 
 static const emfat_entry_t entriesPredefined[] =
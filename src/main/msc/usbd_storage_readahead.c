@@ -0,0 +1,109 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Read-ahead window for the SD card mass storage backends.
+ *
+ * Hosts often read a large file with many small, consecutive requests (a single block at a time when the USB stack's
+ * media packet is 512 bytes). Issuing a command per request wastes most of the card's bandwidth, so once a request
+ * continues the previous one we fetch a whole window of blocks with a single multi-block read and serve the following
+ * requests from RAM. Random accesses and requests at least as large as the window go straight to the card.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_SDCARD
+
+#include "common/maths.h"
+
+#include "msc/usbd_storage_readahead.h"
+
+static DMA_RW_AXI uint8_t readAheadBuffer[MSC_READAHEAD_BLOCKS * MSC_READAHEAD_BLOCK_SIZE] __attribute__((aligned(32)));
+
+static struct {
+    mscReadBlocksFn readBlocks;
+    uint32_t numBlocks;
+    uint32_t windowStart;
+    uint16_t windowCount;   // 0 when the window holds no data
+    uint32_t nextBlock;     // block following the previous request, for sequential access detection
+} readAhead;
+
+void mscReadAheadInit(mscReadBlocksFn readBlocks, uint32_t numBlocks)
+{
+    readAhead.readBlocks = readBlocks;
+    readAhead.numBlocks = numBlocks;
+    readAhead.windowCount = 0;
+    readAhead.nextBlock = 0;
+}
+
+bool mscReadAheadRead(uint32_t blockIndex, uint8_t *buffer, uint16_t blockCount)
+{
+    while (blockCount > 0) {
+        const uint32_t windowEnd = readAhead.windowStart + readAhead.windowCount;
+
+        if (blockIndex >= readAhead.windowStart && blockIndex < windowEnd) {
+            const uint16_t count = MIN(blockCount, windowEnd - blockIndex);
+
+            memcpy(buffer, &readAheadBuffer[(blockIndex - readAhead.windowStart) * MSC_READAHEAD_BLOCK_SIZE], count * MSC_READAHEAD_BLOCK_SIZE);
+
+            blockIndex += count;
+            buffer += count * MSC_READAHEAD_BLOCK_SIZE;
+            blockCount -= count;
+            continue;
+        }
+
+        const bool sequential = blockIndex == readAhead.nextBlock;
+        const uint32_t windowCount = MIN((uint32_t)MSC_READAHEAD_BLOCKS, readAhead.numBlocks - MIN(blockIndex, readAhead.numBlocks));
+
+        if (!sequential || blockCount >= MSC_READAHEAD_BLOCKS || windowCount < blockCount) {
+            if (!readAhead.readBlocks(blockIndex, buffer, blockCount)) {
+                return false;
+            }
+
+            blockIndex += blockCount;
+            blockCount = 0;
+            break;
+        }
+
+        readAhead.windowCount = 0;
+        if (!readAhead.readBlocks(blockIndex, readAheadBuffer, windowCount)) {
+            return false;
+        }
+        readAhead.windowStart = blockIndex;
+        readAhead.windowCount = windowCount;
+    }
+
+    readAhead.nextBlock = blockIndex;
+
+    return true;
+}
+
+void mscReadAheadInvalidate(uint32_t blockIndex, uint16_t blockCount)
+{
+    if (blockIndex < readAhead.windowStart + readAhead.windowCount && blockIndex + blockCount > readAhead.windowStart) {
+        readAhead.windowCount = 0;
+    }
+}
+
+#endif
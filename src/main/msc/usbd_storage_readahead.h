@@ -0,0 +1,34 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MSC_READAHEAD_BLOCK_SIZE    512
+#define MSC_READAHEAD_BLOCKS        8
+
+// Blocking read of blockCount consecutive blocks from the medium, returns false on failure
+typedef bool (*mscReadBlocksFn)(uint32_t blockIndex, uint8_t *buffer, uint16_t blockCount);
+
+void mscReadAheadInit(mscReadBlocksFn readBlocks, uint32_t numBlocks);
+bool mscReadAheadRead(uint32_t blockIndex, uint8_t *buffer, uint16_t blockCount);
+void mscReadAheadInvalidate(uint32_t blockIndex, uint16_t blockCount);
@@ -34,6 +34,7 @@
 #include "common/utils.h"
 
 #include "usbd_storage.h"
+#include "usbd_storage_readahead.h"
 
 #include "drivers/bus_spi.h"
 #include "drivers/io.h"
@@ -136,6 +137,27 @@ USBD_STORAGE_cb_TypeDef USBD_MSC_MICRO_SD_SPI_fops =
 };
 #endif
 
+static bool readFailed;
+
+static void sdcardReadComplete(sdcardBlockOperation_e operation, uint32_t blockIndex, uint8_t *buffer, uint32_t callbackData)
+{
+    UNUSED(operation);
+    UNUSED(blockIndex);
+    UNUSED(callbackData);
+
+    readFailed = buffer == NULL;
+}
+
+static bool sdcardReadBlocks(uint32_t blockIndex, uint8_t *buffer, uint16_t blockCount)
+{
+    while (sdcard_readBlocks(blockIndex, buffer, blockCount, sdcardReadComplete, 0) == 0) {
+        sdcard_poll();
+    }
+    while (sdcard_poll() == 0);
+
+    return !readFailed;
+}
+
 /*******************************************************************************
 * Function Name  : Read_Memory
 * Description    : Handle the Read operation from the microSD card.
@@ -149,6 +171,7 @@ static int8_t STORAGE_Init (uint8_t lun)
 	LED0_OFF;
 	sdcard_init(sdcardConfig());
 	while (sdcard_poll() == 0);
+	mscReadAheadInit(sdcardReadBlocks, sdcard_getMetadata()->numBlocks);
     mscSetActive();
 	return 0;
 }
@@ -215,9 +238,8 @@ static int8_t STORAGE_Read (uint8_t lun,
                  uint16_t blk_len)
 {
 	UNUSED(lun);
-	for (int i = 0; i < blk_len; i++) {
-	    while (sdcard_readBlock(blk_addr + i, buf + (512 * i), NULL, NULL) == 0);
-		while (sdcard_poll() == 0);
+	if (!mscReadAheadRead(blk_addr, buf, blk_len)) {
+		return -1;
 	}
     mscSetActive();
 	return 0;
@@ -235,6 +257,16 @@ static int8_t STORAGE_Write (uint8_t lun,
                   uint16_t blk_len)
 {
 	UNUSED(lun);
+	mscReadAheadInvalidate(blk_addr, blk_len);
+
+	// Stream the blocks as one multi-block write so the card can pre-erase and doesn't need a command per block
+	sdcardOperationStatus_e status;
+	while ((status = sdcard_beginWriteBlocks(blk_addr, blk_len)) == SDCARD_OPERATION_BUSY) {
+		sdcard_poll();
+	}
+	if (status != SDCARD_OPERATION_SUCCESS) {
+		return -1;
+	}
 	for (int i = 0; i < blk_len; i++) {
 		while (sdcard_writeBlock(blk_addr + i, buf + (i * 512), NULL, NULL) != SDCARD_OPERATION_IN_PROGRESS) {
 			sdcard_poll();
@@ -56,6 +56,7 @@
 #endif
 
 #include "usbd_storage.h"
+#include "usbd_storage_readahead.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -149,6 +150,17 @@ USBD_STORAGE_cb_TypeDef USBD_MSC_MICRO_SDIO_fops =
 };
 #endif
 
+static bool sdioReadBlocks(uint32_t blockIndex, uint8_t *buffer, uint16_t blockCount)
+{
+    //buf should be 32bit aligned, but usually is so we don't do byte alignment
+    if (SD_ReadBlocks_DMA(blockIndex, (uint32_t*) buffer, 512, blockCount) != 0) {
+        return false;
+    }
+    while (SD_CheckRead());
+    while(SD_GetState() == false);
+    return true;
+}
+
 /*******************************************************************************
 * Function Name  : Read_Memory
 * Description    : Handle the Read operation from the microSD card.
@@ -185,6 +197,9 @@ static int8_t STORAGE_Init (uint8_t lun)
         return 1;
     }
 
+    SD_GetCardInfo();
+    mscReadAheadInit(sdioReadBlocks, SD_CardInfo.CardCapacity);
+
     mscSetActive();
 
     return 0;
@@ -260,10 +275,7 @@ static int8_t STORAGE_Read (uint8_t lun,
     if (!sdcard_isInserted()) {
         return -1;
     }
-    //buf should be 32bit aligned, but usually is so we don't do byte alignment
-    if (SD_ReadBlocks_DMA(blk_addr, (uint32_t*) buf, 512, blk_len) == 0) {
-        while (SD_CheckRead());
-        while(SD_GetState() == false);
+    if (mscReadAheadRead(blk_addr, buf, blk_len)) {
         mscSetActive();
         return 0;
     }
@@ -285,6 +297,7 @@ static int8_t STORAGE_Write (uint8_t lun,
     if (!sdcard_isInserted()) {
         return -1;
     }
+    mscReadAheadInvalidate(blk_addr, blk_len);
     //buf should be 32bit aligned, but usually is so we don't do byte alignment
     if (SD_WriteBlocks_DMA(blk_addr, (uint32_t*) buf, 512, blk_len) == 0) {
         while (SD_CheckWrite());
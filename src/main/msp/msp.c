@@ -56,6 +56,7 @@
 #include "drivers/dshot.h"
 #include "drivers/flash.h"
 #include "drivers/io.h"
+#include "drivers/max7456.h"
 #include "drivers/motor.h"
 #include "drivers/osd.h"
 #include "drivers/pwm_output.h"
@@ -983,6 +984,19 @@ static bool mspCommonProcessOutCommand(int16_t cmdMSP, sbuf_t *dst, mspPostProce
         break;
     }
 
+#ifdef USE_MAX7456
+    case MSP_OSD_CHAR_WRITE_STATUS:
+        // Added in MSP API 1.44
+        // MSP_OSD_CHAR_WRITE only waits for the NVM when the queue is full,
+        // characters are sent while the pending count is below the queue size.
+        // Polling the status moves the upload on when the OSD task does not run.
+        max7456FontUploadProcess();
+        sbufWriteU8(dst, max7456FontUploadPending());
+        sbufWriteU8(dst, MAX7456_FONT_UPLOAD_QUEUE_SIZE);
+        sbufWriteU16(dst, max7456FontUploadCharsWritten());
+        break;
+#endif
+
     default:
         return false;
     }
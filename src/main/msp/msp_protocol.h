@@ -235,6 +235,8 @@
 #define MSP_SET_TX_INFO                 186 // in message           Used to send runtime information from TX lua scripts to the firmware
 #define MSP_TX_INFO                     187 // out message          Used by TX lua scripts to read information from the firmware
 
+#define MSP_OSD_CHAR_WRITE_STATUS       190 // out message          Get the progress of the MAX7456 font upload
+
 //
 // Multwii original MSP commands
 //
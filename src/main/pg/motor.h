@@ -48,6 +48,7 @@ typedef struct motorDevConfig_s {
     uint8_t  motorTransportProtocol;
     uint8_t  useDshotBitbang;
     uint8_t  useDshotBitbangedTimer;
+    uint8_t  useDshotEdt;                   // Enable extended DShot telemetry (temperature, voltage, current) over bidirectional DShot
 } motorDevConfig_t;
 
 typedef struct motorConfig_s {
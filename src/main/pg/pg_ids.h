@@ -150,7 +150,8 @@
 #define PG_PULLUP_CONFIG 551
 #define PG_PULLDOWN_CONFIG 552
 #define PG_MODE_ACTIVATION_CONFIG 553
-#define PG_BETAFLIGHT_END 553
+#define PG_GYRO_BIAS_MODEL 554
+#define PG_BETAFLIGHT_END 554
 
 
 // OSD configuration (subject to change)
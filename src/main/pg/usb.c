@@ -24,16 +24,20 @@
 
 #include "drivers/io.h"
 
+#include "fc/rc_controls.h"
+
 #include "pg/pg_ids.h"
 
 #include "usb.h"
 
-PG_REGISTER_WITH_RESET_TEMPLATE(usbDev_t, usbDevConfig, PG_USB_CONFIG, 0);
+PG_REGISTER_WITH_RESET_TEMPLATE(usbDev_t, usbDevConfig, PG_USB_CONFIG, 1);
 
 PG_RESET_TEMPLATE(usbDev_t, usbDevConfig,
     .type = DEFAULT,
     .mscButtonPin = IO_TAG(USB_MSC_BUTTON_PIN),
     .mscButtonUsePullup = MSC_BUTTON_IPU,
     .detectPin = IO_TAG(USB_DETECT_PIN),
+    // In the windows joystick driver, the axes are X, Y, Z, X Rotation, Z Rotation, Y Rotation, Vx, Wheel, Slider, Dial
+    .hidChannelMap = { ROLL, PITCH, AUX3, YAW, AUX1, THROTTLE, AUX4, AUX2, AUX5, AUX6 },
 );
 #endif
@@ -24,6 +24,8 @@
 
 #include "pg/pg.h"
 
+#define USB_HID_AXIS_COUNT 10
+
 enum USB_DEV {
     DEFAULT,
     COMPOSITE
@@ -34,6 +36,7 @@ typedef struct usbDev_s {
     ioTag_t mscButtonPin;
     uint8_t mscButtonUsePullup;
     ioTag_t detectPin;
+    uint8_t hidChannelMap[USB_HID_AXIS_COUNT]; // rc channel reported on each HID joystick axis
 } usbDev_t;
 
 PG_DECLARE(usbDev_t, usbDevConfig);
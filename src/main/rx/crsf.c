@@ -275,7 +275,9 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
                     case CRSF_FRAMETYPE_MSP_REQ:
                     case CRSF_FRAMETYPE_MSP_WRITE: {
                         uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
-                        if (bufferCrsfMspFrame(frameStart, CRSF_FRAME_RX_MSP_FRAME_SIZE)) {
+                        // MSP v2 tunnel requests use the whole extended frame payload
+                        const uint8_t mspFrameLength = MAX(crsfFrame.frame.frameLength - CRSF_FRAME_LENGTH_EXT_TYPE_CRC, CRSF_FRAME_RX_MSP_FRAME_SIZE);
+                        if (bufferCrsfMspFrame(frameStart, MIN(mspFrameLength, CRSF_PAYLOAD_SIZE_MAX - CRSF_FRAME_ORIGIN_DEST_SIZE))) {
                             crsfScheduleMspResponse();
                         }
                         break;
@@ -23,16 +23,19 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include <math.h>
 
 #include "platform.h"
 
 #include "build/build_config.h"
 #include "build/debug.h"
 
+#include "common/crc.h"
 #include "common/maths.h"
 #include "common/time.h"
 #include "common/utils.h"
 
+#include "drivers/persistent.h"
 #include "drivers/time.h"
 
 #include "fc/core.h"
@@ -43,6 +46,14 @@
 #define TASK_AVERAGE_EXECUTE_FALLBACK_US 30 // Default task average time if USE_TASK_STATISTICS is not defined
 #define TASK_AVERAGE_EXECUTE_PADDING_US 5   // Add a little padding to the average execution time
 
+// The 95th percentile estimate steps up 19 times as far as it steps down, the
+// step grows with the estimate to converge equally fast for short and long tasks
+#define TASK_P95_STEP_US 0.05f
+#define TASK_P95_STEP_RATIO (1.0f / 512)
+
+#define SCHEDULER_PROFILE_CALIBRATION_TIME_US 10000000
+#define SCHEDULER_PROFILE_MAGIC 0x5350
+
 // DEBUG_SCHEDULER, timings for:
 // 0 - gyroUpdate()
 // 1 - pidController()
@@ -55,6 +66,11 @@ static FAST_RAM_ZERO_INIT uint32_t totalWaitingTasks;
 static FAST_RAM_ZERO_INIT uint32_t totalWaitingTasksSamples;
 
 static FAST_RAM_ZERO_INIT bool calculateTaskStatistics;
+#if defined(USE_TASK_STATISTICS) && defined(USE_PERSISTENT_OBJECTS)
+// The 95th percentile execution times are only tracked while the timing profile is calibrated
+static FAST_RAM_ZERO_INIT bool timingProfileCalibrating;
+static timeUs_t timingProfileCalibrationEndUs;
+#endif
 FAST_RAM_ZERO_INIT uint16_t averageSystemLoadPercent = 0;
 
 static FAST_RAM_ZERO_INIT int taskQueuePos = 0;
@@ -129,10 +145,22 @@ FAST_CODE task_t *queueNext(void)
     return taskQueueArray[++taskQueuePos]; // guaranteed to be NULL at end of queue
 }
 
+#if defined(USE_TASK_STATISTICS) && defined(USE_PERSISTENT_OBJECTS)
+static void schedulerSaveTimingProfile(void);
+#endif
+
 void taskSystemLoad(timeUs_t currentTimeUs)
 {
     UNUSED(currentTimeUs);
 
+#if defined(USE_TASK_STATISTICS) && defined(USE_PERSISTENT_OBJECTS)
+    // The profile is saved once at the end of the calibration, it's used to pick the task rates after a warm reset
+    if (timingProfileCalibrating && cmpTimeUs(currentTimeUs, timingProfileCalibrationEndUs) >= 0) {
+        schedulerSaveTimingProfile();
+        timingProfileCalibrating = false;
+    }
+#endif
+
     // Calculate system load
     if (totalWaitingTasksSamples > 0) {
         averageSystemLoadPercent = 100 * totalWaitingTasks / totalWaitingTasksSamples;
@@ -223,11 +251,13 @@ void schedulerResetTaskStatistics(taskId_e taskId)
         currentTask->movingSumDeltaTimeUs = 0;
         currentTask->totalExecutionTimeUs = 0;
         currentTask->maxExecutionTimeUs = 0;
+        currentTask->p95ExecutionTimeUs = 0;
     } else if (taskId < TASK_COUNT) {
         getTask(taskId)->movingSumExecutionTimeUs = 0;
         getTask(taskId)->movingSumDeltaTimeUs = 0;
         getTask(taskId)->totalExecutionTimeUs = 0;
         getTask(taskId)->maxExecutionTimeUs = 0;
+        getTask(taskId)->p95ExecutionTimeUs = 0;
     }
 #else
     UNUSED(taskId);
@@ -299,6 +329,16 @@ FAST_CODE timeUs_t schedulerExecuteTask(task_t *selectedTask, timeUs_t currentTi
             selectedTask->movingSumDeltaTimeUs += selectedTask->taskLatestDeltaTimeUs - selectedTask->movingSumDeltaTimeUs / TASK_STATS_MOVING_SUM_COUNT;
             selectedTask->totalExecutionTimeUs += taskExecutionTimeUs;   // time consumed by scheduler + task
             selectedTask->maxExecutionTimeUs = MAX(selectedTask->maxExecutionTimeUs, taskExecutionTimeUs);
+#if defined(USE_PERSISTENT_OBJECTS)
+            if (timingProfileCalibrating) {
+                const float p95StepUs = TASK_P95_STEP_US + selectedTask->p95ExecutionTimeUs * TASK_P95_STEP_RATIO;
+                if (taskExecutionTimeUs > selectedTask->p95ExecutionTimeUs) {
+                    selectedTask->p95ExecutionTimeUs += 19 * p95StepUs;
+                } else {
+                    selectedTask->p95ExecutionTimeUs = MAX(selectedTask->p95ExecutionTimeUs - p95StepUs, 0.0f);
+                }
+            }
+#endif
             selectedTask->movingAverageCycleTimeUs += 0.05f * (period - selectedTask->movingAverageCycleTimeUs);
         } else
 #endif
@@ -449,3 +489,170 @@ uint16_t getAverageSystemLoadPercent(void)
 {
     return averageSystemLoadPercent;
 }
+
+#if defined(USE_TASK_STATISTICS)
+static uint16_t schedulerProfileExecutionTime(taskId_e taskId)
+{
+    const task_t *task = getTask(taskId);
+    if (!queueContains(getTask(taskId))) {
+        return 0;
+    }
+
+    return MIN(lrintf(task->p95ExecutionTimeUs), UINT16_MAX);
+}
+
+static bool isScaledProfileTask(const task_t *task)
+{
+#ifdef USE_OSD
+    if (task == getTask(TASK_OSD)) {
+        return true;
+    }
+#endif
+#ifdef USE_TELEMETRY
+    if (task == getTask(TASK_TELEMETRY)) {
+        return true;
+    }
+#endif
+    UNUSED(task);
+
+    return false;
+}
+#endif
+
+void schedulerGetTimingProfile(schedulerTimingProfile_t *profile)
+{
+    memset(profile, 0, sizeof(schedulerTimingProfile_t));
+
+#if defined(USE_TASK_STATISTICS)
+    profile->executionTimeUs[SCHEDULER_PROFILE_GYRO] = schedulerProfileExecutionTime(TASK_GYRO);
+    profile->executionTimeUs[SCHEDULER_PROFILE_FILTER] = schedulerProfileExecutionTime(TASK_FILTER);
+    profile->executionTimeUs[SCHEDULER_PROFILE_PID] = schedulerProfileExecutionTime(TASK_PID);
+#ifdef USE_OSD
+    profile->executionTimeUs[SCHEDULER_PROFILE_OSD] = schedulerProfileExecutionTime(TASK_OSD);
+#endif
+#ifdef USE_TELEMETRY
+    profile->executionTimeUs[SCHEDULER_PROFILE_TELEMETRY] = schedulerProfileExecutionTime(TASK_TELEMETRY);
+#endif
+
+    // The serial task load depends on what's connected rather than on the configuration
+    uint32_t otherTasksLoad = 0;
+    for (int i = 0; i < taskQueueSize; i++) {
+        const task_t *task = taskQueueArray[i];
+        if (task->staticPriority == TASK_PRIORITY_REALTIME || task == getTask(TASK_SERIAL) || isScaledProfileTask(task)) {
+            continue;
+        }
+
+        const timeUs_t averageDeltaTimeUs = task->movingSumDeltaTimeUs / TASK_STATS_MOVING_SUM_COUNT;
+        if (averageDeltaTimeUs > 0) {
+            otherTasksLoad += task->movingSumExecutionTimeUs / TASK_STATS_MOVING_SUM_COUNT * SCHEDULER_PROFILE_LOAD_ONE / averageDeltaTimeUs;
+        }
+    }
+    profile->otherTasksLoad = MIN(otherTasksLoad, (uint32_t)SCHEDULER_PROFILE_LOAD_ONE);
+#endif
+}
+
+#if defined(USE_PERSISTENT_OBJECTS)
+#define SCHEDULER_PROFILE_WORD_COUNT (PERSISTENT_OBJECT_SCHEDULER_PROFILE_END - PERSISTENT_OBJECT_SCHEDULER_PROFILE + 1)
+
+STATIC_ASSERT(sizeof(schedulerTimingProfile_t) == SCHEDULER_PROFILE_WORD_COUNT * sizeof(uint32_t), scheduler_timing_profile_does_not_fit_persistent_objects);
+
+static uint32_t schedulerProfileCheck(const uint32_t *words)
+{
+    return (SCHEDULER_PROFILE_MAGIC << 16) | crc16_ccitt_update(0, words, SCHEDULER_PROFILE_WORD_COUNT * sizeof(uint32_t));
+}
+
+#if defined(USE_TASK_STATISTICS)
+static void schedulerSaveTimingProfile(void)
+{
+    schedulerTimingProfile_t profile;
+    schedulerGetTimingProfile(&profile);
+
+    uint32_t words[SCHEDULER_PROFILE_WORD_COUNT];
+    memcpy(words, &profile, sizeof(words));
+    for (int i = 0; i < SCHEDULER_PROFILE_WORD_COUNT; i++) {
+        persistentObjectWrite(PERSISTENT_OBJECT_SCHEDULER_PROFILE + i, words[i]);
+    }
+    persistentObjectWrite(PERSISTENT_OBJECT_SCHEDULER_PROFILE_CHECK, schedulerProfileCheck(words));
+}
+
+// Measures the task execution times for a while and saves the profile, task statistics must be enabled
+void schedulerStartTimingProfileCalibration(timeUs_t currentTimeUs)
+{
+    for (taskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        getTask(taskId)->p95ExecutionTimeUs = 0;
+    }
+    timingProfileCalibrationEndUs = currentTimeUs + SCHEDULER_PROFILE_CALIBRATION_TIME_US;
+    timingProfileCalibrating = true;
+}
+
+bool schedulerIsTimingProfileCalibrating(void)
+{
+    return timingProfileCalibrating;
+}
+#endif
+
+void schedulerClearTimingProfile(void)
+{
+    persistentObjectWrite(PERSISTENT_OBJECT_SCHEDULER_PROFILE_CHECK, 0);
+}
+#endif
+
+// Returns false if there is no profile from before the last warm reset
+bool schedulerRestoreTimingProfile(schedulerTimingProfile_t *profile)
+{
+#if defined(USE_PERSISTENT_OBJECTS)
+    uint32_t words[SCHEDULER_PROFILE_WORD_COUNT];
+    for (int i = 0; i < SCHEDULER_PROFILE_WORD_COUNT; i++) {
+        words[i] = persistentObjectRead(PERSISTENT_OBJECT_SCHEDULER_PROFILE + i);
+    }
+    if (persistentObjectRead(PERSISTENT_OBJECT_SCHEDULER_PROFILE_CHECK) != schedulerProfileCheck(words)) {
+        return false;
+    }
+
+    memcpy(profile, words, sizeof(schedulerTimingProfile_t));
+    return true;
+#else
+    UNUSED(profile);
+    return false;
+#endif
+}
+
+// CPU load of the gyro, filter and PID tasks
+static uint32_t schedulerRealtimeLoad(const schedulerTimingProfile_t *profile, timeDelta_t gyroSampleLooptimeUs, uint8_t pidDenom)
+{
+    // The gyro task runs on every gyro sample, filtering and PID on every pidDenom'th
+    const uint32_t cycleExecutionTimeUs = profile->executionTimeUs[SCHEDULER_PROFILE_GYRO] * pidDenom
+        + profile->executionTimeUs[SCHEDULER_PROFILE_FILTER] + profile->executionTimeUs[SCHEDULER_PROFILE_PID];
+
+    return cycleExecutionTimeUs * SCHEDULER_PROFILE_LOAD_ONE / ((uint32_t)gyroSampleLooptimeUs * pidDenom);
+}
+
+// Returns the lowest PID denominator, starting from the configured one, which keeps the load within the budget
+uint8_t schedulerSelectPidDenom(const schedulerTimingProfile_t *profile, timeDelta_t gyroSampleLooptimeUs, uint8_t pidDenom, uint8_t maxPidDenom)
+{
+    if (gyroSampleLooptimeUs <= 0 || pidDenom == 0) {
+        return pidDenom;
+    }
+
+    while (pidDenom < maxPidDenom && schedulerRealtimeLoad(profile, gyroSampleLooptimeUs, pidDenom) + profile->otherTasksLoad > SCHEDULER_PROFILE_LOAD_BUDGET) {
+        pidDenom++;
+    }
+
+    return pidDenom;
+}
+
+// Returns the period of the OSD or telemetry task, the desired period is kept if the task fits
+// into its share of the CPU time left over by the other tasks
+timeDelta_t schedulerSelectTaskPeriod(const schedulerTimingProfile_t *profile, timeDelta_t gyroSampleLooptimeUs, uint8_t pidDenom, schedulerProfileTask_e profileTask, timeDelta_t desiredPeriodUs)
+{
+    const uint32_t executionTimeUs = profile->executionTimeUs[profileTask];
+    if (executionTimeUs == 0 || gyroSampleLooptimeUs <= 0 || pidDenom == 0) {
+        return desiredPeriodUs;
+    }
+
+    const int32_t spareLoad = SCHEDULER_PROFILE_LOAD_BUDGET - (int32_t)schedulerRealtimeLoad(profile, gyroSampleLooptimeUs, pidDenom) - profile->otherTasksLoad;
+    const uint32_t taskLoadShare = MAX(spareLoad, SCHEDULER_PROFILE_MIN_SPARE_LOAD) / SCHEDULER_PROFILE_SCALED_TASK_COUNT;
+    const timeDelta_t requiredPeriodUs = executionTimeUs * SCHEDULER_PROFILE_LOAD_ONE / taskLoadShare;
+
+    return MAX(desiredPeriodUs, requiredPeriodUs);
+}
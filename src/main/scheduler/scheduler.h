@@ -35,6 +35,29 @@
 
 #define LOAD_PERCENTAGE_ONE 100
 
+// Timing profile of the tasks, measured on request and kept across warm resets
+// to pick task rates that fit the CPU budget
+#define SCHEDULER_PROFILE_LOAD_ONE 10000      // loads are given in 1/10000 of the CPU time
+#define SCHEDULER_PROFILE_LOAD_BUDGET 9000    // leave some margin for the execution time jitter
+#define SCHEDULER_PROFILE_MIN_SPARE_LOAD 100  // the rate selection never assumes less spare CPU time than this
+
+typedef enum {
+    SCHEDULER_PROFILE_GYRO = 0,
+    SCHEDULER_PROFILE_FILTER,
+    SCHEDULER_PROFILE_PID,
+    // The rates of these tasks are reduced if the CPU budget is exceeded
+    SCHEDULER_PROFILE_OSD,
+    SCHEDULER_PROFILE_TELEMETRY,
+    SCHEDULER_PROFILE_TASK_COUNT
+} schedulerProfileTask_e;
+
+#define SCHEDULER_PROFILE_SCALED_TASK_COUNT (SCHEDULER_PROFILE_TASK_COUNT - SCHEDULER_PROFILE_OSD)
+
+typedef struct schedulerTimingProfile_s {
+    uint16_t executionTimeUs[SCHEDULER_PROFILE_TASK_COUNT]; // 95th percentile, zero if the task is not used
+    uint16_t otherTasksLoad;                                // all the other tasks, except the serial task
+} schedulerTimingProfile_t;
+
 typedef enum {
     TASK_PRIORITY_REALTIME = -1, // Task will be run outside the scheduler logic
     TASK_PRIORITY_IDLE = 0,      // Disables dynamic scheduling, task is executed only if no other task is active this cycle
@@ -105,6 +128,9 @@ typedef enum {
 #ifdef USE_TELEMETRY
     TASK_TELEMETRY,
 #endif
+#ifdef USE_TELEMETRY_HOTT
+    TASK_HOTT_TX,
+#endif
 #ifdef USE_LED_STRIP
     TASK_LEDSTRIP,
 #endif
@@ -179,6 +205,7 @@ typedef struct {
     timeUs_t movingSumDeltaTimeUs;  // moving sum over 32 samples
     timeUs_t maxExecutionTimeUs;
     timeUs_t totalExecutionTimeUs;    // total time consumed by task since boot
+    float    p95ExecutionTimeUs;      // running estimate of the 95th percentile
 #endif
 } task_t;
 
@@ -199,3 +226,11 @@ void taskSystemLoad(timeUs_t currentTimeUs);
 void schedulerOptimizeRate(bool optimizeRate);
 void schedulerEnableGyro(void);
 uint16_t getAverageSystemLoadPercent(void);
+
+void schedulerGetTimingProfile(schedulerTimingProfile_t *profile);
+bool schedulerRestoreTimingProfile(schedulerTimingProfile_t *profile);
+void schedulerStartTimingProfileCalibration(timeUs_t currentTimeUs);
+bool schedulerIsTimingProfileCalibrating(void);
+void schedulerClearTimingProfile(void);
+uint8_t schedulerSelectPidDenom(const schedulerTimingProfile_t *profile, timeDelta_t gyroSampleLooptimeUs, uint8_t pidDenom, uint8_t maxPidDenom);
+timeDelta_t schedulerSelectTaskPeriod(const schedulerTimingProfile_t *profile, timeDelta_t gyroSampleLooptimeUs, uint8_t pidDenom, schedulerProfileTask_e profileTask, timeDelta_t desiredPeriodUs);
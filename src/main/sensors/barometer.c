@@ -29,6 +29,8 @@
 #include "build/debug.h"
 
 #include "common/maths.h"
+#include "common/topic.h"
+#include "common/utils.h"
 
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
@@ -55,7 +57,9 @@
 
 baro_t baro;                        // barometer access functions
 
-PG_REGISTER_WITH_RESET_FN(barometerConfig_t, barometerConfig, PG_BAROMETER_CONFIG, 1);
+TOPIC_DEFINE(baro_t, baro, &baro);
+
+PG_REGISTER_WITH_RESET_FN(barometerConfig_t, barometerConfig, PG_BAROMETER_CONFIG, 2);
 
 void pgResetFn_barometerConfig(barometerConfig_t *barometerConfig)
 {
@@ -63,6 +67,7 @@ void pgResetFn_barometerConfig(barometerConfig_t *barometerConfig)
     barometerConfig->baro_noise_lpf = 600;
     barometerConfig->baro_cf_vel = 985;
     barometerConfig->baro_hardware = BARO_DEFAULT;
+    barometerConfig->baro_temp_decimation = 10;
 
     // For backward compatibility; ceate a valid default value for bus parameters
     //
@@ -146,6 +151,8 @@ static uint32_t baroPressureSum = 0;
 
 #define CALIBRATING_BARO_CYCLES 200 // 10 seconds init_delay + 200 * 25 ms = 15 seconds before ground pressure settles
 #define SET_GROUND_LEVEL_BARO_CYCLES 10 // calibrate baro to new ground level (10 * 25 ms = ~250 ms non blocking)
+#define BARO_TEMPERATURE_MAX_AGE_US 1000000 // a temperature conversion is forced when the last one is older than this
+#define BARO_NOISE_LPF_PERIOD_US 25000 // baro_noise_lpf is the filter coefficient per run of the 40Hz altitude task
 
 static bool baroReady = false;
 
@@ -378,9 +385,17 @@ bool isBaroReady(void) {
     return baroReady;
 }
 
-uint32_t baroUpdate(void)
+bool baroIsTemperatureStale(timeUs_t currentTimeUs)
 {
-    static barometerState_e state = BAROMETER_NEEDS_PRESSURE_START;
+    return cmpTimeUs(currentTimeUs, baro.baroTemperatureTimeUs) > BARO_TEMPERATURE_MAX_AGE_US;
+}
+
+uint32_t baroUpdate(timeUs_t currentTimeUs)
+{
+    // the first pressure is only compensated correctly after a temperature conversion
+    static barometerState_e state = BAROMETER_NEEDS_TEMPERATURE_START;
+    // temperature changes slowly, so sensors without combined read only convert it every baro_temp_decimation pressures
+    static uint8_t pressureSamplesSinceTemperature = 0;
     timeUs_t sleepTime = 1000; // Wait 1ms between states
 
     if (debugMode == DEBUG_BARO) {
@@ -403,6 +418,8 @@ uint32_t baroUpdate(void)
 
         case BAROMETER_NEEDS_TEMPERATURE_SAMPLE:
             if (baro.dev.get_ut(&baro.dev)) {
+                baro.baroTemperatureTimeUs = currentTimeUs;
+                pressureSamplesSinceTemperature = 0;
                 state = BAROMETER_NEEDS_PRESSURE_START;
             }
         break;
@@ -428,10 +445,14 @@ uint32_t baroUpdate(void)
             baro.baroPressure = baroPressure;
             baro.baroTemperature = baroTemperature;
             baroPressureSum = recalculateBarometerTotal(barometerConfig()->baro_sample_count, baroPressureSum, baroPressure);
+            topicPublish(&baroTopic, currentTimeUs);
             if (baro.dev.combined_read) {
+                baro.baroTemperatureTimeUs = currentTimeUs;
                 state = BAROMETER_NEEDS_PRESSURE_START;
-            } else {
+            } else if (++pressureSamplesSinceTemperature >= barometerConfig()->baro_temp_decimation || baroIsTemperatureStale(currentTimeUs)) {
                 state = BAROMETER_NEEDS_TEMPERATURE_START;
+            } else {
+                state = BAROMETER_NEEDS_PRESSURE_START;
             }
 
             if (debugMode == DEBUG_BARO) {
@@ -439,28 +460,65 @@ uint32_t baroUpdate(void)
                 debug[2] = baroPressure;
                 debug[3] = baroPressureSum;
             }
-
-            sleepTime = baro.dev.ut_delay;
         break;
     }
 
     return sleepTime;
 }
 
-static float pressureToAltitude(const float pressure)
+// (1 - (pressure / 101325)^0.190295) as a polynomial of (pressure - 70kPa) / 40kPa, fitted with Chebyshev nodes from
+// 30kPa to 110kPa (about 9100m to -740m), the error is below 0.5cm there. Outside that range powf() is used.
+#define BARO_ALTITUDE_POLY_MIN_PRESSURE     30000.0f
+#define BARO_ALTITUDE_POLY_MAX_PRESSURE     110000.0f
+#define BARO_ALTITUDE_POLY_CENTER_PRESSURE  70000.0f
+#define BARO_ALTITUDE_POLY_HALF_RANGE       40000.0f
+
+static const float altitudePolynomial[] = {
+     6.795884633e-02f, -1.013506259e-01f,  2.344702478e-02f, -8.072950018e-03f,
+     3.239257951e-03f, -1.462661581e-03f,  6.731634375e-04f, -2.000296886e-04f,
+     9.363741194e-05f, -1.653941618e-04f,  8.473748271e-05f,
+};
+
+STATIC_UNIT_TESTED float pressureToAltitude(const float pressure)
+{
+    if (pressure < BARO_ALTITUDE_POLY_MIN_PRESSURE || pressure > BARO_ALTITUDE_POLY_MAX_PRESSURE) {
+        return (1.0f - powf(pressure / 101325.0f, 0.190295f)) * 4433000.0f;
+    }
+
+    const float x = (pressure - BARO_ALTITUDE_POLY_CENTER_PRESSURE) * (1.0f / BARO_ALTITUDE_POLY_HALF_RANGE);
+    float altitude = altitudePolynomial[ARRAYLEN(altitudePolynomial) - 1];
+    for (int i = ARRAYLEN(altitudePolynomial) - 2; i >= 0; i--) {
+        altitude = altitude * x + altitudePolynomial[i];
+    }
+
+    return altitude * 4433000.0f;
+}
+
+// The noise filter runs once per pressure sample, the coefficient is scaled to the sample interval
+// so that the time constant stays the one baro_noise_lpf gives at the rate of the altitude task.
+STATIC_UNIT_TESTED float baroNoiseLpfCoefficient(timeDelta_t sampleIntervalUs)
 {
-    return (1.0f - powf(pressure / 101325.0f, 0.190295f)) * 4433000.0f;
+    const float coefficient = CONVERT_PARAMETER_TO_FLOAT(barometerConfig()->baro_noise_lpf);
+    if (sampleIntervalUs <= 0 || sampleIntervalUs == BARO_NOISE_LPF_PERIOD_US) {
+        return coefficient;
+    }
+    return powf(coefficient, (float)sampleIntervalUs / BARO_NOISE_LPF_PERIOD_US);
 }
 
 int32_t baroCalculateAltitude(void)
 {
+    static timeUs_t previousSampleTimeUs = 0;
     int32_t BaroAlt_tmp;
 
+    const timeDelta_t sampleIntervalUs = previousSampleTimeUs ? cmpTimeUs(baroTopic.sampleTimeUs, previousSampleTimeUs) : 0;
+    previousSampleTimeUs = baroTopic.sampleTimeUs;
+
     // calculates height from ground via baro readings
     if (baroIsCalibrationComplete()) {
         BaroAlt_tmp = lrintf(pressureToAltitude((float)(baroPressureSum / PRESSURE_SAMPLE_COUNT)));
         BaroAlt_tmp -= baroGroundAltitude;
-        baro.BaroAlt = lrintf((float)baro.BaroAlt * CONVERT_PARAMETER_TO_FLOAT(barometerConfig()->baro_noise_lpf) + (float)BaroAlt_tmp * (1.0f - CONVERT_PARAMETER_TO_FLOAT(barometerConfig()->baro_noise_lpf))); // additional LPF to reduce baro noise
+        const float noiseLpf = baroNoiseLpfCoefficient(sampleIntervalUs);
+        baro.BaroAlt = lrintf((float)baro.BaroAlt * noiseLpf + (float)BaroAlt_tmp * (1.0f - noiseLpf)); // additional LPF to reduce baro noise
     }
     else {
         baro.BaroAlt = 0;
@@ -474,7 +532,7 @@ void performBaroCalibrationCycle(void)
 
     baroGroundPressure -= baroGroundPressure / 8;
     baroGroundPressure += baroPressureSum / PRESSURE_SAMPLE_COUNT;
-    baroGroundAltitude = (1.0f - pow_approx((baroGroundPressure / 8) / 101325.0f, 0.190259f)) * 4433000.0f;
+    baroGroundAltitude = lrintf(pressureToAltitude((float)(baroGroundPressure / 8)));
 
     if (baroGroundPressure == savedGroundPressure) {
         calibratingB = 0;
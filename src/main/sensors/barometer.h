@@ -20,7 +20,11 @@
 
 #pragma once
 
+#include "common/time.h"
+#include "common/topic.h"
+
 #include "pg/pg.h"
+
 #include "drivers/barometer/barometer.h"
 
 typedef enum {
@@ -36,6 +40,7 @@ typedef enum {
 } baroSensor_e;
 
 #define BARO_SAMPLE_COUNT_MAX   48
+#define BARO_TEMPERATURE_DECIMATION_MAX 50
 
 typedef struct barometerConfig_s {
     uint8_t baro_bustype;
@@ -49,6 +54,7 @@ typedef struct barometerConfig_s {
     uint16_t baro_cf_vel;                   // apply Complimentary Filter to keep the calculated velocity based on baro velocity (i.e. near real velocity)
     ioTag_t baro_eoc_tag;
     ioTag_t baro_xclr_tag;
+    uint8_t baro_temp_decimation;           // pressure conversions per temperature conversion on sensors without combined read
 } barometerConfig_t;
 
 PG_DECLARE(barometerConfig_t, barometerConfig);
@@ -58,16 +64,24 @@ typedef struct baro_s {
     int32_t BaroAlt;
     int32_t baroTemperature;             // Use temperature for telemetry
     int32_t baroPressure;                // Use pressure for telemetry
+    timeUs_t baroTemperatureTimeUs;      // time of the temperature conversion the pressure was compensated with
 } baro_t;
 
 extern baro_t baro;
 
+TOPIC_DECLARE(baro_t, baro);
+
 void baroPreInit(void);
 bool baroDetect(baroDev_t *dev, baroSensor_e baroHardwareToUse);
 bool baroIsCalibrationComplete(void);
 void baroStartCalibration(void);
 void baroSetGroundLevel(void);
-uint32_t baroUpdate(void);
+uint32_t baroUpdate(timeUs_t currentTimeUs);
 bool isBaroReady(void);
 int32_t baroCalculateAltitude(void);
 void performBaroCalibrationCycle(void);
+bool baroIsTemperatureStale(timeUs_t currentTimeUs);
+#ifdef UNIT_TEST
+float pressureToAltitude(const float pressure);
+float baroNoiseLpfCoefficient(timeDelta_t sampleIntervalUs);
+#endif
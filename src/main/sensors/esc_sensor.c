@@ -209,6 +209,11 @@ static void escSensorDataReceive(uint16_t c, void *data)
 
 bool escSensorInit(void)
 {
+    // Without a serial port the data can still come from extended DShot telemetry
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i = i + 1) {
+        escSensorData[i].dataAge = ESC_DATA_INVALID;
+    }
+
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_ESC_SENSOR);
     if (!portConfig) {
         return false;
@@ -219,10 +224,6 @@ bool escSensorInit(void)
     // Initialize serial port
     escSensorPort = openSerialPort(portConfig->identifier, FUNCTION_ESC_SENSOR, escSensorDataReceive, NULL, ESC_SENSOR_BAUDRATE, MODE_RX, options);
 
-    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i = i + 1) {
-        escSensorData[i].dataAge = ESC_DATA_INVALID;
-    }
-
     return escSensorPort != NULL;
 }
 
@@ -298,12 +299,64 @@ static void selectNextMotor(void)
     }
 }
 
+#ifdef USE_DSHOT_TELEMETRY
+// Extended DShot telemetry values replace the serial data of a motor while they are fresh
+static void updateDshotTelemetryData(timeMs_t currentTimeMs)
+{
+    static timeMs_t lastUpdateMs = 0;
+    static float consumptionMah[MAX_SUPPORTED_MOTORS];
+
+    // Nothing is integrated on the first call, the time since boot is no current sample interval
+    const timeMs_t deltaMs = lastUpdateMs ? currentTimeMs - lastUpdateMs : 0;
+    lastUpdateMs = currentTimeMs;
+
+    for (int i = 0; i < getMotorCount(); i = i + 1) {
+        escSensorData_t *escData = &escSensorData[i];
+        bool dataFresh = false;
+        uint16_t value;
+
+        if (getDshotExtendedTelemetry(i, DSHOT_TELEMETRY_TYPE_TEMPERATURE, currentTimeMs, &value)) {
+            escData->temperature = MIN(value, INT8_MAX);
+            dataFresh = true;
+        }
+        if (getDshotExtendedTelemetry(i, DSHOT_TELEMETRY_TYPE_VOLTAGE, currentTimeMs, &value)) {
+            escData->voltage = value * 25;      // 0.25V steps
+            dataFresh = true;
+        }
+        if (getDshotExtendedTelemetry(i, DSHOT_TELEMETRY_TYPE_CURRENT, currentTimeMs, &value)) {
+            escData->current = value * 100;     // 1A steps
+            // The ESC doesn't report consumption, integrate the current instead
+            consumptionMah[i] += escData->current * deltaMs / 360000.0f;
+            escData->consumption = consumptionMah[i];
+            dataFresh = true;
+        }
+
+        if (dataFresh) {
+            if (isDshotMotorTelemetryActive(i)) {
+                escData->rpm = getDshotTelemetry(i);
+            }
+            escData->dataAge = 0;
+            combinedDataNeedsUpdate = true;
+        } else if (!escSensorPort && escData->dataAge != ESC_DATA_INVALID) {
+            escData->dataAge = ESC_DATA_INVALID;
+            combinedDataNeedsUpdate = true;
+        }
+    }
+}
+#endif
+
 // XXX Review ESC sensor under refactored motor handling
 
 void escSensorProcess(timeUs_t currentTimeUs)
 {
     const timeMs_t currentTimeMs = currentTimeUs / 1000;
 
+#ifdef USE_DSHOT_TELEMETRY
+    if (useDshotTelemetry) {
+        updateDshotTelemetryData(currentTimeMs);
+    }
+#endif
+
     if (!escSensorPort || !motorIsEnabled()) {
         return;
     }
@@ -42,6 +42,7 @@
 #include "drivers/io.h"
 
 #include "config/config.h"
+#include "fc/dispatch.h"
 #include "fc/runtime_config.h"
 
 #ifdef USE_GYRO_DATA_ANALYSE
@@ -94,10 +95,30 @@ STATIC_UNIT_TESTED gyroDev_t * const gyroDevPtr = &gyro.gyroSensor1.gyroDev;
 
 #define DEBUG_GYRO_CALIBRATION 3
 
+#define GYRO_CALIBRATION_MIN_DURATION 25            // 1/100 second, shortest calibration
+#define GYRO_CALIBRATION_BIAS_TOLERANCE 0.5f        // raw gyro units, half width of the bias confidence interval
+#define GYRO_CALIBRATION_CONFIDENCE_Z 2.0f          // 95% confidence interval
+#define GYRO_CALIBRATION_MIN_VARIANCE (1.0f / 12)   // quantisation noise of the raw gyro data
+
+#define GYRO_BIAS_MODEL_SCALE 16
+#define GYRO_BIAS_MODEL_UNCERTAINTY 0.5f            // raw gyro units, standard deviation of the stored bias
+#define GYRO_BIAS_MODEL_UPDATE_THRESHOLD 1.0f       // raw gyro units
+#define GYRO_BIAS_MODEL_TEMPERATURE_MIN 0           // degrees C
+#define GYRO_BIAS_MODEL_TEMPERATURE_STEP 10         // degrees C
+#define GYRO_BIAS_MODEL_SAVE_DELAY_US 1000000
+
+#define GYRO_BIAS_REFINE_DURATION_US 1000000        // stillness per refinement step
+#define GYRO_BIAS_REFINE_GAIN 0.25f
+
 #define GYRO_OVERFLOW_TRIGGER_THRESHOLD 31980  // 97.5% full scale (1950dps for 2000dps gyro)
 #define GYRO_OVERFLOW_RESET_THRESHOLD 30340    // 92.5% full scale (1850dps for 2000dps gyro)
 
-PG_REGISTER_WITH_RESET_FN(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 8);
+PG_REGISTER_WITH_RESET_FN(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 9);
+
+PG_REGISTER_ARRAY(gyroBiasModel_t, GYRO_BIAS_MODEL_COUNT, gyroBiasModel, PG_GYRO_BIAS_MODEL, 0);
+
+static bool gyroBiasModelSaveRequired = false;
+static bool gyroBiasModelSaved = false;
 
 #ifndef GYRO_CONFIG_USE_GYRO_DEFAULT
 #define GYRO_CONFIG_USE_GYRO_DEFAULT GYRO_CONFIG_USE_GYRO_1
@@ -107,6 +128,7 @@ void pgResetFn_gyroConfig(gyroConfig_t *gyroConfig)
 {
     gyroConfig->gyroCalibrationDuration = 125;        // 1.25 seconds
     gyroConfig->gyroMovementCalibrationThreshold = 48;
+    gyroConfig->gyro_bias_save = false;
     gyroConfig->gyro_hardware_lpf = GYRO_HARDWARE_LPF_NORMAL;
     gyroConfig->gyro_lowpass_type = FILTER_PT1;
     gyroConfig->gyro_lowpass_hz = 200;  // NOTE: dynamic lpf is enabled by default so this setting is actually
@@ -174,6 +196,11 @@ static int32_t gyroCalculateCalibratingCycles(void)
     return (gyroConfig()->gyroCalibrationDuration * 10000) / gyro.sampleLooptime;
 }
 
+static int32_t gyroCalculateMinCalibratingCycles(void)
+{
+    return MIN((GYRO_CALIBRATION_MIN_DURATION * 10000) / (int32_t)gyro.sampleLooptime, gyroCalculateCalibratingCycles());
+}
+
 static bool isOnFirstGyroCalibrationCycle(const gyroCalibration_t *gyroCalibration)
 {
     return gyroCalibration->cyclesRemaining == gyroCalculateCalibratingCycles();
@@ -196,6 +223,9 @@ void gyroStartCalibration(bool isFirstArmingCalibration)
         return;
     }
 
+    // The temperature selects the bias model bin, it's read here as the gyro loop can't afford the bus access
+    gyroReadTemperature();
+
     gyroSetCalibrationCycles(&gyro.gyroSensor1);
 #ifdef USE_MULTI_GYRO
     gyroSetCalibrationCycles(&gyro.gyroSensor2);
@@ -211,51 +241,257 @@ bool isFirstArmingGyroCalibrationRunning(void)
     return firstArmingCalibrationWasStarted && !gyroIsCalibrationComplete();
 }
 
-STATIC_UNIT_TESTED void performGyroCalibration(gyroSensor_t *gyroSensor, uint8_t gyroMovementCalibrationThreshold)
+static uint8_t gyroSensorIndex(const gyroSensor_t *gyroSensor)
 {
+#ifdef USE_MULTI_GYRO
+    if (gyroSensor == &gyro.gyroSensor2) {
+        return 1;
+    }
+#else
+    UNUSED(gyroSensor);
+#endif
+    return 0;
+}
+
+// Uses the last temperature read by gyroReadTemperature(). Only a few gyro drivers can read
+// the temperature, with the others all the biases fall into the first bin.
+static uint8_t gyroBiasModelTemperatureBin(void)
+{
+    const int bin = (gyroGetTemperature() - GYRO_BIAS_MODEL_TEMPERATURE_MIN) / GYRO_BIAS_MODEL_TEMPERATURE_STEP;
+
+    return constrain(bin, 0, GYRO_BIAS_MODEL_TEMPERATURE_BIN_COUNT - 1);
+}
+
+static void gyroBiasModelLoad(gyroSensor_t *gyroSensor)
+{
+    gyroCalibration_t *calibration = &gyroSensor->calibration;
+    const gyroBiasModel_t *model = gyroBiasModel(gyroSensorIndex(gyroSensor));
+
+    calibration->temperatureBin = gyroBiasModelTemperatureBin();
+    calibration->priorValid = model->validBins & BIT(calibration->temperatureBin);
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-        // Reset g[axis] at start of calibration
-        if (isOnFirstGyroCalibrationCycle(&gyroSensor->calibration)) {
-            gyroSensor->calibration.sum[axis] = 0.0f;
-            devClear(&gyroSensor->calibration.var[axis]);
+        calibration->prior[axis] = (float)model->bias[calibration->temperatureBin][axis] / GYRO_BIAS_MODEL_SCALE;
+    }
+}
+
+static void gyroBiasModelUpdate(gyroSensor_t *gyroSensor, const float *bias)
+{
+    const uint8_t bin = gyroSensor->calibration.temperatureBin;
+    gyroBiasModel_t *model = gyroBiasModelMutable(gyroSensorIndex(gyroSensor));
+
+    // Small changes are within the uncertainty of the model, ignore them to avoid needless flash writes
+    bool changed = !(model->validBins & BIT(bin));
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        changed |= fabsf(bias[axis] - (float)model->bias[bin][axis] / GYRO_BIAS_MODEL_SCALE) > GYRO_BIAS_MODEL_UPDATE_THRESHOLD;
+    }
+
+    if (changed) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            model->bias[bin][axis] = constrain(lrintf(bias[axis] * GYRO_BIAS_MODEL_SCALE), INT16_MIN, INT16_MAX);
+        }
+        model->validBins |= BIT(bin);
+        gyroBiasModelSaveRequired = true;
+    }
+}
+
+static void gyroBiasModelSave(dispatchEntry_t *self)
+{
+    UNUSED(self);
+
+    // Don't save if the user made config changes that have not yet been saved.
+    if (!ARMING_FLAG(ARMED) && !isConfigDirty()) {
+        writeEEPROM();
+        gyroBiasModelSaveRequired = false;
+        gyroBiasModelSaved = true;
+    }
+}
+
+static dispatchEntry_t gyroBiasModelSaveEntry =
+{
+    gyroBiasModelSave, 0, NULL, false
+};
+
+void gyroBiasModelOnDisarm(void)
+{
+    // Saved at most once per power cycle to limit the flash wear
+    if (gyroConfig()->gyro_bias_save && gyroBiasModelSaveRequired && !gyroBiasModelSaved) {
+        // let the disarming process complete before the time consuming flash operation
+        dispatchAdd(&gyroBiasModelSaveEntry, GYRO_BIAS_MODEL_SAVE_DELAY_US);
+    }
+}
+
+// Combines the samples with the bias from the model, returns true when the bias is known well enough
+static bool gyroCalibrationEstimateBias(const gyroCalibration_t *calibration, int axis, float variance, float *bias)
+{
+    const float mean = calibration->sum[axis] / calibration->var[axis].m_n;
+    const float samplePrecision = calibration->var[axis].m_n / MAX(variance, GYRO_CALIBRATION_MIN_VARIANCE);
+    float precision = samplePrecision;
+
+    *bias = mean;
+    if (calibration->priorValid) {
+        const float priorPrecision = 1.0f / sq(GYRO_BIAS_MODEL_UNCERTAINTY);
+        precision += priorPrecision;
+        *bias = (mean * samplePrecision + calibration->prior[axis] * priorPrecision) / precision;
+    }
+
+    return precision >= sq(GYRO_CALIBRATION_CONFIDENCE_Z / GYRO_CALIBRATION_BIAS_TOLERANCE);
+}
+
+static void gyroCompleteCalibration(gyroSensor_t *gyroSensor, const float *bias)
+{
+    // DEBUG_GYRO_CALIBRATION records the standard deviation of roll
+    // into the spare field - debug[3], in DEBUG_GYRO_RAW
+    DEBUG_SET(DEBUG_GYRO_RAW, DEBUG_GYRO_CALIBRATION, lrintf(devStandardDeviation(&gyroSensor->calibration.var[X])));
+
+    gyroBiasModelUpdate(gyroSensor, bias);
+
+    // please take care with exotic boardalignment !!
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroSensor->gyroDev.gyroZero[axis] = bias[axis];
+    }
+    gyroSensor->gyroDev.gyroZero[Z] -= ((float)gyroConfig()->gyro_offset_yaw / 100);
+
+    schedulerResetTaskStatistics(TASK_SELF); // so calibration cycles do not pollute tasks statistics
+    if (!firstArmingCalibrationWasStarted || (getArmingDisableFlags() & ~ARMING_DISABLED_CALIBRATING) == 0) {
+        beeper(BEEPER_GYRO_CALIBRATED);
+    }
+
+    gyroSensor->calibration.stillSamples = 0;
+    gyroSensor->calibration.cyclesRemaining = 0;
+}
+
+STATIC_UNIT_TESTED void performGyroCalibration(gyroSensor_t *gyroSensor, uint8_t gyroMovementCalibrationThreshold)
+{
+    gyroCalibration_t *calibration = &gyroSensor->calibration;
+
+    if (calibration->cyclesRemaining <= 0) {
+        return;
+    }
+
+    if (isOnFirstGyroCalibrationCycle(calibration)) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            calibration->sum[axis] = 0.0f;
+            devClear(&calibration->var[axis]);
             // gyroZero is set to zero until calibration complete
             gyroSensor->gyroDev.gyroZero[axis] = 0.0f;
         }
+        gyroBiasModelLoad(gyroSensor);
+    }
 
-        // Sum up CALIBRATING_GYRO_TIME_US readings
-        gyroSensor->calibration.sum[axis] += gyroSensor->gyroDev.gyroADCRaw[axis];
-        devPush(&gyroSensor->calibration.var[axis], gyroSensor->gyroDev.gyroADCRaw[axis]);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        calibration->sum[axis] += gyroSensor->gyroDev.gyroADCRaw[axis];
+        devPush(&calibration->var[axis], gyroSensor->gyroDev.gyroADCRaw[axis]);
+    }
 
-        if (isOnFinalGyroCalibrationCycle(&gyroSensor->calibration)) {
-            const float stddev = devStandardDeviation(&gyroSensor->calibration.var[axis]);
-            // DEBUG_GYRO_CALIBRATION records the standard deviation of roll
-            // into the spare field - debug[3], in DEBUG_GYRO_RAW
-            if (axis == X) {
-                DEBUG_SET(DEBUG_GYRO_RAW, DEBUG_GYRO_CALIBRATION, lrintf(stddev));
-            }
+    // The calibration ends as soon as the bias is known well enough, the configured duration is the upper limit
+    const bool isFinalCycle = isOnFinalGyroCalibrationCycle(calibration);
+    if (isFinalCycle || calibration->var[X].m_n >= gyroCalculateMinCalibratingCycles()) {
+        float variance[XYZ_AXIS_COUNT];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            variance[axis] = devVariance(&calibration->var[axis]);
 
             // check deviation and startover in case the model was moved
-            if (gyroMovementCalibrationThreshold && stddev > gyroMovementCalibrationThreshold) {
+            if (gyroMovementCalibrationThreshold && variance[axis] > sq(gyroMovementCalibrationThreshold)) {
                 gyroSetCalibrationCycles(gyroSensor);
                 return;
             }
 
-            // please take care with exotic boardalignment !!
-            gyroSensor->gyroDev.gyroZero[axis] = gyroSensor->calibration.sum[axis] / gyroCalculateCalibratingCycles();
-            if (axis == Z) {
-              gyroSensor->gyroDev.gyroZero[axis] -= ((float)gyroConfig()->gyro_offset_yaw / 100);
+            // the bias has drifted away from the model, e.g. due to aging
+            const float priorError = calibration->sum[axis] / calibration->var[axis].m_n - calibration->prior[axis];
+            const float priorVariance = MAX(variance[axis], GYRO_CALIBRATION_MIN_VARIANCE) / calibration->var[axis].m_n + sq(GYRO_BIAS_MODEL_UNCERTAINTY);
+            if (sq(priorError) > sq(GYRO_CALIBRATION_CONFIDENCE_Z) * priorVariance) {
+                calibration->priorValid = false;
             }
         }
+
+        float bias[XYZ_AXIS_COUNT];
+        bool isConfident = true;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            isConfident &= gyroCalibrationEstimateBias(calibration, axis, variance[axis], &bias[axis]);
+        }
+        if (isConfident || isFinalCycle) {
+            gyroCompleteCalibration(gyroSensor, bias);
+            return;
+        }
+    }
+
+    --calibration->cyclesRemaining;
+}
+
+// Follows the bias drift while the craft is disarmed and kept still, using the latest sample at each call
+static void gyroRefineBias(gyroSensor_t *gyroSensor, uint8_t gyroMovementCalibrationThreshold, timeUs_t currentTimeUs)
+{
+    gyroCalibration_t *calibration = &gyroSensor->calibration;
+    gyroDev_t *gyroDev = &gyroSensor->gyroDev;
+
+    if (!gyroMovementCalibrationThreshold) {
+        return;
+    }
+
+    float bias[XYZ_AXIS_COUNT];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        bias[axis] = gyroDev->gyroZero[axis];
+    }
+    bias[Z] += ((float)gyroConfig()->gyro_offset_yaw / 100);
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (fabsf(gyroDev->gyroADCRaw[axis] - bias[axis]) > gyroMovementCalibrationThreshold) {
+            calibration->stillSamples = 0;
+            return;
+        }
+    }
+
+    if (calibration->stillSamples == 0) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            calibration->sum[axis] = 0.0f;
+            devClear(&calibration->var[axis]);
+        }
+        calibration->stillSinceUs = currentTimeUs;
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        calibration->sum[axis] += gyroDev->gyroADCRaw[axis];
+        devPush(&calibration->var[axis], gyroDev->gyroADCRaw[axis]);
+    }
+
+    calibration->stillSamples++;
+    if (cmpTimeUs(currentTimeUs, calibration->stillSinceUs) < GYRO_BIAS_REFINE_DURATION_US) {
+        return;
     }
+    calibration->stillSamples = 0;
 
-    if (isOnFinalGyroCalibrationCycle(&gyroSensor->calibration)) {
-        schedulerResetTaskStatistics(TASK_SELF); // so calibration cycles do not pollute tasks statistics
-        if (!firstArmingCalibrationWasStarted || (getArmingDisableFlags() & ~ARMING_DISABLED_CALIBRATING) == 0) {
-            beeper(BEEPER_GYRO_CALIBRATED);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (devVariance(&calibration->var[axis]) > sq(gyroMovementCalibrationThreshold)) {
+            return;
         }
     }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float mean = calibration->sum[axis] / calibration->var[axis].m_n;
+        bias[axis] += (mean - bias[axis]) * GYRO_BIAS_REFINE_GAIN;
+        gyroDev->gyroZero[axis] = bias[axis];
+    }
+    gyroDev->gyroZero[Z] -= ((float)gyroConfig()->gyro_offset_yaw / 100);
+
+    // the gyro warms up after power on, so the bias belongs to the current temperature
+    calibration->temperatureBin = gyroBiasModelTemperatureBin();
+    gyroBiasModelUpdate(gyroSensor, bias);
+}
+
+// Called from a low rate task rather than the gyro loop, the refinement doesn't need every sample
+void gyroUpdateBiasRefinement(timeUs_t currentTimeUs)
+{
+    if (ARMING_FLAG(ARMED)) {
+        return;
+    }
 
-    --gyroSensor->calibration.cyclesRemaining;
+    const uint8_t threshold = gyroConfig()->gyroMovementCalibrationThreshold;
+    if (gyro.gyroToUse != GYRO_CONFIG_USE_GYRO_2 && isGyroSensorCalibrationComplete(&gyro.gyroSensor1)) {
+        gyroRefineBias(&gyro.gyroSensor1, threshold, currentTimeUs);
+    }
+#ifdef USE_MULTI_GYRO
+    if (gyro.gyroToUse != GYRO_CONFIG_USE_GYRO_1 && isGyroSensorCalibrationComplete(&gyro.gyroSensor2)) {
+        gyroRefineBias(&gyro.gyroSensor2, threshold, currentTimeUs);
+    }
+#endif
 }
 
 #if defined(USE_GYRO_SLEW_LIMITER)
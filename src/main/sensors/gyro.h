@@ -62,6 +62,11 @@ typedef struct gyroCalibration_s {
     float sum[XYZ_AXIS_COUNT];
     stdev_t var[XYZ_AXIS_COUNT];
     int32_t cyclesRemaining;
+    float prior[XYZ_AXIS_COUNT];        // bias from the model for the current temperature
+    bool priorValid;
+    uint8_t temperatureBin;
+    int32_t stillSamples;               // samples collected since the disarmed craft became still
+    timeUs_t stillSinceUs;
 } gyroCalibration_t;
 
 typedef struct gyroSensor_s {
@@ -185,6 +190,7 @@ typedef struct gyroConfig_s {
     int16_t  yaw_spin_threshold;
 
     uint16_t gyroCalibrationDuration;   // Gyro calibration duration in 1/100 second
+    uint8_t  gyro_bias_save;            // save the gyro bias model on disarm, at most once per power cycle
 
     uint16_t dyn_lpf_gyro_min_hz;
     uint16_t dyn_lpf_gyro_max_hz;
@@ -201,12 +207,30 @@ typedef struct gyroConfig_s {
 
 PG_DECLARE(gyroConfig_t, gyroConfig);
 
+#define GYRO_BIAS_MODEL_TEMPERATURE_BIN_COUNT 8
+
+#ifdef USE_MULTI_GYRO
+#define GYRO_BIAS_MODEL_COUNT 2
+#else
+#define GYRO_BIAS_MODEL_COUNT 1
+#endif
+
+// Calibrated gyro bias per temperature range, used as the starting point of the next calibration
+typedef struct gyroBiasModel_s {
+    int16_t bias[GYRO_BIAS_MODEL_TEMPERATURE_BIN_COUNT][XYZ_AXIS_COUNT]; // 1/16 of the raw gyro unit
+    uint8_t validBins;                                                   // bit mask of the bins holding a bias
+} gyroBiasModel_t;
+
+PG_DECLARE_ARRAY(gyroBiasModel_t, GYRO_BIAS_MODEL_COUNT, gyroBiasModel);
+
 void gyroUpdate(void);
 void gyroFiltering(timeUs_t currentTimeUs);
 bool gyroGetAccumulationAverage(float *accumulation);
 void gyroStartCalibration(bool isFirstArmingCalibration);
 bool isFirstArmingGyroCalibrationRunning(void);
 bool gyroIsCalibrationComplete(void);
+void gyroBiasModelOnDisarm(void);
+void gyroUpdateBiasRefinement(timeUs_t currentTimeUs);
 void gyroReadTemperature(void);
 int16_t gyroGetTemperature(void);
 bool gyroOverflowDetected(void);
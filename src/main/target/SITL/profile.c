@@ -0,0 +1,170 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Function level profile of the SITL build, built with OPTIONS=SITL_PROFILE.
+// Every instrumented function records its call count and self time, the profile is
+// written on exit and is the input of src/utils/hot_code_placement.py.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "platform.h"
+
+#ifdef SITL_PROFILE
+
+#define PROFILE_FUNCTION_COUNT 8192     // power of 2
+#define PROFILE_MAX_DEPTH 256
+#define PROFILE_DEFAULT_FILENAME "profile.txt"
+
+#define NO_INSTRUMENT __attribute__((no_instrument_function))
+
+typedef struct profileEntry_s {
+    void *function;
+    uint64_t calls;
+    uint64_t selfTimeNs;
+} profileEntry_t;
+
+typedef struct profileFrame_s {
+    profileEntry_t *entry;
+    uint64_t startNs;
+    uint64_t childTimeNs;
+} profileFrame_t;
+
+static profileEntry_t entries[PROFILE_FUNCTION_COUNT];
+static profileFrame_t stack[PROFILE_MAX_DEPTH];
+static int depth;
+static bool overflow;
+
+// only the main loop is profiled, the simulator and TCP threads are not part of the firmware
+static pthread_t mainThread;
+
+int main(void);
+
+void __cyg_profile_func_enter(void *function, void *callSite) NO_INSTRUMENT;
+void __cyg_profile_func_exit(void *function, void *callSite) NO_INSTRUMENT;
+
+static NO_INSTRUMENT uint64_t profileTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static NO_INSTRUMENT profileEntry_t *profileFindEntry(void *function)
+{
+    unsigned index = ((uintptr_t)function >> 2) & (PROFILE_FUNCTION_COUNT - 1);
+    for (int i = 0; i < PROFILE_FUNCTION_COUNT; i++) {
+        profileEntry_t *entry = &entries[index];
+        if (entry->function == function) {
+            return entry;
+        }
+        if (!entry->function) {
+            entry->function = function;
+            return entry;
+        }
+        index = (index + 1) & (PROFILE_FUNCTION_COUNT - 1);
+    }
+
+    overflow = true;
+    return NULL;
+}
+
+void __cyg_profile_func_enter(void *function, void *callSite)
+{
+    (void)callSite;
+
+    if (!pthread_equal(pthread_self(), mainThread) || depth >= PROFILE_MAX_DEPTH) {
+        depth += (depth >= PROFILE_MAX_DEPTH);
+        return;
+    }
+
+    profileFrame_t *frame = &stack[depth++];
+    frame->entry = profileFindEntry(function);
+    frame->childTimeNs = 0;
+    frame->startNs = profileTimeNs();
+}
+
+void __cyg_profile_func_exit(void *function, void *callSite)
+{
+    (void)function;
+    (void)callSite;
+
+    if (!pthread_equal(pthread_self(), mainThread) || depth == 0) {
+        return;
+    }
+
+    if (depth > PROFILE_MAX_DEPTH) {
+        depth--;
+        return;
+    }
+
+    const profileFrame_t *frame = &stack[--depth];
+    const uint64_t elapsedNs = profileTimeNs() - frame->startNs;
+    if (frame->entry) {
+        frame->entry->calls++;
+        frame->entry->selfTimeNs += elapsedNs - frame->childTimeNs;
+    }
+    if (depth > 0) {
+        stack[depth - 1].childTimeNs += elapsedNs;
+    }
+}
+
+static NO_INSTRUMENT void profileWrite(void)
+{
+    const char *filename = getenv("SITL_PROFILE_FILE");
+    FILE *file = fopen(filename ? filename : PROFILE_DEFAULT_FILENAME, "w");
+    if (!file) {
+        return;
+    }
+
+    // the addresses are written relative to main() so that they can be resolved with nm
+    fprintf(file, "# betaflight SITL function profile: address calls self_time_ns\n");
+    if (overflow) {
+        fprintf(file, "# more than %d functions, the profile is incomplete\n", PROFILE_FUNCTION_COUNT);
+    }
+    fprintf(file, "anchor main %p\n", (void *)main);
+    for (int i = 0; i < PROFILE_FUNCTION_COUNT; i++) {
+        if (entries[i].function) {
+            fprintf(file, "%p %llu %llu\n", entries[i].function, (unsigned long long)entries[i].calls, (unsigned long long)entries[i].selfTimeNs);
+        }
+    }
+    fclose(file);
+}
+
+static NO_INSTRUMENT void profileSignalHandler(int signal)
+{
+    (void)signal;
+    exit(0);
+}
+
+static NO_INSTRUMENT __attribute__((constructor)) void profileInit(void)
+{
+    mainThread = pthread_self();
+    atexit(profileWrite);
+    signal(SIGINT, profileSignalHandler);
+    signal(SIGTERM, profileSignalHandler);
+}
+
+#endif // SITL_PROFILE
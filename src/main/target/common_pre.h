@@ -139,6 +139,11 @@
 #define DEFAULT_AUX_CHANNEL_COUNT       6
 #endif
 
+// Barometer compensation in single precision float instead of the 64 bit integer reference code
+#if ((__FPU_PRESENT == 1) && (__FPU_USED == 1)) || defined(SIMULATOR_BUILD)
+#define USE_BARO_FLOAT_COMPENSATION
+#endif
+
 // Set the default cpu_overclock to the first level (108MHz) for F411
 // Helps with looptime stability as the CPU is borderline when running native gyro sampling
 #if defined(USE_OVERCLOCK) && defined(STM32F411xE)
@@ -366,6 +371,7 @@
 #define USE_PROFILE_NAMES
 #define USE_SERIALRX_SRXL2     // Spektrum SRXL2 protocol
 #define USE_INTERPOLATED_SP
+#define USE_SMITH_PREDICTOR
 #define USE_CUSTOM_BOX_NAMES
 #define USE_BATTERY_VOLTAGE_SAG_COMPENSATION
 #endif
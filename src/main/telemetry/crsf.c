@@ -71,7 +71,7 @@
 #define CRSF_DEVICEINFO_VERSION             0x01
 #define CRSF_DEVICEINFO_PARAMETER_COUNT     0
 
-#define CRSF_MSP_BUFFER_SIZE 96
+#define CRSF_MSP_BUFFER_SIZE 128
 #define CRSF_MSP_LENGTH_OFFSET 1
 
 static bool crsfTelemetryEnabled;
@@ -106,25 +106,34 @@ bool bufferCrsfMspFrame(uint8_t *frameStart, int frameLength)
 
 bool handleCrsfMspFrameBuffer(uint8_t payloadSize, mspResponseFnPtr responseFn)
 {
-    bool requestHandled = false;
-    if (!mspRxBuffer.len) {
-        return false;
-    }
-    int pos = 0;
-    while (true) {
-        const int mspFrameLength = mspRxBuffer.bytes[pos];
-        if (handleMspFrame(&mspRxBuffer.bytes[CRSF_MSP_LENGTH_OFFSET + pos], mspFrameLength, NULL)) {
-            requestHandled |= sendMspReply(payloadSize, responseFn);
-        }
-        pos += CRSF_MSP_LENGTH_OFFSET + mspFrameLength;
-        ATOMIC_BLOCK(NVIC_PRIO_SERIALUART1) {
-            if (pos >= mspRxBuffer.len) {
-                mspRxBuffer.len = 0;
-                return requestHandled;
+    static bool replyPending = false;
+
+    // Requests of several clients may be interleaved, so all buffered frames are handled before a response chunk is sent
+    if (mspRxBuffer.len) {
+        int pos = 0;
+        while (true) {
+            const int mspFrameLength = mspRxBuffer.bytes[pos];
+            replyPending = handleMspFrame(&mspRxBuffer.bytes[CRSF_MSP_LENGTH_OFFSET + pos], mspFrameLength, NULL);
+            pos += CRSF_MSP_LENGTH_OFFSET + mspFrameLength;
+            bool done = false;
+            ATOMIC_BLOCK(NVIC_PRIO_SERIALUART1) {
+                if (pos >= mspRxBuffer.len) {
+                    mspRxBuffer.len = 0;
+                    done = true;
+                }
+            }
+            if (done) {
+                break;
             }
         }
     }
-    return requestHandled;
+
+    // A response that spans several frames is continued on the following calls
+    if (replyPending) {
+        replyPending = sendMspReply(payloadSize, responseFn);
+    }
+
+    return replyPending;
 }
 #endif
 
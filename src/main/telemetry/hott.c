@@ -82,6 +82,8 @@
 
 #include "io/gps.h"
 
+#include "scheduler/scheduler.h"
+
 #include "sensors/battery.h"
 #include "sensors/barometer.h"
 #include "sensors/sensors.h"
@@ -90,7 +92,6 @@
 #include "telemetry/telemetry.h"
 
 #if defined (USE_HOTT_TEXTMODE) && defined (USE_CMS)
-#include "scheduler/scheduler.h"
 #include "io/displayport_hott.h"
 
 #define HOTT_TEXTMODE_TASK_PERIOD 1000
@@ -102,11 +103,9 @@
 
 #define HOTT_MESSAGE_PREPARATION_FREQUENCY_5_HZ ((1000 * 1000) / 5)
 #define HOTT_RX_SCHEDULE 4000
-#define HOTT_TX_DELAY_US 3000
 #define MILLISECONDS_IN_A_SECOND 1000
 
 static uint32_t rxSchedule = HOTT_RX_SCHEDULE;
-static uint32_t txDelayUs = HOTT_TX_DELAY_US;
 
 static uint32_t lastHoTTRequestCheckAt = 0;
 static uint32_t lastMessagesPreparedAt = 0;
@@ -114,11 +113,18 @@ static uint32_t lastHottAlarmSoundTime = 0;
 
 static bool hottIsSending = false;
 
-static uint8_t *hottMsg = NULL;
-static uint8_t hottMsgRemainingBytesToSendCount;
-static uint8_t hottMsgCrc;
+typedef union hottResponse_u {
+    HOTT_GPS_MSG_t gps;
+    HOTT_EAM_MSG_t eam;
+    hottTextModeMsg_t textMode;
+} hottResponse_t;
 
-#define HOTT_CRC_SIZE (sizeof(hottMsgCrc))
+#define HOTT_CRC_SIZE 1
+
+// The response is copied with its checksum when the request is received, preparing the messages does not change it while it is sent
+static uint8_t hottTxBuffer[sizeof(hottResponse_t) + HOTT_CRC_SIZE];
+static uint8_t hottTxLength;
+static uint8_t hottTxPosition;
 
 #define HOTT_BAUDRATE 19200
 #define HOTT_PORT_MODE MODE_RXTX // must be opened in RXTX so that TX and RX pins are allocated.
@@ -341,6 +347,10 @@ static void hottSerialWrite(uint8_t c)
 
 void freeHoTTTelemetryPort(void)
 {
+    setTaskEnabled(TASK_HOTT_TX, false);
+    hottTxLength = 0;
+    hottIsSending = false;
+
     closeSerialPort(hottPort);
     hottPort = NULL;
     hottTelemetryEnabled = false;
@@ -397,7 +407,6 @@ static void hottConfigurePortForTX(void)
         serialSetMode(hottPort, MODE_TX);
     }
     hottIsSending = true;
-    hottMsgCrc = 0;
 }
 
 static void hottConfigurePortForRX(void)
@@ -408,7 +417,8 @@ static void hottConfigurePortForRX(void)
     } else {
         serialSetMode(hottPort, MODE_RX);
     }
-    hottMsg = NULL;
+    hottTxLength = 0;
+    hottTxPosition = 0;
     hottIsSending = false;
     flushHottRxBuffer();
 }
@@ -436,24 +446,34 @@ void configureHoTTTelemetryPort(void)
     hottTelemetryEnabled = true;
 }
 
-static void hottSendResponse(uint8_t *buffer, int length)
+static void hottSendResponse(const uint8_t *buffer, int length)
 {
-    if (hottIsSending) {
+    if (hottIsSending || hottTxLength) {
         return;
     }
 
-    hottMsg = buffer;
-    hottMsgRemainingBytesToSendCount = length + HOTT_CRC_SIZE;
+    uint8_t crc = 0;
+    for (int i = 0; i < length; i++) {
+        hottTxBuffer[i] = buffer[i];
+        crc += buffer[i];
+    }
+    hottTxBuffer[length] = crc;
+
+    hottTxLength = length + HOTT_CRC_SIZE;
+    hottTxPosition = 0;
+
+    // the bytes are paced by the transmit task, so the telemetry task period does not stretch the gaps
+    setTaskEnabled(TASK_HOTT_TX, true);
 }
 
 static inline void hottSendGPSResponse(void)
 {
-    hottSendResponse((uint8_t *)&hottGPSMessage, sizeof(hottGPSMessage));
+    hottSendResponse((const uint8_t *)&hottGPSMessage, sizeof(hottGPSMessage));
 }
 
 static inline void hottSendEAMResponse(void)
 {
-    hottSendResponse((uint8_t *)&hottEAMMessage, sizeof(hottEAMMessage));
+    hottSendResponse((const uint8_t *)&hottEAMMessage, sizeof(hottEAMMessage));
 }
 
 static void hottPrepareMessages(void) {
@@ -473,7 +493,7 @@ static void hottTextmodeStart()
     rescheduleTask(TASK_TELEMETRY, TASK_PERIOD_HZ(HOTT_TEXTMODE_TASK_PERIOD));
 
     rxSchedule = HOTT_TEXTMODE_RX_SCHEDULE;
-    txDelayUs = HOTT_TEXTMODE_TX_DELAY_US;
+    rescheduleTask(TASK_HOTT_TX, TASK_PERIOD_US(HOTT_TEXTMODE_TX_DELAY_US));
 }
 
 static void hottTextmodeStop()
@@ -485,7 +505,7 @@ static void hottTextmodeStop()
     }
 
     rxSchedule = HOTT_RX_SCHEDULE;
-    txDelayUs = HOTT_TX_DELAY_US;
+    rescheduleTask(TASK_HOTT_TX, TASK_PERIOD_US(HOTT_TX_DELAY_US));
 }
 
 bool hottTextmodeIsAlive()
@@ -536,7 +556,7 @@ static void processHottTextModeRequest(const uint8_t cmd)
     }
 
     hottSetCmsKey(cmd & 0x0f, hottTextModeMessage.esc == HOTT_TEXTMODE_ESC);
-    hottSendResponse((uint8_t *)&hottTextModeMessage, sizeof(hottTextModeMessage));
+    hottSendResponse((const uint8_t *)&hottTextModeMessage, sizeof(hottTextModeMessage));
 }
 #endif
 
@@ -633,26 +653,31 @@ static void hottCheckSerialData(uint32_t currentMicros)
 #endif
 }
 
-static void hottSendTelemetryData(void) {
+/*
+ * Called by the transmit task, which is scheduled every inter-byte gap while a response is pending.
+ * The first run switches the line to transmit, the run after the last byte switches it back.
+ */
+void handleHoTTTransmit(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
 
-    if (!hottIsSending) {
-        hottConfigurePortForTX();
+    if (!hottTelemetryEnabled || !hottTxLength) {
+        setTaskEnabled(TASK_HOTT_TX, false);
         return;
     }
 
-    if (hottMsgRemainingBytesToSendCount == 0) {
-        hottConfigurePortForRX();
+    if (!hottIsSending) {
+        hottConfigurePortForTX();
         return;
     }
 
-    --hottMsgRemainingBytesToSendCount;
-    if (hottMsgRemainingBytesToSendCount == 0) {
-        hottSerialWrite(hottMsgCrc++);
+    if (hottTxPosition < hottTxLength) {
+        hottSerialWrite(hottTxBuffer[hottTxPosition++]);
         return;
     }
 
-    hottMsgCrc += *hottMsg;
-    hottSerialWrite(*hottMsg++);
+    hottConfigurePortForRX();
+    setTaskEnabled(TASK_HOTT_TX, false);
 }
 
 static inline bool shouldPrepareHoTTMessages(uint32_t currentMicros)
@@ -662,7 +687,7 @@ static inline bool shouldPrepareHoTTMessages(uint32_t currentMicros)
 
 static inline bool shouldCheckForHoTTRequest(void)
 {
-    if (hottIsSending) {
+    if (hottIsSending || hottTxLength) {
         return false;
     }
     return true;
@@ -685,8 +710,6 @@ void checkHoTTTelemetryState(void)
 
 void handleHoTTTelemetry(timeUs_t currentTimeUs)
 {
-    static timeUs_t serialTimer;
-
     if (!hottTelemetryEnabled) {
         return;
     }
@@ -699,17 +722,6 @@ void handleHoTTTelemetry(timeUs_t currentTimeUs)
     if (shouldCheckForHoTTRequest()) {
         hottCheckSerialData(currentTimeUs);
     }
-
-    if (!hottMsg)
-        return;
-
-    if (hottIsSending) {
-        if (currentTimeUs - serialTimer < txDelayUs) {
-            return;
-        }
-    }
-    hottSendTelemetryData();
-    serialTimer = currentTimeUs;
 }
 
 #endif
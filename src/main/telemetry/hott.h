@@ -494,7 +494,10 @@ typedef struct HOTT_AIRESC_MSG_s {
     uint8_t stop_byte;      //#44 constant value 0x7d
 } HOTT_AIRESC_MSG_t;
 
+#define HOTT_TX_DELAY_US 3000
+
 void handleHoTTTelemetry(timeUs_t currentTimeUs);
+void handleHoTTTransmit(timeUs_t currentTimeUs);
 void checkHoTTTelemetryState(void);
 
 void initHoTTTelemetry(void);
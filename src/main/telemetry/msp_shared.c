@@ -28,6 +28,8 @@
 
 #include "build/build_config.h"
 
+#include "common/crc.h"
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "msp/msp.h"
@@ -38,6 +40,7 @@
 #include "telemetry/smartport.h"
 
 #define TELEMETRY_MSP_VERSION    1
+#define TELEMETRY_MSP_VERSION_2  2
 #define TELEMETRY_MSP_VER_SHIFT  5
 #define TELEMETRY_MSP_VER_MASK   (0x7 << TELEMETRY_MSP_VER_SHIFT)
 #define TELEMETRY_MSP_ERROR_FLAG (1 << 5)
@@ -47,12 +50,50 @@
 
 #define TELEMETRY_REQUEST_SKIPS_AFTER_EEPROMWRITE 5
 
+// Largest chunk handed to the responseFn, the CRSF extended frame payload is 58 bytes
+#define TELEMETRY_MSP_REPLY_FRAME_SIZE_MAX 64
+
+/*
+ * Version 2 tunnel
+ *
+ * Every chunk starts with the header byte (version 2, start flag and a 4 bit sequence) and a
+ * request ID, so several requests can be in flight and their responses are told apart.
+ * The remaining bytes of the chunks of one request or response form a stream of
+ * <flags> <cmd lo> <cmd hi> <size lo> <size hi> <payload...> <crc>
+ * laid out as in MSPv2, with the CRC8 DVB-S2 of flags, cmd, size and payload. Since the stream is
+ * parsed and generated byte by byte, any chunk size can be used and the CRC is updated as the
+ * chunks are received or sent.
+ */
+#define TELEMETRY_MSP_V2_REQUEST_COUNT  4
+#define TELEMETRY_MSP_V2_HEADER_SIZE    5
+#define TELEMETRY_MSP_V2_FLAG_ERROR     (1 << 0)
+
 enum {
     TELEMETRY_MSP_VER_MISMATCH=0,
     TELEMETRY_MSP_CRC_ERROR=1,
     TELEMETRY_MSP_ERROR=2
 };
 
+typedef enum {
+    MSP_V2_REQUEST_FREE = 0,
+    MSP_V2_REQUEST_RECEIVING,
+    MSP_V2_REQUEST_RESPONDING,
+} mspV2RequestState_e;
+
+typedef struct mspV2Request_s {
+    mspV2RequestState_e state;
+    uint8_t id;
+    uint8_t seq;
+    uint8_t crc;
+    uint16_t streamPosition;
+    uint8_t header[TELEMETRY_MSP_V2_HEADER_SIZE];
+    uint32_t responseOrder;
+    mspPacket_t requestPacket;
+    mspPacket_t responsePacket;
+    mspRxBuffer_t requestBuffer;
+    mspTxBuffer_t responseBuffer;
+} mspV2Request_t;
+
 STATIC_UNIT_TESTED uint8_t checksum = 0;
 STATIC_UNIT_TESTED mspPackage_t mspPackage;
 static mspRxBuffer_t mspRxBuffer;
@@ -60,6 +101,12 @@ static mspTxBuffer_t mspTxBuffer;
 static mspPacket_t mspRxPacket;
 static mspPacket_t mspTxPacket;
 static mspDescriptor_t mspSharedDescriptor;
+static bool mspReplyPending;
+
+STATIC_UNIT_TESTED mspV2Request_t mspV2Requests[TELEMETRY_MSP_V2_REQUEST_COUNT];
+static uint32_t mspV2ResponseCount;
+
+static uint8_t replyFrame[TELEMETRY_MSP_REPLY_FRAME_SIZE_MAX];
 
 void initSharedMsp(void)
 {
@@ -73,6 +120,8 @@ void initSharedMsp(void)
     mspPackage.responsePacket->buf.ptr = mspPackage.responseBuffer;
     mspPackage.responsePacket->buf.end = mspPackage.responseBuffer;
 
+    mspReplyPending = false;
+
     mspSharedDescriptor = mspDescriptorAlloc();
 }
 
@@ -104,7 +153,7 @@ void sendMspErrorResponse(uint8_t error, int16_t cmd)
     sbufSwitchToReader(&mspPackage.responsePacket->buf, mspPackage.responseBuffer);
 }
 
-bool handleMspFrame(uint8_t *frameStart, int frameLength, uint8_t *skipsBeforeResponse)
+static bool handleMspV1Frame(sbuf_t *frameBuf, uint8_t header, uint8_t *skipsBeforeResponse)
 {
     static uint8_t mspStarted = 0;
     static uint8_t lastSeq = 0;
@@ -118,9 +167,7 @@ bool handleMspFrame(uint8_t *frameStart, int frameLength, uint8_t *skipsBeforeRe
     }
 
     mspPacket_t *packet = mspPackage.requestPacket;
-    sbuf_t *frameBuf = sbufInit(&mspPackage.requestFrame, frameStart, frameStart + (uint8_t)frameLength);
     sbuf_t *rxBuf = &mspPackage.requestPacket->buf;
-    const uint8_t header = sbufReadU8(frameBuf);
     const uint8_t seqNumber = header & TELEMETRY_MSP_SEQ_MASK;
     const uint8_t version = (header & TELEMETRY_MSP_VER_MASK) >> TELEMETRY_MSP_VER_SHIFT;
 
@@ -149,31 +196,22 @@ bool handleMspFrame(uint8_t *frameStart, int frameLength, uint8_t *skipsBeforeRe
         return false;
     }
 
-    const uint8_t bufferBytesRemaining = sbufBytesRemaining(rxBuf);
-    const uint8_t frameBytesRemaining = sbufBytesRemaining(frameBuf);
-    uint8_t payload[frameBytesRemaining];
+    const int bufferBytesRemaining = sbufBytesRemaining(rxBuf);
+    const int frameBytesRemaining = sbufBytesRemaining(frameBuf);
+    const int length = MIN(bufferBytesRemaining, frameBytesRemaining);
+
+    checksum = crc8_xor_update(checksum, sbufPtr(frameBuf), length);
+    sbufWriteData(rxBuf, sbufPtr(frameBuf), length);
+    sbufAdvance(frameBuf, length);
 
     if (bufferBytesRemaining >= frameBytesRemaining) {
-        sbufReadData(frameBuf, payload, frameBytesRemaining);
-        sbufAdvance(frameBuf, frameBytesRemaining);
-        sbufWriteData(rxBuf, payload, frameBytesRemaining);
         lastSeq = seqNumber;
 
         return false;
-    } else {
-        sbufReadData(frameBuf, payload, bufferBytesRemaining);
-        sbufAdvance(frameBuf, bufferBytesRemaining);
-        sbufWriteData(rxBuf, payload, bufferBytesRemaining);
-        sbufSwitchToReader(rxBuf, mspPackage.requestBuffer);
-        while (sbufBytesRemaining(rxBuf)) {
-            checksum ^= sbufReadU8(rxBuf);
-        }
-
-        if (checksum != *frameBuf->ptr) {
-            mspStarted = 0;
-            sendMspErrorResponse(TELEMETRY_MSP_CRC_ERROR, packet->cmd);
-            return true;
-        }
+    } else if (checksum != *frameBuf->ptr) {
+        mspStarted = 0;
+        sendMspErrorResponse(TELEMETRY_MSP_CRC_ERROR, packet->cmd);
+        return true;
     }
 
     // Skip a few telemetry requests if command is MSP_EEPROM_WRITE
@@ -187,14 +225,201 @@ bool handleMspFrame(uint8_t *frameStart, int frameLength, uint8_t *skipsBeforeRe
     return true;
 }
 
-bool sendMspReply(uint8_t payloadSize, mspResponseFnPtr responseFn)
+static mspV2Request_t *findMspV2Request(uint8_t id)
+{
+    for (unsigned i = 0; i < ARRAYLEN(mspV2Requests); i++) {
+        if (mspV2Requests[i].state != MSP_V2_REQUEST_FREE && mspV2Requests[i].id == id) {
+            return &mspV2Requests[i];
+        }
+    }
+
+    return NULL;
+}
+
+static mspV2Request_t *allocMspV2Request(void)
+{
+    for (unsigned i = 0; i < ARRAYLEN(mspV2Requests); i++) {
+        if (mspV2Requests[i].state == MSP_V2_REQUEST_FREE) {
+            return &mspV2Requests[i];
+        }
+    }
+
+    return NULL;
+}
+
+static mspV2Request_t *nextMspV2Response(void)
+{
+    mspV2Request_t *next = NULL;
+    for (unsigned i = 0; i < ARRAYLEN(mspV2Requests); i++) {
+        mspV2Request_t *request = &mspV2Requests[i];
+        if (request->state == MSP_V2_REQUEST_RESPONDING && (!next || (int32_t)(request->responseOrder - next->responseOrder) < 0)) {
+            next = request;
+        }
+    }
+
+    return next;
+}
+
+static void startMspV2Response(mspV2Request_t *request, uint8_t flags)
+{
+    sbuf_t *txBuf = &request->responsePacket.buf;
+    const uint16_t size = sbufBytesRemaining(txBuf);
+    const uint16_t cmd = request->responsePacket.cmd;
+
+    request->header[0] = flags;
+    request->header[1] = cmd & 0xff;
+    request->header[2] = cmd >> 8;
+    request->header[3] = size & 0xff;
+    request->header[4] = size >> 8;
+
+    request->state = MSP_V2_REQUEST_RESPONDING;
+    request->seq = 0;
+    request->crc = 0;
+    request->streamPosition = 0;
+    request->responseOrder = mspV2ResponseCount++;
+}
+
+static void sendMspV2ErrorResponse(mspV2Request_t *request, uint8_t error)
+{
+    uint8_t *responseBuffer = (uint8_t *)&request->responseBuffer;
+    sbuf_t *txBuf = sbufInit(&request->responsePacket.buf, responseBuffer, responseBuffer + sizeof(request->responseBuffer));
+
+    request->responsePacket.cmd = request->requestPacket.cmd;
+    sbufWriteU8(txBuf, error);
+    sbufSwitchToReader(txBuf, responseBuffer);
+
+    startMspV2Response(request, TELEMETRY_MSP_V2_FLAG_ERROR);
+}
+
+static void processMspV2Request(mspV2Request_t *request, uint8_t *skipsBeforeResponse)
+{
+    uint8_t *requestBuffer = (uint8_t *)&request->requestBuffer;
+    uint8_t *responseBuffer = (uint8_t *)&request->responseBuffer;
+    mspPacket_t *reply = &request->responsePacket;
+
+    sbufSwitchToReader(&request->requestPacket.buf, requestBuffer);
+
+    reply->cmd = request->requestPacket.cmd;
+    reply->result = 0;
+    sbufInit(&reply->buf, responseBuffer, responseBuffer + sizeof(request->responseBuffer));
+
+    uint8_t flags = 0;
+    mspPostProcessFnPtr mspPostProcessFn = NULL;
+    if (mspFcProcessCommand(mspSharedDescriptor, &request->requestPacket, reply, &mspPostProcessFn) == MSP_RESULT_ERROR) {
+        flags |= TELEMETRY_MSP_V2_FLAG_ERROR;
+    }
+    if (mspPostProcessFn) {
+        mspPostProcessFn(NULL);
+    }
+
+    sbufSwitchToReader(&reply->buf, responseBuffer);
+
+    // Skip a few telemetry requests if command is MSP_EEPROM_WRITE
+    if (request->requestPacket.cmd == MSP_EEPROM_WRITE && skipsBeforeResponse) {
+        *skipsBeforeResponse = TELEMETRY_REQUEST_SKIPS_AFTER_EEPROMWRITE;
+    }
+
+    startMspV2Response(request, flags);
+}
+
+static void receiveMspV2Byte(mspV2Request_t *request, uint8_t c, uint8_t *skipsBeforeResponse)
+{
+    sbuf_t *rxBuf = &request->requestPacket.buf;
+
+    if (request->streamPosition < TELEMETRY_MSP_V2_HEADER_SIZE) {
+        request->header[request->streamPosition++] = c;
+        request->crc = crc8_dvb_s2(request->crc, c);
+
+        if (request->streamPosition == TELEMETRY_MSP_V2_HEADER_SIZE) {
+            const uint16_t size = request->header[3] | (request->header[4] << 8);
+            uint8_t *requestBuffer = (uint8_t *)&request->requestBuffer;
+
+            request->requestPacket.flags = request->header[0];
+            request->requestPacket.cmd = request->header[1] | (request->header[2] << 8);
+            request->requestPacket.result = 0;
+            sbufInit(rxBuf, requestBuffer, requestBuffer + size);
+
+            if (size > sizeof(request->requestBuffer)) {
+                sendMspV2ErrorResponse(request, TELEMETRY_MSP_ERROR);
+            }
+        }
+    } else if (sbufBytesRemaining(rxBuf)) {
+        sbufWriteU8(rxBuf, c);
+        request->crc = crc8_dvb_s2(request->crc, c);
+        request->streamPosition++;
+    } else if (c != request->crc) {
+        sendMspV2ErrorResponse(request, TELEMETRY_MSP_CRC_ERROR);
+    } else {
+        processMspV2Request(request, skipsBeforeResponse);
+    }
+}
+
+static bool mspV2ReplyPending(void)
+{
+    return nextMspV2Response() != NULL;
+}
+
+static void handleMspV2Frame(sbuf_t *frameBuf, uint8_t header, uint8_t *skipsBeforeResponse)
+{
+    if (sbufBytesRemaining(frameBuf) < 1) {
+        return;
+    }
+
+    const uint8_t id = sbufReadU8(frameBuf);
+    const uint8_t seqNumber = header & TELEMETRY_MSP_SEQ_MASK;
+    mspV2Request_t *request = findMspV2Request(id);
+
+    if (header & TELEMETRY_MSP_START_FLAG) {
+        // a repeated request ID restarts the request, dropping any response not yet sent
+        if (!request) {
+            request = allocMspV2Request();
+        }
+        if (!request) {
+            // all requests are in flight, the client will retry
+            return;
+        }
+
+        request->state = MSP_V2_REQUEST_RECEIVING;
+        request->id = id;
+        request->crc = 0;
+        request->streamPosition = 0;
+    } else if (!request || request->state != MSP_V2_REQUEST_RECEIVING) {
+        // no start packet yet, throw this one away
+        return;
+    } else if (((request->seq + 1) & TELEMETRY_MSP_SEQ_MASK) != seqNumber) {
+        // packet loss detected!
+        request->state = MSP_V2_REQUEST_FREE;
+        return;
+    }
+
+    request->seq = seqNumber;
+
+    while (sbufBytesRemaining(frameBuf) && request->state == MSP_V2_REQUEST_RECEIVING) {
+        receiveMspV2Byte(request, sbufReadU8(frameBuf), skipsBeforeResponse);
+    }
+}
+
+bool handleMspFrame(uint8_t *frameStart, int frameLength, uint8_t *skipsBeforeResponse)
+{
+    sbuf_t *frameBuf = sbufInit(&mspPackage.requestFrame, frameStart, frameStart + (uint8_t)frameLength);
+    const uint8_t header = sbufReadU8(frameBuf);
+    const uint8_t version = (header & TELEMETRY_MSP_VER_MASK) >> TELEMETRY_MSP_VER_SHIFT;
+
+    if (version == TELEMETRY_MSP_VERSION_2) {
+        handleMspV2Frame(frameBuf, header, skipsBeforeResponse);
+    } else if (handleMspV1Frame(frameBuf, header, skipsBeforeResponse)) {
+        mspReplyPending = true;
+    }
+
+    return mspReplyPending || mspV2ReplyPending();
+}
+
+static bool sendMspV1Reply(uint8_t payloadSize, mspResponseFnPtr responseFn)
 {
-    static uint8_t checksum = 0;
     static uint8_t seq = 0;
 
-    uint8_t payloadOut[payloadSize];
     sbuf_t payload;
-    sbuf_t *payloadBuf = sbufInit(&payload, payloadOut, payloadOut + payloadSize);
+    sbuf_t *payloadBuf = sbufInit(&payload, replyFrame, replyFrame + payloadSize);
     sbuf_t *txBuf = &mspPackage.responsePacket->buf;
 
     // detect first reply packet
@@ -209,46 +434,94 @@ bool sendMspReply(uint8_t payloadSize, mspResponseFnPtr responseFn)
 
         uint8_t size = sbufBytesRemaining(txBuf);
         sbufWriteU8(payloadBuf, size);
+
+        checksum = size ^ mspPackage.responsePacket->cmd;
     } else {
         // header
         sbufWriteU8(payloadBuf, (seq++ & TELEMETRY_MSP_SEQ_MASK));
     }
 
-    const uint8_t bufferBytesRemaining = sbufBytesRemaining(txBuf);
-    const uint8_t payloadBytesRemaining = sbufBytesRemaining(payloadBuf);
-    uint8_t frame[payloadBytesRemaining];
+    const int bufferBytesRemaining = sbufBytesRemaining(txBuf);
+    const int payloadBytesRemaining = sbufBytesRemaining(payloadBuf);
+    const int length = MIN(bufferBytesRemaining, payloadBytesRemaining);
 
-    if (bufferBytesRemaining >= payloadBytesRemaining) {
+    checksum = crc8_xor_update(checksum, sbufPtr(txBuf), length);
+    sbufWriteData(payloadBuf, sbufPtr(txBuf), length);
+    sbufAdvance(txBuf, length);
 
-        sbufReadData(txBuf, frame, payloadBytesRemaining);
-        sbufAdvance(txBuf, payloadBytesRemaining);
-        sbufWriteData(payloadBuf, frame, payloadBytesRemaining);
-        responseFn(payloadOut);
+    if (bufferBytesRemaining >= payloadBytesRemaining) {
+        responseFn(replyFrame);
 
         return true;
+    }
 
-    } else {
+    sbufSwitchToReader(txBuf, mspPackage.responseBuffer);
 
-        sbufReadData(txBuf, frame, bufferBytesRemaining);
-        sbufAdvance(txBuf, bufferBytesRemaining);
-        sbufWriteData(payloadBuf, frame, bufferBytesRemaining);
-        sbufSwitchToReader(txBuf, mspPackage.responseBuffer);
+    sbufWriteU8(payloadBuf, checksum);
 
-        checksum = sbufBytesRemaining(txBuf) ^ mspPackage.responsePacket->cmd;
+    while (sbufBytesRemaining(payloadBuf)>1) {
+        sbufWriteU8(payloadBuf, 0);
+    }
 
-        while (sbufBytesRemaining(txBuf)) {
-            checksum ^= sbufReadU8(txBuf);
-        }
-        sbufWriteU8(payloadBuf, checksum);
+    mspReplyPending = false;
+    responseFn(replyFrame);
+    return false;
+}
+
+static void sendMspV2Reply(mspV2Request_t *request, uint8_t payloadSize, mspResponseFnPtr responseFn)
+{
+    sbuf_t payload;
+    sbuf_t *payloadBuf = sbufInit(&payload, replyFrame, replyFrame + payloadSize);
+    sbuf_t *txBuf = &request->responsePacket.buf;
 
-        while (sbufBytesRemaining(payloadBuf)>1) {
-            sbufWriteU8(payloadBuf, 0);
+    uint8_t head = (TELEMETRY_MSP_VERSION_2 << TELEMETRY_MSP_VER_SHIFT) | (request->seq++ & TELEMETRY_MSP_SEQ_MASK);
+    if (request->streamPosition == 0) {
+        head |= TELEMETRY_MSP_START_FLAG;
+    }
+    sbufWriteU8(payloadBuf, head);
+    sbufWriteU8(payloadBuf, request->id);
+
+    while (sbufBytesRemaining(payloadBuf) && request->state == MSP_V2_REQUEST_RESPONDING) {
+        uint8_t c;
+        if (request->streamPosition < TELEMETRY_MSP_V2_HEADER_SIZE) {
+            c = request->header[request->streamPosition];
+        } else if (sbufBytesRemaining(txBuf)) {
+            c = sbufReadU8(txBuf);
+        } else {
+            // last byte of the response
+            sbufWriteU8(payloadBuf, request->crc);
+            request->state = MSP_V2_REQUEST_FREE;
+            break;
         }
 
+        request->crc = crc8_dvb_s2(request->crc, c);
+        request->streamPosition++;
+        sbufWriteU8(payloadBuf, c);
     }
 
-    responseFn(payloadOut);
-    return false;
+    while (sbufBytesRemaining(payloadBuf)) {
+        sbufWriteU8(payloadBuf, 0);
+    }
+
+    responseFn(replyFrame);
+}
+
+bool sendMspReply(uint8_t payloadSize, mspResponseFnPtr responseFn)
+{
+    payloadSize = MIN(payloadSize, (uint8_t)TELEMETRY_MSP_REPLY_FRAME_SIZE_MAX);
+
+    if (mspReplyPending) {
+        return sendMspV1Reply(payloadSize, responseFn) || mspV2ReplyPending();
+    }
+
+    mspV2Request_t *request = nextMspV2Response();
+    if (!request) {
+        return false;
+    }
+
+    sendMspV2Reply(request, payloadSize, responseFn);
+
+    return mspReplyPending || mspV2ReplyPending();
 }
 
 #endif
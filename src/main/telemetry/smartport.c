@@ -167,15 +167,38 @@ static uint16_t frSkyDataIdTable[MAX_DATAIDS];
 static uint16_t frSkyEscDataIdTable[MAX_ESC_DATAIDS];
 #endif
 
+// a payload with every byte escaped and the checksum
+#define SMARTPORT_FRAME_BUFFER_SIZE ((sizeof(smartPortPayload_t) + 1) * 2)
+
+// number of sensor values calculated on each run of the telemetry task
+#define SMARTPORT_SENSOR_UPDATES_PER_RUN 4U
+
+// Sensor values are calculated ahead of the poll for them, so the answer is ready within the response window
+typedef struct smartPortSensor_s {
+    smartPortPayload_t payload;
+    uint8_t frame[SMARTPORT_FRAME_BUFFER_SIZE]; // payload stuffed and with checksum, for the serial port
+    uint8_t frameLength;
+    bool valid;
+    bool fresh;     // value changed since it was last sent
+    uint8_t age;    // number of values sent from the same table since this one was sent
+} smartPortSensor_t;
+
 typedef struct frSkyTableInfo_s {
     uint16_t * table;
     uint8_t size;
     uint8_t index;
+    smartPortSensor_t *sensors;
+    uint8_t sensorCount;
 } frSkyTableInfo_t;
 
-static frSkyTableInfo_t frSkyDataIdTableInfo = { frSkyDataIdTable, 0, 0 };
+static smartPortSensor_t smartPortSensors[MAX_DATAIDS];
+static frSkyTableInfo_t frSkyDataIdTableInfo = { frSkyDataIdTable, 0, 0, smartPortSensors, 0 };
 #ifdef USE_ESC_SENSOR_TELEMETRY
-static frSkyTableInfo_t frSkyEscDataIdTableInfo = {frSkyEscDataIdTable, 0, 0};
+// every ESC data ID is sent for each motor and for the combined ESC data
+#define MAX_ESC_SENSORS (MAX_ESC_DATAIDS * (MAX_SUPPORTED_MOTORS + 1))
+
+static smartPortSensor_t smartPortEscSensors[MAX_ESC_SENSORS];
+static frSkyTableInfo_t frSkyEscDataIdTableInfo = { frSkyEscDataIdTable, 0, 0, smartPortEscSensors, 0 };
 #endif
 
 #define SMARTPORT_BAUD 57600
@@ -295,29 +318,46 @@ bool smartPortPayloadContainsMSP(const smartPortPayload_t *payload)
     return payload->frameId == FSSP_MSPC_FRAME_SMARTPORT || payload->frameId == FSSP_MSPC_FRAME_FPORT;
 }
 
-void smartPortWriteFrameSerial(const smartPortPayload_t *payload, serialPort_t *port, uint16_t checksum)
+static uint8_t smartPortStuffByte(uint8_t *frame, uint8_t c)
+{
+    // smart port escape sequence
+    if (c == FSSP_DLE || c == FSSP_START_STOP) {
+        frame[0] = FSSP_DLE;
+        frame[1] = c ^ FSSP_DLE_XOR;
+
+        return 2;
+    }
+
+    frame[0] = c;
+
+    return 1;
+}
+
+static uint8_t smartPortBuildFrame(const smartPortPayload_t *payload, uint8_t *frame, uint16_t checksum)
 {
-    uint8_t *data = (uint8_t *)payload;
+    const uint8_t *data = (const uint8_t *)payload;
+    uint8_t length = 0;
     for (unsigned i = 0; i < sizeof(smartPortPayload_t); i++) {
-        smartPortSendByte(*data++, &checksum, port);
+        length += smartPortStuffByte(&frame[length], data[i]);
+        frskyCheckSumStep(&checksum, data[i]);
     }
     frskyCheckSumFini(&checksum);
-    smartPortSendByte(checksum, NULL, port);
+    length += smartPortStuffByte(&frame[length], checksum);
+
+    return length;
 }
 
-static void smartPortWriteFrameInternal(const smartPortPayload_t *payload)
+void smartPortWriteFrameSerial(const smartPortPayload_t *payload, serialPort_t *port, uint16_t checksum)
 {
-    smartPortWriteFrameSerial(payload, smartPortSerialPort, 0);
+    uint8_t frame[SMARTPORT_FRAME_BUFFER_SIZE];
+    const uint8_t length = smartPortBuildFrame(payload, frame, checksum);
+
+    serialWriteBuf(port, frame, length);
 }
 
-static void smartPortSendPackage(uint16_t id, uint32_t val)
+static void smartPortWriteFrameInternal(const smartPortPayload_t *payload)
 {
-    smartPortPayload_t payload;
-    payload.frameId = FSSP_DATA_FRAME;
-    payload.valueId = id;
-    payload.data = val;
-
-    smartPortWriteFrame(&payload);
+    smartPortWriteFrameSerial(payload, smartPortSerialPort, 0);
 }
 
 #define ADD_SENSOR(dataId) frSkyDataIdTableInfo.table[frSkyDataIdTableInfo.index++] = dataId
@@ -415,6 +455,8 @@ static void initSmartPortSensors(void)
 
     frSkyDataIdTableInfo.size = frSkyDataIdTableInfo.index;
     frSkyDataIdTableInfo.index = 0;
+    frSkyDataIdTableInfo.sensorCount = frSkyDataIdTableInfo.size;
+    memset(smartPortSensors, 0, sizeof(smartPortSensors));
 
 #ifdef USE_ESC_SENSOR_TELEMETRY
     frSkyEscDataIdTableInfo.index = 0;
@@ -434,6 +476,8 @@ static void initSmartPortSensors(void)
 
     frSkyEscDataIdTableInfo.size = frSkyEscDataIdTableInfo.index;
     frSkyEscDataIdTableInfo.index = 0;
+    frSkyEscDataIdTableInfo.sensorCount = 0;
+    memset(smartPortEscSensors, 0, sizeof(smartPortEscSensors));
 #endif
 }
 
@@ -510,378 +554,465 @@ static void smartPortSendMspResponse(uint8_t *data) {
 }
 #endif
 
-void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clearToSend, const timeUs_t *requestTimeout)
+// Calculates the value of a data ID, counters that multiplex several values on one ID only step on to the next value when advance is set
+static bool smartPortCalculateValue(uint16_t id, bool advance, bool longitude, uint32_t *value)
 {
-    static uint8_t smartPortIdCycleCnt = 0;
     static uint8_t t1Cnt = 0;
     static uint8_t t2Cnt = 0;
-    static uint8_t skipRequests = 0;
-#ifdef USE_ESC_SENSOR_TELEMETRY
-    static uint8_t smartPortIdOffset = 0;
-#endif
 
-#if defined(USE_MSP_OVER_TELEMETRY)
-    if (skipRequests) {
-        skipRequests--;
-    } else if (payload && smartPortPayloadContainsMSP(payload)) {
-        // Do not check the physical ID here again
-        // unless we start receiving other sensors' packets
-        // Pass only the payload: skip frameId
-        uint8_t *frameStart = (uint8_t *)&payload->valueId;
-        smartPortMspReplyPending = handleMspFrame(frameStart, SMARTPORT_MSP_PAYLOAD_SIZE, &skipRequests);
-
-        // Don't send MSP response after write to eeprom
-        // CPU just got out of suspended state after writeEEPROM()
-        // We don't know if the receiver is listening again
-        // Skip a few telemetry requests before sending response
-        if (skipRequests) {
-            *clearToSend = false;
-        }
-    }
-#else
-    UNUSED(payload);
-#endif
-
-    bool doRun = true;
-    while (doRun && *clearToSend && !skipRequests) {
-        // Ensure we won't get stuck in the loop if there happens to be nothing available to send in a timely manner - dump the slot if we loop in there for too long.
-        if (requestTimeout) {
-            if (cmpTimeUs(micros(), *requestTimeout) >= 0) {
-                *clearToSend = false;
-
-                return;
-            }
-        } else {
-            doRun = false;
-        }
-
-#if defined(USE_MSP_OVER_TELEMETRY)
-        if (smartPortMspReplyPending) {
-            smartPortMspReplyPending = sendMspReply(SMARTPORT_MSP_PAYLOAD_SIZE, &smartPortSendMspResponse);
-            *clearToSend = false;
-
-            return;
-        }
-#endif
-
-        // we can send back any data we want, our tables keep track of the order and frequency of each data type we send
-        frSkyTableInfo_t * tableInfo = &frSkyDataIdTableInfo;
+    int32_t tmpi;
+    uint32_t tmp2 = 0;
+    uint16_t vfasVoltage;
+    uint8_t cellCount;
 
 #ifdef USE_ESC_SENSOR_TELEMETRY
-        if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
-            // send ESC sensors
-            tableInfo = &frSkyEscDataIdTableInfo;
-            if (tableInfo->index == tableInfo->size) { // end of ESC table, return to other sensors
-                tableInfo->index = 0;
-                smartPortIdCycleCnt = 0;
-                smartPortIdOffset++;
-                if (smartPortIdOffset == getMotorCount() + 1) { // each motor and ESC_SENSOR_COMBINED
-                    smartPortIdOffset = 0;
-                }
-            }
-        }
-        if (smartPortIdCycleCnt < ESC_SENSOR_PERIOD) {
-            // send other sensors
-            tableInfo = &frSkyDataIdTableInfo;
+    escSensorData_t *escData;
 #endif
-            if (tableInfo->index == tableInfo->size) { // end of table reached, loop back
-                tableInfo->index = 0;
-            }
-#ifdef USE_ESC_SENSOR_TELEMETRY
-        }
-#endif
-        uint16_t id = tableInfo->table[tableInfo->index];
-#ifdef USE_ESC_SENSOR_TELEMETRY
-        if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
-            id += smartPortIdOffset;
-        }
-#endif
-        smartPortIdCycleCnt++;
-        tableInfo->index++;
-
-        int32_t tmpi;
-        uint32_t tmp2 = 0;
-        uint16_t vfasVoltage;
-        uint8_t cellCount;
-
-#ifdef USE_ESC_SENSOR_TELEMETRY
-        escSensorData_t *escData;
+#ifndef USE_GPS
+    UNUSED(longitude);
 #endif
 
-        switch (id) {
-            case FSSP_DATAID_VFAS       :
-                vfasVoltage = getBatteryVoltage();
-                if (telemetryConfig()->report_cell_voltage) {
-                    cellCount = getBatteryCellCount();
-                    vfasVoltage = cellCount ? getBatteryVoltage() / cellCount : 0;
-                }
-                smartPortSendPackage(id, vfasVoltage); // in 0.01V according to SmartPort spec
-                *clearToSend = false;
-                break;
+    switch (id) {
+        case FSSP_DATAID_VFAS       :
+            vfasVoltage = getBatteryVoltage();
+            if (telemetryConfig()->report_cell_voltage) {
+                cellCount = getBatteryCellCount();
+                vfasVoltage = cellCount ? getBatteryVoltage() / cellCount : 0;
+            }
+            *value = vfasVoltage; // in 0.01V according to SmartPort spec
+            return true;
 #ifdef USE_ESC_SENSOR_TELEMETRY
-            case FSSP_DATAID_VFAS1      :
-            case FSSP_DATAID_VFAS2      :
-            case FSSP_DATAID_VFAS3      :
-            case FSSP_DATAID_VFAS4      :
-            case FSSP_DATAID_VFAS5      :
-            case FSSP_DATAID_VFAS6      :
-            case FSSP_DATAID_VFAS7      :
-            case FSSP_DATAID_VFAS8      :
-                escData = getEscSensorData(id - FSSP_DATAID_VFAS1);
-                if (escData != NULL) {
-                    smartPortSendPackage(id, escData->voltage);
-                    *clearToSend = false;
-                }
-                break;
+        case FSSP_DATAID_VFAS1      :
+        case FSSP_DATAID_VFAS2      :
+        case FSSP_DATAID_VFAS3      :
+        case FSSP_DATAID_VFAS4      :
+        case FSSP_DATAID_VFAS5      :
+        case FSSP_DATAID_VFAS6      :
+        case FSSP_DATAID_VFAS7      :
+        case FSSP_DATAID_VFAS8      :
+            escData = getEscSensorData(id - FSSP_DATAID_VFAS1);
+            if (escData != NULL) {
+                *value = escData->voltage;
+                return true;
+            }
+            break;
 #endif
-            case FSSP_DATAID_CURRENT    :
-                smartPortSendPackage(id, getAmperage() / 10); // in 0.1A according to SmartPort spec
-                *clearToSend = false;
-                break;
+        case FSSP_DATAID_CURRENT    :
+            *value = getAmperage() / 10; // in 0.1A according to SmartPort spec
+            return true;
 #ifdef USE_ESC_SENSOR_TELEMETRY
-            case FSSP_DATAID_CURRENT1   :
-            case FSSP_DATAID_CURRENT2   :
-            case FSSP_DATAID_CURRENT3   :
-            case FSSP_DATAID_CURRENT4   :
-            case FSSP_DATAID_CURRENT5   :
-            case FSSP_DATAID_CURRENT6   :
-            case FSSP_DATAID_CURRENT7   :
-            case FSSP_DATAID_CURRENT8   :
-                escData = getEscSensorData(id - FSSP_DATAID_CURRENT1);
-                if (escData != NULL) {
-                    smartPortSendPackage(id, escData->current);
-                    *clearToSend = false;
-                }
-                break;
-            case FSSP_DATAID_RPM        :
-                escData = getEscSensorData(ESC_SENSOR_COMBINED);
-                if (escData != NULL) {
-                    smartPortSendPackage(id, calcEscRpm(escData->rpm));
-                    *clearToSend = false;
-                }
-                break;
-            case FSSP_DATAID_RPM1       :
-            case FSSP_DATAID_RPM2       :
-            case FSSP_DATAID_RPM3       :
-            case FSSP_DATAID_RPM4       :
-            case FSSP_DATAID_RPM5       :
-            case FSSP_DATAID_RPM6       :
-            case FSSP_DATAID_RPM7       :
-            case FSSP_DATAID_RPM8       :
-                escData = getEscSensorData(id - FSSP_DATAID_RPM1);
-                if (escData != NULL) {
-                    smartPortSendPackage(id, calcEscRpm(escData->rpm));
-                    *clearToSend = false;
-                }
-                break;
-            case FSSP_DATAID_TEMP        :
-                escData = getEscSensorData(ESC_SENSOR_COMBINED);
-                if (escData != NULL) {
-                    smartPortSendPackage(id, escData->temperature);
-                    *clearToSend = false;
-                }
-                break;
-            case FSSP_DATAID_TEMP1      :
-            case FSSP_DATAID_TEMP2      :
-            case FSSP_DATAID_TEMP3      :
-            case FSSP_DATAID_TEMP4      :
-            case FSSP_DATAID_TEMP5      :
-            case FSSP_DATAID_TEMP6      :
-            case FSSP_DATAID_TEMP7      :
-            case FSSP_DATAID_TEMP8      :
-                escData = getEscSensorData(id - FSSP_DATAID_TEMP1);
-                if (escData != NULL) {
-                    smartPortSendPackage(id, escData->temperature);
-                    *clearToSend = false;
-                }
-                break;
+        case FSSP_DATAID_CURRENT1   :
+        case FSSP_DATAID_CURRENT2   :
+        case FSSP_DATAID_CURRENT3   :
+        case FSSP_DATAID_CURRENT4   :
+        case FSSP_DATAID_CURRENT5   :
+        case FSSP_DATAID_CURRENT6   :
+        case FSSP_DATAID_CURRENT7   :
+        case FSSP_DATAID_CURRENT8   :
+            escData = getEscSensorData(id - FSSP_DATAID_CURRENT1);
+            if (escData != NULL) {
+                *value = escData->current;
+                return true;
+            }
+            break;
+        case FSSP_DATAID_RPM        :
+            escData = getEscSensorData(ESC_SENSOR_COMBINED);
+            if (escData != NULL) {
+                *value = calcEscRpm(escData->rpm);
+                return true;
+            }
+            break;
+        case FSSP_DATAID_RPM1       :
+        case FSSP_DATAID_RPM2       :
+        case FSSP_DATAID_RPM3       :
+        case FSSP_DATAID_RPM4       :
+        case FSSP_DATAID_RPM5       :
+        case FSSP_DATAID_RPM6       :
+        case FSSP_DATAID_RPM7       :
+        case FSSP_DATAID_RPM8       :
+            escData = getEscSensorData(id - FSSP_DATAID_RPM1);
+            if (escData != NULL) {
+                *value = calcEscRpm(escData->rpm);
+                return true;
+            }
+            break;
+        case FSSP_DATAID_TEMP        :
+            escData = getEscSensorData(ESC_SENSOR_COMBINED);
+            if (escData != NULL) {
+                *value = escData->temperature;
+                return true;
+            }
+            break;
+        case FSSP_DATAID_TEMP1      :
+        case FSSP_DATAID_TEMP2      :
+        case FSSP_DATAID_TEMP3      :
+        case FSSP_DATAID_TEMP4      :
+        case FSSP_DATAID_TEMP5      :
+        case FSSP_DATAID_TEMP6      :
+        case FSSP_DATAID_TEMP7      :
+        case FSSP_DATAID_TEMP8      :
+            escData = getEscSensorData(id - FSSP_DATAID_TEMP1);
+            if (escData != NULL) {
+                *value = escData->temperature;
+                return true;
+            }
+            break;
 #endif
-            case FSSP_DATAID_ALTITUDE   :
-                smartPortSendPackage(id, getEstimatedAltitudeCm()); // in cm according to SmartPort spec
-                *clearToSend = false;
-                break;
-            case FSSP_DATAID_FUEL       :
-                smartPortSendPackage(id, getMAhDrawn()); // given in mAh, should be in percent according to SmartPort spec
-                *clearToSend = false;
-                break;
+        case FSSP_DATAID_ALTITUDE   :
+            *value = getEstimatedAltitudeCm(); // in cm according to SmartPort spec
+            return true;
+        case FSSP_DATAID_FUEL       :
+            *value = getMAhDrawn(); // given in mAh, should be in percent according to SmartPort spec
+            return true;
 #if defined(USE_VARIO)
-            case FSSP_DATAID_VARIO      :
-                smartPortSendPackage(id, getEstimatedVario()); // in cm/s according to SmartPort spec
-                *clearToSend = false;
-                break;
+        case FSSP_DATAID_VARIO      :
+            *value = getEstimatedVario(); // in cm/s according to SmartPort spec
+            return true;
 #endif
-            case FSSP_DATAID_HEADING    :
-                smartPortSendPackage(id, attitude.values.yaw * 10); // in degrees * 100 according to SmartPort spec
-                *clearToSend = false;
-                break;
+        case FSSP_DATAID_HEADING    :
+            *value = attitude.values.yaw * 10; // in degrees * 100 according to SmartPort spec
+            return true;
 #if defined(USE_ACC)
-            case FSSP_DATAID_PITCH      :
-                smartPortSendPackage(id, attitude.values.pitch); // given in 10*deg
-                *clearToSend = false;
-                break;
-            case FSSP_DATAID_ROLL       :
-                smartPortSendPackage(id, attitude.values.roll); // given in 10*deg
-                *clearToSend = false;
-                break;
-            case FSSP_DATAID_ACCX       :
-                smartPortSendPackage(id, lrintf(100 * acc.accADC[X] * acc.dev.acc_1G_rec)); // Multiply by 100 to show as x.xx g on Taranis
-                *clearToSend = false;
-                break;
-            case FSSP_DATAID_ACCY       :
-                smartPortSendPackage(id, lrintf(100 * acc.accADC[Y] * acc.dev.acc_1G_rec));
-                *clearToSend = false;
-                break;
-            case FSSP_DATAID_ACCZ       :
-                smartPortSendPackage(id, lrintf(100 * acc.accADC[Z] * acc.dev.acc_1G_rec));
-                *clearToSend = false;
-                break;
+        case FSSP_DATAID_PITCH      :
+            *value = attitude.values.pitch; // given in 10*deg
+            return true;
+        case FSSP_DATAID_ROLL       :
+            *value = attitude.values.roll; // given in 10*deg
+            return true;
+        case FSSP_DATAID_ACCX       :
+            *value = lrintf(100 * acc.accADC[X] * acc.dev.acc_1G_rec); // Multiply by 100 to show as x.xx g on Taranis
+            return true;
+        case FSSP_DATAID_ACCY       :
+            *value = lrintf(100 * acc.accADC[Y] * acc.dev.acc_1G_rec);
+            return true;
+        case FSSP_DATAID_ACCZ       :
+            *value = lrintf(100 * acc.accADC[Z] * acc.dev.acc_1G_rec);
+            return true;
 #endif
-            case FSSP_DATAID_T1         :
-                // we send all the flags as decimal digits for easy reading
+        case FSSP_DATAID_T1         :
+            // we send all the flags as decimal digits for easy reading
 
-                // the t1Cnt simply allows the telemetry view to show at least some changes
+            // the t1Cnt simply allows the telemetry view to show at least some changes
+            if (advance) {
                 t1Cnt++;
                 if (t1Cnt == 4) {
                     t1Cnt = 1;
                 }
-                tmpi = t1Cnt * 10000; // start off with at least one digit so the most significant 0 won't be cut off
-                // the Taranis seems to be able to fit 5 digits on the screen
-                // the Taranis seems to consider this number a signed 16 bit integer
-
-                if (!isArmingDisabled()) {
-                    tmpi += 1;
-                } else {
-                    tmpi += 2;
-                }
-                if (ARMING_FLAG(ARMED)) {
-                    tmpi += 4;
-                }
+            }
+            tmpi = t1Cnt * 10000; // start off with at least one digit so the most significant 0 won't be cut off
+            // the Taranis seems to be able to fit 5 digits on the screen
+            // the Taranis seems to consider this number a signed 16 bit integer
+
+            if (!isArmingDisabled()) {
+                tmpi += 1;
+            } else {
+                tmpi += 2;
+            }
+            if (ARMING_FLAG(ARMED)) {
+                tmpi += 4;
+            }
 
-                if (FLIGHT_MODE(ANGLE_MODE)) {
-                    tmpi += 10;
-                }
-                if (FLIGHT_MODE(HORIZON_MODE)) {
-                    tmpi += 20;
-                }
-                if (FLIGHT_MODE(PASSTHRU_MODE)) {
-                    tmpi += 40;
-                }
+            if (FLIGHT_MODE(ANGLE_MODE)) {
+                tmpi += 10;
+            }
+            if (FLIGHT_MODE(HORIZON_MODE)) {
+                tmpi += 20;
+            }
+            if (FLIGHT_MODE(PASSTHRU_MODE)) {
+                tmpi += 40;
+            }
 
-                if (FLIGHT_MODE(MAG_MODE)) {
-                    tmpi += 100;
-                }
+            if (FLIGHT_MODE(MAG_MODE)) {
+                tmpi += 100;
+            }
 
-                if (FLIGHT_MODE(HEADFREE_MODE)) {
-                    tmpi += 4000;
-                }
+            if (FLIGHT_MODE(HEADFREE_MODE)) {
+                tmpi += 4000;
+            }
 
-                smartPortSendPackage(id, (uint32_t)tmpi);
-                *clearToSend = false;
-                break;
-            case FSSP_DATAID_T2         :
+            *value = (uint32_t)tmpi;
+            return true;
+        case FSSP_DATAID_T2         :
 #ifdef USE_GPS
-                if (sensors(SENSOR_GPS)) {
-                    // satellite accuracy HDOP: 0 = worst [HDOP > 5.5m], 9 = best [HDOP <= 1.0m]
-                    uint16_t hdop = constrain(scaleRange(gpsSol.hdop, 100, 550, 9, 0), 0, 9) * 100;
-                    smartPortSendPackage(id, (STATE(GPS_FIX) ? 1000 : 0) + (STATE(GPS_FIX_HOME) ? 2000 : 0) + hdop + gpsSol.numSat);
-                    *clearToSend = false;
-                } else if (featureIsEnabled(FEATURE_GPS)) {
-                    smartPortSendPackage(id, 0);
-                    *clearToSend = false;
-                } else
+            if (sensors(SENSOR_GPS)) {
+                // satellite accuracy HDOP: 0 = worst [HDOP > 5.5m], 9 = best [HDOP <= 1.0m]
+                uint16_t hdop = constrain(scaleRange(gpsSol.hdop, 100, 550, 9, 0), 0, 9) * 100;
+                *value = (STATE(GPS_FIX) ? 1000 : 0) + (STATE(GPS_FIX_HOME) ? 2000 : 0) + hdop + gpsSol.numSat;
+                return true;
+            } else if (featureIsEnabled(FEATURE_GPS)) {
+                *value = 0;
+                return true;
+            } else
 #endif
-                if (telemetryConfig()->pidValuesAsTelemetry) {
-                    switch (t2Cnt) {
-                        case 0:
-                            tmp2 = currentPidProfile->pid[PID_ROLL].P;
-                            tmp2 += (currentPidProfile->pid[PID_PITCH].P<<8);
-                            tmp2 += (currentPidProfile->pid[PID_YAW].P<<16);
-                        break;
-                        case 1:
-                            tmp2 = currentPidProfile->pid[PID_ROLL].I;
-                            tmp2 += (currentPidProfile->pid[PID_PITCH].I<<8);
-                            tmp2 += (currentPidProfile->pid[PID_YAW].I<<16);
-                        break;
-                        case 2:
-                            tmp2 = currentPidProfile->pid[PID_ROLL].D;
-                            tmp2 += (currentPidProfile->pid[PID_PITCH].D<<8);
-                            tmp2 += (currentPidProfile->pid[PID_YAW].D<<16);
-                        break;
-                        case 3:
-                            tmp2 = currentControlRateProfile->rates[FD_ROLL];
-                            tmp2 += (currentControlRateProfile->rates[FD_PITCH]<<8);
-                            tmp2 += (currentControlRateProfile->rates[FD_YAW]<<16);
-                        break;
-                    }
-                    tmp2 += t2Cnt<<24;
+            if (telemetryConfig()->pidValuesAsTelemetry) {
+                switch (t2Cnt) {
+                    case 0:
+                        tmp2 = currentPidProfile->pid[PID_ROLL].P;
+                        tmp2 += (currentPidProfile->pid[PID_PITCH].P<<8);
+                        tmp2 += (currentPidProfile->pid[PID_YAW].P<<16);
+                    break;
+                    case 1:
+                        tmp2 = currentPidProfile->pid[PID_ROLL].I;
+                        tmp2 += (currentPidProfile->pid[PID_PITCH].I<<8);
+                        tmp2 += (currentPidProfile->pid[PID_YAW].I<<16);
+                    break;
+                    case 2:
+                        tmp2 = currentPidProfile->pid[PID_ROLL].D;
+                        tmp2 += (currentPidProfile->pid[PID_PITCH].D<<8);
+                        tmp2 += (currentPidProfile->pid[PID_YAW].D<<16);
+                    break;
+                    case 3:
+                        tmp2 = currentControlRateProfile->rates[FD_ROLL];
+                        tmp2 += (currentControlRateProfile->rates[FD_PITCH]<<8);
+                        tmp2 += (currentControlRateProfile->rates[FD_YAW]<<16);
+                    break;
+                }
+                tmp2 += t2Cnt<<24;
+                if (advance) {
                     t2Cnt++;
                     if (t2Cnt == 4) {
                         t2Cnt = 0;
                     }
-                    smartPortSendPackage(id, tmp2);
-                    *clearToSend = false;
                 }
+                *value = tmp2;
+                return true;
+            }
 
-                break;
+            break;
 #if defined(USE_ADC_INTERNAL)
-            case FSSP_DATAID_T11        :
-                smartPortSendPackage(id, getCoreTemperatureCelsius());
-                *clearToSend = false;
-                break;
+        case FSSP_DATAID_T11        :
+            *value = getCoreTemperatureCelsius();
+            return true;
 #endif
 #ifdef USE_GPS
-            case FSSP_DATAID_SPEED      :
-                if (STATE(GPS_FIX)) {
-                    //convert to knots: 1cm/s = 0.0194384449 knots
-                    //Speed should be sent in knots/1000 (GPS speed is in cm/s)
-                    uint32_t tmpui = gpsSol.groundSpeed * 1944 / 100;
-                    smartPortSendPackage(id, tmpui);
-                    *clearToSend = false;
-                }
-                break;
-            case FSSP_DATAID_LATLONG    :
-                if (STATE(GPS_FIX)) {
-                    uint32_t tmpui = 0;
-                    // the same ID is sent twice, one for longitude, one for latitude
-                    // the MSB of the sent uint32_t helps FrSky keep track
-                    // the even/odd bit of our counter helps us keep track
-                    if (tableInfo->index & 1) {
-                        tmpui = abs(gpsSol.llh.lon);  // now we have unsigned value and one bit to spare
-                        tmpui = (tmpui + tmpui / 2) / 25 | 0x80000000;  // 6/100 = 1.5/25, division by power of 2 is fast
-                        if (gpsSol.llh.lon < 0) tmpui |= 0x40000000;
-                    }
-                    else {
-                        tmpui = abs(gpsSol.llh.lat);  // now we have unsigned value and one bit to spare
-                        tmpui = (tmpui + tmpui / 2) / 25;  // 6/100 = 1.5/25, division by power of 2 is fast
-                        if (gpsSol.llh.lat < 0) tmpui |= 0x40000000;
-                    }
-                    smartPortSendPackage(id, tmpui);
-                    *clearToSend = false;
-                }
-                break;
-            case FSSP_DATAID_HOME_DIST  :
-                if (STATE(GPS_FIX)) {
-                    smartPortSendPackage(id, GPS_distanceToHome);
-                     *clearToSend = false;
+        case FSSP_DATAID_SPEED      :
+            if (STATE(GPS_FIX)) {
+                //convert to knots: 1cm/s = 0.0194384449 knots
+                //Speed should be sent in knots/1000 (GPS speed is in cm/s)
+                uint32_t tmpui = gpsSol.groundSpeed * 1944 / 100;
+                *value = tmpui;
+                return true;
+            }
+            break;
+        case FSSP_DATAID_LATLONG    :
+            if (STATE(GPS_FIX)) {
+                uint32_t tmpui = 0;
+                // the same ID is sent twice, one for longitude, one for latitude
+                // the MSB of the sent uint32_t helps FrSky keep track
+                // the first of the two table entries holds the latitude
+                if (longitude) {
+                    tmpui = abs(gpsSol.llh.lon);  // now we have unsigned value and one bit to spare
+                    tmpui = (tmpui + tmpui / 2) / 25 | 0x80000000;  // 6/100 = 1.5/25, division by power of 2 is fast
+                    if (gpsSol.llh.lon < 0) tmpui |= 0x40000000;
                 }
-                break;
-            case FSSP_DATAID_GPS_ALT    :
-                if (STATE(GPS_FIX)) {
-                    smartPortSendPackage(id, gpsSol.llh.altCm); // in cm according to SmartPort spec
-                    *clearToSend = false;
+                else {
+                    tmpui = abs(gpsSol.llh.lat);  // now we have unsigned value and one bit to spare
+                    tmpui = (tmpui + tmpui / 2) / 25;  // 6/100 = 1.5/25, division by power of 2 is fast
+                    if (gpsSol.llh.lat < 0) tmpui |= 0x40000000;
                 }
-                break;
+                *value = tmpui;
+                return true;
+            }
+            break;
+        case FSSP_DATAID_HOME_DIST  :
+            if (STATE(GPS_FIX)) {
+                *value = GPS_distanceToHome;
+                return true;
+            }
+            break;
+        case FSSP_DATAID_GPS_ALT    :
+            if (STATE(GPS_FIX)) {
+                *value = gpsSol.llh.altCm; // in cm according to SmartPort spec
+                return true;
+            }
+            break;
+#endif
+        case FSSP_DATAID_A4         :
+            cellCount = getBatteryCellCount();
+            vfasVoltage = cellCount ? (getBatteryVoltage() / cellCount) : 0; // in 0.01V according to SmartPort spec
+            *value = vfasVoltage;
+            return true;
+        default:
+            break;
+            // the value is not available, the data ID is skipped until it is
+    }
+
+    return false;
+}
+
+static void updateSmartPortSensor(frSkyTableInfo_t *tableInfo, unsigned index)
+{
+    smartPortSensor_t *sensor = &tableInfo->sensors[index];
+    const unsigned tableIndex = index % tableInfo->size;
+    uint16_t id = tableInfo->table[tableIndex];
+    // an ID that is in the table twice carries two values
+    const bool longitude = tableIndex > 0 && tableInfo->table[tableIndex - 1] == id;
+#ifdef USE_ESC_SENSOR_TELEMETRY
+    if (tableInfo == &frSkyEscDataIdTableInfo) {
+        // each motor and ESC_SENSOR_COMBINED
+        id += index / tableInfo->size;
+    }
+#endif
+
+    uint32_t value;
+    const bool wasValid = sensor->valid;
+    // values that have not been sent yet are replaced without stepping on multiplexed counters
+    sensor->valid = smartPortCalculateValue(id, !sensor->fresh, longitude, &value);
+    if (!sensor->valid) {
+        return;
+    }
+
+    if (!wasValid || sensor->payload.valueId != id || sensor->payload.data != value) {
+        sensor->fresh = true;
+    }
+
+    sensor->payload.frameId = FSSP_DATA_FRAME;
+    sensor->payload.valueId = id;
+    sensor->payload.data = value;
+
+    if (telemetryState == TELEMETRY_STATE_INITIALIZED_SERIAL) {
+        sensor->frameLength = smartPortBuildFrame(&sensor->payload, sensor->frame, 0);
+    }
+}
+
+// Calculates a few of the values on each call, so that a poll can be answered with a ready frame
+static void updateSmartPortSensors(void)
+{
+#ifdef USE_ESC_SENSOR_TELEMETRY
+    frSkyEscDataIdTableInfo.sensorCount = MIN(frSkyEscDataIdTableInfo.size * (getMotorCount() + 1), MAX_ESC_SENSORS);
+    const unsigned sensorCount = frSkyDataIdTableInfo.sensorCount + frSkyEscDataIdTableInfo.sensorCount;
+#else
+    const unsigned sensorCount = frSkyDataIdTableInfo.sensorCount;
+#endif
+    static unsigned updateIndex = 0;
+
+    for (unsigned i = 0; i < MIN(sensorCount, SMARTPORT_SENSOR_UPDATES_PER_RUN); i++) {
+        if (updateIndex >= sensorCount) {
+            updateIndex = 0;
+        }
+
+        if (updateIndex < frSkyDataIdTableInfo.sensorCount) {
+            updateSmartPortSensor(&frSkyDataIdTableInfo, updateIndex);
+#ifdef USE_ESC_SENSOR_TELEMETRY
+        } else {
+            updateSmartPortSensor(&frSkyEscDataIdTableInfo, updateIndex - frSkyDataIdTableInfo.sensorCount);
 #endif
-            case FSSP_DATAID_A4         :
-                cellCount = getBatteryCellCount();
-                vfasVoltage = cellCount ? (getBatteryVoltage() / cellCount) : 0; // in 0.01V according to SmartPort spec
-                smartPortSendPackage(id, vfasVoltage);
-                *clearToSend = false;
-                break;
-            default:
-                break;
-                // if nothing is sent, hasRequest isn't cleared, we already incremented the counter, just loop back to the start
         }
+        updateIndex++;
+    }
+}
+
+// New values are sent first, values that did not change are still sent in turn as they age
+static smartPortSensor_t *nextSmartPortSensor(frSkyTableInfo_t *tableInfo)
+{
+    smartPortSensor_t *next = NULL;
+    unsigned nextPriority = 0;
+    for (unsigned i = 0; i < tableInfo->sensorCount; i++) {
+        smartPortSensor_t *sensor = &tableInfo->sensors[i];
+        if (sensor->valid) {
+            const unsigned priority = sensor->age + (sensor->fresh ? tableInfo->sensorCount : 0) + 1;
+            if (priority > nextPriority) {
+                next = sensor;
+                nextPriority = priority;
+            }
+        }
+    }
+
+    return next;
+}
+
+static void sendSmartPortSensor(frSkyTableInfo_t *tableInfo, smartPortSensor_t *sensor)
+{
+    if (telemetryState == TELEMETRY_STATE_INITIALIZED_SERIAL) {
+        serialWriteBuf(smartPortSerialPort, sensor->frame, sensor->frameLength);
+    } else {
+        smartPortWriteFrame(&sensor->payload);
+    }
+
+    for (unsigned i = 0; i < tableInfo->sensorCount; i++) {
+        if (tableInfo->sensors[i].age < UINT8_MAX) {
+            tableInfo->sensors[i].age++;
+        }
+    }
+    sensor->age = 0;
+    sensor->fresh = false;
+}
+
+void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clearToSend, const timeUs_t *requestTimeout)
+{
+    static uint8_t skipRequests = 0;
+#ifdef USE_ESC_SENSOR_TELEMETRY
+    static uint8_t smartPortIdCycleCnt = 0;
+#endif
+
+#if defined(USE_MSP_OVER_TELEMETRY)
+    if (skipRequests) {
+        skipRequests--;
+    } else if (payload && smartPortPayloadContainsMSP(payload)) {
+        // Do not check the physical ID here again
+        // unless we start receiving other sensors' packets
+        // Pass only the payload: skip frameId
+        uint8_t *frameStart = (uint8_t *)&payload->valueId;
+        smartPortMspReplyPending = handleMspFrame(frameStart, SMARTPORT_MSP_PAYLOAD_SIZE, &skipRequests);
+
+        // Don't send MSP response after write to eeprom
+        // CPU just got out of suspended state after writeEEPROM()
+        // We don't know if the receiver is listening again
+        // Skip a few telemetry requests before sending response
+        if (skipRequests) {
+            *clearToSend = false;
+        }
+    }
+#else
+    UNUSED(payload);
+#endif
+
+    if (!*clearToSend || skipRequests) {
+        return;
+    }
+
+    // The frames are prepared by the telemetry task, so the slot is answered right away or not at all
+    if (requestTimeout && cmpTimeUs(micros(), *requestTimeout) >= 0) {
+        *clearToSend = false;
+
+        return;
+    }
+
+#if defined(USE_MSP_OVER_TELEMETRY)
+    if (smartPortMspReplyPending) {
+        smartPortMspReplyPending = sendMspReply(SMARTPORT_MSP_PAYLOAD_SIZE, &smartPortSendMspResponse);
+        *clearToSend = false;
+
+        return;
+    }
+#endif
+
+    // we can send back any data we want, our tables keep track of the order and frequency of each data type we send
+    frSkyTableInfo_t *tableInfo = &frSkyDataIdTableInfo;
+    smartPortSensor_t *sensor = NULL;
+
+#ifdef USE_ESC_SENSOR_TELEMETRY
+    if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD + frSkyEscDataIdTableInfo.size) {
+        // the ESC sensors have had their turn, return to the other sensors
+        smartPortIdCycleCnt = 0;
+    }
+    if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
+        // send ESC sensors
+        tableInfo = &frSkyEscDataIdTableInfo;
+        sensor = nextSmartPortSensor(tableInfo);
+    }
+    if (!sensor) {
+        tableInfo = &frSkyDataIdTableInfo;
+        sensor = nextSmartPortSensor(tableInfo);
+    }
+    smartPortIdCycleCnt++;
+#else
+    sensor = nextSmartPortSensor(tableInfo);
+#endif
+
+    if (sensor) {
+        sendSmartPortSensor(tableInfo, sensor);
+        *clearToSend = false;
     }
 }
 
@@ -902,7 +1033,11 @@ void handleSmartPortTelemetry(void)
             payload = smartPortDataReceive(c, &clearToSend, serialReadyToSend, true);
         }
 
-            processSmartPortTelemetry(payload, &clearToSend, &requestTimeout);
+        processSmartPortTelemetry(payload, &clearToSend, &requestTimeout);
+    }
+
+    if (telemetryState != TELEMETRY_STATE_UNINITIALIZED) {
+        updateSmartPortSensors();
     }
 }
 #endif
@@ -36,7 +36,7 @@
 #define USB_HID_CDC_CONFIG_DESC_SIZ  (USB_HID_CONFIG_DESC_SIZ - 9 + USB_CDC_CONFIG_DESC_SIZ + 8)
 
 #define HID_INTERFACE 0x0
-#define HID_POOLING_INTERVAL 0x0A // 10ms - 100Hz update rate
+#define HID_POOLING_INTERVAL 0x01 // 1ms - 1000Hz update rate
 
 #define CDC_COM_INTERFACE 0x1
 
@@ -105,9 +105,9 @@ __ALIGN_BEGIN static uint8_t USBD_HID_CDC_CfgDesc[USB_HID_CDC_CONFIG_DESC_SIZ] _
 
   HID_EPIN_ADDR,                           /*bEndpointAddress: Endpoint Address (IN)*/
   0x03,                                    /*bmAttributes: Interrupt endpoint*/
-  HID_EPIN_SIZE,                           /*wMaxPacketSize: 8 Byte max */
+  HID_EPIN_SIZE,                           /*wMaxPacketSize: 20 Byte max */
   0x00,
-  HID_POOLING_INTERVAL,                    /*bInterval: Polling Interval (10 ms)*/
+  HID_POOLING_INTERVAL,                    /*bInterval: Polling Interval (1 ms)*/
   /* 34 */
 
   /******** /IAD should be positioned just before the CDC interfaces ******
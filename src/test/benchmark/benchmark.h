@@ -0,0 +1,82 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Host benchmarks of the flight critical code, see benchmark_main.cc.
+//
+// BENCHMARK(name)
+// {
+//     ...set up the fixed synthetic input...
+//     while (benchmarkKeepRunning(state)) {
+//         ...one call of the kernel...
+//     }
+//     benchmarkUse(result);
+// }
+//
+// Only the loop is timed, the set up runs again for every measurement.
+
+typedef struct benchmarkState_s {
+    uint32_t iterations;
+    uint32_t remaining;
+    bool running;
+    uint64_t startNs;
+    uint64_t startCycles;
+    uint64_t elapsedNs;
+    uint64_t elapsedCycles;
+} benchmarkState_t;
+
+typedef void benchmarkFn_t(benchmarkState_t *state);
+
+bool benchmarkStartStop(benchmarkState_t *state);
+
+static inline bool benchmarkKeepRunning(benchmarkState_t *state)
+{
+    if (state->remaining) {
+        state->remaining--;
+        return true;
+    }
+    return benchmarkStartStop(state);
+}
+
+// keeps the compiler from removing the calculation of a result that is not used otherwise
+template <typename T>
+static inline void benchmarkUse(const T &value)
+{
+    __asm__ volatile("" : : "g"(&value) : "memory");
+}
+
+// the input a kernel reads changes every call, so it can not be hoisted out of the loop
+static inline void benchmarkClobber(void)
+{
+    __asm__ volatile("" : : : "memory");
+}
+
+struct benchmarkRegistration_s {
+    benchmarkRegistration_s(const char *name, benchmarkFn_t *fn);
+};
+
+#define BENCHMARK(name) \
+    static void benchmark_##name(benchmarkState_t *state); \
+    static benchmarkRegistration_s benchmarkRegistration_##name(#name, benchmark_##name); \
+    static void benchmark_##name(benchmarkState_t *state)
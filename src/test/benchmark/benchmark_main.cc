@@ -0,0 +1,251 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Runs the benchmarks registered with BENCHMARK().
+//
+// Every benchmark is run BENCHMARK_REPEATS times for about BENCHMARK_RUN_NS, the
+// median time per call is reported. The results are written as lines of
+//     <name> <ns per call> <cycles per call> <calls>
+// which is also the format of the baseline they are compared with.
+//
+// options:
+//     --filter=<text>       only run the benchmarks with <text> in their name
+//     --output=<file>       append the results to <file>
+//     --baseline=<file>     compare the results with <file>, fail if slower by more than the tolerance
+//     --tolerance=<percent> allowed slow down against the baseline, default 15
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "benchmark.h"
+
+#define BENCHMARK_MAX_COUNT 32
+#define BENCHMARK_REPEATS 15
+#define BENCHMARK_RUN_NS 10000000       // 10ms
+#define BENCHMARK_MAX_ITERATIONS 100000000
+#define BENCHMARK_DEFAULT_TOLERANCE_PERCENT 15.0
+#define BENCHMARK_NAME_LENGTH 64
+
+typedef struct benchmark_s {
+    const char *name;
+    benchmarkFn_t *fn;
+} benchmark_t;
+
+typedef struct benchmarkResult_s {
+    double nsPerCall;
+    double cyclesPerCall;
+    uint32_t iterations;
+} benchmarkResult_t;
+
+static benchmark_t benchmarks[BENCHMARK_MAX_COUNT];
+static int benchmarkCount;
+
+benchmarkRegistration_s::benchmarkRegistration_s(const char *name, benchmarkFn_t *fn)
+{
+    if (benchmarkCount == BENCHMARK_MAX_COUNT) {
+        fprintf(stderr, "too many benchmarks, increase BENCHMARK_MAX_COUNT\n");
+        exit(2);
+    }
+    benchmarks[benchmarkCount].name = name;
+    benchmarks[benchmarkCount].fn = fn;
+    benchmarkCount++;
+}
+
+static uint64_t nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// time stamp counter cycles where there is one, 0 otherwise
+static uint64_t nowCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+bool benchmarkStartStop(benchmarkState_t *state)
+{
+    if (!state->running) {
+        // first call, the set up is done
+        state->running = true;
+        state->remaining = state->iterations - 1;
+        state->startNs = nowNs();
+        state->startCycles = nowCycles();
+        return true;
+    }
+
+    state->elapsedCycles = nowCycles() - state->startCycles;
+    state->elapsedNs = nowNs() - state->startNs;
+    state->running = false;
+    return false;
+}
+
+static void runOnce(const benchmark_t *benchmark, uint32_t iterations, benchmarkState_t *state)
+{
+    memset(state, 0, sizeof(*state));
+    state->iterations = iterations;
+    benchmark->fn(state);
+    if (state->running) {
+        fprintf(stderr, "%s: benchmarkKeepRunning() has to be called until it returns false\n", benchmark->name);
+        exit(2);
+    }
+}
+
+static int compareDouble(const void *a, const void *b)
+{
+    const double x = *(const double *)a;
+    const double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static benchmarkResult_t runBenchmark(const benchmark_t *benchmark)
+{
+    benchmarkState_t state;
+
+    // find the number of calls that take about BENCHMARK_RUN_NS, this also warms up the caches
+    uint32_t iterations = 1;
+    runOnce(benchmark, iterations, &state);
+    while (state.elapsedNs < BENCHMARK_RUN_NS / 10 && iterations < BENCHMARK_MAX_ITERATIONS / 10) {
+        iterations *= 10;
+        runOnce(benchmark, iterations, &state);
+    }
+    if (state.elapsedNs > 0 && state.elapsedNs < BENCHMARK_RUN_NS) {
+        const double scaled = (double)iterations * BENCHMARK_RUN_NS / state.elapsedNs;
+        iterations = scaled < BENCHMARK_MAX_ITERATIONS ? (uint32_t)scaled : BENCHMARK_MAX_ITERATIONS;
+    }
+
+    double nsPerCall[BENCHMARK_REPEATS];
+    double cyclesPerCall[BENCHMARK_REPEATS];
+    for (int i = 0; i < BENCHMARK_REPEATS; i++) {
+        runOnce(benchmark, iterations, &state);
+        nsPerCall[i] = (double)state.elapsedNs / iterations;
+        cyclesPerCall[i] = (double)state.elapsedCycles / iterations;
+    }
+    qsort(nsPerCall, BENCHMARK_REPEATS, sizeof(double), compareDouble);
+    qsort(cyclesPerCall, BENCHMARK_REPEATS, sizeof(double), compareDouble);
+
+    benchmarkResult_t result;
+    result.nsPerCall = nsPerCall[BENCHMARK_REPEATS / 2];
+    result.cyclesPerCall = cyclesPerCall[BENCHMARK_REPEATS / 2];
+    result.iterations = iterations;
+    return result;
+}
+
+// the ns per call of <name> in the baseline, or a negative value if it has none
+static double baselineNsPerCall(const char *filename, const char *name)
+{
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        return -1;
+    }
+
+    double nsPerCall = -1;
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        char baselineName[BENCHMARK_NAME_LENGTH];
+        double baselineNs;
+        if (line[0] != '#' && sscanf(line, "%63s %lf", baselineName, &baselineNs) == 2 && strcmp(baselineName, name) == 0) {
+            nsPerCall = baselineNs;
+        }
+    }
+    fclose(file);
+
+    return nsPerCall;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *filter = NULL;
+    const char *outputFilename = NULL;
+    const char *baselineFilename = NULL;
+    double tolerancePercent = BENCHMARK_DEFAULT_TOLERANCE_PERCENT;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--filter=", 9) == 0) {
+            filter = argv[i] + 9;
+        } else if (strncmp(argv[i], "--output=", 9) == 0) {
+            outputFilename = argv[i] + 9;
+        } else if (strncmp(argv[i], "--baseline=", 11) == 0) {
+            baselineFilename = argv[i] + 11;
+        } else if (strncmp(argv[i], "--tolerance=", 12) == 0) {
+            tolerancePercent = atof(argv[i] + 12);
+        } else {
+            fprintf(stderr, "usage: %s [--filter=<text>] [--output=<file>] [--baseline=<file>] [--tolerance=<percent>]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    FILE *output = NULL;
+    if (outputFilename) {
+        output = fopen(outputFilename, "a");
+        if (!output) {
+            perror(outputFilename);
+            return 2;
+        }
+        if (ftell(output) == 0) {
+            fprintf(output, "# name ns_per_call cycles_per_call calls\n");
+        }
+    }
+
+    int regressions = 0;
+    for (int i = 0; i < benchmarkCount; i++) {
+        const benchmark_t *benchmark = &benchmarks[i];
+        if (filter && !strstr(benchmark->name, filter)) {
+            continue;
+        }
+
+        const benchmarkResult_t result = runBenchmark(benchmark);
+        printf("%-32s %10.2f ns %10.1f cycles", benchmark->name, result.nsPerCall, result.cyclesPerCall);
+        if (output) {
+            fprintf(output, "%s %.2f %.1f %u\n", benchmark->name, result.nsPerCall, result.cyclesPerCall, result.iterations);
+        }
+
+        const double baseline = baselineFilename ? baselineNsPerCall(baselineFilename, benchmark->name) : -1;
+        if (baseline > 0) {
+            const double changePercent = 100.0 * (result.nsPerCall - baseline) / baseline;
+            const bool regression = changePercent > tolerancePercent;
+            printf("  %+6.1f%% against %.2f ns%s", changePercent, baseline, regression ? "  REGRESSION" : "");
+            regressions += regression;
+        }
+        printf("\n");
+    }
+
+    if (output) {
+        fclose(output);
+    }
+
+    if (regressions) {
+        printf("%d benchmark(s) slower than the baseline by more than %.0f%%\n", regressions, tolerancePercent);
+        return 1;
+    }
+    return 0;
+}
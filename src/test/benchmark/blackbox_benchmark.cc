@@ -0,0 +1,169 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "blackbox/blackbox.h"
+    #include "common/utils.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+    #include "pg/rx.h"
+    #include "pg/motor.h"
+
+    #include "drivers/accgyro/accgyro.h"
+    #include "drivers/accgyro/gyro_sync.h"
+    #include "drivers/serial.h"
+
+    #include "fc/runtime_config.h"
+
+    #include "flight/failsafe.h"
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+
+    #include "io/gps.h"
+    #include "io/serial.h"
+
+    #include "rx/rx.h"
+
+    #include "sensors/battery.h"
+    #include "sensors/gyro.h"
+
+    void blackboxLogIteration(timeUs_t currentTimeUs);
+    void blackboxAdvanceIterationTimers(void);
+}
+
+#include "benchmark.h"
+
+#define LOOPTIME_US 125         // 8kHz
+
+gyroDev_t gyroDev;
+
+static serialPort_t blackboxPort;
+static serialPortConfig_t blackboxPortConfig;
+static uint32_t bytesWritten;
+static timeMs_t currentTimeMs;
+
+// the logging of one PID loop at the full rate to a serial port, every loop writes
+// a P frame and every 256th loop an I frame.
+// loadMainState() and the system information header are not built for UNIT_TEST,
+// so the log is started by hand and this is the cost of the frame encoding and
+// the blackbox device, not of collecting the state.
+BENCHMARK(blackboxLogIteration)
+{
+    pgResetAll();
+    blackboxPortConfig.identifier = SERIAL_PORT_USART1;
+    blackboxPortConfig.blackbox_baudrateIndex = BAUD_2000000;
+    blackboxConfigMutable()->device = BLACKBOX_DEVICE_SERIAL;
+    blackboxConfigMutable()->sample_rate = 0;
+    targetPidLooptime = LOOPTIME_US;
+    blackboxInit();
+
+    armingFlags |= ARMED;
+    timeUs_t currentTimeUs = 0;
+    // open the log and send the field definitions
+    for (int i = 0; i < 10000; i++) {
+        blackboxUpdate(currentTimeUs);
+        currentTimeUs += LOOPTIME_US;
+        currentTimeMs = currentTimeUs / 1000;
+    }
+    const uint32_t headerBytes = bytesWritten;
+    blackboxLogIteration(currentTimeUs);
+    if (bytesWritten == headerBytes) {
+        fprintf(stderr, "blackbox is not logging\n");
+        exit(2);
+    }
+
+    while (benchmarkKeepRunning(state)) {
+        blackboxLogIteration(currentTimeUs);
+        blackboxAdvanceIterationTimers();
+        currentTimeUs += LOOPTIME_US;
+    }
+    benchmarkUse(bytesWritten);
+
+    blackboxFinish();
+    armingFlags &= ~ARMED;
+}
+
+extern "C" {
+
+PG_REGISTER(flight3DConfig_t, flight3DConfig, PG_MOTOR_3D_CONFIG, 0);
+PG_REGISTER(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 0);
+PG_REGISTER(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 0);
+PG_REGISTER(batteryConfig_t, batteryConfig, PG_BATTERY_CONFIG, 0);
+PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
+PG_REGISTER_ARRAY(modeActivationCondition_t, MAX_MODE_ACTIVATION_CONDITION_COUNT, modeActivationConditions, PG_MODE_ACTIVATION_PROFILE, 0);
+
+uint8_t armingFlags;
+uint8_t stateFlags;
+const uint32_t baudRates[] = {0, 9600, 19200, 38400, 57600, 115200, 230400, 250000,
+        400000, 460800, 500000, 921600, 1000000, 1500000, 2000000, 2470000}; // see baudRate_e
+uint8_t debugMode = 0;
+int16_t debug[DEBUG16_VALUE_COUNT];
+int32_t blackboxHeaderBudget;
+gpsSolutionData_t gpsSol;
+int32_t GPS_home[2];
+
+gyro_t gyro;
+
+float motorOutputHigh, motorOutputLow;
+float motor_disarmed[MAX_SUPPORTED_MOTORS];
+static pidProfile_t pidProfile;
+pidProfile_t *currentPidProfile = &pidProfile;
+uint32_t targetPidLooptime;
+
+boxBitmask_t rcModeActivationMask;
+
+void mspSerialAllocatePorts(void) {}
+uint32_t getArmingBeepTimeMicros(void) {return 0;}
+uint16_t getBatteryVoltageLatest(void) {return 0;}
+uint8_t getMotorCount(void) {return 4;}
+bool areMotorsRunning(void) { return true; }
+bool IS_RC_MODE_ACTIVE(boxId_e) {return false;}
+bool isModeActivationConditionPresent(boxId_e) {return false;}
+uint32_t millis(void) {return currentTimeMs;}
+bool sensors(uint32_t) {return false;}
+void serialWrite(serialPort_t *, uint8_t) { bytesWritten++; }
+uint32_t serialTxBytesFree(const serialPort_t *) {return 1024;}
+bool isSerialTransmitBufferEmpty(const serialPort_t *) {return true;}
+bool featureIsEnabled(uint32_t) {return false;}
+void mspSerialReleasePortIfAllocated(serialPort_t *) {}
+const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e ) {return &blackboxPortConfig;}
+serialPort_t *findSharedSerialPort(uint16_t , serialPortFunction_e ) {return NULL;}
+serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) {return &blackboxPort;}
+void closeSerialPort(serialPort_t *) {}
+portSharing_e determinePortSharing(const serialPortConfig_t *, serialPortFunction_e ) {return PORTSHARING_UNUSED;}
+failsafePhase_e failsafePhase(void) {return FAILSAFE_IDLE;}
+bool rxAreFlightChannelsValid(void) {return true;}
+bool rxIsReceivingSignal(void) {return true;}
+bool isRssiConfigured(void) {return false;}
+
+}
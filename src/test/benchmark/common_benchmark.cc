@@ -0,0 +1,211 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+extern "C" {
+    #include "common/crc.h"
+    #include "common/huffman.h"
+    #include "common/maths.h"
+    #include "common/printf.h"
+    #include "common/topic.h"
+}
+
+#include "benchmark.h"
+
+#define MSP_FRAME_LENGTH 64
+#define BLACKBOX_HEADER_LENGTH 256
+
+// typical MSP V2 payload
+static void fillFrame(uint8_t *frame, int length)
+{
+    for (int i = 0; i < length; i++) {
+        frame[i] = (i * 37 + 11) & 0xff;
+    }
+}
+
+BENCHMARK(crc16_ccitt_update)
+{
+    uint8_t frame[MSP_FRAME_LENGTH];
+    fillFrame(frame, sizeof(frame));
+
+    uint16_t crc = 0;
+    while (benchmarkKeepRunning(state)) {
+        benchmarkClobber();
+        crc = crc16_ccitt_update(crc, frame, sizeof(frame));
+    }
+    benchmarkUse(crc);
+}
+
+BENCHMARK(crc8_dvb_s2_update)
+{
+    uint8_t frame[MSP_FRAME_LENGTH];
+    fillFrame(frame, sizeof(frame));
+
+    uint8_t crc = 0;
+    while (benchmarkKeepRunning(state)) {
+        benchmarkClobber();
+        crc = crc8_dvb_s2_update(crc, frame, sizeof(frame));
+    }
+    benchmarkUse(crc);
+}
+
+BENCHMARK(huffmanEncodeBuf)
+{
+    // blackbox headers are mostly text, the case the huffman table is built for
+    static const char header[] = "H Field I name:loopIteration,time,axisP[0]\n";
+    char in[BLACKBOX_HEADER_LENGTH];
+    for (unsigned i = 0; i < sizeof(in); i++) {
+        in[i] = header[i % (sizeof(header) - 1)];
+    }
+    uint8_t out[BLACKBOX_HEADER_LENGTH];
+
+    int length = 0;
+    while (benchmarkKeepRunning(state)) {
+        benchmarkClobber();
+        length = huffmanEncodeBuf(out, sizeof(out), (const uint8_t *)in, sizeof(in), huffmanTable);
+    }
+    benchmarkUse(length);
+    benchmarkUse(out);
+}
+
+BENCHMARK(tfp_format)
+{
+    // an OSD element and a blackbox header line
+    char buffer[64];
+    int value = -1234;
+
+    int length = 0;
+    while (benchmarkKeepRunning(state)) {
+        benchmarkClobber();
+        length = tfp_sprintf(buffer, "%3d%c %5d H rollPID:%d,%d,%d", value & 0xff, 'A', value, 45, 80, 40);
+        value++;
+    }
+    benchmarkUse(length);
+    benchmarkUse(buffer);
+}
+
+// the accuracy tiers of common/maths.c, one call per iteration over a sweep of inputs
+#define TRIGONOMETRY_STEP 0.0123f
+
+BENCHMARK(sin_approx)
+{
+    float x = -M_PIf;
+    float sum = 0;
+    while (benchmarkKeepRunning(state)) {
+        sum += sin_approx(x);
+        x = (x < M_PIf) ? x + TRIGONOMETRY_STEP : -M_PIf;
+    }
+    benchmarkUse(sum);
+}
+
+BENCHMARK(sin_approx_table)
+{
+    float x = -M_PIf;
+    float sum = 0;
+    while (benchmarkKeepRunning(state)) {
+        sum += sin_approx_table(x);
+        x = (x < M_PIf) ? x + TRIGONOMETRY_STEP : -M_PIf;
+    }
+    benchmarkUse(sum);
+}
+
+BENCHMARK(atan2_approx)
+{
+    float x = -1.0f;
+    float sum = 0;
+    while (benchmarkKeepRunning(state)) {
+        sum += atan2_approx(0.7f - x, x);
+        x = (x < 1.0f) ? x + TRIGONOMETRY_STEP : -1.0f;
+    }
+    benchmarkUse(sum);
+}
+
+BENCHMARK(atan2_approx_table)
+{
+    float x = -1.0f;
+    float sum = 0;
+    while (benchmarkKeepRunning(state)) {
+        sum += atan2_approx_table(0.7f - x, x);
+        x = (x < 1.0f) ? x + TRIGONOMETRY_STEP : -1.0f;
+    }
+    benchmarkUse(sum);
+}
+
+BENCHMARK(invSqrt)
+{
+    float x = 0.5f;
+    float sum = 0;
+    while (benchmarkKeepRunning(state)) {
+        benchmarkClobber();
+        sum += 1.0f / sqrtf(x);
+        x = (x < 2.0f) ? x + TRIGONOMETRY_STEP : 0.5f;
+    }
+    benchmarkUse(sum);
+}
+
+BENCHMARK(invSqrt_approx)
+{
+    float x = 0.5f;
+    float sum = 0;
+    while (benchmarkKeepRunning(state)) {
+        benchmarkClobber();
+        sum += invSqrt_approx(x);
+        x = (x < 2.0f) ? x + TRIGONOMETRY_STEP : 0.5f;
+    }
+    benchmarkUse(sum);
+}
+
+// a sample published at the gyro rate and read by one polling subscriber and one callback
+static int32_t topicSample[3];
+static topic_t topicBenchmark = { .sample = topicSample };
+static int32_t topicCallbackSum;
+
+static void topicCallback(const void *sample, timeUs_t sampleTimeUs)
+{
+    UNUSED(sampleTimeUs);
+    topicCallbackSum += ((const int32_t *)sample)[0];
+}
+
+BENCHMARK(topicPublishRead)
+{
+    topicSubscriber_t polling;
+    topicSubscriber_t callback;
+    topicSubscribe(&polling, &topicBenchmark, NULL);
+    topicSubscribe(&callback, &topicBenchmark, topicCallback);
+
+    timeUs_t sampleTimeUs = 0;
+    int32_t sum = 0;
+    while (benchmarkKeepRunning(state)) {
+        topicSample[0] = sampleTimeUs;
+        topicPublish(&topicBenchmark, sampleTimeUs);
+        const int32_t *sample = (const int32_t *)topicReadNew(&polling);
+        if (sample) {
+            sum += sample[0];
+        }
+        sampleTimeUs += 125;
+    }
+    benchmarkUse(sum);
+    benchmarkUse(topicCallbackSum);
+
+    topicUnsubscribe(&callback);
+}
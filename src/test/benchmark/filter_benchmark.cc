@@ -0,0 +1,133 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/axis.h"
+    #include "common/filter.h"
+
+    #include "drivers/dshot.h"
+
+    #include "flight/mixer.h"
+    #include "flight/rpm_filter.h"
+
+    #include "pg/motor.h"
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    #include "sensors/gyro.h"
+
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint8_t debugMode;
+
+    gyro_t gyro;
+
+    PG_REGISTER(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 0);
+
+    uint8_t getMotorCount(void) { return 4; }
+    uint16_t getDshotTelemetry(uint8_t index) { return 200 + index * 10; }
+}
+
+#include "benchmark.h"
+
+#define LOOPTIME_US 125         // 8kHz
+#define SAMPLE_COUNT 256        // power of 2
+
+static float samples[SAMPLE_COUNT];
+
+// gyro noise with a motor line, the input of the gyro filters
+static float gyroSample(int i)
+{
+    if (!samples[1]) {
+        for (int j = 0; j < SAMPLE_COUNT; j++) {
+            samples[j] = 100.0f * sinf(j * 0.3f) + 10.0f * sinf(j * 2.1f);
+        }
+    }
+    return samples[i & (SAMPLE_COUNT - 1)];
+}
+
+BENCHMARK(biquadFilterApply)
+{
+    biquadFilter_t filter;
+    biquadFilterInitLPF(&filter, 150, LOOPTIME_US);
+
+    float out = 0;
+    int i = 0;
+    while (benchmarkKeepRunning(state)) {
+        out = biquadFilterApply(&filter, gyroSample(i++));
+    }
+    benchmarkUse(out);
+}
+
+BENCHMARK(biquadFilterApplyNotch)
+{
+    biquadFilter_t filter;
+    biquadFilterInit(&filter, 260, LOOPTIME_US, filterGetNotchQ(260, 160), FILTER_NOTCH);
+
+    float out = 0;
+    int i = 0;
+    while (benchmarkKeepRunning(state)) {
+        out = biquadFilterApplyDF1(&filter, gyroSample(i++));
+    }
+    benchmarkUse(out);
+}
+
+BENCHMARK(pt1FilterApply)
+{
+    pt1Filter_t filter;
+    pt1FilterInit(&filter, pt1FilterGain(100, LOOPTIME_US * 1e-6f));
+
+    float out = 0;
+    int i = 0;
+    while (benchmarkKeepRunning(state)) {
+        out = pt1FilterApply(&filter, gyroSample(i++));
+    }
+    benchmarkUse(out);
+}
+
+// the RPM notch bank of one gyro loop: 4 motors x 3 harmonics on every axis
+// and the update of the notch frequencies
+BENCHMARK(rpmFilterGyro)
+{
+    pgResetAll();
+    motorConfigMutable()->dev.useDshotTelemetry = true;
+    motorConfigMutable()->motorPoleCount = 14;
+    gyro.targetLooptime = LOOPTIME_US;
+    rpmFilterInit(rpmFilterConfig());
+
+    float out[XYZ_AXIS_COUNT] = { 0 };
+    int i = 0;
+    while (benchmarkKeepRunning(state)) {
+        const float sample = gyroSample(i++);
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            out[axis] = rpmFilterGyro(axis, sample);
+        }
+        rpmFilterUpdate();
+    }
+    benchmarkUse(out);
+}
@@ -0,0 +1,55 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+
+    void gyroAnalyseBenchmarkInit(uint32_t looptimeUs);
+    void gyroAnalyseBenchmarkUpdate(float sample);
+}
+
+#include "benchmark.h"
+
+#define LOOPTIME_US 125         // 8kHz
+#define SAMPLE_COUNT 256
+
+// the dynamic notch of the gyro loop, see gyro_analyse_benchmark_c.c
+BENCHMARK(gyroDataAnalyse)
+{
+    gyroAnalyseBenchmarkInit(LOOPTIME_US);
+
+    // a 300Hz motor line and some broadband noise
+    float samples[SAMPLE_COUNT];
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        samples[i] = 50.0f * sinf(2 * M_PIf * 300 * i * LOOPTIME_US * 1e-6f) + (i * 7919 % 23) - 11;
+    }
+
+    int i = 0;
+    while (benchmarkKeepRunning(state)) {
+        gyroAnalyseBenchmarkUpdate(samples[i++ % SAMPLE_COUNT]);
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// arm_math.h is C only, so the dynamic notch is driven from here
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "platform.h"
+
+#include "build/debug.h"
+
+#include "common/axis.h"
+#include "common/filter.h"
+#include "common/utils.h"
+
+#include "drivers/time.h"
+
+#include "fc/core.h"
+
+#include "flight/gyroanalyse.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+#include "sensors/gyro.h"
+
+int16_t debug[DEBUG16_VALUE_COUNT];
+uint8_t debugMode;
+
+gyro_t gyro;
+
+PG_REGISTER(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 0);
+
+static gyroAnalyseState_t analyseState;
+static biquadFilter_t notchFilterDyn[XYZ_AXIS_COUNT];
+static biquadFilter_t notchFilterDyn2[XYZ_AXIS_COUNT];
+
+timeUs_t micros(void)
+{
+    return 0;
+}
+
+uint8_t calculateThrottlePercentAbs(void)
+{
+    return 50;
+}
+
+// the assembler version in arm_bitreversal2.S is only built for the MCU
+void arm_bitreversal_32(uint32_t *pSrc, const uint16_t bitRevLen, const uint16_t *pBitRevTable)
+{
+    for (int i = 0; i < bitRevLen; i += 2) {
+        uint32_t *a = pSrc + pBitRevTable[i] / sizeof(uint32_t);
+        uint32_t *b = pSrc + pBitRevTable[i + 1] / sizeof(uint32_t);
+        for (int j = 0; j < 2; j++) {
+            const uint32_t tmp = a[j];
+            a[j] = b[j];
+            b[j] = tmp;
+        }
+    }
+}
+
+// the default dynamic notch configuration
+void gyroAnalyseBenchmarkInit(uint32_t looptimeUs)
+{
+    gyroConfigMutable()->dyn_notch_max_hz = 600;
+    gyroConfigMutable()->dyn_notch_width_percent = 8;
+    gyroConfigMutable()->dyn_notch_q = 120;
+    gyroConfigMutable()->dyn_notch_min_hz = 150;
+    gyro.targetLooptime = looptimeUs;
+
+    gyroDataAnalyseStateInit(&analyseState, looptimeUs);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        biquadFilterInit(&notchFilterDyn[axis], 400, looptimeUs, 1.2f, FILTER_NOTCH);
+        biquadFilterInit(&notchFilterDyn2[axis], 400, looptimeUs, 1.2f, FILTER_NOTCH);
+    }
+}
+
+// one gyro loop: the samples are pushed, the FFT and the notch update are spread over the loops
+void gyroAnalyseBenchmarkUpdate(float sample)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroDataAnalysePush(&analyseState, axis, sample);
+    }
+    gyroDataAnalyse(&analyseState, notchFilterDyn, notchFilterDyn2);
+}
@@ -0,0 +1,138 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/axis.h"
+    #include "common/maths.h"
+
+    #include "config/feature.h"
+
+    #include "drivers/motor.h"
+    #include "drivers/time.h"
+
+    #include "fc/controlrate_profile.h"
+    #include "fc/core.h"
+    #include "fc/rc.h"
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+
+    #include "io/beeper.h"
+
+    #include "flight/failsafe.h"
+    #include "flight/mixer.h"
+    #include "flight/mixer_tricopter.h"
+    #include "flight/pid.h"
+
+    #include "pg/motor.h"
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+    #include "pg/rx.h"
+
+    #include "rx/rx.h"
+
+    #include "sensors/battery.h"
+    #include "sensors/gyro.h"
+
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint8_t debugMode;
+
+    PG_REGISTER(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 0);
+    PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
+    PG_REGISTER(flight3DConfig_t, flight3DConfig, PG_MOTOR_3D_CONFIG, 0);
+
+    static pidProfile_t pidProfile;
+    pidProfile_t *currentPidProfile = &pidProfile;
+    static controlRateConfig_t controlRateProfile;
+    controlRateConfig_t *currentControlRateProfile = &controlRateProfile;
+
+    pidAxisData_t pidData[XYZ_AXIS_COUNT];
+    float rcCommand[4];
+    int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+
+    // DSHOT endpoints
+    void motorInitEndpoints(const motorConfig_t *, float outputLimit, float *outputLow, float *outputHigh, float *disarm, float *deadbandMotor3DHigh, float *deadbandMotor3DLow)
+    {
+        *outputLow = 48 + 5.5f * 2000 / 100;
+        *outputHigh = 48 + outputLimit * 1999;
+        *disarm = 0;
+        *deadbandMotor3DHigh = 0;
+        *deadbandMotor3DLow = 0;
+    }
+    void motorWriteAll(float *) { }
+    void delay(timeMs_t) { }
+    bool IS_RC_MODE_ACTIVE(boxId_e) { return false; }
+    bool airmodeIsEnabled(void) { return true; }
+    void beeperConfirmationBeeps(uint8_t) { }
+    bool featureIsEnabled(uint32_t) { return false; }
+    bool failsafeIsActive(void) { return false; }
+    float getRcDeflection(int) { return 0; }
+    float getRcDeflectionAbs(int) { return 0; }
+    bool isFlipOverAfterCrashActive(void) { return false; }
+    bool isLaunchControlActive(void) { return false; }
+    bool isMotorsReversed(void) { return false; }
+    void mixerTricopterInit(void) { }
+    float mixerTricopterMotorCorrection(int) { return 0; }
+    void pidResetIterm(void) { }
+    void pidUpdateAntiGravityThrottleFilter(float) { }
+}
+
+#include "benchmark.h"
+
+#define LOOPTIME_US 125         // 8kHz
+
+// the mixing of one PID loop of an armed quad in airmode, the PID sums and the
+// throttle change every loop and some loops saturate the motors
+BENCHMARK(mixTable)
+{
+    pgResetAll();
+    pidProfile.pidSumLimit = PIDSUM_LIMIT;
+    pidProfile.pidSumLimitYaw = PIDSUM_LIMIT_YAW;
+    pidProfile.motor_output_limit = 100;
+    mixerInit(MIXER_QUADX);
+    mixerConfigureOutput();
+    ENABLE_ARMING_FLAG(ARMED);
+
+    timeUs_t currentTimeUs = 0;
+    int i = 0;
+    while (benchmarkKeepRunning(state)) {
+        const int phase = i++ & 0xff;
+        pidData[FD_ROLL].Sum = phase * 2 - 256;
+        pidData[FD_PITCH].Sum = 128 - phase;
+        pidData[FD_YAW].Sum = (phase & 0x3f) - 32;
+        rcCommand[THROTTLE] = 1000 + phase * 3;
+        benchmarkClobber();
+
+        mixTable(currentTimeUs);
+        currentTimeUs += LOOPTIME_US;
+    }
+    benchmarkUse(motor);
+
+    DISABLE_ARMING_FLAG(ARMED);
+}
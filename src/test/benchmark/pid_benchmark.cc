@@ -0,0 +1,115 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/axis.h"
+    #include "common/maths.h"
+    #include "common/filter.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    #include "drivers/sound_beeper.h"
+
+    #include "fc/core.h"
+    #include "fc/rc.h"
+    #include "fc/rc_controls.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/imu.h"
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+    #include "flight/pid_init.h"
+
+    #include "sensors/gyro.h"
+    #include "sensors/acceleration.h"
+
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint8_t debugMode;
+
+    gyro_t gyro;
+    attitudeEulerAngles_t attitude;
+
+    PG_REGISTER(accelerometerConfig_t, accelerometerConfig, PG_ACCELEROMETER_CONFIG, 0);
+
+    static float setpointRate[XYZ_AXIS_COUNT];
+    static float rcDeflection[XYZ_AXIS_COUNT];
+
+    float getThrottlePIDAttenuation(void) { return 1.0f; }
+    float getMotorMixRange(void) { return 0.3f; }
+    float getSetpointRate(int axis) { return setpointRate[axis]; }
+    bool isAirmodeActivated() { return true; }
+    float getRcDeflectionAbs(int axis) { return fabsf(rcDeflection[axis]); }
+    void systemBeep(bool) { }
+    bool gyroOverflowDetected(void) { return false; }
+    float getRcDeflection(int axis) { return rcDeflection[axis]; }
+    void beeperConfirmationBeeps(uint8_t) { }
+    bool isLaunchControlActive(void) { return false; }
+    void disarm(flightLogDisarmReason_e) { }
+    float applyFFLimit(int axis, float value, float Kp, float currentPidSetpoint) {
+        UNUSED(axis);
+        UNUSED(Kp);
+        UNUSED(currentPidSetpoint);
+        return value;
+    }
+}
+
+#include "benchmark.h"
+
+#define LOOPTIME_US 125         // 8kHz
+
+// one PID loop of an armed quad in acro mode with the default profile,
+// the sticks and the gyro move every loop
+BENCHMARK(pidController)
+{
+    pgResetAll();
+    const pidProfile_t *pidProfile = pidProfiles(0);
+    gyro.targetLooptime = LOOPTIME_US;
+    pidInit(pidProfile);
+    pidStabilisationState(PID_STABILISATION_ON);
+    ENABLE_ARMING_FLAG(ARMED);
+
+    timeUs_t currentTimeUs = 0;
+    int i = 0;
+    while (benchmarkKeepRunning(state)) {
+        const float phase = (i++ & 0xff) * (2 * M_PIf / 256);
+        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+            rcDeflection[axis] = 0.5f * sin_approx(phase + axis);
+            setpointRate[axis] = 670.0f * rcDeflection[axis];
+            gyro.gyroADCf[axis] = 0.9f * setpointRate[axis];
+        }
+        benchmarkClobber();
+
+        pidController(pidProfile, currentTimeUs);
+        currentTimeUs += targetPidLooptime;
+    }
+    benchmarkUse(pidData);
+
+    DISABLE_ARMING_FLAG(ARMED);
+}
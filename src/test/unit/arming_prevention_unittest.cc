@@ -16,6 +16,7 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 
 extern "C" {
     #include "blackbox/blackbox.h"
@@ -68,6 +69,7 @@ extern "C" {
     controlRateConfig_t *currentControlRateProfile;
     attitudeEulerAngles_t attitude;
     gpsSolutionData_t gpsSol;
+    topic_t gpsSolTopic;
     uint32_t targetPidLooptime;
     bool cmsInMenu = false;
     float axisPID_P[3], axisPID_I[3], axisPID_D[3], axisPIDSum[3];
@@ -299,6 +301,66 @@ TEST(ArmingPreventionTest, Prearm)
     EXPECT_FALSE(isArmingDisabled());
 }
 
+TEST(ArmingPreventionTest, PrearmFollowsModeConfiguration)
+{
+    // given
+    simulationTime = 0;
+
+    // and
+    // no prearm mode configured
+    modeActivationConditionsMutable(0)->auxChannelIndex = 0;
+    modeActivationConditionsMutable(0)->modeId = BOXARM;
+    modeActivationConditionsMutable(0)->range.startStep = CHANNEL_VALUE_TO_STEP(1750);
+    modeActivationConditionsMutable(0)->range.endStep = CHANNEL_VALUE_TO_STEP(CHANNEL_RANGE_MAX);
+    memset(modeActivationConditionsMutable(1), 0, sizeof(modeActivationCondition_t));
+    rcControlsInit();
+
+    // and
+    rxConfigMutable()->mincheck = 1050;
+
+    // given
+    rcData[THROTTLE] = 1000;
+    rcData[4] = 1000;
+    rcData[5] = 1000;
+    mockIsUpright = true;
+
+    // when
+    updateActivatedModes();
+    updateArmingStatus();
+
+    // expect
+    EXPECT_FALSE(isArmingDisabled());
+    EXPECT_EQ(0, getArmingDisableFlags());
+
+    // given
+    // prearm mode is added, the arming conditions are updated with the mode activation conditions
+    modeActivationConditionsMutable(1)->auxChannelIndex = 1;
+    modeActivationConditionsMutable(1)->modeId = BOXPREARM;
+    modeActivationConditionsMutable(1)->range.startStep = CHANNEL_VALUE_TO_STEP(1750);
+    modeActivationConditionsMutable(1)->range.endStep = CHANNEL_VALUE_TO_STEP(CHANNEL_RANGE_MAX);
+    rcControlsInit();
+
+    // when
+    updateActivatedModes();
+    updateArmingStatus();
+
+    // expect
+    EXPECT_TRUE(isArmingDisabled());
+    EXPECT_EQ(ARMING_DISABLED_NOPREARM, getArmingDisableFlags());
+
+    // given
+    // prearm is enabled
+    rcData[5] = 1800;
+
+    // when
+    updateActivatedModes();
+    updateArmingStatus();
+
+    // expect
+    EXPECT_FALSE(isArmingDisabled());
+    EXPECT_EQ(0, getArmingDisableFlags());
+}
+
 TEST(ArmingPreventionTest, RadioTurnedOnAtAnyTimeArmed)
 {
     // given
@@ -1044,6 +1106,7 @@ extern "C" {
     bool baroIsCalibrationComplete(void) { return true; }
     bool gyroIsCalibrationComplete(void) { return gyroCalibDone; }
     void gyroStartCalibration(bool) {}
+    void gyroBiasModelOnDisarm(void) {}
     bool isFirstArmingGyroCalibrationRunning(void) { return false; }
     void pidController(const pidProfile_t *, timeUs_t) {}
     void pidStabilisationState(pidStabilisationState_e) {}
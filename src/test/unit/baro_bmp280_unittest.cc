@@ -24,6 +24,7 @@ extern "C" {
 #include "drivers/bus.h"
 
 void bmp280Calculate(int32_t *pressure, int32_t *temperature);
+void bmp280CalculateFloat(int32_t *pressure, int32_t *temperature);
 
 extern uint32_t bmp280_up;
 extern uint32_t bmp280_ut;
@@ -142,6 +143,62 @@ TEST(baroBmp280Test, TestBmp280CalculateZeroP)
     EXPECT_EQ(2508, temperature); // 25.08 degC
 }
 
+TEST(baroBmp280Test, TestBmp280CalculateFloatMatchesInteger)
+{
+    // given
+    bmp280_cal.dig_T1 = 27504;
+    bmp280_cal.dig_T2 = 26435;
+    bmp280_cal.dig_T3 = -1000;
+    bmp280_cal.dig_P1 = 36477;
+    bmp280_cal.dig_P2 = -10685;
+    bmp280_cal.dig_P3 = 3024;
+    bmp280_cal.dig_P4 = 2855;
+    bmp280_cal.dig_P5 = 140;
+    bmp280_cal.dig_P6 = -7;
+    bmp280_cal.dig_P7 = 15500;
+    bmp280_cal.dig_P8 = -14600;
+    bmp280_cal.dig_P9 = 6000;
+
+    // -40 to 85 degC and 30 to 110 kPa
+    for (int32_t ut = 390000; ut <= 620000; ut += 23000) {
+        for (int32_t up = 170000; up <= 520000; up += 7000) {
+            int32_t pressure, temperature;
+            int32_t pressureFloat, temperatureFloat;
+            bmp280_ut = ut;
+            bmp280_up = up;
+
+            // when
+            bmp280Calculate(&pressure, &temperature);
+            bmp280CalculateFloat(&pressureFloat, &temperatureFloat);
+
+            // then
+            EXPECT_NEAR(temperature, temperatureFloat, 1);
+            EXPECT_NEAR(pressure, pressureFloat, 1);
+        }
+    }
+}
+
+TEST(baroBmp280Test, TestBmp280CalculateFloatZeroP)
+{
+    // given
+    int32_t pressure, temperature;
+    bmp280_up = 415148; // Digital pressure value
+    bmp280_ut = 519888; // Digital temperature value
+
+    // and
+    bmp280_cal.dig_T1 = 27504;
+    bmp280_cal.dig_T2 = 26435;
+    bmp280_cal.dig_T3 = -1000;
+    bmp280_cal.dig_P1 = 0;
+
+    // when
+    bmp280CalculateFloat(&pressure, &temperature);
+
+    // then
+    EXPECT_EQ(0, pressure); // P1=0 trips pressure to 0 Pa, avoiding division by zero
+    EXPECT_EQ(2508, temperature); // 25.08 degC
+}
+
 // STUBS
 
 extern "C" {
@@ -24,6 +24,8 @@ extern "C" {
 #include "drivers/bus.h"
 
 void bmp388Calculate(int32_t *pressure, int32_t *temperature);
+void bmp388PrecomputeFloatCalibration(void);
+void bmp388CalculateFloat(int32_t *pressure, int32_t *temperature);
 
 extern uint32_t bmp388_up;
 extern uint32_t bmp388_ut;
@@ -135,7 +137,50 @@ TEST(baroBmp388Test, TestBmp388CalculateWithSampleCalibration)
     EXPECT_NE(0, t_lin);
 
     // and
-    EXPECT_EQ(39535, pressure); // 39535 Pa
+    EXPECT_EQ(101211, pressure); // 101211 Pa
+}
+
+TEST(baroBmp388Test, TestBmp388CalculateFloatWithSampleCalibration)
+{
+    // given
+    int32_t pressure, temperature;
+    bmp388_up = 7323488; // uncompensated pressure value
+    bmp388_ut = 9937920; // uncompensated temperature value
+
+    // and
+    baroBmp388ConfigureSampleCalibration();
+    bmp388PrecomputeFloatCalibration();
+
+    // when
+    bmp388CalculateFloat(&pressure, &temperature);
+
+    // then
+    EXPECT_NEAR(4880, temperature, 1); // 48.80 degrees C
+    EXPECT_NEAR(101211, pressure, 1); // 101211 Pa
+}
+
+TEST(baroBmp388Test, TestBmp388CalculateFloatMatchesInteger)
+{
+    // given
+    baroBmp388ConfigureSampleCalibration();
+    bmp388PrecomputeFloatCalibration();
+
+    for (uint32_t ut = 7000000; ut <= 10000000; ut += 250000) {
+        for (uint32_t up = 6000000; up <= 9000000; up += 100000) {
+            int32_t pressure, temperature;
+            int32_t pressureFloat, temperatureFloat;
+            bmp388_ut = ut;
+            bmp388_up = up;
+
+            // when
+            bmp388Calculate(&pressure, &temperature);
+            bmp388CalculateFloat(&pressureFloat, &temperatureFloat);
+
+            // then
+            EXPECT_NEAR(temperature, temperatureFloat, 1);
+            EXPECT_NEAR(pressure, pressureFloat, 1);
+        }
+    }
 }
 
 // STUBS
@@ -25,6 +25,7 @@ extern "C" {
 
 int8_t ms5611CRC(uint16_t *prom);
 void ms5611Calculate(int32_t *pressure, int32_t *temperature);
+void ms5611CalculateFloat(int32_t *pressure, int32_t *temperature);
 
 extern uint16_t ms5611_c[8];
 extern uint32_t ms5611_up;
@@ -139,6 +140,31 @@ TEST(baroMS5611Test, TestMs5611CalculatePressureLTMinus15Deg)
     EXPECT_EQ(90613, pressure);  // 906.13 mbar
 }
 
+TEST(baroMS5611Test, TestMs5611CalculateFloatMatchesInteger)
+{
+    // given
+    uint16_t ms5611_c_test[] = {0x0000, 40127, 36924, 23317, 23282, 33464, 28312, 0x0000}; // calibration data from MS5611 datasheet
+    memcpy(&ms5611_c, &ms5611_c_test, sizeof(ms5611_c_test));
+
+    // below -15 to above 20 degC and 30 to 110 kPa
+    for (uint32_t ut = 7269150; ut <= 8969150; ut += 50000) {
+        for (uint32_t up = 5000000; up <= 10000000; up += 125000) {
+            int32_t pressure, temperature;
+            int32_t pressureFloat, temperatureFloat;
+            ms5611_ut = ut;
+            ms5611_up = up;
+
+            // when
+            ms5611Calculate(&pressure, &temperature);
+            ms5611CalculateFloat(&pressureFloat, &temperatureFloat);
+
+            // then
+            EXPECT_NEAR(temperature, temperatureFloat, 1);
+            EXPECT_NEAR(pressure, pressureFloat, 1);
+        }
+    }
+}
+
 // STUBS
 
 extern "C" {
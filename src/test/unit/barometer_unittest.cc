@@ -0,0 +1,191 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    #include "sensors/barometer.h"
+    #include "sensors/sensors.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static int temperatureStarts;
+static int pressureStarts;
+
+static void fakeStartUT(baroDev_t *) { temperatureStarts++; }
+static void fakeStartUP(baroDev_t *) { pressureStarts++; }
+static bool fakeReady(baroDev_t *) { return true; }
+static void fakeCalculate(int32_t *pressure, int32_t *temperature)
+{
+    *pressure = 101325;
+    *temperature = 2500;
+}
+
+static void initFakeBaro(bool combinedRead, uint16_t conversionDelayUs)
+{
+    pgResetAll();
+    temperatureStarts = 0;
+    pressureStarts = 0;
+
+    baro.dev.combined_read = combinedRead;
+    baro.dev.ut_delay = combinedRead ? 0 : conversionDelayUs;
+    baro.dev.up_delay = conversionDelayUs;
+    baro.dev.start_ut = fakeStartUT;
+    baro.dev.read_ut = fakeReady;
+    baro.dev.get_ut = fakeReady;
+    baro.dev.start_up = fakeStartUP;
+    baro.dev.read_up = fakeReady;
+    baro.dev.get_up = fakeReady;
+    baro.dev.calculate = fakeCalculate;
+}
+
+// runs the baro task for the given time, rescheduled like the scheduler does
+static timeUs_t runBaro(timeUs_t currentTimeUs, timeUs_t durationUs)
+{
+    const timeUs_t endTimeUs = currentTimeUs + durationUs;
+    timeUs_t periodUs = 1000;
+    while (cmpTimeUs(endTimeUs, currentTimeUs) > 0) {
+        const uint32_t newDeadline = baroUpdate(currentTimeUs);
+        if (newDeadline != 0) {
+            periodUs = newDeadline;
+        }
+        currentTimeUs += periodUs;
+    }
+    return currentTimeUs;
+}
+
+TEST(BarometerTest, PressureToAltitudeMatchesPowf)
+{
+    // 30 to 110 kPa is the range of the polynomial
+    for (int pressure = 30000; pressure <= 110000; pressure += 5) {
+        const double expected = (1.0 - pow(pressure / 101325.0, 0.190295)) * 4433000.0;
+        EXPECT_NEAR(expected, pressureToAltitude(pressure), 1.0f); // 1cm
+    }
+
+    // outside of it powf() is used
+    EXPECT_NEAR((1.0 - pow(20000 / 101325.0, 0.190295)) * 4433000.0, pressureToAltitude(20000), 1.0f);
+    EXPECT_NEAR((1.0 - pow(120000 / 101325.0, 0.190295)) * 4433000.0, pressureToAltitude(120000), 1.0f);
+    EXPECT_NEAR(0.0f, pressureToAltitude(101325), 1.0f);
+}
+
+TEST(BarometerTest, NoiseLpfFollowsSampleInterval)
+{
+    // given
+    pgResetAll();
+    barometerConfigMutable()->baro_noise_lpf = 600;
+
+    // then the coefficient is the configured one at the rate of the altitude task
+    EXPECT_FLOAT_EQ(0.6f, baroNoiseLpfCoefficient(25000));
+    EXPECT_FLOAT_EQ(0.6f, baroNoiseLpfCoefficient(0));
+
+    // and two samples at twice the rate decay as much as one at the task rate
+    const float coefficient = baroNoiseLpfCoefficient(12500);
+    EXPECT_FLOAT_EQ(0.6f, coefficient * coefficient);
+    EXPECT_FLOAT_EQ(0.36f, baroNoiseLpfCoefficient(50000));
+}
+
+TEST(BarometerTest, TemperatureIsDecimated)
+{
+    // given
+    initFakeBaro(false, 10000);
+    barometerConfigMutable()->baro_temp_decimation = 5;
+
+    // when
+    timeUs_t currentTimeUs = 10000000;
+    currentTimeUs = runBaro(currentTimeUs, 500000);
+
+    // then
+    // the first conversion is a temperature, then one per five pressures
+    EXPECT_GT(temperatureStarts, 0);
+    EXPECT_NEAR(pressureStarts, 5 * temperatureStarts, 5);
+    // a pressure or temperature conversion takes 12ms with the reads, so 72ms for five pressures and a temperature
+    EXPECT_NEAR(500000 * 5 / 72000, pressureStarts, 2);
+    EXPECT_FALSE(baroIsTemperatureStale(currentTimeUs));
+}
+
+TEST(BarometerTest, TemperatureEveryPressureWithoutDecimation)
+{
+    // given
+    initFakeBaro(false, 10000);
+    barometerConfigMutable()->baro_temp_decimation = 1;
+
+    // when
+    runBaro(10000000, 500000);
+
+    // then
+    EXPECT_NEAR(pressureStarts, temperatureStarts, 1);
+}
+
+TEST(BarometerTest, StaleTemperatureIsConverted)
+{
+    // given
+    initFakeBaro(false, 50000);
+    barometerConfigMutable()->baro_temp_decimation = BARO_TEMPERATURE_DECIMATION_MAX;
+
+    // when
+    timeUs_t currentTimeUs = 20000000;
+    currentTimeUs = runBaro(currentTimeUs, 10000000);
+
+    // then
+    // fifty pressure conversions take longer than the temperature may get old
+    EXPECT_GT(pressureStarts / temperatureStarts, 10);
+    EXPECT_LT(pressureStarts / temperatureStarts, BARO_TEMPERATURE_DECIMATION_MAX);
+    EXPECT_FALSE(baroIsTemperatureStale(currentTimeUs));
+    EXPECT_TRUE(baroIsTemperatureStale(currentTimeUs + 2000000));
+}
+
+TEST(BarometerTest, CombinedReadConvertsNoTemperature)
+{
+    // given
+    initFakeBaro(true, 20000);
+
+    // when
+    const timeUs_t currentTimeUs = runBaro(40000000, 1000000);
+
+    // then
+    EXPECT_EQ(0, temperatureStarts);
+    EXPECT_NEAR(1000000 / 22000, pressureStarts, 2);
+    EXPECT_EQ(101325, baro.baroPressure);
+    EXPECT_EQ(2500, baro.baroTemperature);
+    EXPECT_FALSE(baroIsTemperatureStale(currentTimeUs));
+}
+
+// STUBS
+
+extern "C" {
+
+uint8_t debugMode;
+int16_t debug[DEBUG16_VALUE_COUNT];
+uint8_t detectedSensors[SENSOR_INDEX_COUNT];
+
+void sensorsSet(uint32_t) {}
+void delay(uint32_t) {}
+
+}
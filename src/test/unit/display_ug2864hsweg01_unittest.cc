@@ -0,0 +1,397 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/bus.h"
+    #include "drivers/bus_i2c.h"
+    #include "drivers/display_ug2864hsweg01.h"
+
+    extern uint8_t framebuffer[SCREEN_PAGE_COUNT][SCREEN_WIDTH];
+    extern uint8_t dirtyStart[SCREEN_PAGE_COUNT];
+    extern uint8_t dirtyEnd[SCREEN_PAGE_COUNT];
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Model of the display controller RAM, driven by the bytes the driver puts on the bus
+static uint8_t displayRam[SCREEN_PAGE_COUNT][SCREEN_WIDTH];
+static uint8_t displayPage;
+static uint8_t displayColumn;
+
+static int blockingWriteCount;
+static int transferCount;
+static int transferredBytes;
+static bool i2cTransferPending;
+static int transferPollsRemaining;
+
+static busDevice_t bus;
+
+static void resetModel(void)
+{
+    memset(displayRam, 0xaa, sizeof(displayRam));
+    displayPage = 0;
+    displayColumn = 0;
+    blockingWriteCount = 0;
+    transferCount = 0;
+    transferredBytes = 0;
+    i2cTransferPending = false;
+    transferPollsRemaining = 0;
+}
+
+static void displayCommand(uint8_t command)
+{
+    if ((command & 0xf8) == 0xb0) {
+        displayPage = command & 0x07;
+    } else if ((command & 0xf0) == 0x00) {
+        displayColumn = (displayColumn & 0xf0) | (command & 0x0f);
+    } else if ((command & 0xf0) == 0x10) {
+        displayColumn = (displayColumn & 0x0f) | ((command & 0x0f) << 4);
+    }
+}
+
+static void displayData(uint8_t data)
+{
+    if (displayColumn < SCREEN_WIDTH) {
+        displayRam[displayPage][displayColumn++] = data;
+    }
+}
+
+static void renderAndFlush(void)
+{
+    while (i2c_OLED_flush(&bus)) {
+    }
+}
+
+static int dirtyPageCount(void)
+{
+    int count = 0;
+    for (int page = 0; page < SCREEN_PAGE_COUNT; page++) {
+        if (dirtyStart[page] < dirtyEnd[page]) {
+            count++;
+        }
+    }
+    return count;
+}
+
+class DisplayUg2864hsweg01Test : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        resetModel();
+        ug2864hsweg01InitI2C(&bus);
+        renderAndFlush();
+        resetModel();
+        memset(displayRam, 0, sizeof(displayRam));
+    }
+};
+
+TEST_F(DisplayUg2864hsweg01Test, TestInitSendsWholeScreen)
+{
+    // given
+    resetModel();
+
+    // when
+    ug2864hsweg01InitI2C(&bus);
+
+    // then
+    EXPECT_EQ(SCREEN_PAGE_COUNT, dirtyPageCount());
+
+    // when
+    renderAndFlush();
+
+    // then
+    EXPECT_EQ(0, dirtyPageCount());
+    EXPECT_EQ(SCREEN_PAGE_COUNT * SCREEN_WIDTH, transferredBytes);
+    for (int page = 0; page < SCREEN_PAGE_COUNT; page++) {
+        for (int column = 0; column < SCREEN_WIDTH; column++) {
+            EXPECT_EQ(0, displayRam[page][column]);
+        }
+    }
+}
+
+TEST_F(DisplayUg2864hsweg01Test, TestRenderingDoesNotTouchTheBus)
+{
+    // when
+    i2c_OLED_set_line(&bus, 2);
+    i2c_OLED_send_string(&bus, "BETAFLIGHT");
+
+    // then
+    EXPECT_EQ(0, blockingWriteCount);
+    EXPECT_EQ(0, transferCount);
+
+    // and
+    EXPECT_EQ(1, dirtyPageCount());
+    EXPECT_EQ(0, dirtyStart[2]);
+    EXPECT_LE(dirtyEnd[2], 10 * CHARACTER_WIDTH_TOTAL);
+}
+
+TEST_F(DisplayUg2864hsweg01Test, TestFlushOnlySendsDirtyColumns)
+{
+    // given
+    i2c_OLED_set_xy(&bus, 4, 3);
+    i2c_OLED_send_char(&bus, '8');
+
+    // when
+    renderAndFlush();
+
+    // then
+    EXPECT_EQ(1, transferCount);
+    EXPECT_LE(transferredBytes, CHARACTER_WIDTH_TOTAL);
+    EXPECT_EQ(0, memcmp(framebuffer, displayRam, sizeof(displayRam)));
+}
+
+TEST_F(DisplayUg2864hsweg01Test, TestRedrawingSameTextIsFree)
+{
+    // given
+    i2c_OLED_set_line(&bus, 1);
+    i2c_OLED_send_string(&bus, "Volts: 16.80 Cells: 4");
+    renderAndFlush();
+    resetModel();
+
+    // when
+    i2c_OLED_set_line(&bus, 1);
+    i2c_OLED_send_string(&bus, "Volts: 16.80 Cells: 4");
+
+    // then
+    EXPECT_EQ(0, dirtyPageCount());
+    EXPECT_FALSE(i2c_OLED_flush(&bus));
+    EXPECT_EQ(0, transferCount);
+}
+
+TEST_F(DisplayUg2864hsweg01Test, TestChangedFieldOnly)
+{
+    // given
+    i2c_OLED_set_line(&bus, 1);
+    i2c_OLED_send_string(&bus, "Volts: 16.80 Cells: 4");
+    renderAndFlush();
+    resetModel();
+    memcpy(displayRam, framebuffer, sizeof(displayRam));
+
+    // when
+    i2c_OLED_set_line(&bus, 1);
+    i2c_OLED_send_string(&bus, "Volts: 16.79 Cells: 4");
+    renderAndFlush();
+
+    // then
+    EXPECT_EQ(1, transferCount);
+    EXPECT_LE(transferredBytes, 2 * CHARACTER_WIDTH_TOTAL);
+    EXPECT_EQ(0, memcmp(framebuffer, displayRam, sizeof(displayRam)));
+}
+
+TEST_F(DisplayUg2864hsweg01Test, TestFlushSendsAPagePerCall)
+{
+    // given
+    for (int row = 0; row < SCREEN_CHARACTER_ROW_COUNT; row++) {
+        i2c_OLED_set_line(&bus, row);
+        i2c_OLED_send_string(&bus, "ABCDEFGHIJKLMNOPQRSTU");
+    }
+
+    // when
+    renderAndFlush();
+
+    // then each transfer carries the dirty columns of one page
+    EXPECT_EQ(SCREEN_PAGE_COUNT, transferCount);
+    EXPECT_EQ(0, blockingWriteCount);
+    EXPECT_EQ(0, memcmp(framebuffer, displayRam, sizeof(displayRam)));
+}
+
+TEST_F(DisplayUg2864hsweg01Test, TestFlushWaitsForBus)
+{
+    // given
+    i2c_OLED_set_line(&bus, 0);
+    i2c_OLED_send_string(&bus, "RX");
+    i2cTransferPending = true;
+
+    // when
+    const bool pending = i2c_OLED_flush(&bus);
+
+    // then
+    EXPECT_TRUE(pending);
+    EXPECT_EQ(0, transferCount);
+
+    // when
+    i2cTransferPending = false;
+    renderAndFlush();
+
+    // then
+    EXPECT_EQ(1, transferCount);
+    EXPECT_EQ(0, memcmp(framebuffer, displayRam, sizeof(displayRam)));
+}
+
+TEST_F(DisplayUg2864hsweg01Test, TestFlushDoesNotWaitForTransfer)
+{
+    // given
+    i2c_OLED_set_line(&bus, 4);
+    i2c_OLED_send_string(&bus, "ALT 12.3");
+    i2c_OLED_set_line(&bus, 5);
+    i2c_OLED_send_string(&bus, "HDG 270");
+
+    // when
+    EXPECT_TRUE(i2c_OLED_flush(&bus));
+
+    // then the call returns with the transfer still in progress
+    EXPECT_EQ(1, transferCount);
+    EXPECT_TRUE(i2cTransferPending);
+
+    // when the bus is still busy on the next run
+    EXPECT_TRUE(i2c_OLED_flush(&bus));
+
+    // then nothing more is sent and the second page stays dirty
+    EXPECT_EQ(1, transferCount);
+    EXPECT_EQ(1, dirtyPageCount());
+
+    // when
+    renderAndFlush();
+
+    // then
+    EXPECT_EQ(2, transferCount);
+    EXPECT_EQ(0, memcmp(framebuffer, displayRam, sizeof(displayRam)));
+}
+
+TEST_F(DisplayUg2864hsweg01Test, TestCommandsFailWhileBusy)
+{
+    // given
+    i2cTransferPending = true;
+
+    // when
+    const bool initialised = ug2864hsweg01InitI2C(&bus);
+
+    // then
+    EXPECT_FALSE(initialised);
+    EXPECT_EQ(0, blockingWriteCount);
+}
+
+TEST_F(DisplayUg2864hsweg01Test, TestClearQuick)
+{
+    // given
+    i2c_OLED_set_line(&bus, 5);
+    i2c_OLED_send_string(&bus, "TASKS");
+    renderAndFlush();
+    resetModel();
+    memcpy(displayRam, framebuffer, sizeof(displayRam));
+
+    // when
+    i2c_OLED_clear_display_quick(&bus);
+
+    // then only the page with content is dirty
+    EXPECT_EQ(1, dirtyPageCount());
+
+    // when
+    renderAndFlush();
+
+    // then
+    for (int page = 0; page < SCREEN_PAGE_COUNT; page++) {
+        for (int column = 0; column < SCREEN_WIDTH; column++) {
+            EXPECT_EQ(0, displayRam[page][column]);
+        }
+    }
+}
+
+TEST_F(DisplayUg2864hsweg01Test, TestWritesPastScreenEdgeAreClipped)
+{
+    // when
+    i2c_OLED_set_xy(&bus, SCREEN_CHARACTER_COLUMN_COUNT - 1, 0);
+    i2c_OLED_send_string(&bus, "XYZ");
+    i2c_OLED_set_xy(&bus, 0, SCREEN_PAGE_COUNT);
+    i2c_OLED_send_string(&bus, "XYZ");
+    renderAndFlush();
+
+    // then
+    EXPECT_EQ(0, dirtyPageCount());
+    EXPECT_EQ(0, memcmp(framebuffer, displayRam, sizeof(displayRam)));
+    EXPECT_EQ(0, displayRam[1][0]);
+}
+
+// STUBS
+
+extern "C" {
+
+bool i2cWrite(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t data)
+{
+    UNUSED(device);
+    UNUSED(addr_);
+
+    blockingWriteCount++;
+    if (reg == 0x80) {
+        displayCommand(data);
+    } else {
+        displayData(data);
+    }
+    return true;
+}
+
+bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_, uint8_t *data)
+{
+    UNUSED(device);
+    UNUSED(addr_);
+
+    if (i2cTransferPending) {
+        return false;
+    }
+
+    transferCount++;
+    // The transfer completes in the background, the bus is busy for a few polls
+    i2cTransferPending = true;
+    transferPollsRemaining = 3;
+
+    // Walk the control bytes, Co set means a single byte follows and then another control byte
+    uint8_t control = reg_;
+    int i = 0;
+    while (i < len_ && (control & 0x80)) {
+        if (control & 0x40) {
+            displayData(data[i++]);
+        } else {
+            displayCommand(data[i++]);
+        }
+        if (i < len_) {
+            control = data[i++];
+        }
+    }
+    while (i < len_) {
+        if (control & 0x40) {
+            displayData(data[i]);
+            transferredBytes++;
+        } else {
+            displayCommand(data[i]);
+        }
+        i++;
+    }
+    return true;
+}
+
+bool i2cBusy(I2CDevice device, bool *error)
+{
+    UNUSED(device);
+    if (error) {
+        *error = false;
+    }
+    if (transferPollsRemaining > 0 && --transferPollsRemaining == 0) {
+        i2cTransferPending = false;
+    }
+    return i2cTransferPending;
+}
+
+}
@@ -0,0 +1,278 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/time.h"
+
+    #include "drivers/dshot.h"
+    #include "drivers/dshot_command.h"
+    #include "drivers/dshot_dpwm.h"
+    #include "drivers/motor.h"
+    #include "drivers/pwm_output.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define MOTOR_COUNT 4
+#define MOTOR_UPDATE_US 125 // 8kHz
+
+typedef struct frame_s {
+    timeUs_t at;
+    uint16_t value[MOTOR_COUNT];
+} frame_t;
+
+extern "C" {
+    timeUs_t simulatedTimeUs;
+    bool motorsEnabled;
+    motorDevice_t dshotPwmDevice;
+    static motorDmaOutput_t dmaMotors[MOTOR_COUNT];
+}
+
+static uint16_t throttle;
+static std::vector<frame_t> frames;
+
+// Mocks the dshot motor device, the driver substitutes the current command for the
+// motor value and the command queue decides whether the frame goes out
+static void motorUpdate(void)
+{
+    uint16_t value[MOTOR_COUNT];
+
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        value[i] = dshotCommandIsProcessing() ? dshotCommandGetCurrent(i) : throttle;
+    }
+    if (!dshotCommandQueueEmpty() && !dshotCommandOutputIsEnabled(MOTOR_COUNT)) {
+        return;
+    }
+
+    frame_t frame;
+    frame.at = simulatedTimeUs;
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        frame.value[i] = value[i];
+        dmaMotors[i].protocolControl.value = value[i];
+    }
+    frames.push_back(frame);
+}
+
+static void runMotorUpdates(timeUs_t durationUs)
+{
+    for (timeUs_t elapsedUs = 0; elapsedUs < durationUs; elapsedUs += MOTOR_UPDATE_US) {
+        simulatedTimeUs += MOTOR_UPDATE_US;
+        motorUpdate();
+    }
+}
+
+// The frames carrying a command, no motor update sends a command to some motors and throttle to others
+static std::vector<frame_t> commandFrames(void)
+{
+    std::vector<frame_t> result;
+
+    for (const frame_t &frame : frames) {
+        bool isCommand = false;
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            isCommand |= frame.value[i] > 0 && frame.value[i] <= DSHOT_MAX_COMMAND;
+        }
+        if (isCommand) {
+            result.push_back(frame);
+        }
+    }
+    return result;
+}
+
+static std::vector<std::pair<uint8_t, uint8_t>> callbacks;
+static std::vector<timeUs_t> callbackTimes;
+
+extern "C" {
+    static void onCommandComplete(uint8_t index, uint8_t command)
+    {
+        callbacks.push_back(std::make_pair(index, command));
+        callbackTimes.push_back(simulatedTimeUs);
+    }
+
+    static void onCommandCompleteQueueNext(uint8_t index, uint8_t command)
+    {
+        onCommandComplete(index, command);
+        if (command == DSHOT_CMD_SPIN_DIRECTION_REVERSED) {
+            dshotCommandWriteWithCallback(index, MOTOR_COUNT, DSHOT_CMD_SAVE_SETTINGS, DSHOT_CMD_TYPE_BLOCKING, onCommandComplete);
+        }
+    }
+}
+
+class DshotCommandTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        // drain anything left by a previous test
+        motorsEnabled = false;
+        throttle = 0;
+        for (int i = 0; i < 100 && !dshotCommandQueueEmpty(); i++) {
+            runMotorUpdates(200000);
+        }
+        simulatedTimeUs = 1000000;
+        dshotPwmDevice.count = MOTOR_COUNT;
+        memset(dmaMotors, 0, sizeof(dmaMotors));
+        frames.clear();
+        callbacks.clear();
+        callbackTimes.clear();
+    }
+};
+
+TEST_F(DshotCommandTest, RepeatsCommandWithoutBlocking)
+{
+    // given the motors are disabled
+    const timeUs_t queuedAtUs = simulatedTimeUs;
+
+    // when
+    dshotCommandWrite(ALL_MOTORS, MOTOR_COUNT, DSHOT_CMD_SPIN_DIRECTION_REVERSED, DSHOT_CMD_TYPE_BLOCKING);
+
+    // expect the call to return without spending any time
+    EXPECT_EQ(queuedAtUs, simulatedTimeUs);
+    EXPECT_FALSE(dshotCommandQueueEmpty());
+
+    // when the motor update runs
+    runMotorUpdates(40000);
+
+    // expect ten repeats, after the initial delay and at least 1ms apart
+    const std::vector<frame_t> sent = commandFrames();
+    ASSERT_EQ(10U, sent.size());
+    EXPECT_GE(sent[0].at, queuedAtUs + 10000);
+    EXPECT_LE(sent[0].at, queuedAtUs + 10000 + MOTOR_UPDATE_US);
+    for (unsigned i = 0; i < sent.size(); i++) {
+        for (int motor = 0; motor < MOTOR_COUNT; motor++) {
+            EXPECT_EQ(DSHOT_CMD_SPIN_DIRECTION_REVERSED, sent[i].value[motor]);
+        }
+        if (i > 0) {
+            EXPECT_GE(sent[i].at - sent[i - 1].at, 1000U);
+            EXPECT_LE(sent[i].at - sent[i - 1].at, 1000U + MOTOR_UPDATE_US);
+        }
+    }
+    EXPECT_TRUE(dshotCommandQueueEmpty());
+}
+
+TEST_F(DshotCommandTest, ReportsCompletionAfterDelay)
+{
+    // given
+    dshotCommandWriteWithCallback(2, MOTOR_COUNT, DSHOT_CMD_BEACON1, DSHOT_CMD_TYPE_BLOCKING, onCommandComplete);
+
+    // when
+    runMotorUpdates(50000);
+
+    // expect the beacon on motor 2 only, not yet completed within the beep delay
+    std::vector<frame_t> sent = commandFrames();
+    ASSERT_EQ(1U, sent.size());
+    EXPECT_EQ(DSHOT_CMD_MOTOR_STOP, sent[0].value[0]);
+    EXPECT_EQ(DSHOT_CMD_BEACON1, sent[0].value[2]);
+    EXPECT_TRUE(callbacks.empty());
+
+    // when the beep delay has passed
+    runMotorUpdates(100000);
+
+    // expect one callback, for the motor and command queued
+    ASSERT_EQ(1U, callbacks.size());
+    EXPECT_EQ(2, callbacks[0].first);
+    EXPECT_EQ(DSHOT_CMD_BEACON1, callbacks[0].second);
+    EXPECT_GE(callbackTimes[0] - sent[0].at, 100000U);
+    EXPECT_TRUE(dshotCommandQueueEmpty());
+}
+
+TEST_F(DshotCommandTest, CallbackCanQueueTheNextCommand)
+{
+    // given
+    dshotCommandWriteWithCallback(ALL_MOTORS, MOTOR_COUNT, DSHOT_CMD_SPIN_DIRECTION_REVERSED, DSHOT_CMD_TYPE_BLOCKING, onCommandCompleteQueueNext);
+
+    // when
+    runMotorUpdates(80000);
+
+    // expect both commands ten times, in sequence and without a second initial delay
+    const std::vector<frame_t> sent = commandFrames();
+    ASSERT_EQ(20U, sent.size());
+    EXPECT_EQ(DSHOT_CMD_SPIN_DIRECTION_REVERSED, sent[9].value[0]);
+    EXPECT_EQ(DSHOT_CMD_SAVE_SETTINGS, sent[10].value[0]);
+    EXPECT_LT(sent[10].at - sent[9].at, 2500U);
+    ASSERT_EQ(2U, callbacks.size());
+    EXPECT_EQ(DSHOT_CMD_SAVE_SETTINGS, callbacks[1].second);
+}
+
+TEST_F(DshotCommandTest, SendsDistinctCommandsPerMotor)
+{
+    // given
+    dshotCommandWrite(0, MOTOR_COUNT, DSHOT_CMD_SPIN_DIRECTION_NORMAL, DSHOT_CMD_TYPE_BLOCKING);
+    dshotCommandWrite(1, MOTOR_COUNT, DSHOT_CMD_SPIN_DIRECTION_REVERSED, DSHOT_CMD_TYPE_BLOCKING);
+    dshotCommandWrite(3, MOTOR_COUNT, DSHOT_CMD_SPIN_DIRECTION_REVERSED, DSHOT_CMD_TYPE_BLOCKING);
+
+    // when
+    runMotorUpdates(40000);
+
+    // expect the commands to go out together, each to its own motor
+    const std::vector<frame_t> sent = commandFrames();
+    ASSERT_EQ(10U, sent.size());
+    for (const frame_t &frame : sent) {
+        EXPECT_EQ(DSHOT_CMD_SPIN_DIRECTION_NORMAL, frame.value[0]);
+        EXPECT_EQ(DSHOT_CMD_SPIN_DIRECTION_REVERSED, frame.value[1]);
+        EXPECT_EQ(DSHOT_CMD_MOTOR_STOP, frame.value[2]);
+        EXPECT_EQ(DSHOT_CMD_SPIN_DIRECTION_REVERSED, frame.value[3]);
+    }
+}
+
+TEST_F(DshotCommandTest, InlineCommandWaitsForIdleMotors)
+{
+    // given the motors are enabled for longer than the protocol detection, and spinning
+    motorsEnabled = true;
+    simulatedTimeUs += 5000000;
+    throttle = 1000;
+    runMotorUpdates(MOTOR_UPDATE_US);
+
+    // when
+    dshotCommandWrite(ALL_MOTORS, MOTOR_COUNT, DSHOT_CMD_SPIN_DIRECTION_NORMAL, DSHOT_CMD_TYPE_INLINE);
+    runMotorUpdates(30000);
+
+    // expect no command while the motors spin
+    EXPECT_TRUE(commandFrames().empty());
+
+    // when the motors stop
+    throttle = 0;
+    const timeUs_t stoppedAtUs = simulatedTimeUs;
+    runMotorUpdates(40000);
+
+    // expect the command after the initial delay
+    const std::vector<frame_t> sent = commandFrames();
+    ASSERT_EQ(10U, sent.size());
+    EXPECT_GE(sent[0].at, stoppedAtUs + 10000);
+}
+
+// STUBS
+
+extern "C" {
+    timeUs_t micros(void) { return simulatedTimeUs; }
+    timeMs_t millis(void) { return simulatedTimeUs / 1000; }
+
+    bool isMotorProtocolDshot(void) { return true; }
+    bool motorIsEnabled(void) { return motorsEnabled; }
+    timeMs_t motorGetMotorEnableTimeMs(void) { return motorsEnabled ? 1 : 0; }
+
+    motorDmaOutput_t *getMotorDmaOutput(uint8_t index) { return &dmaMotors[index]; }
+}
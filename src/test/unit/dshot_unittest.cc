@@ -0,0 +1,231 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/time.h"
+
+    #include "drivers/dshot.h"
+    #include "drivers/dshot_bitbang_decode.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define SAMPLES_PER_BIT 3       // bitbang input is oversampled 3x
+#define IDLE_SAMPLES 10
+#define BUFFER_SAMPLES (IDLE_SAMPLES + 21 * SAMPLES_PER_BIT + 20)
+#define PIN 5
+
+extern "C" {
+    timeMs_t simulatedTimeMs;
+}
+
+static uint16_t samples[BUFFER_SAMPLES];
+
+static const uint8_t gcrEncode[16] = {
+    0x19, 0x1b, 0x12, 0x13, 0x1d, 0x15, 0x16, 0x17,
+    0x1a, 0x09, 0x0a, 0x0b, 0x1e, 0x0d, 0x0e, 0x0f };
+
+// Builds the bitbang input of a telemetry frame carrying the 12 bit value. The checksummed
+// 16 bit frame is GCR encoded to 20 bits, after a start bit every 1 is a level change of the
+// line, which idles high. jitter stretches or shrinks alternate levels by one sample.
+static uint32_t decodeSampleFrame(uint16_t value, int jitter)
+{
+    const uint16_t csum = ~(value ^ (value >> 4) ^ (value >> 8)) & 0xf;
+    const uint16_t frame = (value << 4) | csum;
+
+    uint32_t gcr = 1;   // start bit
+    for (int nibble = 3; nibble >= 0; nibble--) {
+        gcr = (gcr << 5) | gcrEncode[(frame >> (nibble * 4)) & 0xf];
+    }
+
+    int index = 0;
+    while (index < IDLE_SAMPLES) {
+        samples[index++] = 1 << PIN;
+    }
+    uint16_t level = 1 << PIN;
+    int levels = 0;
+    for (int bit = 20; bit >= 0; bit--) {
+        if (gcr & (1 << bit)) {
+            level ^= 1 << PIN;
+            if (levels++ % 2) {
+                index += jitter;
+            }
+        }
+        for (int i = 0; i < SAMPLES_PER_BIT; i++) {
+            samples[index++] = level;
+        }
+    }
+    while (index < BUFFER_SAMPLES) {
+        samples[index++] = 1 << PIN;
+    }
+
+    return decode_bb(samples, BUFFER_SAMPLES, PIN);
+}
+
+class DshotTelemetryTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        memset(&dshotTelemetryState, 0, sizeof(dshotTelemetryState));
+        simulatedTimeMs = 10000;
+    }
+};
+
+TEST_F(DshotTelemetryTest, DecodesErpmFrame)
+{
+    // given a period of 0x1f4 << 1 = 1000us, 60000 erpm
+    const uint16_t value = (1 << 9) | 0x1f4;
+
+    // when
+    const uint32_t decoded = decodeSampleFrame(value, 0);
+    const bool valid = dshotUpdateTelemetryData(0, decoded);
+
+    // expect
+    EXPECT_EQ(value, decoded);
+    EXPECT_TRUE(valid);
+    EXPECT_EQ(600, getDshotTelemetry(0));
+    EXPECT_TRUE(dshotTelemetryState.motorState[0].telemetryActive);
+}
+
+TEST_F(DshotTelemetryTest, DecodesStoppedMotor)
+{
+    // given
+    dshotTelemetryState.motorState[1].telemetryValue = 600;
+
+    // when
+    const bool valid = dshotUpdateTelemetryData(1, decodeSampleFrame(0x0fff, 0));
+
+    // expect
+    EXPECT_TRUE(valid);
+    EXPECT_EQ(0, getDshotTelemetry(1));
+}
+
+TEST_F(DshotTelemetryTest, DecodesExtendedFrames)
+{
+    // given temperature 45C, voltage 16.5V and current 12A
+    const uint16_t temperature = 0x200 | 45;
+    const uint16_t voltage = 0x400 | 66;
+    const uint16_t current = 0x600 | 12;
+    dshotTelemetryState.motorState[2].telemetryValue = 600;
+
+    // when
+    EXPECT_TRUE(dshotUpdateTelemetryData(2, decodeSampleFrame(temperature, 0)));
+    EXPECT_TRUE(dshotUpdateTelemetryData(2, decodeSampleFrame(voltage, 0)));
+    EXPECT_TRUE(dshotUpdateTelemetryData(2, decodeSampleFrame(current, 0)));
+
+    // expect each value with its type, the eRPM value untouched
+    uint16_t value;
+    EXPECT_TRUE(getDshotExtendedTelemetry(2, DSHOT_TELEMETRY_TYPE_TEMPERATURE, simulatedTimeMs, &value));
+    EXPECT_EQ(45, value);
+    EXPECT_TRUE(getDshotExtendedTelemetry(2, DSHOT_TELEMETRY_TYPE_VOLTAGE, simulatedTimeMs, &value));
+    EXPECT_EQ(66, value);
+    EXPECT_TRUE(getDshotExtendedTelemetry(2, DSHOT_TELEMETRY_TYPE_CURRENT, simulatedTimeMs, &value));
+    EXPECT_EQ(12, value);
+    EXPECT_FALSE(getDshotExtendedTelemetry(2, DSHOT_TELEMETRY_TYPE_DEBUG1, simulatedTimeMs, &value));
+    EXPECT_FALSE(getDshotExtendedTelemetry(1, DSHOT_TELEMETRY_TYPE_TEMPERATURE, simulatedTimeMs, &value));
+    EXPECT_EQ(600, getDshotTelemetry(2));
+}
+
+TEST_F(DshotTelemetryTest, DistinguishesFrameTypes)
+{
+    dshotTelemetryType_e type;
+    uint16_t decoded;
+
+    // expect a normalised period with the mantissa msb set to be eRPM
+    EXPECT_TRUE(dshotDecodeTelemetryValue(0xf00, &type, &decoded));
+    EXPECT_EQ(DSHOT_TELEMETRY_TYPE_ERPM, type);
+
+    // expect a short period with a zero exponent to be eRPM
+    EXPECT_TRUE(dshotDecodeTelemetryValue(0x0c8, &type, &decoded));
+    EXPECT_EQ(DSHOT_TELEMETRY_TYPE_ERPM, type);
+    EXPECT_EQ(3000, decoded);
+
+    // expect the even codes 0x2 .. 0xe to be the extended types
+    EXPECT_TRUE(dshotDecodeTelemetryValue(0x8ab, &type, &decoded));
+    EXPECT_EQ(DSHOT_TELEMETRY_TYPE_DEBUG1, type);
+    EXPECT_EQ(0xab, decoded);
+    EXPECT_TRUE(dshotDecodeTelemetryValue(0xc07, &type, &decoded));
+    EXPECT_EQ(DSHOT_TELEMETRY_TYPE_STRESS_LEVEL, type);
+    EXPECT_TRUE(dshotDecodeTelemetryValue(0xe80, &type, &decoded));
+    EXPECT_EQ(DSHOT_TELEMETRY_TYPE_STATE_EVENTS, type);
+    EXPECT_EQ(0x80, decoded);
+
+    // expect a zero period to be invalid
+    EXPECT_FALSE(dshotDecodeTelemetryValue(0x000, &type, &decoded));
+}
+
+TEST_F(DshotTelemetryTest, ExtendedValuesExpire)
+{
+    // given
+    EXPECT_TRUE(dshotUpdateTelemetryData(0, decodeSampleFrame(0x400 | 64, 0)));
+
+    // when the timeout has passed
+    uint16_t value;
+    simulatedTimeMs += DSHOT_EXTENDED_TELEMETRY_TIMEOUT_MS;
+    EXPECT_TRUE(getDshotExtendedTelemetry(0, DSHOT_TELEMETRY_TYPE_VOLTAGE, simulatedTimeMs, &value));
+    simulatedTimeMs++;
+
+    // expect
+    EXPECT_FALSE(getDshotExtendedTelemetry(0, DSHOT_TELEMETRY_TYPE_VOLTAGE, simulatedTimeMs, &value));
+}
+
+TEST_F(DshotTelemetryTest, ToleratesSampleJitter)
+{
+    // expect levels a sample longer or shorter to decode the same
+    EXPECT_EQ(0x42a, decodeSampleFrame(0x42a, 1));
+    EXPECT_EQ(0x42a, decodeSampleFrame(0x42a, -1));
+}
+
+TEST_F(DshotTelemetryTest, RejectsCorruptFrame)
+{
+    // given a frame with a flipped level in the middle
+    decodeSampleFrame(0x200 | 45, 0);
+    const int index = IDLE_SAMPLES + 10 * SAMPLES_PER_BIT;
+    for (int i = 0; i < SAMPLES_PER_BIT; i++) {
+        samples[index + i] ^= 1 << PIN;
+    }
+
+    // when
+    const uint32_t decoded = decode_bb(samples, BUFFER_SAMPLES, PIN);
+
+    // expect
+    EXPECT_EQ(BB_INVALID, decoded);
+}
+
+// STUBS
+
+extern "C" {
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+
+    bool useDshotTelemetry = true;
+
+    timeMs_t millis(void) { return simulatedTimeMs; }
+
+    bool featureIsEnabled(uint32_t) { return false; }
+}
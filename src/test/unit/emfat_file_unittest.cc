@@ -0,0 +1,246 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/version.h"
+
+    #include "drivers/bus_spi.h"
+    #include "drivers/io.h"
+
+    #include "msc/emfat.h"
+    #include "msc/emfat_file.h"
+
+    #include "pg/flash.h"
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    PG_REGISTER(flashConfig_t, flashConfig, PG_FLASH_CONFIG, 0);
+
+    extern emfat_t emfat;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define SECTOR_SIZE 512
+#define CLUSTER_SIZE 4096
+
+// W25N01G model on the SPI bus, enough for detection, page reads and status polling
+#define W25N01G_JEDEC_ID 0xEFAA21
+#define PAGE_SIZE 2048
+#define SPARE_SIZE 64
+#define MODEL_PAGES 256         // data beyond this is erased
+#define USED_SIZE (100 * PAGE_SIZE + 700)
+
+static uint8_t flashData[MODEL_PAGES * PAGE_SIZE];
+static uint8_t pageBuffer[PAGE_SIZE + SPARE_SIZE];
+static int pageReadCount;
+
+static bool commandPending;
+static uint8_t command;
+static uint16_t column;
+
+static uint8_t flashPatternByte(uint32_t address)
+{
+    return (address * 7 + (address >> 11)) & 0x7f;
+}
+
+static void loadPage(uint32_t page)
+{
+    pageReadCount++;
+    if (page < MODEL_PAGES) {
+        memcpy(pageBuffer, &flashData[page * PAGE_SIZE], PAGE_SIZE);
+    } else {
+        memset(pageBuffer, 0xff, PAGE_SIZE);
+    }
+    // The spare area holds ECC and bad block markers, not log data
+    memset(pageBuffer + PAGE_SIZE, 0x5a, SPARE_SIZE);
+}
+
+static void modelTransfer(const uint8_t *txData, uint8_t *rxData, int len)
+{
+    if (commandPending) {
+        commandPending = false;
+        command = txData[0];
+        switch (command) {
+        case 0x9f:  // RDID, dummy byte then id
+            if (rxData) {
+                rxData[2] = (W25N01G_JEDEC_ID >> 16) & 0xff;
+                rxData[3] = (W25N01G_JEDEC_ID >> 8) & 0xff;
+                rxData[4] = W25N01G_JEDEC_ID & 0xff;
+            }
+            break;
+        case 0x05:  // READ_STATUS_REG, never busy, no ECC errors
+            if (rxData) {
+                rxData[2] = 0;
+            }
+            break;
+        case 0x13:  // PAGE_DATA_READ
+            loadPage((txData[2] << 8) | txData[3]);
+            break;
+        case 0x03:  // READ_DATA from the column, data follows in the next transfer
+            column = (txData[1] << 8) | txData[2];
+            break;
+        case 0xa5:  // READ_BBM_LUT, no remapped blocks
+            if (rxData) {
+                memset(rxData, 0, len);
+            }
+            break;
+        default:
+            break;
+        }
+        return;
+    }
+
+    if (command == 0x03 && rxData) {
+        // Clocking past the spare area reads bus noise
+        for (int i = 0; i < len; i++, column++) {
+            rxData[i] = column < sizeof(pageBuffer) ? pageBuffer[column] : 0xa5;
+        }
+    } else if (command == 0xa5 && rxData) {
+        memset(rxData, 0, len);
+    }
+}
+
+static uint32_t fileFirstSector(const emfat_entry_t *entry)
+{
+    return emfat.priv.root_lba + (entry->priv.first_clust - 2) * (CLUSTER_SIZE / SECTOR_SIZE);
+}
+
+static const emfat_entry_t *findEntry(const char *suffix)
+{
+    for (int i = 0; i < emfat.priv.num_entries; i++) {
+        const emfat_entry_t *entry = &emfat.priv.entries[i];
+        if (entry->name && strlen(entry->name) >= strlen(suffix)
+            && !strcmp(entry->name + strlen(entry->name) - strlen(suffix), suffix)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+class EmfatFileTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        memset(flashData, 0xff, sizeof(flashData));
+        for (uint32_t address = 0; address < USED_SIZE; address++) {
+            flashData[address] = flashPatternByte(address);
+        }
+        const char header[] = "H Product:Blackbox flight data recorder by Nicholas Sherlock\n";
+        memcpy(flashData, header, strlen(header));
+
+        flashConfigMutable()->csTag = IO_TAG(PA4);
+        flashConfigMutable()->spiDevice = SPI_DEV_TO_CFG(SPIDEV_1);
+
+        emfat_init_files();
+        pageReadCount = 0;
+    }
+};
+
+TEST_F(EmfatFileTest, TestReadAcrossFlashPages)
+{
+    // given the log of all used flash space
+    const emfat_entry_t *entry = findEntry("_ALL.BBL");
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ((uint32_t)101 * PAGE_SIZE, entry->curr_size);
+
+    // when reading 32 sectors starting part way into a flash page
+    static uint8_t buf[32 * SECTOR_SIZE];
+    memset(buf, 0xee, sizeof(buf));
+    emfat_read(&emfat, buf, fileFirstSector(entry) + 3, 32);
+
+    // then every byte comes from the flash, not the spare area or a stale buffer
+    for (uint32_t i = 0; i < sizeof(buf); i++) {
+        ASSERT_EQ(flashData[3 * SECTOR_SIZE + i], buf[i]) << "at offset " << i;
+    }
+    // and each flash page is loaded once
+    EXPECT_EQ(9, pageReadCount);
+}
+
+TEST_F(EmfatFileTest, TestReadPastEndOfLog)
+{
+    // given
+    const emfat_entry_t *entry = findEntry("_ALL.BBL");
+    ASSERT_NE(nullptr, entry);
+    const uint32_t lastSector = fileFirstSector(entry) + entry->curr_size / SECTOR_SIZE - 1;
+
+    // when the read runs past the end of the file into erased flash
+    static uint8_t buf[2 * SECTOR_SIZE];
+    emfat_read(&emfat, buf, lastSector, 2);
+
+    // then the last sector of the file is intact
+    for (uint32_t i = 0; i < SECTOR_SIZE; i++) {
+        ASSERT_EQ(flashData[entry->curr_size - SECTOR_SIZE + i], buf[i]);
+    }
+}
+
+// STUBS
+
+extern "C" {
+    static uint8_t ioTagPin;
+
+    void __NOP(void) {}
+    uint32_t millis(void) { return 0; }
+    void delay(uint32_t) {}
+
+    void mscSetActive(void) {}
+    void mscActivityLed(void) {}
+    void ledSet(int, bool) {}
+
+    IO_t IOGetByTag(ioTag_t) { return &ioTagPin; }
+    bool IOIsFreeOrPreinit(IO_t) { return true; }
+    void IOInit(IO_t, resourceOwner_e, uint8_t) {}
+    void IOConfigGPIO(IO_t, ioConfig_t) {}
+    // Chip select starts a new command
+    void IOLo(IO_t) { commandPending = true; }
+    void IOHi(IO_t) { command = 0; }
+
+    SPI_TypeDef *spiInstanceByDevice(SPIDevice) { return (SPI_TypeDef *)&ioTagPin; }
+    void spiBusSetInstance(busDevice_t *, SPI_TypeDef *) {}
+    void spiSetDivisor(SPI_TypeDef *, uint16_t) {}
+    void spiPreinitByTag(ioTag_t) {}
+    void spiPreinitRegister(ioTag_t, uint8_t, uint8_t) {}
+
+    bool spiTransfer(SPI_TypeDef *, const uint8_t *txData, uint8_t *rxData, int len)
+    {
+        modelTransfer(txData, rxData, len);
+        return true;
+    }
+
+    uint8_t spiTransferByte(SPI_TypeDef *, uint8_t data)
+    {
+        modelTransfer(&data, NULL, 1);
+        return 0;
+    }
+
+    bool spiBusTransfer(const busDevice_t *, const uint8_t *txData, uint8_t *rxData, int length)
+    {
+        IOLo(NULL);
+        modelTransfer(txData, rxData, length);
+        IOHi(NULL);
+        return true;
+    }
+}
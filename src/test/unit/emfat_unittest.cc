@@ -0,0 +1,233 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "msc/emfat.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define SECTOR_SIZE 512
+#define CLUSTER_SIZE 4096
+#define LOG_SIZE (2 * 1024 * 1024 + 1234)
+#define SMALL_SIZE 5000
+
+// File-backed model of the onboard flash, counting transactions like flashfsReadAbs() would issue
+static FILE *flashFile;
+static int flashReadCount;
+static uint32_t flashBytesRead;
+
+static uint8_t flashPatternByte(uint32_t address)
+{
+    return (address * 7 + (address >> 9)) & 0xFF;
+}
+
+static void flashFileCreate(uint32_t size)
+{
+    flashFile = tmpfile();
+    ASSERT_NE(nullptr, flashFile);
+    for (uint32_t address = 0; address < size; address++) {
+        fputc(flashPatternByte(address), flashFile);
+    }
+    fflush(flashFile);
+}
+
+static void flashReadProc(uint8_t *dest, int size, uint32_t offset, emfat_entry_t *entry)
+{
+    UNUSED(entry);
+
+    flashReadCount++;
+    flashBytesRead += size;
+    fseek(flashFile, offset, SEEK_SET);
+    size_t len = fread(dest, 1, size, flashFile);
+    memset(dest + len, 0xFF, size - len);
+}
+
+static emfat_t emfat;
+static emfat_entry_t entries[4];
+
+class EmfatTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        memset(entries, 0, sizeof(entries));
+
+        entries[0].name = "";
+        entries[0].dir = true;
+
+        entries[1].name = "LOG00001.BBL";
+        entries[1].level = 1;
+        entries[1].offset = 0;
+        entries[1].curr_size = LOG_SIZE;
+        entries[1].max_size = LOG_SIZE;
+        entries[1].readcb = flashReadProc;
+
+        entries[2].name = "LOG00002.BBL";
+        entries[2].level = 1;
+        entries[2].offset = LOG_SIZE;
+        entries[2].curr_size = SMALL_SIZE;
+        entries[2].max_size = SMALL_SIZE;
+        entries[2].readcb = flashReadProc;
+
+        flashFileCreate(LOG_SIZE + SMALL_SIZE);
+        flashReadCount = 0;
+        flashBytesRead = 0;
+
+        ASSERT_TRUE(emfat_init(&emfat, "BETAFLT", entries));
+    }
+
+    virtual void TearDown() {
+        fclose(flashFile);
+    }
+
+    uint32_t fileFirstSector(const emfat_entry_t *entry) {
+        return emfat.priv.root_lba + (entry->priv.first_clust - 2) * (CLUSTER_SIZE / SECTOR_SIZE);
+    }
+};
+
+TEST_F(EmfatTest, TestContiguousSectorsCoalesced)
+{
+    // given
+    const uint32_t firstSector = fileFirstSector(&entries[1]);
+    static uint8_t buf[64 * SECTOR_SIZE];
+
+    // when
+    emfat_read(&emfat, buf, firstSector + 3, 64);
+
+    // then
+    EXPECT_EQ(1, flashReadCount);
+    EXPECT_EQ(sizeof(buf), flashBytesRead);
+    for (uint32_t i = 0; i < sizeof(buf); i++) {
+        ASSERT_EQ(flashPatternByte(3 * SECTOR_SIZE + i), buf[i]);
+    }
+}
+
+TEST_F(EmfatTest, TestReadSplitAtFileBoundary)
+{
+    // given
+    const uint32_t lastSectorOfFirstFile = fileFirstSector(&entries[2]) - 1;
+    static uint8_t buf[4 * SECTOR_SIZE];
+
+    // when
+    emfat_read(&emfat, buf, lastSectorOfFirstFile, 4);
+
+    // then
+    EXPECT_EQ(2, flashReadCount);
+
+    // first sector is the tail of the reserved area of the first file
+    const uint32_t firstFileOffset = (lastSectorOfFirstFile - fileFirstSector(&entries[1])) * SECTOR_SIZE;
+    EXPECT_EQ(flashPatternByte(firstFileOffset), buf[0]);
+
+    // the remaining sectors start at the beginning of the second file
+    for (uint32_t i = 0; i < 3 * SECTOR_SIZE; i++) {
+        ASSERT_EQ(flashPatternByte(LOG_SIZE + i), buf[SECTOR_SIZE + i]);
+    }
+}
+
+TEST_F(EmfatTest, TestFatChainAndCopies)
+{
+    // given
+    static uint8_t fat1[SECTOR_SIZE];
+    static uint8_t fat2[SECTOR_SIZE];
+
+    // when
+    emfat_read(&emfat, fat1, emfat.priv.fat1_lba, 1);
+    emfat_read(&emfat, fat2, emfat.priv.fat2_lba, 1);
+
+    // then
+    EXPECT_EQ(0, memcmp(fat1, fat2, SECTOR_SIZE));
+
+    const uint32_t *fat = (const uint32_t *)fat1;
+    // root directory occupies a single cluster
+    EXPECT_EQ(0x0FFFFFFFu, fat[entries[0].priv.first_clust]);
+    // first log file is a linear chain ending in EOF
+    for (uint32_t clust = entries[1].priv.first_clust; clust < entries[1].priv.last_clust && clust < 128; clust++) {
+        EXPECT_EQ(clust + 1, fat[clust]);
+    }
+    if (entries[1].priv.last_clust < 128) {
+        EXPECT_EQ(0x0FFFFFFFu, fat[entries[1].priv.last_clust]);
+    }
+}
+
+TEST_F(EmfatTest, TestMetadataSectorCached)
+{
+    // given
+    static uint8_t first[SECTOR_SIZE];
+    static uint8_t second[SECTOR_SIZE];
+    const uint32_t rootSector = fileFirstSector(&entries[0]);
+
+    // when
+    emfat_read(&emfat, first, rootSector, 1);
+
+    // then
+    EXPECT_EQ(rootSector, emfat.priv.cache_lba);
+
+    // and
+    emfat_read(&emfat, second, rootSector, 1);
+    EXPECT_EQ(0, memcmp(first, second, SECTOR_SIZE));
+    EXPECT_EQ(0, memcmp("BETAFLT", first, 7));
+    EXPECT_EQ(0, memcmp("LOG00001BBL", first + 32, 11));
+
+    // and
+    // a FAT2 sector reuses the FAT1 cache slot
+    emfat_read(&emfat, first, emfat.priv.fat1_lba + 1, 1);
+    emfat_read(&emfat, second, emfat.priv.fat2_lba + 1, 1);
+    EXPECT_EQ(emfat.priv.fat1_lba + 1, emfat.priv.cache_lba);
+    EXPECT_EQ(0, memcmp(first, second, SECTOR_SIZE));
+
+    // and
+    // data sectors never go through the cache
+    emfat_read(&emfat, first, fileFirstSector(&entries[1]), 1);
+    EXPECT_EQ(emfat.priv.fat1_lba + 1, emfat.priv.cache_lba);
+}
+
+TEST_F(EmfatTest, TestWholeFileThroughput)
+{
+    // given
+    // typical USB MSC request of 8 sectors
+    const int sectorsPerRequest = 8;
+    static uint8_t buf[8 * SECTOR_SIZE];
+    const uint32_t firstSector = fileFirstSector(&entries[1]);
+    const uint32_t sectorCount = (LOG_SIZE + SECTOR_SIZE - 1) / SECTOR_SIZE;
+
+    // when
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t sector = 0; sector < sectorCount; sector += sectorsPerRequest) {
+        emfat_read(&emfat, buf, firstSector + sector, sectorsPerRequest);
+        ASSERT_EQ(flashPatternByte(sector * SECTOR_SIZE), buf[0]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    // then
+    // one flash transaction per host request rather than per sector
+    EXPECT_EQ((int)((sectorCount + sectorsPerRequest - 1) / sectorsPerRequest), flashReadCount);
+
+    const double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("emfat read %u bytes in %d flash reads, %.1f MB/s\n", (unsigned)flashBytesRead, flashReadCount,
+        flashBytesRead / seconds / 1e6);
+}
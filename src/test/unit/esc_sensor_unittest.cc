@@ -0,0 +1,136 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/time.h"
+
+    #include "config/feature.h"
+
+    #include "drivers/dshot.h"
+    #include "drivers/dshot_dpwm.h"
+
+    #include "io/serial.h"
+
+    #include "pg/motor.h"
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    #include "sensors/esc_sensor.h"
+
+    PG_REGISTER(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 0);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define MOTOR_COUNT 4
+
+// Extended telemetry frames, the type code in the top nibble
+#define EDT_TEMPERATURE(celsius) (0x200 | (celsius))
+#define EDT_VOLTAGE(quarterVolts) (0x400 | (quarterVolts))
+#define EDT_CURRENT(amps) (0x600 | (amps))
+
+extern "C" {
+    timeMs_t simulatedTimeMs;
+}
+
+static void receiveEdt(uint8_t motor, uint8_t celsius, uint8_t quarterVolts, uint8_t amps)
+{
+    EXPECT_TRUE(dshotUpdateTelemetryData(motor, EDT_TEMPERATURE(celsius)));
+    EXPECT_TRUE(dshotUpdateTelemetryData(motor, EDT_VOLTAGE(quarterVolts)));
+    EXPECT_TRUE(dshotUpdateTelemetryData(motor, EDT_CURRENT(amps)));
+}
+
+class EscSensorTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        memset(&dshotTelemetryState, 0, sizeof(dshotTelemetryState));
+        simulatedTimeMs = 10000;
+    }
+};
+
+TEST_F(EscSensorTest, EdtDataWithoutSerialPort)
+{
+    // given no serial port for the ESC sensor
+    EXPECT_FALSE(escSensorInit());
+    EXPECT_EQ(ESC_DATA_INVALID, getEscSensorData(0)->dataAge);
+
+    // when extended telemetry arrives for one motor
+    receiveEdt(0, 45, 66, 12);
+    escSensorProcess(simulatedTimeMs * 1000);
+
+    // expect its values in the ESC sensor data
+    const escSensorData_t *escData = getEscSensorData(0);
+    EXPECT_EQ(0, escData->dataAge);
+    EXPECT_EQ(45, escData->temperature);
+    EXPECT_EQ(66 * 25, escData->voltage);
+    EXPECT_EQ(1200, escData->current);
+    // the first sample has no interval to integrate over, the time since boot is not one
+    EXPECT_EQ(0, escData->consumption);
+
+    // and the motors without telemetry to stay invalid
+    EXPECT_EQ(ESC_DATA_INVALID, getEscSensorData(1)->dataAge);
+
+    // when the current keeps flowing for 3 seconds
+    for (int i = 0; i < 3; i++) {
+        simulatedTimeMs += 1000;
+        receiveEdt(0, 45, 66, 12);
+        escSensorProcess(simulatedTimeMs * 1000);
+    }
+
+    // expect the consumption of 12A over 3s
+    EXPECT_EQ(10, getEscSensorData(0)->consumption);
+
+    // when the telemetry stops
+    simulatedTimeMs += 3 * DSHOT_EXTENDED_TELEMETRY_TIMEOUT_MS;
+    escSensorProcess(simulatedTimeMs * 1000);
+
+    // expect the data to be invalid
+    EXPECT_EQ(ESC_DATA_INVALID, getEscSensorData(0)->dataAge);
+}
+
+// STUBS
+
+extern "C" {
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+
+    bool useDshotTelemetry = true;
+
+    timeMs_t millis(void) { return simulatedTimeMs; }
+
+    bool featureIsEnabled(uint32_t mask) { return mask == FEATURE_ESC_SENSOR; }
+
+    uint8_t getMotorCount(void) { return MOTOR_COUNT; }
+    bool motorIsEnabled(void) { return true; }
+    motorDmaOutput_t *getMotorDmaOutput(uint8_t) { return NULL; }
+    bool isDshotMotorTelemetryActive(uint8_t) { return false; }
+
+    const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e) { return NULL; }
+    serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) { return NULL; }
+}
@@ -244,6 +244,8 @@ bool compassIsHealthy(void) { return true; }
 bool baroIsCalibrationComplete(void) { return true; }
 void performBaroCalibrationCycle(void) {}
 int32_t baroCalculateAltitude(void) { return 0; }
+baro_t baro;
+topic_t baroTopic;
 bool gyroGetAccumulationAverage(float *) { return false; }
 bool accGetAccumulationAverage(float *) { return false; }
 void mixerSetThrottleAngleCorrection(int) {};
@@ -17,6 +17,8 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <limits.h>
 
@@ -53,9 +55,131 @@ TEST(IoSerialTest, TestFindPortConfig)
     EXPECT_EQ(NULL, portConfig);
 }
 
+// Loopback serial port, the bytes to receive are scheduled at a time and everything
+// written to the port is recorded. Every poll of the receive buffer takes 1ms.
+
+#define LOOPBACK_BUFFER_SIZE    4096
+#define SIMULATION_TIME_LIMIT_MS 60000
+
+typedef struct loopbackPort_s {
+    serialPort_t port;
+    uint8_t rx[LOOPBACK_BUFFER_SIZE];
+    uint32_t rxAtMs[LOOPBACK_BUFFER_SIZE];
+    int rxCount;
+    int rxRead;
+    uint8_t tx[LOOPBACK_BUFFER_SIZE];
+    int txCount;
+    uint32_t txFree;            // reported free transmit space, the transmitter drains between polls
+    int writeCalls;
+} loopbackPort_t;
+
+static loopbackPort_t devicePort;
+static loopbackPort_t hostPort;
+static uint32_t simulationTimeMs;
+static int deviceConsumed;
+
+static void loopbackReset(loopbackPort_t *loopback)
+{
+    memset(loopback, 0, sizeof(*loopback));
+    loopback->txFree = 256;
+}
+
+static void loopbackSchedule(loopbackPort_t *loopback, uint32_t atMs, const char *data)
+{
+    for (int i = 0; data[i]; i++) {
+        loopback->rx[loopback->rxCount] = data[i];
+        loopback->rxAtMs[loopback->rxCount] = atMs;
+        loopback->rxCount++;
+    }
+}
+
+static void deviceConsumer(uint8_t)
+{
+    deviceConsumed++;
+}
+
+static void passthroughSetup(void)
+{
+    loopbackReset(&devicePort);
+    loopbackReset(&hostPort);
+    simulationTimeMs = 0;
+    deviceConsumed = 0;
+}
+
+TEST(IoSerialTest, PassthroughMovesDataInBulk)
+{
+    // given
+    passthroughSetup();
+    char data[1001];
+    for (int i = 0; i < 1000; i++) {
+        data[i] = 'a' + i % 26;
+    }
+    data[1000] = 0;
+    loopbackSchedule(&devicePort, 10, data);
+    loopbackSchedule(&hostPort, 3000, "+++");
+
+    // when
+    serialPassthrough(&devicePort.port, &hostPort.port, &deviceConsumer, NULL);
+
+    // expect
+    EXPECT_EQ(1000, hostPort.txCount);
+    EXPECT_EQ(0, memcmp(data, hostPort.tx, 1000));
+    EXPECT_LT(hostPort.writeCalls, 1000 / 10);
+    EXPECT_EQ(1000, deviceConsumed);
+
+    // and
+    // the escape sequence is not forwarded and ends the passthrough after the guard time
+    EXPECT_EQ(0, devicePort.txCount);
+    EXPECT_GE(simulationTimeMs, 3000u + 1000u);
+}
+
+TEST(IoSerialTest, PassthroughTransmitFlowControl)
+{
+    // given
+    passthroughSetup();
+    hostPort.txFree = 5;
+    char data[301];
+    for (int i = 0; i < 300; i++) {
+        data[i] = 1 + i % 100;
+    }
+    data[300] = 0;
+    loopbackSchedule(&devicePort, 10, data);
+    loopbackSchedule(&hostPort, 3000, "+++");
+
+    // when
+    serialPassthrough(&devicePort.port, &hostPort.port, NULL, NULL);
+
+    // expect
+    EXPECT_EQ(300, hostPort.txCount);
+    EXPECT_EQ(0, memcmp(data, hostPort.tx, 300));
+}
+
+TEST(IoSerialTest, PassthroughEscapeNeedsGuardTime)
+{
+    // given
+    passthroughSetup();
+    // no pause before the sequence
+    loopbackSchedule(&hostPort, 1500, "a+++b");
+    // no pause after the sequence
+    loopbackSchedule(&hostPort, 3000, "+++");
+    loopbackSchedule(&hostPort, 3500, "c");
+    // a lone escape character
+    loopbackSchedule(&hostPort, 5000, "+");
+    loopbackSchedule(&hostPort, 8000, "+++");
+
+    // when
+    serialPassthrough(&devicePort.port, &hostPort.port, NULL, NULL);
+
+    // expect
+    EXPECT_EQ(10, devicePort.txCount);
+    EXPECT_EQ(0, memcmp("a+++b+++c+", devicePort.tx, 10));
+    EXPECT_EQ(0, hostPort.txCount);
+    EXPECT_GE(simulationTimeMs, 8000u + 1000u);
+}
 
 // STUBS
 extern "C" {
+    uint32_t millis(void) { return simulationTimeMs; }
     void delay(uint32_t) {}
 
     bool isSerialTransmitBufferEmpty(const serialPort_t *) { return true; }
@@ -64,9 +188,39 @@ extern "C" {
 
     bool telemetryCheckRxPortShared(const serialPortConfig_t *) { return false; }
 
-    uint32_t serialRxBytesWaiting(const serialPort_t *) { return 0; }
-    uint8_t serialRead(serialPort_t *) { return 0; }
-    void serialWrite(serialPort_t *, uint8_t) {}
+    uint32_t serialRxBytesWaiting(const serialPort_t *instance)
+    {
+        const loopbackPort_t *loopback = (const loopbackPort_t *)instance;
+        if (++simulationTimeMs > SIMULATION_TIME_LIMIT_MS) {
+            ADD_FAILURE() << "passthrough did not return";
+            abort();
+        }
+        int waiting = 0;
+        while (loopback->rxRead + waiting < loopback->rxCount && loopback->rxAtMs[loopback->rxRead + waiting] <= simulationTimeMs) {
+            waiting++;
+        }
+        return waiting;
+    }
+
+    uint8_t serialRead(serialPort_t *instance)
+    {
+        loopbackPort_t *loopback = (loopbackPort_t *)instance;
+        return loopback->rx[loopback->rxRead++];
+    }
+
+    void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count)
+    {
+        loopbackPort_t *loopback = (loopbackPort_t *)instance;
+        EXPECT_LE((uint32_t)count, loopback->txFree);
+        memcpy(&loopback->tx[loopback->txCount], data, count);
+        loopback->txCount += count;
+        loopback->writeCalls++;
+    }
+
+    void serialWrite(serialPort_t *instance, uint8_t ch)
+    {
+        serialWriteBuf(instance, &ch, 1);
+    }
 
     serialPort_t *usbVcpOpen(void) { return NULL; }
 
@@ -80,7 +234,7 @@ extern "C" {
 
     void serialSetCtrlLineStateCb(serialPort_t *, void (*)(void *, uint16_t ), void *) {}
     void serialSetCtrlLineState(serialPort_t *, uint16_t ) {}
-    uint32_t serialTxBytesFree(const serialPort_t *) {return 1;}
+    uint32_t serialTxBytesFree(const serialPort_t *instance) { return ((const loopbackPort_t *)instance)->txFree; }
 
     void serialSetBaudRateCb(serialPort_t *, void (*)(serialPort_t *context, uint32_t baud), serialPort_t *) {}
 
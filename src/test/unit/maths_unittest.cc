@@ -272,4 +272,58 @@ TEST(MathsUnittest, TestFastTrigonometryACos)
     printf("acos_approx maximum absolute error = %e rads (%e degree)\n", error, error / M_PI * 180.0f);
     EXPECT_LE(error, 1e-4);
 }
+
+TEST(MathsUnittest, TestTableTrigonometrySinCos)
+{
+    double sinError = 0;
+    for (float x = -10 * M_PI; x < 10 * M_PI; x += M_PI / 3000) {
+        double approxResult = sin_approx_table(x);
+        double libmResult = sinf(x);
+        sinError = MAX(sinError, fabs(approxResult - libmResult));
+    }
+    printf("sin_approx_table maximum absolute error = %e\n", sinError);
+    EXPECT_LE(sinError, 2e-5);
+
+    double cosError = 0;
+    for (float x = -10 * M_PI; x < 10 * M_PI; x += M_PI / 3000) {
+        double approxResult = cos_approx_table(x);
+        double libmResult = cosf(x);
+        cosError = MAX(cosError, fabs(approxResult - libmResult));
+    }
+    printf("cos_approx_table maximum absolute error = %e\n", cosError);
+    EXPECT_LE(cosError, 2e-5);
+
+    // exact at the quadrant boundaries
+    EXPECT_FLOAT_EQ(0.0f, sin_approx_table(0.0f));
+    EXPECT_FLOAT_EQ(1.0f, sin_approx_table(M_PIf / 2));
+    EXPECT_FLOAT_EQ(-1.0f, sin_approx_table(-M_PIf / 2));
+    EXPECT_FLOAT_EQ(1.0f, cos_approx_table(0.0f));
+    EXPECT_FLOAT_EQ(-1.0f, cos_approx_table(M_PIf));
+}
+
+TEST(MathsUnittest, TestTableTrigonometryATan2)
+{
+    double error = 0;
+    for (float x = -1.0f; x < 1.0f; x += 0.01) {
+        for (float y = -1.0f; y < 1.0f; y += 0.001) {
+            double approxResult = atan2_approx_table(y, x);
+            double libmResult = atan2f(y, x);
+            error = MAX(error, fabs(approxResult - libmResult));
+        }
+    }
+    printf("atan2_approx_table maximum absolute error = %e rads (%e degree)\n", error, error / M_PI * 180.0f);
+    EXPECT_LE(error, 2.1e-5);
+}
 #endif
+
+TEST(MathsUnittest, TestFastInvSqrt)
+{
+    double error = 0;
+    for (float x = 1e-4f; x < 1e4f; x *= 1.001f) {
+        double approxResult = invSqrt_approx(x);
+        double libmResult = 1.0 / sqrt(x);
+        error = MAX(error, fabs(approxResult - libmResult) / libmResult);
+    }
+    printf("invSqrt_approx maximum relative error = %e\n", error);
+    EXPECT_LE(error, 1.8e-3);
+}
@@ -0,0 +1,417 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "drivers/bus_spi.h"
+    #include "drivers/io.h"
+    #include "drivers/max7456.h"
+    #include "drivers/osd.h"
+
+    #include "pg/max7456.h"
+    #include "pg/vcd.h"
+
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Host model of the MAX7456 registers, the SPI transfers are (address, data) byte pairs
+// while CS is low and an address with bit 7 set reads the register.
+
+#define REG_VM0             0x00
+#define REG_CMM             0x08
+#define REG_CMAH            0x09
+#define REG_CMAL            0x0a
+#define REG_CMDI            0x0b
+#define REG_OSDM            0x0c
+#define REG_STAT            0xa0    // read only
+
+#define VM0_RESET           0x02
+#define VM0_OSD_ENABLE      0x08
+#define VM0_PAL             0x40
+#define STAT_PAL            0x01
+#define STAT_LOS            0x04
+#define STAT_NVR_BUSY       0x20
+#define CMM_WRITE_NVR       0xa0
+
+#define CHAR_BYTES          54
+#define NVR_BUSY_POLLS      3       // the status reads the NVM write stays busy for
+
+static struct {
+    bool addressPhase;
+    uint8_t address;
+    uint8_t reg[0x80];
+    uint8_t stat;                   // video input bits of STAT
+    uint8_t charRam[CHAR_BYTES];
+    uint8_t nvm[256][CHAR_BYTES];
+    int nvmBusyPolls;
+    int nvmWrites;
+    int writesWhileNvmBusy;
+    int readCount[0x100];           // by address byte
+} chip;
+
+static uint32_t simulationTimeMs;
+
+static uint8_t chipTransferByte(uint8_t data)
+{
+    if (chip.addressPhase) {
+        chip.address = data;
+        chip.addressPhase = false;
+        return 0;
+    }
+    chip.addressPhase = true;
+
+    const uint8_t address = chip.address;
+    if (address == REG_STAT) {
+        chip.readCount[address]++;
+        uint8_t stat = chip.stat;
+        if (chip.nvmBusyPolls) {
+            chip.nvmBusyPolls--;
+            stat |= STAT_NVR_BUSY;
+        }
+        return stat;
+    }
+    if (address & 0x80) {
+        chip.readCount[address]++;
+        return chip.reg[address & 0x7f];
+    }
+
+    if (chip.nvmBusyPolls && (address == REG_CMAH || address == REG_CMAL || address == REG_CMDI || address == REG_CMM)) {
+        chip.writesWhileNvmBusy++;
+    }
+
+    chip.reg[address] = data;
+    switch (address) {
+    case REG_VM0:
+        if (data & VM0_RESET) {
+            chip.reg[REG_VM0] = 0;
+        }
+        break;
+    case REG_CMDI:
+        if (chip.reg[REG_CMAL] < CHAR_BYTES) {
+            chip.charRam[chip.reg[REG_CMAL]] = data;
+        }
+        break;
+    case REG_CMM:
+        if (data == CMM_WRITE_NVR) {
+            memcpy(chip.nvm[chip.reg[REG_CMAH]], chip.charRam, CHAR_BYTES);
+            chip.nvmBusyPolls = NVR_BUSY_POLLS;
+            chip.nvmWrites++;
+        }
+        break;
+    }
+    return 0;
+}
+
+static void chipPowerOn(void)
+{
+    memset(&chip, 0, sizeof(chip));
+    chip.addressPhase = true;
+    chip.reg[REG_OSDM] = 0x1B;
+    chip.stat = STAT_LOS;
+}
+
+static int chipRegisterReads(void)
+{
+    return chip.readCount[REG_VM0 | 0x80] + chip.readCount[REG_STAT];
+}
+
+static void fontCharacter(uint8_t *data, uint8_t seed)
+{
+    for (int i = 0; i < CHAR_BYTES; i++) {
+        data[i] = seed + i;
+    }
+}
+
+static void initDevice(uint8_t videoSystem)
+{
+    static const max7456Config_t config = { .clockConfig = MAX7456_CLOCK_CONFIG_FULL, .csTag = 1, .spiDevice = 1, .preInitOPU = false };
+    const vcdProfile_t vcdProfile = { .video_system = videoSystem, .h_offset = 0, .v_offset = 0 };
+
+    chipPowerOn();
+    EXPECT_EQ(MAX7456_INIT_OK, max7456Init(&config, &vcdProfile, false));
+    max7456RefreshAll();
+}
+
+// change every character so that the screen is never in sync
+static void changeWholeScreen(int pass)
+{
+    for (int y = 0; y < VIDEO_LINES_PAL; y++) {
+        for (int x = 0; x < 30; x++) {
+            max7456WriteChar(x, y, 'A' + pass % 26);
+        }
+    }
+}
+
+static void drawUntilSynced(void)
+{
+    for (int i = 0; i < 20; i++) {
+        max7456DrawScreen();
+    }
+    EXPECT_TRUE(max7456BuffersSynced());
+}
+
+TEST(Max7456Test, FontCharacterIsWrittenWithoutWaitingForTheNvm)
+{
+    // given
+    simulationTimeMs = 0;
+    initDevice(VIDEO_SYSTEM_NTSC);
+    EXPECT_EQ(VM0_OSD_ENABLE, chip.reg[REG_VM0]);
+
+    uint8_t data[CHAR_BYTES];
+    fontCharacter(data, 10);
+
+    // when
+    EXPECT_TRUE(max7456WriteNvm(0x41, data));
+
+    // expect
+    // the character is in the NVM write and the status was not polled
+    EXPECT_EQ(1, chip.nvmWrites);
+    EXPECT_EQ(0, chip.readCount[REG_STAT]);
+    EXPECT_EQ(0, chip.reg[REG_VM0]);
+    EXPECT_EQ(1, max7456FontUploadPending());
+    EXPECT_EQ(0, max7456FontUploadCharsWritten());
+
+    // when
+    // the OSD task polls the NVM busy state once per pass
+    int passes = 0;
+    while (max7456FontUploadPending() && passes < 100) {
+        max7456DrawScreen();
+        passes++;
+    }
+
+    // expect
+    EXPECT_EQ(NVR_BUSY_POLLS + 1, passes);
+    EXPECT_EQ(NVR_BUSY_POLLS + 1, chip.readCount[REG_STAT]);
+    EXPECT_EQ(0, memcmp(data, chip.nvm[0x41], CHAR_BYTES));
+    EXPECT_EQ(1, max7456FontUploadCharsWritten());
+    EXPECT_EQ(0, chip.writesWhileNvmBusy);
+
+    // and
+    // the display is enabled again
+    EXPECT_EQ(VM0_OSD_ENABLE, chip.reg[REG_VM0]);
+}
+
+TEST(Max7456Test, FullQueueWaitsForTheOldestCharacter)
+{
+    // given
+    simulationTimeMs = 0;
+    initDevice(VIDEO_SYSTEM_NTSC);
+
+    uint8_t data[MAX7456_FONT_UPLOAD_QUEUE_SIZE + 1][CHAR_BYTES];
+    for (int i = 0; i < MAX7456_FONT_UPLOAD_QUEUE_SIZE + 1; i++) {
+        fontCharacter(data[i], i * 3);
+    }
+
+    // when
+    for (int i = 0; i < MAX7456_FONT_UPLOAD_QUEUE_SIZE; i++) {
+        EXPECT_TRUE(max7456WriteNvm(i, data[i]));
+    }
+
+    // expect
+    EXPECT_EQ(MAX7456_FONT_UPLOAD_QUEUE_SIZE, max7456FontUploadPending());
+    EXPECT_EQ(1, chip.nvmWrites);
+
+    // when
+    EXPECT_TRUE(max7456WriteNvm(MAX7456_FONT_UPLOAD_QUEUE_SIZE, data[MAX7456_FONT_UPLOAD_QUEUE_SIZE]));
+
+    // expect
+    // the first character was finished to make room
+    EXPECT_EQ(MAX7456_FONT_UPLOAD_QUEUE_SIZE, max7456FontUploadPending());
+    EXPECT_EQ(2, chip.nvmWrites);
+
+    // when
+    int passes = 0;
+    while (max7456FontUploadPending() && passes < 100) {
+        max7456DrawScreen();
+        passes++;
+    }
+
+    // expect
+    EXPECT_EQ(MAX7456_FONT_UPLOAD_QUEUE_SIZE + 1, chip.nvmWrites);
+    for (int i = 0; i < MAX7456_FONT_UPLOAD_QUEUE_SIZE + 1; i++) {
+        EXPECT_EQ(0, memcmp(data[i], chip.nvm[i], CHAR_BYTES));
+    }
+    EXPECT_EQ(0, chip.writesWhileNvmBusy);
+    EXPECT_EQ(1 + MAX7456_FONT_UPLOAD_QUEUE_SIZE + 1, max7456FontUploadCharsWritten());
+    EXPECT_EQ(VM0_OSD_ENABLE, chip.reg[REG_VM0]);
+}
+
+TEST(Max7456Test, UploadFinishesWithoutTheOsdTask)
+{
+    // given
+    simulationTimeMs = 0;
+    initDevice(VIDEO_SYSTEM_NTSC);
+
+    uint8_t data[2][CHAR_BYTES];
+    fontCharacter(data[0], 4);
+    fontCharacter(data[1], 7);
+    EXPECT_TRUE(max7456WriteNvm(0x10, data[0]));
+    EXPECT_TRUE(max7456WriteNvm(0x11, data[1]));
+
+    // when
+    // only the upload status is polled, as the MSP handler does
+    int polls = 0;
+    while (max7456FontUploadPending() && polls < 100) {
+        max7456FontUploadProcess();
+        polls++;
+    }
+
+    // expect
+    EXPECT_EQ(0, max7456FontUploadPending());
+    EXPECT_EQ(0, memcmp(data[0], chip.nvm[0x10], CHAR_BYTES));
+    EXPECT_EQ(0, memcmp(data[1], chip.nvm[0x11], CHAR_BYTES));
+    EXPECT_EQ(0, chip.writesWhileNvmBusy);
+    EXPECT_EQ(VM0_OSD_ENABLE, chip.reg[REG_VM0]);
+}
+
+TEST(Max7456Test, HealthCheckWaitsForIdleScreen)
+{
+    // given
+    simulationTimeMs = 0;
+    initDevice(VIDEO_SYSTEM_NTSC);
+    drawUntilSynced();
+
+    // and
+    // the screen is being redrawn
+    changeWholeScreen(0);
+    max7456DrawScreen();
+    int reads = chipRegisterReads();
+
+    // when
+    // the stall check is due
+    simulationTimeMs = 1500;
+    for (int i = 1; i < 10; i++) {
+        changeWholeScreen(i);
+        max7456DrawScreen();
+    }
+
+    // expect
+    EXPECT_EQ(reads, chipRegisterReads());
+
+    // when
+    // the check is overdue
+    simulationTimeMs = 2100;
+    changeWholeScreen(10);
+    max7456DrawScreen();
+
+    // expect
+    EXPECT_EQ(reads + 1, chipRegisterReads());
+
+    // given
+    drawUntilSynced();
+    simulationTimeMs = 3200;
+    reads = chipRegisterReads();
+
+    // when
+    max7456DrawScreen();
+
+    // expect
+    // one register read per pass when the screen is idle
+    EXPECT_EQ(reads + 1, chipRegisterReads());
+    EXPECT_EQ(VM0_OSD_ENABLE, chip.reg[REG_VM0]);
+}
+
+TEST(Max7456Test, StalledChipIsReinitialised)
+{
+    // given
+    simulationTimeMs = 0;
+    initDevice(VIDEO_SYSTEM_NTSC);
+    drawUntilSynced();
+
+    // and
+    // the chip was reset by a brown out when the camera was swapped
+    chip.reg[REG_VM0] = 0;
+    simulationTimeMs = 1500;
+
+    // when
+    max7456DrawScreen();
+
+    // expect
+    EXPECT_EQ(VM0_OSD_ENABLE, chip.reg[REG_VM0]);
+    EXPECT_FALSE(max7456BuffersSynced());
+}
+
+TEST(Max7456Test, VideoStandardChangeIsDetected)
+{
+    // given
+    simulationTimeMs = 0;
+    initDevice(VIDEO_SYSTEM_AUTO);
+    drawUntilSynced();
+    EXPECT_EQ(VIDEO_LINES_NTSC, max7456GetRowsCount());
+
+    // and
+    // a PAL camera is connected
+    chip.stat = STAT_PAL;
+
+    // when
+    // the signal is checked and seen again after the debounce time
+    for (simulationTimeMs = 1100; simulationTimeMs < 4000; simulationTimeMs += 100) {
+        max7456DrawScreen();
+    }
+
+    // expect
+    EXPECT_EQ(VM0_PAL | VM0_OSD_ENABLE, chip.reg[REG_VM0]);
+    EXPECT_EQ(VIDEO_LINES_PAL, max7456GetRowsCount());
+}
+
+// STUBS
+extern "C" {
+uint32_t millis(void) { return simulationTimeMs; }
+void delay(uint32_t) {}
+
+uint8_t spiTransferByte(SPI_TypeDef *, uint8_t data)
+{
+    return chipTransferByte(data);
+}
+
+bool spiTransfer(SPI_TypeDef *, const uint8_t *txData, uint8_t *rxData, int len)
+{
+    for (int i = 0; i < len; i++) {
+        const uint8_t b = chipTransferByte(txData ? txData[i] : 0xff);
+        if (rxData) {
+            rxData[i] = b;
+        }
+    }
+    return true;
+}
+
+void spiSetDivisor(SPI_TypeDef *, uint16_t) {}
+void spiBusSetDivisor(busDevice_t *, SPIClockDivider_e) {}
+void spiBusSetInstance(busDevice_t *, SPI_TypeDef *) {}
+SPI_TypeDef *spiInstanceByDevice(SPIDevice) { return NULL; }
+void spiPreinitRegister(ioTag_t, uint8_t, uint8_t) {}
+
+IO_t IOGetByTag(ioTag_t tag) { return (IO_t)(uintptr_t)tag; }
+bool IOIsFreeOrPreinit(IO_t) { return true; }
+void IOInit(IO_t, resourceOwner_e, uint8_t) {}
+void IOConfigGPIO(IO_t, ioConfig_t) {}
+void IOLo(IO_t) { chip.addressPhase = true; }
+void IOHi(IO_t) {}
+}
@@ -0,0 +1,251 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "flight/mixer.h"
+    #include "flight/mixer_allocation.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TOLERANCE 1e-5f
+
+static const motorMixer_t mixerQuadX[] = {
+    { 1.0f, -1.0f,  1.0f, -1.0f },          // REAR_R
+    { 1.0f, -1.0f, -1.0f,  1.0f },          // FRONT_R
+    { 1.0f,  1.0f,  1.0f,  1.0f },          // REAR_L
+    { 1.0f,  1.0f, -1.0f, -1.0f },          // FRONT_L
+};
+
+static const motorMixer_t mixerHex6X[] = {
+    { 1.0f, -0.5f,  0.866025f,  1.0f },     // REAR_R
+    { 1.0f, -0.5f, -0.866025f,  1.0f },     // FRONT_R
+    { 1.0f,  0.5f,  0.866025f, -1.0f },     // REAR_L
+    { 1.0f,  0.5f, -0.866025f, -1.0f },     // FRONT_L
+    { 1.0f, -1.0f,  0.0f,      -1.0f },     // RIGHT
+    { 1.0f,  1.0f,  0.0f,       1.0f },     // LEFT
+};
+
+static const motorMixer_t mixerOctoX8[] = {
+    { 1.0f, -1.0f,  1.0f, -1.0f },          // REAR_R
+    { 1.0f, -1.0f, -1.0f,  1.0f },          // FRONT_R
+    { 1.0f,  1.0f,  1.0f,  1.0f },          // REAR_L
+    { 1.0f,  1.0f, -1.0f, -1.0f },          // FRONT_L
+    { 1.0f, -1.0f,  1.0f,  1.0f },          // UNDER_REAR_R
+    { 1.0f, -1.0f, -1.0f, -1.0f },          // UNDER_FRONT_R
+    { 1.0f,  1.0f,  1.0f, -1.0f },          // UNDER_REAR_L
+    { 1.0f,  1.0f, -1.0f,  1.0f },          // UNDER_FRONT_L
+};
+
+static float mixRange(const float *motorMix, int motorCount)
+{
+    float mixMax = 0, mixMin = 0;
+    for (int i = 0; i < motorCount; i++) {
+        mixMax = fmaxf(mixMax, motorMix[i]);
+        mixMin = fminf(mixMin, motorMix[i]);
+    }
+    return mixMax - mixMin;
+}
+
+static void expectMix(const motorMixer_t *mixer, int motorCount, const float *motorMix,
+    float roll, float pitch, float yaw, float rollPitchScale, float yawScale)
+{
+    for (int i = 0; i < motorCount; i++) {
+        const float expected = rollPitchScale * (roll * mixer[i].roll + pitch * mixer[i].pitch) + yawScale * yaw * mixer[i].yaw;
+        EXPECT_NEAR(expected, motorMix[i], TOLERANCE);
+    }
+}
+
+TEST(MixerAllocationTest, UnsaturatedDemandIsUnchanged)
+{
+    // given
+    float motorMix[MAX_SUPPORTED_MOTORS];
+    mixerAllocation_t allocation;
+
+    // when
+    mixerAllocateByPriority(motorMix, mixerQuadX, 4, 0.2f, -0.1f, 0.15f, 0.0f, &allocation);
+
+    // then
+    EXPECT_FLOAT_EQ(1.0f, allocation.rollPitchScale);
+    EXPECT_FLOAT_EQ(1.0f, allocation.yawScale);
+    expectMix(mixerQuadX, 4, motorMix, 0.2f, -0.1f, 0.15f, 1.0f, 1.0f);
+    EXPECT_NEAR(0.7f, allocation.motorMixMax - allocation.motorMixMin, TOLERANCE);
+}
+
+TEST(MixerAllocationTest, YawDoesNotReduceRollPitch)
+{
+    // given
+    // roll needs 0.6 of the motor range, yaw would need 1.2
+    float motorMix[MAX_SUPPORTED_MOTORS];
+    mixerAllocation_t allocation;
+
+    // when
+    mixerAllocateByPriority(motorMix, mixerQuadX, 4, 0.3f, 0.0f, 0.6f, 0.0f, &allocation);
+
+    // then
+    // roll is kept, yaw gets the rest of the range
+    EXPECT_FLOAT_EQ(1.0f, allocation.rollPitchScale);
+    // 0.3 + 0.6 * yawScale - (-0.3 - 0.6 * yawScale) = 1
+    EXPECT_NEAR(0.4f / 1.2f, allocation.yawScale, TOLERANCE);
+    expectMix(mixerQuadX, 4, motorMix, 0.3f, 0.0f, 0.6f, 1.0f, 0.4f / 1.2f);
+    EXPECT_NEAR(1.0f, mixRange(motorMix, 4), TOLERANCE);
+    EXPECT_NEAR(allocation.motorMixMax - allocation.motorMixMin, mixRange(motorMix, 4), TOLERANCE);
+}
+
+TEST(MixerAllocationTest, YawOnRollPitchUnloadedMotorsIsKept)
+{
+    // given
+    // roll and pitch together only load the diagonal FRONT_R and REAR_L motors
+    float motorMix[MAX_SUPPORTED_MOTORS];
+    mixerAllocation_t allocation;
+
+    // when
+    mixerAllocateByPriority(motorMix, mixerQuadX, 4, 0.25f, 0.25f, 0.3f, 0.0f, &allocation);
+
+    // then
+    // yaw moves the diagonal up together, the range stays 1 until REAR_R and FRONT_L at -0.3 * yawScale
+    // are below FRONT_R at -0.5 + 0.3 * yawScale
+    EXPECT_FLOAT_EQ(1.0f, allocation.rollPitchScale);
+    EXPECT_NEAR(0.5f / 0.6f, allocation.yawScale, TOLERANCE);
+    expectMix(mixerQuadX, 4, motorMix, 0.25f, 0.25f, 0.3f, 1.0f, 0.5f / 0.6f);
+    EXPECT_NEAR(1.0f, mixRange(motorMix, 4), TOLERANCE);
+}
+
+TEST(MixerAllocationTest, SaturatedRollPitchLeavesNoYaw)
+{
+    // given
+    float motorMix[MAX_SUPPORTED_MOTORS];
+    mixerAllocation_t allocation;
+
+    // when
+    mixerAllocateByPriority(motorMix, mixerQuadX, 4, 1.0f, 0.0f, 0.5f, 0.0f, &allocation);
+
+    // then
+    EXPECT_NEAR(0.5f, allocation.rollPitchScale, TOLERANCE);
+    EXPECT_NEAR(0.0f, allocation.yawScale, TOLERANCE);
+    expectMix(mixerQuadX, 4, motorMix, 1.0f, 0.0f, 0.5f, 0.5f, 0.0f);
+    EXPECT_NEAR(1.0f, mixRange(motorMix, 4), TOLERANCE);
+}
+
+TEST(MixerAllocationTest, FullYawPriorityScalesAllAxesTogether)
+{
+    // given
+    float motorMix[MAX_SUPPORTED_MOTORS];
+    mixerAllocation_t allocation;
+
+    // when
+    mixerAllocateByPriority(motorMix, mixerQuadX, 4, 0.3f, -0.2f, 0.6f, 1.0f, &allocation);
+
+    // then
+    // the same as the legacy mixer, every axis divided by the range of 1.8
+    const float scale = 1.0f / 1.8f;
+    EXPECT_NEAR(scale, allocation.rollPitchScale, TOLERANCE);
+    EXPECT_NEAR(scale, allocation.yawScale, TOLERANCE);
+    expectMix(mixerQuadX, 4, motorMix, 0.3f, -0.2f, 0.6f, scale, scale);
+}
+
+TEST(MixerAllocationTest, PartialYawPriority)
+{
+    // given
+    float motorMix[MAX_SUPPORTED_MOTORS];
+    mixerAllocation_t allocation;
+
+    // when
+    // roll 0.3 and half the yaw 0.3 use 1.2 of the range
+    mixerAllocateByPriority(motorMix, mixerQuadX, 4, 0.3f, 0.0f, 0.6f, 0.5f, &allocation);
+
+    // then
+    // the first half of the yaw is scaled with roll, the second half gets nothing
+    EXPECT_NEAR(1.0f / 1.2f, allocation.rollPitchScale, TOLERANCE);
+    EXPECT_NEAR(0.5f / 1.2f, allocation.yawScale, TOLERANCE);
+    EXPECT_NEAR(1.0f, mixRange(motorMix, 4), TOLERANCE);
+    // yaw keeps more authority than without priority
+    mixerAllocation_t noPriority;
+    mixerAllocateByPriority(motorMix, mixerQuadX, 4, 0.3f, 0.0f, 0.6f, 0.0f, &noPriority);
+    EXPECT_GT(allocation.yawScale, noPriority.yawScale);
+    EXPECT_LT(allocation.rollPitchScale, noPriority.rollPitchScale);
+}
+
+static void checkAllocationIsMaximal(const motorMixer_t *mixer, int motorCount, float yawPriority)
+{
+    srand(motorCount);
+    for (int n = 0; n < 2000; n++) {
+        const float roll = (rand() / (float)RAND_MAX - 0.5f) * 2.0f;
+        const float pitch = (rand() / (float)RAND_MAX - 0.5f) * 2.0f;
+        const float yaw = (rand() / (float)RAND_MAX - 0.5f) * 2.0f;
+
+        float motorMix[MAX_SUPPORTED_MOTORS];
+        mixerAllocation_t allocation;
+        mixerAllocateByPriority(motorMix, mixer, motorCount, roll, pitch, yaw, yawPriority, &allocation);
+
+        // the allocated mix always fits in the motor range
+        const float range = mixRange(motorMix, motorCount);
+        EXPECT_LE(range, 1.0f + TOLERANCE);
+        EXPECT_NEAR(allocation.motorMixMax - allocation.motorMixMin, range, TOLERANCE);
+        EXPECT_GE(allocation.rollPitchScale, 0.0f);
+        EXPECT_LE(allocation.rollPitchScale, 1.0f);
+        EXPECT_GE(allocation.yawScale, 0.0f);
+        EXPECT_LE(allocation.yawScale, 1.0f);
+        expectMix(mixer, motorCount, motorMix, roll, pitch, yaw, allocation.rollPitchScale, allocation.yawScale);
+
+        // and no more of the second stage yaw fits without reducing roll and pitch
+        const float maxYawScale = yawPriority * allocation.rollPitchScale + (1.0f - yawPriority);
+        if (allocation.yawScale < maxYawScale - TOLERANCE) {
+            float moreYawMix[MAX_SUPPORTED_MOTORS];
+            for (int i = 0; i < motorCount; i++) {
+                moreYawMix[i] = motorMix[i] + 0.001f * yaw * mixer[i].yaw;
+            }
+            EXPECT_GT(mixRange(moreYawMix, motorCount), 1.0f);
+        }
+        // and roll and pitch are only reduced when they saturate on their own with the prioritised yaw
+        if (allocation.rollPitchScale < 1.0f - TOLERANCE) {
+            float firstMix[MAX_SUPPORTED_MOTORS];
+            for (int i = 0; i < motorCount; i++) {
+                firstMix[i] = allocation.rollPitchScale * (roll * mixer[i].roll + pitch * mixer[i].pitch + yawPriority * yaw * mixer[i].yaw);
+            }
+            EXPECT_NEAR(1.0f, mixRange(firstMix, motorCount), TOLERANCE);
+        }
+    }
+}
+
+TEST(MixerAllocationTest, QuadXAllocationIsMaximal)
+{
+    checkAllocationIsMaximal(mixerQuadX, 4, 0.0f);
+    checkAllocationIsMaximal(mixerQuadX, 4, 0.3f);
+}
+
+TEST(MixerAllocationTest, Hex6XAllocationIsMaximal)
+{
+    checkAllocationIsMaximal(mixerHex6X, 6, 0.0f);
+    checkAllocationIsMaximal(mixerHex6X, 6, 0.3f);
+}
+
+TEST(MixerAllocationTest, OctoX8AllocationIsMaximal)
+{
+    checkAllocationIsMaximal(mixerOctoX8, 8, 0.0f);
+    checkAllocationIsMaximal(mixerOctoX8, 8, 0.3f);
+}
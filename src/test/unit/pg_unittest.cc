@@ -30,6 +30,11 @@ extern "C" {
 
     #include "flight/mixer.h"
 
+    #include "config/config_eeprom.h"
+    #include "config/config_streamer.h"
+
+    #include "drivers/system.h"
+
 //PG_DECLARE(motorConfig_t, motorConfig);
 
 PG_REGISTER_WITH_RESET_TEMPLATE(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 1);
@@ -40,6 +45,28 @@ PG_RESET_TEMPLATE(motorConfig_t, motorConfig,
     .mincommand = 1000,
     .dev = {.motorPwmRate = 400}
 );
+
+// a registry with as many PGs as a full featured target
+typedef struct testConfig_s {
+    uint32_t value;
+    uint8_t data[5];
+} testConfig_t;
+
+#define TEST_PG_BASE 3000
+#define TEST_PG_COUNT 160
+
+#define TEST_PG(n) \
+    PG_DECLARE(testConfig_t, testConfig ## n); \
+    PG_REGISTER(testConfig_t, testConfig ## n, TEST_PG_BASE + n, 0)
+#define TEST_PG_10(n) \
+    TEST_PG(n ## 0); TEST_PG(n ## 1); TEST_PG(n ## 2); TEST_PG(n ## 3); TEST_PG(n ## 4); \
+    TEST_PG(n ## 5); TEST_PG(n ## 6); TEST_PG(n ## 7); TEST_PG(n ## 8); TEST_PG(n ## 9)
+
+TEST_PG(0); TEST_PG(1); TEST_PG(2); TEST_PG(3); TEST_PG(4); TEST_PG(5); TEST_PG(6); TEST_PG(7); TEST_PG(8); TEST_PG(9);
+TEST_PG_10(1); TEST_PG_10(2); TEST_PG_10(3); TEST_PG_10(4); TEST_PG_10(5); TEST_PG_10(6); TEST_PG_10(7);
+TEST_PG_10(8); TEST_PG_10(9); TEST_PG_10(10); TEST_PG_10(11); TEST_PG_10(12); TEST_PG_10(13); TEST_PG_10(14); TEST_PG_10(15);
+
+uint8_t eepromData[EEPROM_SIZE];
 }
 
 
@@ -84,7 +111,174 @@ TEST(ParameterGroupsfTest, Test_pgFind)
     EXPECT_EQ(400, motorConfig3.dev.motorPwmRate);
 }
 
+static testConfig_t *testConfig(pgn_t pgn)
+{
+    return (testConfig_t *)pgFind(pgn)->address;
+}
+
+static void setTestConfigs(uint32_t value)
+{
+    for (int i = 0; i < TEST_PG_COUNT; i++) {
+        testConfig(TEST_PG_BASE + i)->value = value + i;
+        memset(testConfig(TEST_PG_BASE + i)->data, i, sizeof(testConfig_t::data));
+    }
+}
+
+TEST(ParameterGroupsfTest, Test_configRoundTrip)
+{
+    // given
+    pgResetAll();
+    motorConfigMutable()->minthrottle = 1070;
+    setTestConfigs(100);
+    writeConfigToEEPROM();
+
+    // when
+    pgResetAll();
+    setTestConfigs(0);
+    const bool success = loadEEPROM();
+
+    // then
+    EXPECT_TRUE(success);
+    EXPECT_EQ(1070, motorConfig()->minthrottle);
+    for (int i = 0; i < TEST_PG_COUNT; i++) {
+        EXPECT_EQ(100U + i, testConfig(TEST_PG_BASE + i)->value);
+        EXPECT_EQ(i, testConfig(TEST_PG_BASE + i)->data[sizeof(testConfig_t::data) - 1]);
+    }
+}
+
+// A stored record starts with its size, the pgn, the version and the flags, followed by the PG
+#define STORED_RECORD_HEADER_SIZE 6
+
+// returns the stored record of the PG
+static uint8_t *findStoredRecord(pgn_t pgnToFind)
+{
+    uint8_t *p = eepromData + 2;
+    pgn_t pgn;
+    while (memcpy(&pgn, p + 2, sizeof(pgn)), pgn != pgnToFind) {
+        uint16_t size;
+        memcpy(&size, p, sizeof(size));
+        p += size;
+    }
+
+    return p;
+}
+
+static void setStoredRecordPgn(uint8_t *record, pgn_t pgn)
+{
+    memcpy(record + 2, &pgn, sizeof(pgn));
+}
+
+TEST(ParameterGroupsfTest, Test_configValidatedAndIndexedInOnePass)
+{
+    // given
+    pgResetAll();
+    setTestConfigs(200);
+    writeConfigToEEPROM();
+
+    // when
+    setTestConfigs(0);
+    const bool valid = isEEPROMStructureValid();
+    // the pgn is no longer searched for, the records are loaded from the index built during validation
+    setStoredRecordPgn(findStoredRecord(TEST_PG_BASE), PG_RESERVED_FOR_TESTING_1);
+    const bool success = loadEEPROM();
+
+    // then
+    EXPECT_TRUE(valid);
+    EXPECT_TRUE(success);
+    EXPECT_EQ(200U, testConfig(TEST_PG_BASE)->value);
+    EXPECT_EQ(200U + TEST_PG_COUNT - 1, testConfig(TEST_PG_BASE + TEST_PG_COUNT - 1)->value);
+}
+
+TEST(ParameterGroupsfTest, Test_configNotIndexedIfCrcFails)
+{
+    // given
+    pgResetAll();
+    setTestConfigs(600);
+    writeConfigToEEPROM();
+    uint8_t *record = findStoredRecord(TEST_PG_BASE + 1);
+    record[STORED_RECORD_HEADER_SIZE] ^= 0xff;
+
+    // when
+    setTestConfigs(0);
+    const bool valid = isEEPROMStructureValid();
+    // an index built from the corrupted config would still find the record
+    setStoredRecordPgn(findStoredRecord(TEST_PG_BASE), PG_RESERVED_FOR_TESTING_1);
+    loadEEPROM();
+
+    // then
+    EXPECT_FALSE(valid);
+    EXPECT_EQ(0U, testConfig(TEST_PG_BASE)->value);
+}
+
+TEST(ParameterGroupsfTest, Test_configReloadedAfterWrite)
+{
+    // given
+    pgResetAll();
+    setTestConfigs(300);
+    writeConfigToEEPROM();
+    loadEEPROM();
+
+    // when
+    // the records are rewritten, the index must not point to the old ones
+    motorConfigMutable()->minthrottle = 1100;
+    setTestConfigs(400);
+    writeConfigToEEPROM();
+    setTestConfigs(0);
+    loadEEPROM();
+
+    // then
+    EXPECT_EQ(1100, motorConfig()->minthrottle);
+    EXPECT_EQ(400U, testConfig(TEST_PG_BASE)->value);
+    EXPECT_EQ(400U + TEST_PG_COUNT - 1, testConfig(TEST_PG_BASE + TEST_PG_COUNT - 1)->value);
+}
+
+TEST(ParameterGroupsfTest, Test_missingRecordReset)
+{
+    // given
+    pgResetAll();
+    motorConfigMutable()->minthrottle = 1070;
+    setTestConfigs(500);
+    writeConfigToEEPROM();
+
+    // the record of the first test PG was stored by an older firmware with a PG that no longer exists
+    setStoredRecordPgn(findStoredRecord(TEST_PG_BASE), PG_RESERVED_FOR_TESTING_1);
+
+    // when
+    setTestConfigs(0);
+    EXPECT_FALSE(isEEPROMStructureValid()); // CRC mismatch
+    const bool success = loadEEPROM();
+
+    // then
+    EXPECT_FALSE(success);
+    EXPECT_EQ(0U, testConfig(TEST_PG_BASE)->value);
+    EXPECT_EQ(501U, testConfig(TEST_PG_BASE + 1)->value);
+    EXPECT_EQ(1070, motorConfig()->minthrottle);
+}
+
 // STUBS
 
 extern "C" {
+void failureMode(failureMode_e) {}
+
+void config_streamer_init(config_streamer_t *c)
+{
+    memset(c, 0, sizeof(*c));
+}
+
+void config_streamer_start(config_streamer_t *c, uintptr_t base, int size)
+{
+    c->address = base;
+    c->size = size;
+    c->at = 0;
+}
+
+int config_streamer_write(config_streamer_t *c, const uint8_t *p, uint32_t size)
+{
+    memcpy((uint8_t *)c->address + c->at, p, size);
+    c->at += size;
+    return 0;
+}
+
+int config_streamer_flush(config_streamer_t *) { return 0; }
+int config_streamer_finish(config_streamer_t *) { return 0; }
 }
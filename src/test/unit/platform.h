@@ -31,6 +31,8 @@
 #define FAST_CODE_NOINLINE
 #define FAST_RAM_ZERO_INIT
 #define FAST_RAM
+#define DMA_RAM
+#define DMA_RW_AXI
 
 #define PID_PROFILE_COUNT 3
 #define CONTROL_RATE_PROFILE_COUNT  6
@@ -73,6 +75,11 @@ typedef struct
     void* test;
 } TIM_OCInitTypeDef;
 
+typedef struct
+{
+    void* test;
+} TIM_ICInitTypeDef;
+
 typedef struct {
     void* test;
 } DMA_TypeDef;
@@ -81,6 +88,10 @@ typedef struct {
     void* test;
 } DMA_Channel_TypeDef;
 
+typedef struct {
+    void* test;
+} DMA_InitTypeDef;
+
 uint8_t DMA_GetFlagStatus(void *);
 void DMA_Cmd(DMA_Channel_TypeDef*, FunctionalState );
 void DMA_ClearFlag(uint32_t);
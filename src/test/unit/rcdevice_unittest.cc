@@ -26,6 +26,7 @@ extern "C" {
     #include "platform.h"
 
     #include "common/bitarray.h"
+    #include "common/crc.h"
     #include "common/maths.h"
     #include "common/utils.h"
     #include "common/streambuf.h"
@@ -58,6 +59,7 @@ extern "C" {
     extern runcamDevice_t *camDevice;
     extern bool isButtonPressed;
     extern bool rcdeviceInMenu;
+    extern bool waitingDeviceResponse;
     extern rcdeviceWaitingResponseQueue waitingResponseQueue;
     PG_REGISTER_WITH_RESET_FN(rcdeviceConfig_t, rcdeviceConfig, PG_RCDEVICE_CONFIG, 0);
     bool unitTestIsSwitchActivited(boxId_e boxId)
@@ -100,6 +102,9 @@ typedef struct testData_s {
     uint8_t responseBufsLen[MAX_RESPONSES_COUNT];
     uint8_t responseDataReadPos;
     uint32_t millis;
+    uint8_t writeCount;
+    uint8_t writtenData[RCDEVICE_PROTOCOL_MAX_PACKET_SIZE];
+    uint8_t writtenDataLen;
 } testData_t;
 
 static testData_t testData;
@@ -759,6 +764,266 @@ TEST(RCDeviceTest, Test5KeyOSDCableSimulationWithout5KeyFeatureSupport)
     }
 }
 
+#define MAX_RECORDED_RESPONSES 16
+
+static uint8_t recordedResponseCount;
+static uint8_t recordedCommands[MAX_RECORDED_RESPONSES];
+static uint8_t recordedOperations[MAX_RECORDED_RESPONSES];
+static rcdeviceResponseStatus_e recordedResults[MAX_RECORDED_RESPONSES];
+
+static void recordResponse(rcdeviceResponseParseContext_t *ctx)
+{
+    if (recordedResponseCount < MAX_RECORDED_RESPONSES) {
+        recordedCommands[recordedResponseCount] = ctx->command;
+        recordedOperations[recordedResponseCount] = ctx->paramDataLen ? ctx->paramData[0] : RCDEVICE_PROTOCOL_5KEY_SIMULATION_NONE;
+        recordedResults[recordedResponseCount] = ctx->result;
+        recordedResponseCount++;
+    }
+}
+
+static void initReadyDevice()
+{
+    resetRCDeviceStatus();
+
+    memset(&testData, 0, sizeof(testData));
+    testData.isRunCamSplitOpenPortSupported = true;
+    testData.isRunCamSplitPortConfigurated = true;
+    testData.isAllowBufferReadWrite = true;
+    uint8_t responseData[] = { 0xCC, 0x01, 0x37, 0x00, 0xBD };
+    addResponseData(responseData, sizeof(responseData), true);
+    rcdeviceInit();
+    testData.millis += 3001;
+    rcdeviceReceive(millis() * 1000);
+    testData.millis += minTimeout;
+    testData.responseDataReadPos = 0;
+    testData.indexOfCurrentRespBuf = 0;
+    rcdeviceReceive(millis() * 1000);
+    testData.millis += minTimeout;
+    EXPECT_TRUE(camDevice->isReady);
+    clearResponseBuff();
+
+    recordedResponseCount = 0;
+    testData.writeCount = 0;
+}
+
+static uint8_t appendPacket(uint8_t *packet, uint8_t command, uint8_t operation)
+{
+    uint8_t len = 0;
+    packet[len++] = RCDEVICE_PROTOCOL_HEADER;
+    packet[len++] = command;
+    if (operation != RCDEVICE_PROTOCOL_5KEY_SIMULATION_NONE) {
+        packet[len++] = operation;
+    }
+    uint8_t crc = 0;
+    for (int i = 0; i < len; i++) {
+        crc = crc8_dvb_s2(crc, packet[i]);
+    }
+    packet[len++] = crc;
+
+    return len;
+}
+
+TEST(RCDeviceTest, TestPipelinedButtonSequenceSentInOneBurst)
+{
+    // given
+    initReadyDevice();
+    const uint8_t operations[] = { RCDEVICE_PROTOCOL_5KEY_SIMULATION_RIGHT, RCDEVICE_PROTOCOL_5KEY_SIMULATION_DOWN };
+
+    // when
+    uint8_t clickCount = runcamDeviceSimulate5KeyOSDCableButtonSequence(camDevice, operations, ARRAYLEN(operations), recordResponse);
+
+    // then
+    EXPECT_EQ(2, clickCount);
+    EXPECT_EQ(1, testData.writeCount);
+    EXPECT_EQ(4, waitingResponseQueue.itemCount);
+
+    uint8_t expected[RCDEVICE_PROTOCOL_MAX_PACKET_SIZE];
+    uint8_t expectedLen = 0;
+    expectedLen += appendPacket(&expected[expectedLen], RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_PRESS, RCDEVICE_PROTOCOL_5KEY_SIMULATION_RIGHT);
+    expectedLen += appendPacket(&expected[expectedLen], RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_RELEASE, RCDEVICE_PROTOCOL_5KEY_SIMULATION_NONE);
+    expectedLen += appendPacket(&expected[expectedLen], RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_PRESS, RCDEVICE_PROTOCOL_5KEY_SIMULATION_DOWN);
+    expectedLen += appendPacket(&expected[expectedLen], RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_RELEASE, RCDEVICE_PROTOCOL_5KEY_SIMULATION_NONE);
+    EXPECT_EQ(expectedLen, testData.writtenDataLen);
+    EXPECT_EQ(0, memcmp(expected, testData.writtenData, expectedLen));
+
+    clearResponseBuff();
+}
+
+TEST(RCDeviceTest, TestPipelinedResponsesMatchedInOrder)
+{
+    // given
+    initReadyDevice();
+    const uint8_t operations[] = { RCDEVICE_PROTOCOL_5KEY_SIMULATION_UP, RCDEVICE_PROTOCOL_5KEY_SIMULATION_SET };
+    uint8_t responseData[] = { 0xCC, 0xA5, 0xCC, 0xA5, 0xCC, 0xA5, 0xCC, 0xA5 };
+    addResponseData(responseData, sizeof(responseData), true);
+    runcamDeviceSimulate5KeyOSDCableButtonSequence(camDevice, operations, ARRAYLEN(operations), recordResponse);
+
+    // when
+    rcdeviceReceive(millis() * 1000);
+
+    // then
+    EXPECT_EQ(0, waitingResponseQueue.itemCount);
+    ASSERT_EQ(4, recordedResponseCount);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(RCDEVICE_RESP_SUCCESS, recordedResults[i]);
+    }
+    EXPECT_EQ(RCDEVICE_PROTOCOL_5KEY_SIMULATION_UP, recordedOperations[0]);
+    EXPECT_EQ(RCDEVICE_PROTOCOL_5KEY_SIMULATION_SET, recordedOperations[2]);
+    EXPECT_EQ(RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_PRESS, recordedCommands[0]);
+    EXPECT_EQ(RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_RELEASE, recordedCommands[1]);
+    EXPECT_EQ(RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_PRESS, recordedCommands[2]);
+    EXPECT_EQ(RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_RELEASE, recordedCommands[3]);
+
+    clearResponseBuff();
+}
+
+TEST(RCDeviceTest, TestPipelinedPartialResponsesKeepRemainingRequests)
+{
+    // given
+    initReadyDevice();
+    const uint8_t operations[] = { RCDEVICE_PROTOCOL_5KEY_SIMULATION_LEFT };
+    uint8_t responseData[] = { 0xCC, 0xA5 };
+    addResponseData(responseData, sizeof(responseData), true);
+    runcamDeviceSimulate5KeyOSDCableButtonSequence(camDevice, operations, ARRAYLEN(operations), recordResponse);
+
+    // when
+    rcdeviceReceive(millis() * 1000);
+
+    // then only the press is answered, the release keeps waiting
+    EXPECT_EQ(1, recordedResponseCount);
+    EXPECT_EQ(RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_PRESS, recordedCommands[0]);
+    EXPECT_EQ(1, waitingResponseQueue.itemCount);
+
+    clearResponseBuff();
+}
+
+TEST(RCDeviceTest, TestPipelinedRequestsResentAfterLostResponse)
+{
+    // given
+    initReadyDevice();
+    const uint8_t operations[] = { RCDEVICE_PROTOCOL_5KEY_SIMULATION_RIGHT, RCDEVICE_PROTOCOL_5KEY_SIMULATION_LEFT };
+    runcamDeviceSimulate5KeyOSDCableButtonSequence(camDevice, operations, ARRAYLEN(operations), recordResponse);
+    EXPECT_EQ(1, testData.writeCount);
+
+    // when
+    testData.millis += 1000;
+    rcdeviceReceive(millis() * 1000);
+
+    // then all the requests are sent again, in order
+    EXPECT_EQ(5, testData.writeCount);
+    EXPECT_EQ(4, waitingResponseQueue.itemCount);
+    EXPECT_EQ(0, recordedResponseCount);
+    uint8_t expected[RCDEVICE_PROTOCOL_MAX_PACKET_SIZE];
+    uint8_t expectedLen = appendPacket(expected, RCDEVICE_PROTOCOL_COMMAND_5KEY_SIMULATION_RELEASE, RCDEVICE_PROTOCOL_5KEY_SIMULATION_NONE);
+    EXPECT_EQ(expectedLen, testData.writtenDataLen);
+    EXPECT_EQ(0, memcmp(expected, testData.writtenData, expectedLen));
+
+    // when
+    uint8_t responseData[] = { 0xCC, 0xA5, 0xCC, 0xA5, 0xCC, 0xA5, 0xCC, 0xA5 };
+    addResponseData(responseData, sizeof(responseData), true);
+    testData.indexOfCurrentRespBuf = 0;
+    testData.responseDataReadPos = 0;
+    rcdeviceReceive(millis() * 1000);
+
+    // then
+    EXPECT_EQ(4, recordedResponseCount);
+    EXPECT_EQ(0, waitingResponseQueue.itemCount);
+
+    clearResponseBuff();
+}
+
+TEST(RCDeviceTest, TestPipelinedSequenceLimitedByQueue)
+{
+    // given
+    initReadyDevice();
+    uint8_t operations[MAX_WAITING_RESPONSES];
+    for (unsigned i = 0; i < ARRAYLEN(operations); i++) {
+        operations[i] = RCDEVICE_PROTOCOL_5KEY_SIMULATION_DOWN;
+    }
+
+    // when
+    uint8_t clickCount = runcamDeviceSimulate5KeyOSDCableButtonSequence(camDevice, operations, ARRAYLEN(operations), recordResponse);
+
+    // then
+    EXPECT_EQ(MAX_WAITING_RESPONSES / 2, clickCount);
+    EXPECT_EQ(MAX_WAITING_RESPONSES, waitingResponseQueue.itemCount);
+    EXPECT_EQ(0, runcamDeviceSimulate5KeyOSDCableButtonSequence(camDevice, operations, 1, recordResponse));
+    EXPECT_EQ(1, testData.writeCount);
+
+    clearResponseBuff();
+}
+
+TEST(RCDeviceTest, TestResponseTimeoutAdaptsToResponseTime)
+{
+    // given
+    initReadyDevice();
+    const uint8_t operations[] = { RCDEVICE_PROTOCOL_5KEY_SIMULATION_SET };
+    camDevice->isResponseTimeMeasured = false;
+
+    // when
+    runcamDeviceSimulate5KeyOSDCableButtonSequence(camDevice, operations, ARRAYLEN(operations), recordResponse);
+
+    // then the full timeout is used until the response time is known
+    rcdeviceResponseParseContext_t *ctx = &waitingResponseQueue.buffer[waitingResponseQueue.headPos];
+    EXPECT_EQ(400u, ctx->timeoutTimestamp - ctx->startTimestamp);
+
+    // when
+    uint8_t responseData[] = { 0xCC, 0xA5, 0xCC, 0xA5 };
+    addResponseData(responseData, sizeof(responseData), true);
+    testData.indexOfCurrentRespBuf = 0;
+    testData.responseDataReadPos = 0;
+    rcdeviceReceive(millis() * 1000);
+    EXPECT_EQ(0, waitingResponseQueue.itemCount);
+    runcamDeviceSimulate5KeyOSDCableButtonSequence(camDevice, operations, ARRAYLEN(operations), recordResponse);
+
+    // then
+    EXPECT_TRUE(camDevice->isResponseTimeMeasured);
+    ctx = &waitingResponseQueue.buffer[waitingResponseQueue.headPos];
+    EXPECT_EQ((timeMs_t)RCDEVICE_MIN_RESPONSE_TIMEOUT_MS, ctx->timeoutTimestamp - ctx->startTimestamp);
+
+    clearResponseBuff();
+}
+
+TEST(RCDeviceTest, TestStickClickSentOncePerStickMovement)
+{
+    // given
+    initReadyDevice();
+    rcdeviceInMenu = true;
+    waitingDeviceResponse = false;
+    rcData[THROTTLE] = FIVE_KEY_JOYSTICK_MID;
+    rcData[ROLL] = FIVE_KEY_JOYSTICK_MID;
+    rcData[PITCH] = FIVE_KEY_JOYSTICK_MID;
+    rcData[YAW] = FIVE_KEY_JOYSTICK_MID;
+    rcdeviceUpdate(millis() * 1000);
+    testData.writeCount = 0;
+
+    // when
+    rcData[ROLL] = FIVE_KEY_JOYSTICK_MAX;
+    rcdeviceUpdate(millis() * 1000);
+    rcdeviceUpdate(millis() * 1000);
+
+    // then a single click is sent, without waiting for the responses
+    EXPECT_EQ(1, testData.writeCount);
+    EXPECT_EQ(2, waitingResponseQueue.itemCount);
+    EXPECT_FALSE(isButtonPressed);
+
+    // when
+    rcData[ROLL] = FIVE_KEY_JOYSTICK_MID;
+    rcdeviceUpdate(millis() * 1000);
+    rcData[ROLL] = FIVE_KEY_JOYSTICK_MAX;
+    rcdeviceUpdate(millis() * 1000);
+
+    // then
+    EXPECT_EQ(2, testData.writeCount);
+    EXPECT_EQ(4, waitingResponseQueue.itemCount);
+    EXPECT_TRUE(rcdeviceInMenu);
+
+    rcData[ROLL] = FIVE_KEY_JOYSTICK_MID;
+    rcdeviceUpdate(millis() * 1000);
+    rcdeviceInMenu = false;
+    clearResponseBuff();
+}
+
 extern "C" {
     serialPort_t *openSerialPort(serialPortIdentifier_e identifier, serialPortFunction_e functionMask, serialReceiveCallbackPtr callback, void *callbackData, uint32_t baudRate, portMode_e mode, portOptions_e options)
     {
@@ -951,6 +1216,10 @@ extern "C" {
     { 
         UNUSED(instance); UNUSED(data); UNUSED(count); 
 
+        testData.writeCount++;
+        testData.writtenDataLen = MIN(count, RCDEVICE_PROTOCOL_MAX_PACKET_SIZE);
+        memcpy(testData.writtenData, data, testData.writtenDataLen);
+
         // reset the input buffer
         testData.responseDataReadPos = 0;
         testData.indexOfCurrentRespBuf++;
@@ -16,6 +16,7 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 
 extern "C" {
     #include "platform.h"
@@ -63,6 +64,8 @@ extern "C" {
     void taskFiltering(timeUs_t) { simulatedTime += TEST_FILTERING_TIME; taskFilterRan = true; }
     void taskMainPidLoop(timeUs_t) { simulatedTime += TEST_PID_LOOP_TIME; taskPidRan = true; }
     void taskUpdateAccelerometer(timeUs_t) { simulatedTime += TEST_UPDATE_ACCEL_TIME; }
+    bool serialDataWaiting = false;
+    bool taskSerialCheck(timeUs_t, timeDelta_t) { return serialDataWaiting; }
     void taskHandleSerial(timeUs_t) { simulatedTime += TEST_HANDLE_SERIAL_TIME; }
     void taskUpdateBatteryVoltage(timeUs_t) { simulatedTime += TEST_UPDATE_BATTERY_TIME; }
     bool rxUpdateCheck(timeUs_t, timeDelta_t) { simulatedTime += TEST_UPDATE_RX_CHECK_TIME; return false; }
@@ -134,6 +137,7 @@ extern "C" {
         },
         [TASK_SERIAL] = {
             .taskName = "SERIAL",
+            .checkFunc = taskSerialCheck,
             .taskFunc = taskHandleSerial,
             .desiredPeriodUs = TASK_PERIOD_HZ(100),
             .staticPriority = TASK_PRIORITY_LOW,
@@ -422,6 +426,47 @@ TEST(SchedulerUnittest, TestTwoTasks)
     EXPECT_EQ(&tasks[TASK_ATTITUDE], unittest_scheduler_selectedTask);
 }
 
+TEST(SchedulerUnittest, TestEventDrivenSerialTask)
+{
+    // disable all tasks except TASK_SERIAL
+    for (int taskId = 0; taskId < TASK_COUNT; ++taskId) {
+        setTaskEnabled(static_cast<taskId_e>(taskId), false);
+    }
+    setTaskEnabled(TASK_SERIAL, true);
+
+    // given
+    simulatedTime = 100000;
+    serialDataWaiting = false;
+    tasks[TASK_SERIAL].lastExecutedAtUs = simulatedTime;
+    tasks[TASK_SERIAL].dynamicPriority = 0;
+
+    // when several task periods pass without any data arriving
+    simulatedTime += 3 * TASK_PERIOD_HZ(100);
+    scheduler();
+
+    // expect the task not to run
+    EXPECT_EQ(static_cast<task_t*>(0), unittest_scheduler_selectedTask);
+    EXPECT_EQ(0, unittest_scheduler_waitingTasks);
+
+    // when data arrives
+    simulatedTime += 100;
+    serialDataWaiting = true;
+    scheduler();
+
+    // expect the task to run straight away
+    EXPECT_EQ(&tasks[TASK_SERIAL], unittest_scheduler_selectedTask);
+    EXPECT_EQ(simulatedTime - TEST_HANDLE_SERIAL_TIME, tasks[TASK_SERIAL].lastExecutedAtUs);
+    EXPECT_EQ(0, tasks[TASK_SERIAL].dynamicPriority);
+
+    // when the data has been consumed
+    serialDataWaiting = false;
+    simulatedTime += 100;
+    scheduler();
+
+    // expect the task not to run again
+    EXPECT_EQ(static_cast<task_t*>(0), unittest_scheduler_selectedTask);
+}
+
 TEST(SchedulerUnittest, TestGyroTask)
 {
     static const uint32_t startTime = 4000;
@@ -605,3 +650,94 @@ TEST(SchedulerUnittest, TestGyroLookahead)
     // TASK_ACCEL should have run
     EXPECT_EQ(&tasks[TASK_ACCEL], unittest_scheduler_selectedTask);
 }
+
+static schedulerTimingProfile_t testTimingProfile(uint16_t gyroTimeUs, uint16_t filterTimeUs, uint16_t pidTimeUs, uint16_t otherTasksLoad)
+{
+    schedulerTimingProfile_t profile;
+    memset(&profile, 0, sizeof(profile));
+    profile.executionTimeUs[SCHEDULER_PROFILE_GYRO] = gyroTimeUs;
+    profile.executionTimeUs[SCHEDULER_PROFILE_FILTER] = filterTimeUs;
+    profile.executionTimeUs[SCHEDULER_PROFILE_PID] = pidTimeUs;
+    profile.otherTasksLoad = otherTasksLoad;
+
+    return profile;
+}
+
+TEST(SchedulerUnittest, TestSelectPidDenomSlowCpu)
+{
+    // given
+    // the realtime tasks take 86% of the CPU at 8k
+    schedulerTimingProfile_t profile = testTimingProfile(TEST_GYRO_SAMPLE_TIME, TEST_FILTERING_TIME, TEST_PID_LOOP_TIME, 1000);
+
+    // when
+    const uint8_t pidDenom = schedulerSelectPidDenom(&profile, TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ), 1, 16);
+
+    // then
+    // the PID loop runs at 4k
+    EXPECT_EQ(2, pidDenom);
+}
+
+TEST(SchedulerUnittest, TestSelectPidDenomFastCpu)
+{
+    // given
+    schedulerTimingProfile_t profile = testTimingProfile(5, 10, 15, 1000);
+
+    // when
+    const uint8_t pidDenom = schedulerSelectPidDenom(&profile, TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ), 1, 16);
+
+    // then
+    EXPECT_EQ(1, pidDenom);
+}
+
+TEST(SchedulerUnittest, TestSelectPidDenomNeverFasterThanConfigured)
+{
+    // given
+    schedulerTimingProfile_t profile = testTimingProfile(TEST_GYRO_SAMPLE_TIME, TEST_FILTERING_TIME, TEST_PID_LOOP_TIME, 1000);
+
+    // when
+    const uint8_t pidDenom = schedulerSelectPidDenom(&profile, TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ), 4, 16);
+
+    // then
+    EXPECT_EQ(4, pidDenom);
+}
+
+TEST(SchedulerUnittest, TestSelectPidDenomCappedAtMaximum)
+{
+    // given
+    schedulerTimingProfile_t profile = testTimingProfile(100, 200, 300, 1000);
+
+    // when
+    const uint8_t pidDenom = schedulerSelectPidDenom(&profile, TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ), 1, 4);
+
+    // then
+    EXPECT_EQ(4, pidDenom);
+}
+
+TEST(SchedulerUnittest, TestSelectTaskPeriod)
+{
+    // given
+    schedulerTimingProfile_t profile = testTimingProfile(TEST_GYRO_SAMPLE_TIME, TEST_FILTERING_TIME, TEST_PID_LOOP_TIME, 1000);
+    const timeDelta_t desiredPeriodUs = TASK_PERIOD_HZ(60);
+
+    // when
+    // the OSD fits into its share of the spare CPU time
+    profile.executionTimeUs[SCHEDULER_PROFILE_OSD] = 500;
+
+    // then
+    EXPECT_EQ(desiredPeriodUs, schedulerSelectTaskPeriod(&profile, TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ), 2, SCHEDULER_PROFILE_OSD, desiredPeriodUs));
+
+    // when
+    // the OSD takes longer than its share of the spare CPU time
+    profile.executionTimeUs[SCHEDULER_PROFILE_OSD] = 4000;
+
+    // then
+    // the OSD runs less often
+    EXPECT_LT(desiredPeriodUs, schedulerSelectTaskPeriod(&profile, TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ), 2, SCHEDULER_PROFILE_OSD, desiredPeriodUs));
+
+    // when
+    // the telemetry task wasn't running before the reset
+    profile.executionTimeUs[SCHEDULER_PROFILE_TELEMETRY] = 0;
+
+    // then
+    EXPECT_EQ(TASK_PERIOD_HZ(250), schedulerSelectTaskPeriod(&profile, TASK_PERIOD_HZ(TEST_GYRO_SAMPLE_HZ), 2, SCHEDULER_PROFILE_TELEMETRY, TASK_PERIOD_HZ(250)));
+}
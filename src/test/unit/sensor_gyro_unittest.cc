@@ -32,6 +32,7 @@ extern "C" {
     #include "drivers/accgyro/accgyro_fake.h"
     #include "drivers/accgyro/accgyro_mpu.h"
     #include "drivers/sensor.h"
+    #include "fc/dispatch.h"
     #include "io/beeper.h"
     #include "pg/pg.h"
     #include "pg/pg_ids.h"
@@ -48,6 +49,9 @@ extern "C" {
 
     uint8_t debugMode;
     int16_t debug[DEBUG16_VALUE_COUNT];
+
+    int dispatchAddCount = 0;
+    dispatchEntry_t *dispatchedEntry = NULL;
 }
 
 #include "unittest_macros.h"
@@ -151,6 +155,215 @@ TEST(SensorGyro, Update)
     EXPECT_NEAR(90 * gyroDevPtr->scale, gyro.gyroADC[Z], 1e-3);
 }
 
+// deterministic uniformly distributed noise
+static int16_t testNoise(int16_t amplitude)
+{
+    static uint32_t seed = 12345;
+    seed = seed * 1103515245 + 12345;
+    return (int16_t)((seed >> 16) % (2 * amplitude + 1)) - amplitude;
+}
+
+static void initCalibrationTest(void)
+{
+    pgResetAll();
+    gyroInit();
+    gyroSetTargetLooptime(1);
+}
+
+// feeds samples around the given bias until the calibration ends, returns the number of samples used
+static int calibrateWithNoise(int16_t noise, int bumpStart, int bumpLength)
+{
+    static const int gyroMovementCalibrationThreshold = 48;
+    gyroStartCalibration(false);
+    int cycles = 0;
+    while (!gyroIsCalibrationComplete() && cycles < 100000) {
+        const int16_t bump = (cycles >= bumpStart && cycles < bumpStart + bumpLength) ? 400 : 0;
+        gyroDevPtr->gyroADCRaw[X] = 5 + bump + testNoise(noise);
+        gyroDevPtr->gyroADCRaw[Y] = 6 + testNoise(noise);
+        gyroDevPtr->gyroADCRaw[Z] = 7 + testNoise(noise);
+        performGyroCalibration(gyroSensorPtr, gyroMovementCalibrationThreshold);
+        cycles++;
+    }
+    return cycles;
+}
+
+TEST(SensorGyro, CalibrationEndsWhenBiasIsKnown)
+{
+    // given
+    initCalibrationTest();
+    const int maxCycles = gyroConfig()->gyroCalibrationDuration * 10000 / gyro.sampleLooptime;
+
+    // when
+    const int cycles = calibrateWithNoise(8, -1, 0);
+
+    // then
+    EXPECT_LT(cycles, maxCycles / 2);
+    EXPECT_NEAR(5, gyroDevPtr->gyroZero[X], 0.5);
+    EXPECT_NEAR(6, gyroDevPtr->gyroZero[Y], 0.5);
+    EXPECT_NEAR(7, gyroDevPtr->gyroZero[Z], 0.5);
+}
+
+TEST(SensorGyro, NoisyCalibrationTakesLonger)
+{
+    // given
+    initCalibrationTest();
+    const int quietCycles = calibrateWithNoise(2, -1, 0);
+    initCalibrationTest();
+
+    // when
+    const int noisyCycles = calibrateWithNoise(32, -1, 0);
+
+    // then
+    EXPECT_GT(noisyCycles, quietCycles);
+    EXPECT_NEAR(5, gyroDevPtr->gyroZero[X], 0.5);
+    EXPECT_NEAR(6, gyroDevPtr->gyroZero[Y], 0.5);
+    EXPECT_NEAR(7, gyroDevPtr->gyroZero[Z], 0.5);
+}
+
+TEST(SensorGyro, BumpedCalibrationRestartsEarly)
+{
+    // given
+    initCalibrationTest();
+    const int maxCycles = gyroConfig()->gyroCalibrationDuration * 10000 / gyro.sampleLooptime;
+    const int bumpStart = 100;
+
+    // when
+    const int cycles = calibrateWithNoise(8, bumpStart, 200);
+
+    // then
+    // the bump is detected without waiting for the full calibration duration
+    EXPECT_LT(cycles, maxCycles);
+    EXPECT_NEAR(5, gyroDevPtr->gyroZero[X], 0.5);
+    EXPECT_NEAR(6, gyroDevPtr->gyroZero[Y], 0.5);
+    EXPECT_NEAR(7, gyroDevPtr->gyroZero[Z], 0.5);
+}
+
+TEST(SensorGyro, CalibrationStartsFromBiasModel)
+{
+    // given
+    initCalibrationTest();
+    const int firstCycles = calibrateWithNoise(32, -1, 0);
+    const gyroBiasModel_t *model = gyroBiasModel(0);
+    EXPECT_NE(0, model->validBins);
+
+    // when
+    const int secondCycles = calibrateWithNoise(32, -1, 0);
+
+    // then
+    EXPECT_LT(secondCycles, firstCycles);
+    EXPECT_NEAR(5, gyroDevPtr->gyroZero[X], 0.5);
+    EXPECT_NEAR(6, gyroDevPtr->gyroZero[Y], 0.5);
+    EXPECT_NEAR(7, gyroDevPtr->gyroZero[Z], 0.5);
+}
+
+TEST(SensorGyro, StaleBiasModelIgnored)
+{
+    // given
+    initCalibrationTest();
+    gyroBiasModel_t *model = gyroBiasModelMutable(0);
+    for (int bin = 0; bin < GYRO_BIAS_MODEL_TEMPERATURE_BIN_COUNT; bin++) {
+        model->bias[bin][X] = 40 * 16;
+        model->bias[bin][Y] = -40 * 16;
+        model->bias[bin][Z] = 0;
+    }
+    model->validBins = 0xff;
+
+    // when
+    calibrateWithNoise(8, -1, 0);
+
+    // then
+    EXPECT_NEAR(5, gyroDevPtr->gyroZero[X], 0.5);
+    EXPECT_NEAR(6, gyroDevPtr->gyroZero[Y], 0.5);
+    EXPECT_NEAR(7, gyroDevPtr->gyroZero[Z], 0.5);
+}
+
+TEST(SensorGyro, BiasRefinedWhileDisarmedAndStill)
+{
+    // given
+    pgResetAll();
+    gyroConfigMutable()->gyro_lowpass_hz = 0;
+    gyroConfigMutable()->gyro_lowpass2_hz = 0;
+    gyroInit();
+    gyroSetTargetLooptime(1);
+    gyroDevPtr->readFn = fakeGyroRead;
+    gyroStartCalibration(false);
+    while (!gyroIsCalibrationComplete()) {
+        fakeGyroSet(gyroDevPtr, 5, 6, 7);
+        gyroUpdate();
+    }
+    EXPECT_FLOAT_EQ(5, gyroDevPtr->gyroZero[X]);
+    timeUs_t currentTimeUs = 0;
+
+    // when
+    // the bias drifts while the craft is on the ground, the refinement sees every 8th sample
+    for (int i = 0; i < 100000; i++) {
+        fakeGyroSet(gyroDevPtr, 9, 6, 7);
+        gyroUpdate();
+        if (i % 8 == 0) {
+            currentTimeUs += 1000;
+            gyroUpdateBiasRefinement(currentTimeUs);
+        }
+    }
+
+    // then
+    EXPECT_NEAR(9, gyroDevPtr->gyroZero[X], 0.5);
+    EXPECT_FLOAT_EQ(6, gyroDevPtr->gyroZero[Y]);
+    EXPECT_FLOAT_EQ(7, gyroDevPtr->gyroZero[Z]);
+
+    // when
+    // the craft is moving
+    for (int i = 0; i < 100000; i++) {
+        fakeGyroSet(gyroDevPtr, 200 + i % 100, 6, 7);
+        gyroUpdate();
+        if (i % 8 == 0) {
+            currentTimeUs += 1000;
+            gyroUpdateBiasRefinement(currentTimeUs);
+        }
+    }
+
+    // then
+    EXPECT_NEAR(9, gyroDevPtr->gyroZero[X], 0.5);
+}
+
+TEST(SensorGyro, BiasModelNotSavedByDefault)
+{
+    // given
+    initCalibrationTest();
+    calibrateWithNoise(8, -1, 0);
+    dispatchAddCount = 0;
+
+    // when
+    gyroBiasModelOnDisarm();
+
+    // then
+    EXPECT_EQ(0, dispatchAddCount);
+}
+
+TEST(SensorGyro, BiasModelSavedOnDisarmOncePerPowerCycle)
+{
+    // given
+    initCalibrationTest();
+    gyroConfigMutable()->gyro_bias_save = true;
+    calibrateWithNoise(8, -1, 0);
+    dispatchAddCount = 0;
+
+    // when
+    gyroBiasModelOnDisarm();
+
+    // then
+    EXPECT_EQ(1, dispatchAddCount);
+
+    // when
+    // the save is done, then the model changes again
+    dispatchedEntry->dispatch(dispatchedEntry);
+    gyroBiasModelMutable(0)->validBins = 0;
+    calibrateWithNoise(8, -1, 0);
+    gyroBiasModelOnDisarm();
+
+    // then
+    EXPECT_EQ(1, dispatchAddCount);
+}
+
 // STUBS
 
 extern "C" {
@@ -163,4 +376,7 @@ void sensorsSet(uint32_t) {}
 void schedulerResetTaskStatistics(taskId_e) {}
 int getArmingDisableFlags(void) {return 0;}
 void writeEEPROM(void) {}
+uint8_t armingFlags = 0;
+bool isConfigDirty(void) {return false;}
+void dispatchAdd(dispatchEntry_t *entry, int) {dispatchAddCount++; dispatchedEntry = entry;}
 }
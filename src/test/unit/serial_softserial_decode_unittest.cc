@@ -0,0 +1,173 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/serial_softserial_decode.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define BIT_PERIOD 1458 // 168MHz cycles at 115200 baud
+
+typedef struct edge_s {
+    uint32_t at;
+    bool level;
+} edge_t;
+
+// Builds the line transitions of 8N1 frames sent back to back, optionally with a
+// different bit period than the receiver's and a repeating jitter on each edge
+static std::vector<edge_t> edgesForBytes(const std::vector<uint8_t> &bytes, uint32_t startAt, uint32_t bitPeriod, int jitter = 0)
+{
+    std::vector<edge_t> edges;
+    bool level = true;
+    int bitCount = 0;
+
+    for (uint8_t byte : bytes) {
+        const uint16_t frame = (1 << 9) | (byte << 1);
+        for (int bit = 0; bit < 10; bit++, bitCount++) {
+            const bool bitLevel = frame & (1 << bit);
+            if (bitLevel != level) {
+                const int offset = (edges.size() % 2) ? jitter : -jitter;
+                edges.push_back({ startAt + bitCount * bitPeriod + offset, bitLevel });
+                level = bitLevel;
+            }
+        }
+    }
+    return edges;
+}
+
+static std::vector<int> decode(softSerialDecoder_t *decoder, const std::vector<edge_t> &edges, uint32_t idleAt)
+{
+    std::vector<int> results;
+
+    for (const edge_t &edge : edges) {
+        const int result = softSerialDecodeEdge(decoder, edge.at, edge.level);
+        if (result != SOFTSERIAL_DECODE_NONE) {
+            results.push_back(result);
+        }
+    }
+    const int result = softSerialDecodeIdle(decoder, idleAt);
+    if (result != SOFTSERIAL_DECODE_NONE) {
+        results.push_back(result);
+    }
+    return results;
+}
+
+TEST(SoftSerialDecodeUnittest, DecodesBackToBackBytes)
+{
+    // given
+    const std::vector<uint8_t> bytes = { 0x55, 0x00, 0xFF, 0xA5, 0x80, 0x01, 0x7E };
+    softSerialDecoder_t decoder;
+    softSerialDecoderInit(&decoder, BIT_PERIOD);
+
+    // when
+    const std::vector<int> results = decode(&decoder, edgesForBytes(bytes, 1000, BIT_PERIOD), 1000 + 80 * BIT_PERIOD);
+
+    // expect
+    EXPECT_EQ(std::vector<int>(bytes.begin(), bytes.end()), results);
+}
+
+TEST(SoftSerialDecodeUnittest, CompletesTrailingHighBitsWhenIdle)
+{
+    // given a byte whose last edge is in the middle of the frame
+    softSerialDecoder_t decoder;
+    softSerialDecoderInit(&decoder, BIT_PERIOD);
+    const std::vector<edge_t> edges = edgesForBytes({ 0x0F }, 1000, BIT_PERIOD);
+
+    // when the stop bit has not been reached yet
+    for (const edge_t &edge : edges) {
+        EXPECT_EQ(SOFTSERIAL_DECODE_NONE, softSerialDecodeEdge(&decoder, edge.at, edge.level));
+    }
+
+    // expect no byte
+    EXPECT_EQ(SOFTSERIAL_DECODE_NONE, softSerialDecodeIdle(&decoder, 1000 + 9 * BIT_PERIOD));
+
+    // when the centre of the stop bit has passed
+    // expect the byte, once
+    EXPECT_EQ(0x0F, softSerialDecodeIdle(&decoder, 1000 + 10 * BIT_PERIOD));
+    EXPECT_EQ(SOFTSERIAL_DECODE_NONE, softSerialDecodeIdle(&decoder, 1000 + 20 * BIT_PERIOD));
+}
+
+TEST(SoftSerialDecodeUnittest, ToleratesBaudMismatchAndJitter)
+{
+    // given a sender 3% slow with edges a tenth of a bit early and late
+    const std::vector<uint8_t> bytes = { 0x55, 0xAA, 0x01, 0x80, 0x7E, 0x33 };
+    softSerialDecoder_t decoder;
+    softSerialDecoderInit(&decoder, BIT_PERIOD);
+
+    // when
+    const std::vector<int> results = decode(&decoder, edgesForBytes(bytes, 1000, BIT_PERIOD * 103 / 100, BIT_PERIOD / 10), 1000 + 80 * BIT_PERIOD);
+
+    // expect
+    EXPECT_EQ(std::vector<int>(bytes.begin(), bytes.end()), results);
+}
+
+TEST(SoftSerialDecodeUnittest, ReportsMissingStopBit)
+{
+    // given a break, the line held low for longer than a frame
+    softSerialDecoder_t decoder;
+    softSerialDecoderInit(&decoder, BIT_PERIOD);
+    const std::vector<edge_t> edges = { { 1000, false }, { 1000 + 12 * BIT_PERIOD, true } };
+
+    // when
+    const std::vector<int> results = decode(&decoder, edges, 1000 + 30 * BIT_PERIOD);
+
+    // expect
+    EXPECT_EQ(std::vector<int>({ SOFTSERIAL_DECODE_ERROR }), results);
+}
+
+TEST(SoftSerialDecodeUnittest, RejectsGlitchAndResynchronises)
+{
+    // given a pulse shorter than half a bit ahead of a byte
+    softSerialDecoder_t decoder;
+    softSerialDecoderInit(&decoder, BIT_PERIOD);
+    std::vector<edge_t> edges = { { 1000, false }, { 1000 + BIT_PERIOD / 4, true } };
+    const std::vector<edge_t> byteEdges = edgesForBytes({ 0xC3 }, 1000 + 3 * BIT_PERIOD, BIT_PERIOD);
+    edges.insert(edges.end(), byteEdges.begin(), byteEdges.end());
+
+    // when
+    const std::vector<int> results = decode(&decoder, edges, 1000 + 20 * BIT_PERIOD);
+
+    // expect
+    EXPECT_EQ(std::vector<int>({ SOFTSERIAL_DECODE_ERROR, 0xC3 }), results);
+}
+
+TEST(SoftSerialDecodeUnittest, HandlesTimestampWrap)
+{
+    // given a frame that starts just before the time stamps wrap
+    const std::vector<uint8_t> bytes = { 0x96, 0x69 };
+    const uint32_t startAt = UINT32_MAX - 3 * BIT_PERIOD;
+    softSerialDecoder_t decoder;
+    softSerialDecoderInit(&decoder, BIT_PERIOD);
+
+    // when
+    const std::vector<int> results = decode(&decoder, edgesForBytes(bytes, startAt, BIT_PERIOD), startAt + 30 * BIT_PERIOD);
+
+    // expect
+    EXPECT_EQ(std::vector<int>(bytes.begin(), bytes.end()), results);
+}
@@ -0,0 +1,352 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <cmath>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/axis.h"
+    #include "common/filter.h"
+    #include "common/maths.h"
+
+    #include "drivers/dshot.h"
+
+    #include "fc/runtime_config.h"
+
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+    #include "flight/smith_predictor.h"
+
+    #include "pg/motor.h"
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    #include "sensors/gyro.h"
+
+    PG_REGISTER(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 0);
+    PG_REGISTER(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 0);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define LOOPTIME_US 125
+#define DT (LOOPTIME_US * 1e-6f)
+#define MOTOR_COUNT 4
+#define MAX_GYRO_DELAY_SAMPLES 128
+
+static const motorMixer_t quadXMix[MOTOR_COUNT] = {
+    { 1.0f, -1.0f,  1.0f, -1.0f },
+    { 1.0f, -1.0f, -1.0f,  1.0f },
+    { 1.0f,  1.0f,  1.0f,  1.0f },
+    { 1.0f,  1.0f, -1.0f, -1.0f },
+};
+
+static uint16_t erpm[MOTOR_COUNT];
+
+// A quad whose motors spin up and down as first order lags, whose body rate is
+// the integral of the motor torque and whose gyro is delayed by the filters.
+class QuadPlant {
+public:
+    QuadPlant(float spinUpTau, float spinDownTau, float axisGain, int gyroDelaySamples)
+        : spinUpTau(spinUpTau), spinDownTau(spinDownTau), axisGain(axisGain), gyroDelaySamples(gyroDelaySamples)
+    {
+        memset(motorOutput, 0, sizeof(motorOutput));
+        memset(rate, 0, sizeof(rate));
+        memset(rateHistory, 0, sizeof(rateHistory));
+        historyIndex = 0;
+    }
+
+    void step(void)
+    {
+        float torque[XYZ_AXIS_COUNT] = { 0 };
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            const float command = (motor[i] - motorOutputLow) / (motorOutputHigh - motorOutputLow);
+            const float tau = command > motorOutput[i] ? spinUpTau : spinDownTau;
+            motorOutput[i] += DT / (tau + DT) * (command - motorOutput[i]);
+            torque[FD_ROLL] += quadXMix[i].roll * motorOutput[i];
+            torque[FD_PITCH] += quadXMix[i].pitch * motorOutput[i];
+            torque[FD_YAW] += quadXMix[i].yaw * motorOutput[i];
+            // 20000 eRPM at full output, reported in steps of 100 eRPM
+            erpm[i] = lrintf(20 + 180 * motorOutput[i]);
+        }
+
+        historyIndex = (historyIndex + 1) % MAX_GYRO_DELAY_SAMPLES;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            rate[axis] += axisGain * torque[axis] * DT;
+            rateHistory[historyIndex][axis] = rate[axis];
+            const int delayedIndex = (historyIndex - gyroDelaySamples + MAX_GYRO_DELAY_SAMPLES) % MAX_GYRO_DELAY_SAMPLES;
+            gyro.gyroADCf[axis] = rateHistory[delayedIndex][axis];
+        }
+    }
+
+    float rate[XYZ_AXIS_COUNT];
+
+private:
+    float spinUpTau;
+    float spinDownTau;
+    float axisGain;
+    int gyroDelaySamples;
+    float motorOutput[MOTOR_COUNT];
+    float rateHistory[MAX_GYRO_DELAY_SAMPLES][XYZ_AXIS_COUNT];
+    int historyIndex;
+};
+
+static void setMotorOutputs(const float pidSum[XYZ_AXIS_COUNT])
+{
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        const float output = 0.5f + quadXMix[i].roll * pidSum[FD_ROLL] + quadXMix[i].pitch * pidSum[FD_PITCH] + quadXMix[i].yaw * pidSum[FD_YAW];
+        motor[i] = motorOutputLow + constrainf(output, 0.0f, 1.0f) * (motorOutputHigh - motorOutputLow);
+    }
+}
+
+static pidProfile_t profile;
+
+static void initPredictor(uint8_t strength, uint8_t delay, bool useDshotTelemetry)
+{
+    memset(&profile, 0, sizeof(profile));
+    profile.smith_predictor_strength = strength;
+    profile.smith_predictor_delay = delay;
+    profile.smith_predictor_motor_tau = 20;
+    motorConfigMutable()->dev.useDshotTelemetry = useDshotTelemetry;
+    gyro.targetLooptime = LOOPTIME_US;
+    memset(gyro.gyroADCf, 0, sizeof(gyro.gyroADCf));
+    motorOutputLow = 48;
+    motorOutputHigh = 2047;
+    float pidSum[XYZ_AXIS_COUNT] = { 0 };
+    setMotorOutputs(pidSum);
+
+    smithPredictorInit(&profile);
+    smithPredictorResetModel();
+    ENABLE_ARMING_FLAG(ARMED);
+}
+
+TEST(SmithPredictorUnittest, LowpassDelay)
+{
+    EXPECT_FLOAT_EQ(1.0f / (2 * M_PIf * 100), smithPredictorLowpassDelay(FILTER_PT1, 100, 4000));
+    EXPECT_FLOAT_EQ(1.41421356f / (2 * M_PIf * 100), smithPredictorLowpassDelay(FILTER_BIQUAD, 100, 4000));
+    EXPECT_EQ(0.0f, smithPredictorLowpassDelay(FILTER_PT1, 0, 4000));
+    // filters above nyquist are not initialised
+    EXPECT_EQ(0.0f, smithPredictorLowpassDelay(FILTER_PT1, 5000, 4000));
+}
+
+TEST(SmithPredictorUnittest, DelaySamples)
+{
+    // 2ms of gyro filter delay and a 100Hz PT1 on D
+    gyroConfigMutable()->gyro_lowpass_hz = 0;
+    gyroConfigMutable()->gyro_lowpass2_hz = 0;
+    initPredictor(100, 20, false);
+    EXPECT_EQ(16, smithPredictorGetDelaySamples(false));
+    EXPECT_EQ(16, smithPredictorGetDelaySamples(true));
+
+    profile.dterm_lowpass_hz = 100;
+    profile.dterm_filter_type = FILTER_PT1;
+    smithPredictorInit(&profile);
+    EXPECT_EQ(16, smithPredictorGetDelaySamples(false));
+    EXPECT_EQ(16 + 13, smithPredictorGetDelaySamples(true));
+
+    // estimated from the gyro lowpass filters
+    profile.smith_predictor_delay = 0;
+    gyroConfigMutable()->gyro_lowpass_type = FILTER_PT1;
+    gyroConfigMutable()->gyro_lowpass_hz = 200;
+    gyroConfigMutable()->gyro_lowpass2_type = FILTER_BIQUAD;
+    gyroConfigMutable()->gyro_lowpass2_hz = 250;
+    smithPredictorInit(&profile);
+    EXPECT_EQ(14, smithPredictorGetDelaySamples(false));
+
+    // the longest delay of the setting fits at 8kHz
+    profile.smith_predictor_delay = 100;
+    smithPredictorInit(&profile);
+    EXPECT_EQ(80, smithPredictorGetDelaySamples(false));
+    EXPECT_EQ(80 + 13, smithPredictorGetDelaySamples(true));
+
+    // limited to the length of the torque history
+    profile.dterm_lowpass_hz = 10;
+    smithPredictorInit(&profile);
+    EXPECT_EQ(80, smithPredictorGetDelaySamples(false));
+    EXPECT_EQ(SMITH_PREDICTOR_MAX_DELAY_SAMPLES, smithPredictorGetDelaySamples(true));
+
+    gyroConfigMutable()->gyro_lowpass_hz = 0;
+    gyroConfigMutable()->gyro_lowpass2_hz = 0;
+}
+
+// square wave roll and pitch commands that move the motors in both directions
+static void runOpenLoop(QuadPlant *plant, int loops)
+{
+    for (int i = 0; i < loops; i++) {
+        const float phase = (i % 800) < 400 ? 1.0f : -1.0f;
+        const float pidSum[XYZ_AXIS_COUNT] = { 0.1f * phase, (i % 1200) < 600 ? 0.05f : -0.05f, 0 };
+        setMotorOutputs(pidSum);
+        plant->step();
+        smithPredictorUpdate();
+    }
+}
+
+TEST(SmithPredictorUnittest, IdentifiesMotorTimeConstantsFromRpm)
+{
+    initPredictor(100, 20, true);
+    QuadPlant plant(0.015f, 0.035f, 20000, 16);
+
+    runOpenLoop(&plant, 5 * 8000);
+
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        EXPECT_NEAR(0.015f, smithPredictorGetMotorTimeConstant(i, true), 0.003f);
+        EXPECT_NEAR(0.035f, smithPredictorGetMotorTimeConstant(i, false), 0.007f);
+    }
+}
+
+TEST(SmithPredictorUnittest, KeepsDefaultTimeConstantsWithoutTelemetry)
+{
+    initPredictor(100, 20, false);
+    QuadPlant plant(0.015f, 0.035f, 20000, 16);
+
+    runOpenLoop(&plant, 8000);
+
+    EXPECT_FLOAT_EQ(0.02f, smithPredictorGetMotorTimeConstant(0, true));
+    EXPECT_FLOAT_EQ(0.02f, smithPredictorGetMotorTimeConstant(0, false));
+}
+
+TEST(SmithPredictorUnittest, IdentifiesAxisGain)
+{
+    initPredictor(100, 20, true);
+    QuadPlant plant(0.015f, 0.035f, 20000, 16);
+
+    runOpenLoop(&plant, 5 * 8000);
+
+    EXPECT_NEAR(20000, smithPredictorGetAxisGain(FD_ROLL), 2000);
+    EXPECT_NEAR(20000, smithPredictorGetAxisGain(FD_PITCH), 2000);
+    // the yaw torque comes from the motors spinning down slower than up
+    EXPECT_NEAR(20000, smithPredictorGetAxisGain(FD_YAW), 4000);
+}
+
+TEST(SmithPredictorUnittest, PredictsRateChangeOverDelay)
+{
+    initPredictor(100, 20, true);
+    QuadPlant plant(0.015f, 0.035f, 20000, 16);
+    runOpenLoop(&plant, 5 * 8000);
+
+    // the predicted gyro follows the rate the plant has now
+    float error = 0.0f;
+    float delayError = 0.0f;
+    for (int i = 0; i < 8000; i++) {
+        const float pidSum[XYZ_AXIS_COUNT] = { 0.1f * sin_approx(i * 2 * M_PIf / 400), 0, 0 };
+        setMotorOutputs(pidSum);
+        plant.step();
+        smithPredictorUpdate();
+        error += sq(gyro.gyroADCf[FD_ROLL] + smithPredictorPtermCorrection(FD_ROLL) - plant.rate[FD_ROLL]);
+        delayError += sq(gyro.gyroADCf[FD_ROLL] - plant.rate[FD_ROLL]);
+    }
+    EXPECT_LT(error, 0.05f * delayError);
+}
+
+TEST(SmithPredictorUnittest, NoCorrectionWhenOffOrDisarmed)
+{
+    initPredictor(0, 20, true);
+    QuadPlant plant(0.015f, 0.035f, 20000, 16);
+    runOpenLoop(&plant, 8000);
+    EXPECT_EQ(0.0f, smithPredictorPtermCorrection(FD_ROLL));
+    EXPECT_EQ(0.0f, smithPredictorDtermCorrection(FD_ROLL));
+
+    initPredictor(100, 20, true);
+    runOpenLoop(&plant, 8000);
+    EXPECT_NE(0.0f, smithPredictorPtermCorrection(FD_ROLL));
+    const float gain = smithPredictorGetAxisGain(FD_ROLL);
+
+    DISABLE_ARMING_FLAG(ARMED);
+    runOpenLoop(&plant, 1);
+    EXPECT_EQ(0.0f, smithPredictorPtermCorrection(FD_ROLL));
+    EXPECT_EQ(0.0f, smithPredictorDtermCorrection(FD_ROLL));
+    // the identified model is kept for the next flight
+    EXPECT_EQ(gain, smithPredictorGetAxisGain(FD_ROLL));
+}
+
+// A rate controller with P on the error and D on the measurement like pidController(),
+// tracking roll steps. Returns the mean squared tracking error once the steps of the
+// last second have settled, the gains are too high for the delay without the predictor.
+static float runClosedLoop(uint8_t strength, int gyroDelaySamples)
+{
+    initPredictor(strength, gyroDelaySamples * 10 / 8, true);
+    QuadPlant plant(0.015f, 0.035f, 20000, gyroDelaySamples);
+
+    const float kp = 0.002f;
+    const float kd = 0.000002f;
+    const int loops = 6 * 8000;
+    float previousGyroRateDterm = 0.0f;
+    float error = 0.0f;
+    for (int i = 0; i < loops; i++) {
+        const float setpoint = (i % 4000) < 2000 ? 200.0f : -200.0f;
+        plant.step();
+        smithPredictorUpdate();
+
+        const float gyroRate = gyro.gyroADCf[FD_ROLL];
+        const float gyroRateDterm = gyroRate + smithPredictorDtermCorrection(FD_ROLL);
+        const float pidSum[XYZ_AXIS_COUNT] = {
+            kp * (setpoint - gyroRate - smithPredictorPtermCorrection(FD_ROLL)) - kd * (gyroRateDterm - previousGyroRateDterm) / DT,
+            0,
+            0
+        };
+        previousGyroRateDterm = gyroRateDterm;
+        setMotorOutputs(pidSum);
+
+        // after the step response has settled
+        if (i >= loops - 8000 && (i % 2000) >= 800) {
+            error += sq(setpoint - plant.rate[FD_ROLL]) / (4 * 1200);
+        }
+    }
+    return error;
+}
+
+TEST(SmithPredictorUnittest, ClosedLoopWithFilterDelay)
+{
+    for (int gyroDelaySamples = 8; gyroDelaySamples <= 32; gyroDelaySamples *= 2) {
+        const float uncompensatedError = runClosedLoop(0, gyroDelaySamples);
+        const float compensatedError = runClosedLoop(100, gyroDelaySamples);
+        EXPECT_LT(compensatedError, 0.7f * uncompensatedError) << gyroDelaySamples << " samples of delay";
+        // the delay is compensated, the error no longer depends on it
+        EXPECT_LT(compensatedError, 100.0f) << gyroDelaySamples << " samples of delay";
+    }
+}
+
+// STUBS
+
+extern "C" {
+
+int16_t debug[DEBUG16_VALUE_COUNT];
+uint8_t debugMode;
+uint8_t armingFlags;
+
+gyro_t gyro;
+
+float motor[MAX_SUPPORTED_MOTORS];
+float motorOutputHigh, motorOutputLow;
+
+float pidGetDT(void) { return DT; }
+uint8_t getMotorCount(void) { return MOTOR_COUNT; }
+const motorMixer_t *mixerGetMotorMix(void) { return quadXMix; }
+bool isDshotMotorTelemetryActive(uint8_t) { return true; }
+uint16_t getDshotTelemetry(uint8_t index) { return erpm[index]; }
+
+}
@@ -70,6 +70,13 @@
 
 #define TARGET_BOARD_IDENTIFIER "TEST"
 
+#ifdef CONFIG_IN_RAM
+#define EEPROM_SIZE     4096
+extern uint8_t eepromData[EEPROM_SIZE];
+#define __config_start (*eepromData)
+#define __config_end (*ARRAYEND(eepromData))
+#endif
+
 #define DEFAULT_BLACKBOX_DEVICE     BLACKBOX_DEVICE_SERIAL
 
 #define LED_STRIP_TIMER 1
@@ -69,6 +69,7 @@ extern "C" {
     uint8_t sbufReadU8(sbuf_t *src);
     int sbufBytesRemaining(sbuf_t *buf);
     void initSharedMsp();
+    bool handleCrsfMspFrameBuffer(uint8_t payloadSize, mspResponseFnPtr responseFn);
     uint16_t testBatteryVoltage = 0;
 
     int32_t testAmperage = 0;
@@ -247,6 +248,363 @@ TEST(CrossFireMSPTest, SendMspReply) {
     EXPECT_EQ(0x71, sbufReadU8(&payloadOutputBuf)); // CRC
 }
 
+#define MSP_V2_TEST_ECHO 0x3001
+#define MSP_V2_TEST_FAIL 0x3002
+
+#define MSP_V2_HEADER(start, seq) ((2 << 5) | ((start) ? (1 << 4) : 0) | ((seq) & 0x0F))
+
+typedef struct mspV2TestChunk_s {
+    uint8_t length;
+    uint8_t bytes[CRSF_FRAME_TX_MSP_FRAME_SIZE];
+} mspV2TestChunk_t;
+
+typedef struct mspV2TestResponse_s {
+    uint8_t id;
+    uint8_t flags;
+    uint16_t cmd;
+    uint16_t size;
+    uint8_t payload[128];
+    bool crcOk;
+} mspV2TestResponse_t;
+
+static uint8_t mspV2ReplyChunks[16][CRSF_FRAME_TX_MSP_FRAME_SIZE];
+static int mspV2ReplyChunkCount;
+
+static void testCaptureMspV2Response(uint8_t *payload)
+{
+    memcpy(mspV2ReplyChunks[mspV2ReplyChunkCount++], payload, CRSF_FRAME_TX_MSP_FRAME_SIZE);
+}
+
+// splits an MSPv2 tunnel request into chunks of chunkSize bytes
+static int buildMspV2Request(mspV2TestChunk_t *chunks, uint8_t chunkSize, uint8_t id, uint16_t cmd, const uint8_t *payload, uint16_t size)
+{
+    uint8_t stream[5 + 128 + 1];
+    int streamLength = 0;
+    stream[streamLength++] = 0;
+    stream[streamLength++] = cmd & 0xff;
+    stream[streamLength++] = cmd >> 8;
+    stream[streamLength++] = size & 0xff;
+    stream[streamLength++] = size >> 8;
+    memcpy(&stream[streamLength], payload, size);
+    streamLength += size;
+    uint8_t crc = 0;
+    for (int i = 0; i < streamLength; i++) {
+        crc = crc8_dvb_s2(crc, stream[i]);
+    }
+    stream[streamLength++] = crc;
+
+    int chunkCount = 0;
+    for (int pos = 0; pos < streamLength; chunkCount++) {
+        mspV2TestChunk_t *chunk = &chunks[chunkCount];
+        memset(chunk, 0, sizeof(*chunk));
+        chunk->length = chunkSize;
+        chunk->bytes[0] = MSP_V2_HEADER(chunkCount == 0, chunkCount);
+        chunk->bytes[1] = id;
+        for (int i = 2; i < chunkSize && pos < streamLength; i++) {
+            chunk->bytes[i] = stream[pos++];
+        }
+    }
+
+    return chunkCount;
+}
+
+// reassembles the responses from the captured chunks, in the order they were completed
+static int parseMspV2Responses(mspV2TestResponse_t *responses)
+{
+    int responseCount = 0;
+    mspV2TestResponse_t *response = NULL;
+    int streamPosition = 0;
+    uint8_t crc = 0;
+    uint8_t seq = 0;
+
+    for (int c = 0; c < mspV2ReplyChunkCount; c++) {
+        const uint8_t *chunk = mspV2ReplyChunks[c];
+        EXPECT_EQ(2, chunk[0] >> 5);
+        if (chunk[0] & (1 << 4)) {
+            EXPECT_EQ(NULL, response); // previous response must be complete
+            response = &responses[responseCount++];
+            memset(response, 0, sizeof(*response));
+            response->id = chunk[1];
+            streamPosition = 0;
+            crc = 0;
+            seq = chunk[0] & 0x0F;
+        } else {
+            EXPECT_TRUE(response != NULL);
+            if (!response) {
+                return responseCount;
+            }
+            EXPECT_EQ(response->id, chunk[1]);
+            EXPECT_EQ((seq + 1) & 0x0F, chunk[0] & 0x0F);
+            seq = chunk[0] & 0x0F;
+        }
+
+        for (int i = 2; i < CRSF_FRAME_TX_MSP_FRAME_SIZE && response; i++) {
+            const uint8_t b = chunk[i];
+            if (streamPosition < 5) {
+                switch (streamPosition) {
+                case 0: response->flags = b; break;
+                case 1: response->cmd = b; break;
+                case 2: response->cmd |= b << 8; break;
+                case 3: response->size = b; break;
+                case 4: response->size |= b << 8; break;
+                }
+            } else if (streamPosition < 5 + response->size) {
+                response->payload[streamPosition - 5] = b;
+            } else {
+                response->crcOk = (b == crc);
+                response = NULL;
+                break;
+            }
+            crc = crc8_dvb_s2(crc, b);
+            streamPosition++;
+        }
+    }
+
+    return responseCount;
+}
+
+static void drainMspV2Responses(void)
+{
+    mspV2ReplyChunkCount = 0;
+    while (sendMspReply(CRSF_FRAME_TX_MSP_FRAME_SIZE, &testCaptureMspV2Response) && mspV2ReplyChunkCount < 16);
+}
+
+TEST(CrossFireMSPTest, V2SingleChunkRequest)
+{
+    // given
+    const uint8_t payload[] = { 0x11, 0x22, 0x33 };
+    mspV2TestChunk_t chunks[4];
+    const int chunkCount = buildMspV2Request(chunks, CRSF_FRAME_TX_MSP_FRAME_SIZE, 7, MSP_V2_TEST_ECHO, payload, sizeof(payload));
+    EXPECT_EQ(1, chunkCount);
+
+    // when
+    const bool pending = handleMspFrame(chunks[0].bytes, chunks[0].length, NULL);
+
+    // then
+    EXPECT_TRUE(pending);
+
+    // when
+    drainMspV2Responses();
+
+    // then
+    EXPECT_EQ(1, mspV2ReplyChunkCount);
+    mspV2TestResponse_t responses[4];
+    EXPECT_EQ(1, parseMspV2Responses(responses));
+    EXPECT_EQ(7, responses[0].id);
+    EXPECT_EQ(0, responses[0].flags);
+    EXPECT_EQ(MSP_V2_TEST_ECHO, responses[0].cmd);
+    EXPECT_EQ(sizeof(payload), responses[0].size);
+    EXPECT_EQ(0, memcmp(payload, responses[0].payload, sizeof(payload)));
+    EXPECT_TRUE(responses[0].crcOk);
+    EXPECT_FALSE(sendMspReply(CRSF_FRAME_TX_MSP_FRAME_SIZE, &testCaptureMspV2Response));
+}
+
+TEST(CrossFireMSPTest, V2InterleavedRequests)
+{
+    // given
+    uint8_t payloadA[20];
+    uint8_t payloadB[10];
+    for (unsigned i = 0; i < sizeof(payloadA); i++) {
+        payloadA[i] = i;
+    }
+    for (unsigned i = 0; i < sizeof(payloadB); i++) {
+        payloadB[i] = 0xA0 + i;
+    }
+    mspV2TestChunk_t chunksA[8];
+    mspV2TestChunk_t chunksB[8];
+    const int chunkCountA = buildMspV2Request(chunksA, CRSF_FRAME_RX_MSP_FRAME_SIZE, 1, MSP_V2_TEST_ECHO, payloadA, sizeof(payloadA));
+    const int chunkCountB = buildMspV2Request(chunksB, CRSF_FRAME_RX_MSP_FRAME_SIZE, 2, MSP_V2_TEST_ECHO, payloadB, sizeof(payloadB));
+    EXPECT_EQ(5, chunkCountA);
+    EXPECT_EQ(3, chunkCountB);
+
+    // when
+    bool pending = false;
+    for (int i = 0; i < chunkCountA; i++) {
+        pending = handleMspFrame(chunksA[i].bytes, chunksA[i].length, NULL);
+        if (i < chunkCountB) {
+            pending = handleMspFrame(chunksB[i].bytes, chunksB[i].length, NULL);
+        }
+    }
+
+    // then
+    EXPECT_TRUE(pending);
+
+    // when
+    drainMspV2Responses();
+
+    // then
+    mspV2TestResponse_t responses[4];
+    EXPECT_EQ(2, parseMspV2Responses(responses));
+
+    // request 2 completes first, so its response is sent first
+    EXPECT_EQ(2, responses[0].id);
+    EXPECT_EQ(sizeof(payloadB), responses[0].size);
+    EXPECT_EQ(0, memcmp(payloadB, responses[0].payload, sizeof(payloadB)));
+    EXPECT_TRUE(responses[0].crcOk);
+
+    EXPECT_EQ(1, responses[1].id);
+    EXPECT_EQ(sizeof(payloadA), responses[1].size);
+    EXPECT_EQ(0, memcmp(payloadA, responses[1].payload, sizeof(payloadA)));
+    EXPECT_TRUE(responses[1].crcOk);
+}
+
+TEST(CrossFireMSPTest, V2MultiChunkResponse)
+{
+    // given
+    uint8_t payload[120];
+    for (unsigned i = 0; i < sizeof(payload); i++) {
+        payload[i] = 3 * i;
+    }
+    mspV2TestChunk_t chunks[8];
+    const int chunkCount = buildMspV2Request(chunks, CRSF_FRAME_TX_MSP_FRAME_SIZE, 3, MSP_V2_TEST_ECHO, payload, sizeof(payload));
+    EXPECT_EQ(3, chunkCount);
+
+    // when
+    for (int i = 0; i < chunkCount; i++) {
+        handleMspFrame(chunks[i].bytes, chunks[i].length, NULL);
+    }
+    drainMspV2Responses();
+
+    // then
+    EXPECT_EQ(3, mspV2ReplyChunkCount);
+    mspV2TestResponse_t responses[4];
+    EXPECT_EQ(1, parseMspV2Responses(responses));
+    EXPECT_EQ(3, responses[0].id);
+    EXPECT_EQ(sizeof(payload), responses[0].size);
+    EXPECT_EQ(0, memcmp(payload, responses[0].payload, sizeof(payload)));
+    EXPECT_TRUE(responses[0].crcOk);
+}
+
+TEST(CrossFireMSPTest, V2CrcErrorResponse)
+{
+    // given
+    const uint8_t payload[] = { 0x01, 0x02 };
+    mspV2TestChunk_t chunks[4];
+    buildMspV2Request(chunks, CRSF_FRAME_TX_MSP_FRAME_SIZE, 4, MSP_V2_TEST_ECHO, payload, sizeof(payload));
+    chunks[0].bytes[2 + 5 + sizeof(payload)] ^= 0xFF;
+
+    // when
+    EXPECT_TRUE(handleMspFrame(chunks[0].bytes, chunks[0].length, NULL));
+    drainMspV2Responses();
+
+    // then
+    mspV2TestResponse_t responses[4];
+    EXPECT_EQ(1, parseMspV2Responses(responses));
+    EXPECT_EQ(4, responses[0].id);
+    EXPECT_EQ(1, responses[0].flags & 0x01);
+    EXPECT_EQ(1, responses[0].size);
+    EXPECT_TRUE(responses[0].crcOk);
+}
+
+TEST(CrossFireMSPTest, V2CommandErrorResponse)
+{
+    // given
+    mspV2TestChunk_t chunks[4];
+    buildMspV2Request(chunks, CRSF_FRAME_TX_MSP_FRAME_SIZE, 5, MSP_V2_TEST_FAIL, NULL, 0);
+
+    // when
+    EXPECT_TRUE(handleMspFrame(chunks[0].bytes, chunks[0].length, NULL));
+    drainMspV2Responses();
+
+    // then
+    mspV2TestResponse_t responses[4];
+    EXPECT_EQ(1, parseMspV2Responses(responses));
+    EXPECT_EQ(MSP_V2_TEST_FAIL, responses[0].cmd);
+    EXPECT_EQ(1, responses[0].flags & 0x01);
+    EXPECT_EQ(0, responses[0].size);
+}
+
+TEST(CrossFireMSPTest, V2SequenceLossDropsRequest)
+{
+    // given
+    uint8_t payload[20] = { 0 };
+    mspV2TestChunk_t chunks[8];
+    const int chunkCount = buildMspV2Request(chunks, CRSF_FRAME_RX_MSP_FRAME_SIZE, 6, MSP_V2_TEST_ECHO, payload, sizeof(payload));
+
+    // when
+    bool pending = false;
+    for (int i = 0; i < chunkCount; i++) {
+        if (i != 1) {
+            pending = handleMspFrame(chunks[i].bytes, chunks[i].length, NULL);
+        }
+    }
+
+    // then
+    EXPECT_FALSE(pending);
+    EXPECT_FALSE(sendMspReply(CRSF_FRAME_TX_MSP_FRAME_SIZE, &testCaptureMspV2Response));
+
+    // when the client retries
+    for (int i = 0; i < chunkCount; i++) {
+        pending = handleMspFrame(chunks[i].bytes, chunks[i].length, NULL);
+    }
+
+    // then
+    EXPECT_TRUE(pending);
+    drainMspV2Responses();
+    mspV2TestResponse_t responses[4];
+    EXPECT_EQ(1, parseMspV2Responses(responses));
+    EXPECT_EQ(6, responses[0].id);
+    EXPECT_TRUE(responses[0].crcOk);
+}
+
+TEST(CrossFireMSPTest, V2RequestsBufferedInCrsfTelemetry)
+{
+    // given
+    uint8_t payload[100];
+    for (unsigned i = 0; i < sizeof(payload); i++) {
+        payload[i] = i ^ 0x5A;
+    }
+    mspV2TestChunk_t chunks[8];
+    const int chunkCount = buildMspV2Request(chunks, CRSF_FRAME_TX_MSP_FRAME_SIZE, 8, MSP_V2_TEST_ECHO, payload, sizeof(payload));
+    EXPECT_EQ(2, chunkCount);
+
+    // when both chunks are buffered before the telemetry task runs
+    for (int i = 0; i < chunkCount; i++) {
+        EXPECT_TRUE(bufferCrsfMspFrame(chunks[i].bytes, chunks[i].length));
+    }
+    mspV2ReplyChunkCount = 0;
+    int calls = 0;
+    while (handleCrsfMspFrameBuffer(CRSF_FRAME_TX_MSP_FRAME_SIZE, &testCaptureMspV2Response) && calls < 16) {
+        calls++;
+    }
+
+    // then the response spanning two frames is sent completely
+    EXPECT_EQ(2, mspV2ReplyChunkCount);
+    mspV2TestResponse_t responses[4];
+    EXPECT_EQ(1, parseMspV2Responses(responses));
+    EXPECT_EQ(8, responses[0].id);
+    EXPECT_EQ(sizeof(payload), responses[0].size);
+    EXPECT_EQ(0, memcmp(payload, responses[0].payload, sizeof(payload)));
+    EXPECT_TRUE(responses[0].crcOk);
+}
+
+TEST(CrossFireMSPTest, V1RequestStillHandledWithV2Pending)
+{
+    // given a pending v2 response
+    const uint8_t payload[] = { 0x42 };
+    mspV2TestChunk_t chunks[4];
+    buildMspV2Request(chunks, CRSF_FRAME_TX_MSP_FRAME_SIZE, 9, MSP_V2_TEST_ECHO, payload, sizeof(payload));
+    EXPECT_TRUE(handleMspFrame(chunks[0].bytes, chunks[0].length, NULL));
+
+    // when a v1 request arrives
+    initSharedMsp();
+    crsfFrame = *(const crsfFrame_t*)crsfPidRequest;
+    uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + 2;
+    EXPECT_TRUE(handleMspFrame(frameStart, CRSF_FRAME_RX_MSP_FRAME_SIZE, NULL));
+
+    // then the v1 response is sent first, followed by the v2 response
+    mspV2ReplyChunkCount = 0;
+    EXPECT_TRUE(sendMspReply(CRSF_FRAME_TX_MSP_FRAME_SIZE, &testCaptureMspV2Response));
+    EXPECT_EQ(0x10, mspV2ReplyChunks[0][0] & 0xF0); // v1 start frame
+    EXPECT_EQ(30, mspV2ReplyChunks[0][1]);
+
+    drainMspV2Responses();
+    mspV2TestResponse_t responses[4];
+    EXPECT_EQ(1, parseMspV2Responses(responses));
+    EXPECT_EQ(9, responses[0].id);
+    EXPECT_EQ(0x42, responses[0].payload[0]);
+}
+
 // STUBS
 
 extern "C" {
@@ -293,10 +651,16 @@ extern "C" {
         UNUSED(mspPostProcessFn);
 
         sbuf_t *dst = &reply->buf;
-        const uint8_t cmdMSP = cmd->cmd;
+        const uint16_t cmdMSP = cmd->cmd;
         reply->cmd = cmd->cmd;
 
-        if (cmdMSP == 0x70) {
+        if (cmdMSP == MSP_V2_TEST_ECHO) {
+            while (sbufBytesRemaining(&cmd->buf)) {
+                sbufWriteU8(dst, sbufReadU8(&cmd->buf));
+            }
+        } else if (cmdMSP == MSP_V2_TEST_FAIL) {
+            return MSP_RESULT_ERROR;
+        } else if (cmdMSP == 0x70) {
             for (unsigned int ii=1; ii<=30; ii++) {
                 sbufWriteU8(dst, ii);
             }
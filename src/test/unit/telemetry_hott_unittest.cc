@@ -38,6 +38,8 @@ extern "C" {
 
     #include "fc/runtime_config.h"
 
+    #include "scheduler/scheduler.h"
+
     #include "flight/pid.h"
 
     #include "io/gps.h"
@@ -159,6 +161,146 @@ TEST(TelemetryHottTest, PrepareGPSMessage_Altitude1m)
 }
 */
 
+#define TEST_SERIAL_BUFFER_SIZE 256
+
+static uint8_t serialRxBuffer[TEST_SERIAL_BUFFER_SIZE];
+static int serialRxHead;
+static int serialRxTail;
+static uint8_t serialTxBuffer[TEST_SERIAL_BUFFER_SIZE];
+static int serialTxLength;
+static bool hottTxTaskEnabled;
+static timeUs_t testTimeUs = 1000000;
+
+static void sendHottRequest(uint8_t requestId, uint8_t address)
+{
+    serialRxBuffer[serialRxHead++ % TEST_SERIAL_BUFFER_SIZE] = requestId;
+    serialRxBuffer[serialRxHead++ % TEST_SERIAL_BUFFER_SIZE] = address;
+}
+
+// runs the telemetry task until the request is accepted
+static void handleHottRequest(void)
+{
+    handleHoTTTelemetry(testTimeUs);
+    testTimeUs += 5000;
+    handleHoTTTelemetry(testTimeUs);
+    testTimeUs += 5000;
+}
+
+// runs the transmit task until it disables itself
+static int runHottTransmitTask(void)
+{
+    int runs = 0;
+    while (hottTxTaskEnabled && runs < TEST_SERIAL_BUFFER_SIZE) {
+        handleHoTTTransmit(testTimeUs);
+        testTimeUs += HOTT_TX_DELAY_US;
+        runs++;
+    }
+
+    return runs;
+}
+
+static void initHottTelemetryForTest(void)
+{
+    initHoTTTelemetry();
+    checkHoTTTelemetryState();
+    serialRxHead = serialRxTail = 0;
+    serialTxLength = 0;
+}
+
+TEST(TelemetryHottTest, EAMResponseSentByTransmitTask)
+{
+    // given
+    initHottTelemetryForTest();
+    testBatteryVoltage = 1260;
+    testTimeUs += 1000000;
+    handleHoTTTelemetry(testTimeUs);
+
+    // when
+    sendHottRequest(HOTT_BINARY_MODE_REQUEST_ID, HOTT_TELEMETRY_EAM_SENSOR_ID);
+    handleHottRequest();
+
+    // then the telemetry task does not send anything itself
+    EXPECT_TRUE(hottTxTaskEnabled);
+    EXPECT_EQ(0, serialTxLength);
+
+    // when
+    const int runs = runHottTransmitTask();
+
+    // then one byte is sent per run, after the line was switched to transmit
+    EXPECT_FALSE(hottTxTaskEnabled);
+    EXPECT_EQ((int)sizeof(HOTT_EAM_MSG_t) + 1, serialTxLength);
+    EXPECT_EQ(serialTxLength + 2, runs);
+
+    const HOTT_EAM_MSG_t *msg = (const HOTT_EAM_MSG_t *)serialTxBuffer;
+    EXPECT_EQ(0x7C, msg->start_byte);
+    EXPECT_EQ(HOTT_TELEMETRY_EAM_SENSOR_ID, msg->eam_sensor_id);
+    EXPECT_EQ(126, msg->main_voltage_L | (msg->main_voltage_H << 8));
+    EXPECT_EQ(0x7D, msg->stop_byte);
+
+    uint8_t crc = 0;
+    for (unsigned i = 0; i < sizeof(HOTT_EAM_MSG_t); i++) {
+        crc += serialTxBuffer[i];
+    }
+    EXPECT_EQ(crc, serialTxBuffer[sizeof(HOTT_EAM_MSG_t)]);
+}
+
+TEST(TelemetryHottTest, ResponseNotChangedWhileSending)
+{
+    // given
+    initHottTelemetryForTest();
+    testBatteryVoltage = 1110;
+    testTimeUs += 1000000;
+    handleHoTTTelemetry(testTimeUs);
+    sendHottRequest(HOTT_BINARY_MODE_REQUEST_ID, HOTT_TELEMETRY_EAM_SENSOR_ID);
+    handleHottRequest();
+    handleHoTTTransmit(testTimeUs);
+    handleHoTTTransmit(testTimeUs);
+
+    // when the messages are prepared again in the middle of the response
+    testBatteryVoltage = 1500;
+    testTimeUs += 1000000;
+    handleHoTTTelemetry(testTimeUs);
+    runHottTransmitTask();
+
+    // then
+    const HOTT_EAM_MSG_t *msg = (const HOTT_EAM_MSG_t *)serialTxBuffer;
+    EXPECT_EQ((int)sizeof(HOTT_EAM_MSG_t) + 1, serialTxLength);
+    EXPECT_EQ(111, msg->main_voltage_L | (msg->main_voltage_H << 8));
+}
+
+TEST(TelemetryHottTest, NoRequestHandledWhileSending)
+{
+    // given
+    initHottTelemetryForTest();
+    sendHottRequest(HOTT_BINARY_MODE_REQUEST_ID, HOTT_TELEMETRY_EAM_SENSOR_ID);
+    handleHottRequest();
+    EXPECT_TRUE(hottTxTaskEnabled);
+
+    // when
+    sendHottRequest(HOTT_BINARY_MODE_REQUEST_ID, HOTT_TELEMETRY_EAM_SENSOR_ID);
+    handleHottRequest();
+
+    // then the second request is left alone until the response is complete
+    EXPECT_EQ(2, serialRxHead - serialRxTail);
+    runHottTransmitTask();
+    EXPECT_EQ((int)sizeof(HOTT_EAM_MSG_t) + 1, serialTxLength);
+    EXPECT_EQ(0, serialRxHead - serialRxTail);
+}
+
+TEST(TelemetryHottTest, UnknownAddressNotAnswered)
+{
+    // given
+    initHottTelemetryForTest();
+
+    // when
+    sendHottRequest(HOTT_BINARY_MODE_REQUEST_ID, 0x8D);
+    handleHottRequest();
+
+    // then
+    EXPECT_FALSE(hottTxTaskEnabled);
+    EXPECT_EQ(0, serialTxLength);
+}
+
 // STUBS
 
 extern "C" {
@@ -189,10 +331,22 @@ uint32_t millis(void) {
 
 uint32_t micros(void) { return 0; }
 
+static serialPort_t testPort;
+static const serialPortConfig_t testPortConfig = { .identifier = SERIAL_PORT_USART1 };
+
+void setTaskEnabled(taskId_e taskId, bool enabled)
+{
+    if (taskId == TASK_HOTT_TX) {
+        hottTxTaskEnabled = enabled;
+    }
+}
+
+void rescheduleTask(taskId_e, timeDelta_t) {}
+
 uint32_t serialRxBytesWaiting(const serialPort_t *instance)
 {
     UNUSED(instance);
-    return 0;
+    return serialRxHead - serialRxTail;
 }
 
 uint32_t serialTxBytesFree(const serialPort_t *instance)
@@ -204,13 +358,15 @@ uint32_t serialTxBytesFree(const serialPort_t *instance)
 uint8_t serialRead(serialPort_t *instance)
 {
     UNUSED(instance);
-    return 0;
+    return serialRxBuffer[serialRxTail++ % TEST_SERIAL_BUFFER_SIZE];
 }
 
 void serialWrite(serialPort_t *instance, uint8_t ch)
 {
     UNUSED(instance);
-    UNUSED(ch);
+    if (serialTxLength < TEST_SERIAL_BUFFER_SIZE) {
+        serialTxBuffer[serialTxLength++] = ch;
+    }
 }
 
 void serialSetMode(serialPort_t *instance, portMode_e mode)
@@ -229,7 +385,7 @@ serialPort_t *openSerialPort(serialPortIdentifier_e identifier, serialPortFuncti
     UNUSED(mode);
     UNUSED(options);
 
-    return NULL;
+    return &testPort;
 }
 
 void closeSerialPort(serialPort_t *serialPort)
@@ -241,7 +397,7 @@ const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e function)
 {
     UNUSED(function);
 
-    return NULL;
+    return &testPortConfig;
 }
 
 bool sensors(uint32_t mask)
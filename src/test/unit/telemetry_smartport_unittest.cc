@@ -0,0 +1,367 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "config/feature.h"
+
+    #include "drivers/serial.h"
+
+    #include "fc/controlrate_profile.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/imu.h"
+    #include "flight/pid.h"
+
+    #include "io/gps.h"
+    #include "io/serial.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    #include "sensors/acceleration.h"
+    #include "sensors/battery.h"
+    #include "sensors/sensors.h"
+
+    #include "telemetry/smartport.h"
+    #include "telemetry/telemetry.h"
+
+    PG_REGISTER(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 0);
+
+    uint16_t testBatteryVoltage = 0;
+    int32_t testAmperage = 0;
+    int32_t testMAhDrawn = 0;
+    uint32_t testEnabledSensors = 0;
+    bool testGpsFeature = false;
+    uint32_t testTimeUs = 0;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_RX_BUFFER_SIZE 16
+#define TEST_TX_BUFFER_SIZE 64
+
+static serialPort_t testPort;
+static const serialPortConfig_t testPortConfig = { .identifier = SERIAL_PORT_USART1 };
+
+static uint8_t rxBuffer[TEST_RX_BUFFER_SIZE];
+static int rxHead;
+static int rxTail;
+
+static uint8_t txBuffer[TEST_TX_BUFFER_SIZE];
+static int txLength;
+
+static void receiverSend(uint8_t c)
+{
+    rxBuffer[rxHead++ % TEST_RX_BUFFER_SIZE] = c;
+}
+
+// the receiver polls our sensor ID and returns the frame sent in our slot
+static int pollSensor(uint8_t *frame)
+{
+    txLength = 0;
+    receiverSend(FSSP_START_STOP);
+    receiverSend(FSSP_SENSOR_ID1);
+
+    handleSmartPortTelemetry();
+
+    memcpy(frame, txBuffer, txLength);
+    return txLength;
+}
+
+// removes the byte stuffing and checks the checksum
+static bool decodeFrame(const uint8_t *frame, int length, smartPortPayload_t *payload)
+{
+    uint8_t data[sizeof(smartPortPayload_t) + 1];
+    unsigned count = 0;
+    for (int i = 0; i < length; i++) {
+        uint8_t c = frame[i];
+        if (c == FSSP_START_STOP) {
+            return false;
+        }
+        if (c == FSSP_DLE) {
+            c = frame[++i] ^ FSSP_DLE_XOR;
+        }
+        if (count >= sizeof(data)) {
+            return false;
+        }
+        data[count++] = c;
+    }
+    if (count != sizeof(data)) {
+        return false;
+    }
+
+    uint16_t checksum = 0;
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        checksum += data[i];
+    }
+    checksum = (checksum & 0xFF) + (checksum >> 8);
+    checksum = (checksum & 0xFF) + (checksum >> 8);
+    if (checksum != 0xFF) {
+        return false;
+    }
+
+    memcpy(payload, data, sizeof(smartPortPayload_t));
+    return true;
+}
+
+// runs the telemetry task without a poll, to calculate the values
+static void runTelemetryTask(int count)
+{
+    for (int i = 0; i < count; i++) {
+        txLength = 0;
+        handleSmartPortTelemetry();
+        EXPECT_EQ(0, txLength);
+    }
+}
+
+static void initTelemetry(void)
+{
+    static bool initialised = false;
+    if (!initialised) {
+        testEnabledSensors = SENSOR_VOLTAGE | SENSOR_CURRENT | SENSOR_FUEL | SENSOR_GROUND_SPEED;
+        testGpsFeature = true;
+        EXPECT_TRUE(initSmartPortTelemetry());
+        checkSmartPortTelemetryState();
+        initialised = true;
+    }
+    rxHead = rxTail = 0;
+}
+
+TEST(TelemetrySmartPortTest, PollAnsweredWithPreparedFrame)
+{
+    // given
+    initTelemetry();
+    uint8_t frame[TEST_TX_BUFFER_SIZE];
+
+    // when
+    runTelemetryTask(2);
+    const int length = pollSensor(frame);
+
+    // then
+    smartPortPayload_t payload;
+    EXPECT_TRUE(decodeFrame(frame, length, &payload));
+    EXPECT_EQ(FSSP_DATA_FRAME, payload.frameId);
+}
+
+TEST(TelemetrySmartPortTest, AllAvailableValuesSentInPollLoop)
+{
+    // given
+    initTelemetry();
+    testBatteryVoltage = 1260;
+    testAmperage = 1500;
+    testMAhDrawn = 321;
+    runTelemetryTask(2);
+
+    // when
+    bool vfasSent = false;
+    bool a4Sent = false;
+    bool currentSent = false;
+    bool fuelSent = false;
+    for (int i = 0; i < 20; i++) {
+        uint8_t frame[TEST_TX_BUFFER_SIZE];
+        const int length = pollSensor(frame);
+        smartPortPayload_t payload;
+        ASSERT_TRUE(decodeFrame(frame, length, &payload));
+
+        switch (payload.valueId) {
+        case 0x0210:
+            EXPECT_EQ(1260, payload.data);
+            vfasSent = true;
+            break;
+        case 0x0910:
+            a4Sent = true;
+            break;
+        case 0x0200:
+            EXPECT_EQ(150, payload.data);
+            currentSent = true;
+            break;
+        case 0x0600:
+            EXPECT_EQ(321, payload.data);
+            fuelSent = true;
+            break;
+        default:
+            // no GPS fix, the speed must not be sent
+            ADD_FAILURE() << "unexpected data ID " << payload.valueId;
+        }
+    }
+
+    // then
+    EXPECT_TRUE(vfasSent);
+    EXPECT_TRUE(a4Sent);
+    EXPECT_TRUE(currentSent);
+    EXPECT_TRUE(fuelSent);
+}
+
+TEST(TelemetrySmartPortTest, ChangedValueSentFirst)
+{
+    // given
+    initTelemetry();
+    testBatteryVoltage = 1250;
+    testAmperage = 1000;
+    testMAhDrawn = 100;
+    runTelemetryTask(2);
+    for (int i = 0; i < 8; i++) {
+        uint8_t frame[TEST_TX_BUFFER_SIZE];
+        pollSensor(frame);
+    }
+
+    // when
+    testMAhDrawn = 101;
+    runTelemetryTask(2);
+    uint8_t frame[TEST_TX_BUFFER_SIZE];
+    const int length = pollSensor(frame);
+
+    // then
+    smartPortPayload_t payload;
+    EXPECT_TRUE(decodeFrame(frame, length, &payload));
+    EXPECT_EQ(0x0600, payload.valueId);
+    EXPECT_EQ(101, payload.data);
+}
+
+TEST(TelemetrySmartPortTest, FrameIsByteStuffed)
+{
+    // given
+    initTelemetry();
+    testMAhDrawn = 0;
+    runTelemetryTask(2);
+    for (int i = 0; i < 8; i++) {
+        uint8_t frame[TEST_TX_BUFFER_SIZE];
+        pollSensor(frame);
+    }
+    testMAhDrawn = FSSP_START_STOP | (FSSP_DLE << 8);
+    runTelemetryTask(2);
+
+    // when
+    uint8_t frame[TEST_TX_BUFFER_SIZE];
+    const int length = pollSensor(frame);
+
+    // then
+    EXPECT_GE(length, (int)sizeof(smartPortPayload_t) + 1 + 2);
+    const uint8_t stuffed[] = { FSSP_DLE, FSSP_START_STOP ^ FSSP_DLE_XOR, FSSP_DLE, FSSP_DLE ^ FSSP_DLE_XOR };
+    EXPECT_EQ(0, memcmp(stuffed, &frame[3], sizeof(stuffed)));
+    smartPortPayload_t payload;
+    EXPECT_TRUE(decodeFrame(frame, length, &payload));
+    EXPECT_EQ(0x0600, payload.valueId);
+    EXPECT_EQ((uint32_t)testMAhDrawn, payload.data);
+}
+
+TEST(TelemetrySmartPortTest, OtherSensorPollNotAnswered)
+{
+    // given
+    initTelemetry();
+    testMAhDrawn = 200;
+    runTelemetryTask(2);
+
+    // when
+    txLength = 0;
+    receiverSend(FSSP_START_STOP);
+    receiverSend(FSSP_SENSOR_ID3);
+    handleSmartPortTelemetry();
+
+    // then
+    EXPECT_EQ(0, txLength);
+}
+
+TEST(TelemetrySmartPortTest, ValueSentWhenAvailable)
+{
+    // given
+    initTelemetry();
+    ENABLE_STATE(GPS_FIX);
+    gpsSol.groundSpeed = 1000;
+    runTelemetryTask(2);
+
+    // when
+    bool speedSent = false;
+    for (int i = 0; i < 10; i++) {
+        uint8_t frame[TEST_TX_BUFFER_SIZE];
+        const int length = pollSensor(frame);
+        smartPortPayload_t payload;
+        ASSERT_TRUE(decodeFrame(frame, length, &payload));
+        if (payload.valueId == 0x0830) {
+            EXPECT_EQ(1000 * 1944 / 100, payload.data);
+            speedSent = true;
+        }
+    }
+
+    // then
+    EXPECT_TRUE(speedSent);
+    DISABLE_STATE(GPS_FIX);
+}
+
+// STUBS
+
+extern "C" {
+    gpsSolutionData_t gpsSol;
+    uint16_t GPS_distanceToHome;
+    attitudeEulerAngles_t attitude = { { 0, 0, 0 } };
+    acc_t acc;
+    uint8_t stateFlags;
+    uint16_t flightModeFlags;
+    uint8_t armingFlags;
+    pidProfile_t *currentPidProfile;
+    controlRateConfig_t *currentControlRateProfile;
+
+    uint32_t micros(void) { return testTimeUs; }
+
+    bool featureIsEnabled(uint32_t mask) { return (mask & FEATURE_GPS) && testGpsFeature; }
+    bool sensors(uint32_t) { return false; }
+    bool isArmingDisabled(void) { return false; }
+
+    bool telemetryIsSensorEnabled(sensor_e sensor) { return testEnabledSensors & sensor; }
+    bool telemetryDetermineEnabledState(portSharing_e) { return true; }
+
+    const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e) { return &testPortConfig; }
+    portSharing_e determinePortSharing(const serialPortConfig_t *, serialPortFunction_e) { return PORTSHARING_NOT_SHARED; }
+    serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) { return &testPort; }
+    void closeSerialPort(serialPort_t *) {}
+
+    uint32_t serialRxBytesWaiting(const serialPort_t *) { return rxHead - rxTail; }
+    uint8_t serialRead(serialPort_t *) { return rxBuffer[rxTail++ % TEST_RX_BUFFER_SIZE]; }
+    void serialWrite(serialPort_t *, uint8_t c)
+    {
+        if (txLength < TEST_TX_BUFFER_SIZE) {
+            txBuffer[txLength++] = c;
+        }
+    }
+    void serialWriteBuf(serialPort_t *port, const uint8_t *data, int count)
+    {
+        while (count--) {
+            serialWrite(port, *data++);
+        }
+    }
+
+    bool isBatteryVoltageConfigured(void) { return true; }
+    uint16_t getBatteryVoltage(void) { return testBatteryVoltage; }
+    uint8_t getBatteryCellCount(void) { return 0; }
+    bool isAmperageConfigured(void) { return true; }
+    int32_t getAmperage(void) { return testAmperage; }
+    int32_t getMAhDrawn(void) { return testMAhDrawn; }
+    int32_t getEstimatedAltitudeCm(void) { return 0; }
+    int16_t getEstimatedVario(void) { return 0; }
+}
@@ -0,0 +1,225 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/topic.h"
+
+    typedef struct testSample_s {
+        int32_t value;
+        uint8_t axis[3];
+    } testSample_t;
+
+    TOPIC_DECLARE(testSample_t, testSample);
+
+    // TOPIC_DEFINE() uses a C only builtin for its type check
+    static testSample_t testSample;
+    topic_t testSampleTopic = { .sample = &testSample };
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static int callbackCount;
+static const void *callbackSample;
+static timeUs_t callbackTimeUs;
+
+static void callback(const void *sample, timeUs_t sampleTimeUs)
+{
+    callbackCount++;
+    callbackSample = sample;
+    callbackTimeUs = sampleTimeUs;
+}
+
+static int otherCallbackCount;
+
+static void otherCallback(const void *sample, timeUs_t sampleTimeUs)
+{
+    UNUSED(sample);
+    UNUSED(sampleTimeUs);
+    otherCallbackCount++;
+}
+
+class TopicTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        testSampleTopic.sampleTimeUs = 0;
+        testSampleTopic.sequence = 0;
+        testSampleTopic.callbacks = NULL;
+        testSample.value = 0;
+        callbackCount = 0;
+        callbackSample = NULL;
+        callbackTimeUs = 0;
+        otherCallbackCount = 0;
+    }
+};
+
+TEST_F(TopicTest, NothingBeforeTheFirstSample)
+{
+    // given
+    topicSubscriber_t subscriber = TOPIC_SUBSCRIBER(testSample);
+
+    // expect
+    EXPECT_EQ(NULL, testSampleTopicLatest());
+    EXPECT_FALSE(topicHasNew(&subscriber));
+    EXPECT_EQ(0u, topicUnreadCount(&subscriber));
+    EXPECT_EQ(NULL, testSampleTopicReadNew(&subscriber));
+}
+
+TEST_F(TopicTest, SamplesAreNotCopied)
+{
+    // given
+    topicSubscriber_t subscriber = TOPIC_SUBSCRIBER(testSample);
+
+    // when
+    testSample.value = 42;
+    topicPublish(&testSampleTopic, 1000);
+
+    // then
+    // subscribers see the publisher's storage
+    EXPECT_EQ(&testSample, testSampleTopicLatest());
+    const testSample_t *sample = testSampleTopicReadNew(&subscriber);
+    EXPECT_EQ(&testSample, sample);
+    EXPECT_EQ(42, sample->value);
+    EXPECT_EQ(1000u, testSampleTopic.sampleTimeUs);
+}
+
+TEST_F(TopicTest, EachSampleIsReadOnce)
+{
+    // given
+    topicSubscriber_t subscriber = TOPIC_SUBSCRIBER(testSample);
+
+    // when
+    topicPublish(&testSampleTopic, 1000);
+
+    // then
+    EXPECT_TRUE(topicHasNew(&subscriber));
+    EXPECT_NE((void *)NULL, testSampleTopicReadNew(&subscriber));
+    EXPECT_FALSE(topicHasNew(&subscriber));
+    EXPECT_EQ(NULL, testSampleTopicReadNew(&subscriber));
+
+    // but the latest sample stays available
+    EXPECT_EQ(&testSample, testSampleTopicLatest());
+}
+
+TEST_F(TopicTest, SubscribersAreIndependent)
+{
+    // given
+    topicSubscriber_t fast = TOPIC_SUBSCRIBER(testSample);
+    topicSubscriber_t slow = TOPIC_SUBSCRIBER(testSample);
+
+    // when
+    for (int i = 0; i < 5; i++) {
+        testSample.value = i;
+        topicPublish(&testSampleTopic, 1000 * i);
+        EXPECT_EQ(i, testSampleTopicReadNew(&fast)->value);
+    }
+
+    // then
+    // the slow subscriber gets the latest sample and knows how many it missed
+    EXPECT_EQ(5u, topicUnreadCount(&slow));
+    EXPECT_EQ(4, testSampleTopicReadNew(&slow)->value);
+    EXPECT_EQ(0u, topicUnreadCount(&slow));
+    EXPECT_EQ(0u, topicUnreadCount(&fast));
+}
+
+TEST_F(TopicTest, SamplesBeforeSubscribingAreNotNew)
+{
+    // given
+    topicPublish(&testSampleTopic, 1000);
+    topicSubscriber_t subscriber;
+
+    // when
+    topicSubscribe(&subscriber, &testSampleTopic, NULL);
+
+    // then
+    EXPECT_FALSE(topicHasNew(&subscriber));
+    topicPublish(&testSampleTopic, 2000);
+    EXPECT_TRUE(topicHasNew(&subscriber));
+}
+
+TEST_F(TopicTest, CallbacksOnPublish)
+{
+    // given
+    topicSubscriber_t subscriber;
+    topicSubscriber_t otherSubscriber;
+    topicSubscribe(&subscriber, &testSampleTopic, callback);
+    topicSubscribe(&otherSubscriber, &testSampleTopic, otherCallback);
+
+    // when
+    topicPublish(&testSampleTopic, 1234);
+    topicPublish(&testSampleTopic, 2345);
+
+    // then
+    EXPECT_EQ(2, callbackCount);
+    EXPECT_EQ(2, otherCallbackCount);
+    EXPECT_EQ(&testSample, callbackSample);
+    EXPECT_EQ(2345u, callbackTimeUs);
+
+    // when
+    topicUnsubscribe(&subscriber);
+    topicPublish(&testSampleTopic, 3456);
+
+    // then
+    EXPECT_EQ(2, callbackCount);
+    EXPECT_EQ(3, otherCallbackCount);
+
+    // when
+    topicUnsubscribe(&otherSubscriber);
+    topicPublish(&testSampleTopic, 4567);
+
+    // then
+    EXPECT_EQ(3, otherCallbackCount);
+    EXPECT_EQ(NULL, testSampleTopic.callbacks);
+}
+
+TEST_F(TopicTest, SampleAge)
+{
+    // when
+    topicPublish(&testSampleTopic, 1000);
+
+    // then
+    EXPECT_EQ(0, topicSampleAgeUs(&testSampleTopic, 1000));
+    EXPECT_EQ(2500, topicSampleAgeUs(&testSampleTopic, 3500));
+
+    // and the age survives the microsecond counter wrapping
+    topicPublish(&testSampleTopic, UINT32_MAX - 99);
+    EXPECT_EQ(200, topicSampleAgeUs(&testSampleTopic, 100));
+}
+
+TEST_F(TopicTest, SequenceCountsEverySample)
+{
+    // given
+    topicSubscriber_t subscriber = TOPIC_SUBSCRIBER(testSample);
+
+    // when
+    for (int i = 1; i <= 100000; i++) {
+        testSample.value = i;
+        topicPublish(&testSampleTopic, i);
+    }
+
+    // then
+    EXPECT_EQ(100000u, testSampleTopic.sequence);
+    EXPECT_EQ(100000, testSampleTopicReadNew(&subscriber)->value);
+}
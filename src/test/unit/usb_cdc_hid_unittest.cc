@@ -0,0 +1,178 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+
+    #include "fc/rc_controls.h"
+
+    #include "io/usb_cdc_hid.h"
+
+    #include "rx/rx.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static const uint8_t defaultChannelMap[USB_HID_AXIS_COUNT] = { ROLL, PITCH, AUX3, YAW, AUX1, THROTTLE, AUX4, AUX2, AUX5, AUX6 };
+
+static int16_t reportAxis(const uint8_t *report, unsigned axis)
+{
+    return (int16_t)(report[2 * axis] | (report[2 * axis + 1] << 8));
+}
+
+static void setAllChannels(int16_t *channelData, int16_t value)
+{
+    for (unsigned i = 0; i < MAX_SUPPORTED_RC_CHANNEL_COUNT; i++) {
+        channelData[i] = value;
+    }
+}
+
+TEST(UsbCdcHidUnittest, TestReportSize)
+{
+    // given
+    uint8_t report[USB_CDC_HID_REPORT_SIZE];
+    int16_t channelData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+    setAllChannels(channelData, PWM_RANGE_MIDDLE);
+
+    // when
+    const uint8_t reportSize = usbHidBuildReport(report, channelData, MAX_SUPPORTED_RC_CHANNEL_COUNT, defaultChannelMap);
+
+    // then
+    EXPECT_EQ(20, reportSize);
+    for (unsigned i = 0; i < USB_HID_AXIS_COUNT; i++) {
+        EXPECT_EQ(0, reportAxis(report, i));
+    }
+}
+
+TEST(UsbCdcHidUnittest, TestFullScaleIsSixteenBit)
+{
+    // given
+    uint8_t report[USB_CDC_HID_REPORT_SIZE];
+    int16_t channelData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+    setAllChannels(channelData, PWM_RANGE_MAX);
+    channelData[YAW] = PWM_RANGE_MIN;
+
+    // when
+    usbHidBuildReport(report, channelData, MAX_SUPPORTED_RC_CHANNEL_COUNT, defaultChannelMap);
+
+    // then
+    EXPECT_EQ(USB_CDC_HID_RANGE_MAX, reportAxis(report, 0));
+    EXPECT_EQ(USB_CDC_HID_RANGE_MIN, reportAxis(report, 3));
+    EXPECT_EQ(USB_CDC_HID_RANGE_MAX, reportAxis(report, 9));
+
+    // and
+    EXPECT_EQ(0xff, report[0]);
+    EXPECT_EQ(0x7f, report[1]);
+}
+
+TEST(UsbCdcHidUnittest, TestYAxisIsInverted)
+{
+    // given
+    uint8_t report[USB_CDC_HID_REPORT_SIZE];
+    int16_t channelData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+    setAllChannels(channelData, PWM_RANGE_MIDDLE);
+    channelData[PITCH] = PWM_RANGE_MAX;
+
+    // when
+    usbHidBuildReport(report, channelData, MAX_SUPPORTED_RC_CHANNEL_COUNT, defaultChannelMap);
+
+    // then
+    EXPECT_EQ(USB_CDC_HID_RANGE_MIN, reportAxis(report, 1));
+}
+
+TEST(UsbCdcHidUnittest, TestResolution)
+{
+    // given
+    uint8_t report[USB_CDC_HID_REPORT_SIZE];
+    int16_t channelData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+    setAllChannels(channelData, PWM_RANGE_MIDDLE);
+
+    // when
+    int16_t previous = INT16_MIN;
+    for (int value = PWM_RANGE_MIN; value <= PWM_RANGE_MAX; value++) {
+        channelData[ROLL] = value;
+        usbHidBuildReport(report, channelData, MAX_SUPPORTED_RC_CHANNEL_COUNT, defaultChannelMap);
+
+        // then every microsecond of stick travel is a distinct axis value
+        EXPECT_GT(reportAxis(report, 0), previous);
+        previous = reportAxis(report, 0);
+    }
+}
+
+TEST(UsbCdcHidUnittest, TestOutOfRangeValuesAreConstrained)
+{
+    // given
+    uint8_t report[USB_CDC_HID_REPORT_SIZE];
+    int16_t channelData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+    setAllChannels(channelData, PWM_RANGE_MIDDLE);
+    channelData[ROLL] = 2200;
+    channelData[YAW] = 800;
+
+    // when
+    usbHidBuildReport(report, channelData, MAX_SUPPORTED_RC_CHANNEL_COUNT, defaultChannelMap);
+
+    // then
+    EXPECT_EQ(USB_CDC_HID_RANGE_MAX, reportAxis(report, 0));
+    EXPECT_EQ(USB_CDC_HID_RANGE_MIN, reportAxis(report, 3));
+}
+
+TEST(UsbCdcHidUnittest, TestCustomChannelMap)
+{
+    // given
+    uint8_t report[USB_CDC_HID_REPORT_SIZE];
+    int16_t channelData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+    for (unsigned i = 0; i < MAX_SUPPORTED_RC_CHANNEL_COUNT; i++) {
+        channelData[i] = PWM_RANGE_MIN + 50 * i;
+    }
+    const uint8_t channelMap[USB_HID_AXIS_COUNT] = { 17, 0, 16, 3, 4, 5, 6, 7, 8, 2 };
+
+    // when
+    usbHidBuildReport(report, channelData, MAX_SUPPORTED_RC_CHANNEL_COUNT, channelMap);
+
+    // then
+    EXPECT_EQ(scaleRange(PWM_RANGE_MIN + 50 * 17, PWM_RANGE_MIN, PWM_RANGE_MAX, USB_CDC_HID_RANGE_MIN, USB_CDC_HID_RANGE_MAX), reportAxis(report, 0));
+    EXPECT_EQ(USB_CDC_HID_RANGE_MAX, reportAxis(report, 1));
+    EXPECT_EQ(scaleRange(PWM_RANGE_MIN + 50 * 16, PWM_RANGE_MIN, PWM_RANGE_MAX, USB_CDC_HID_RANGE_MIN, USB_CDC_HID_RANGE_MAX), reportAxis(report, 2));
+    EXPECT_EQ(scaleRange(PWM_RANGE_MIN + 50 * 2, PWM_RANGE_MIN, PWM_RANGE_MAX, USB_CDC_HID_RANGE_MIN, USB_CDC_HID_RANGE_MAX), reportAxis(report, 9));
+}
+
+TEST(UsbCdcHidUnittest, TestUnavailableChannelIsCentred)
+{
+    // given
+    uint8_t report[USB_CDC_HID_REPORT_SIZE];
+    int16_t channelData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+    setAllChannels(channelData, PWM_RANGE_MAX);
+    const uint8_t channelMap[USB_HID_AXIS_COUNT] = { 0, 1, 2, 3, 8, 9, 10, 11, 200, 255 };
+
+    // when
+    usbHidBuildReport(report, channelData, 8, channelMap);
+
+    // then
+    EXPECT_EQ(USB_CDC_HID_RANGE_MAX, reportAxis(report, 3));
+    for (unsigned i = 4; i < USB_HID_AXIS_COUNT; i++) {
+        EXPECT_EQ(0, reportAxis(report, i));
+    }
+}
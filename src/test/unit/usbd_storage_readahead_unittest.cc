@@ -0,0 +1,219 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "drivers/sdcard_standard.h"
+
+    #include "msc/usbd_storage_readahead.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define BLOCK_SIZE 512
+#define CARD_BLOCKS 256
+
+// Command level model of an SD card: each read is a CMD17, or a CMD18 streaming blocks followed by CMD12
+static uint8_t cardBlocks[CARD_BLOCKS][BLOCK_SIZE];
+static int commandCount[64];
+static int blocksTransferred;
+static bool cardFails;
+
+static bool cardReadBlocks(uint32_t blockIndex, uint8_t *buffer, uint16_t blockCount)
+{
+    if (cardFails || blockCount == 0 || blockIndex + blockCount > CARD_BLOCKS) {
+        return false;
+    }
+
+    if (blockCount == 1) {
+        commandCount[SDCARD_COMMAND_READ_SINGLE_BLOCK]++;
+    } else {
+        commandCount[SDCARD_COMMAND_READ_MULTIPLE_BLOCK]++;
+        commandCount[SDCARD_COMMAND_STOP_TRANSMISSION]++;
+    }
+
+    memcpy(buffer, cardBlocks[blockIndex], blockCount * BLOCK_SIZE);
+    blocksTransferred += blockCount;
+
+    return true;
+}
+
+static void cardWriteBlock(uint32_t blockIndex, uint8_t value)
+{
+    memset(cardBlocks[blockIndex], value, BLOCK_SIZE);
+    commandCount[SDCARD_COMMAND_WRITE_BLOCK]++;
+}
+
+static int readCommands(void)
+{
+    return commandCount[SDCARD_COMMAND_READ_SINGLE_BLOCK] + commandCount[SDCARD_COMMAND_READ_MULTIPLE_BLOCK];
+}
+
+class ReadAheadTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        for (int i = 0; i < CARD_BLOCKS; i++) {
+            memset(cardBlocks[i], i, BLOCK_SIZE);
+        }
+        memset(commandCount, 0, sizeof(commandCount));
+        blocksTransferred = 0;
+        cardFails = false;
+
+        mscReadAheadInit(cardReadBlocks, CARD_BLOCKS);
+    }
+};
+
+TEST_F(ReadAheadTest, TestSequentialSingleBlockReadsUseMultiBlockCommands)
+{
+    // given
+    uint8_t buf[BLOCK_SIZE];
+
+    // when
+    for (int block = 0; block < 64; block++) {
+        EXPECT_TRUE(mscReadAheadRead(block, buf, 1));
+        ASSERT_EQ(block, buf[0]);
+        ASSERT_EQ(block, buf[BLOCK_SIZE - 1]);
+    }
+
+    // then
+    EXPECT_EQ(0, commandCount[SDCARD_COMMAND_READ_SINGLE_BLOCK]);
+    EXPECT_EQ(64 / MSC_READAHEAD_BLOCKS, commandCount[SDCARD_COMMAND_READ_MULTIPLE_BLOCK]);
+    EXPECT_EQ(64 / MSC_READAHEAD_BLOCKS, commandCount[SDCARD_COMMAND_STOP_TRANSMISSION]);
+    EXPECT_EQ(64, blocksTransferred);
+}
+
+TEST_F(ReadAheadTest, TestRandomReadsDoNotReadAhead)
+{
+    // given
+    uint8_t buf[BLOCK_SIZE];
+    const uint32_t blocks[] = { 100, 7, 200, 42, 150 };
+
+    // when
+    for (unsigned i = 0; i < ARRAYLEN(blocks); i++) {
+        EXPECT_TRUE(mscReadAheadRead(blocks[i], buf, 1));
+        EXPECT_EQ(blocks[i], buf[0]);
+    }
+
+    // then
+    EXPECT_EQ((int)ARRAYLEN(blocks), commandCount[SDCARD_COMMAND_READ_SINGLE_BLOCK]);
+    EXPECT_EQ(0, commandCount[SDCARD_COMMAND_READ_MULTIPLE_BLOCK]);
+    EXPECT_EQ((int)ARRAYLEN(blocks), blocksTransferred);
+}
+
+TEST_F(ReadAheadTest, TestLargeRequestReadDirectly)
+{
+    // given
+    static uint8_t buf[16 * BLOCK_SIZE];
+
+    // when
+    EXPECT_TRUE(mscReadAheadRead(0, buf, 16));
+    EXPECT_TRUE(mscReadAheadRead(16, buf, 16));
+
+    // then
+    EXPECT_EQ(2, commandCount[SDCARD_COMMAND_READ_MULTIPLE_BLOCK]);
+    EXPECT_EQ(32, blocksTransferred);
+    for (int i = 0; i < 16; i++) {
+        EXPECT_EQ(16 + i, buf[i * BLOCK_SIZE]);
+    }
+}
+
+TEST_F(ReadAheadTest, TestRequestStraddlingWindow)
+{
+    // given
+    uint8_t buf[4 * BLOCK_SIZE];
+
+    // when
+    // first request fills a window of blocks 0..7
+    EXPECT_TRUE(mscReadAheadRead(0, buf, 2));
+    EXPECT_TRUE(mscReadAheadRead(2, buf, 4));
+    // blocks 6 and 7 come from the window, 8 and 9 from the next one
+    EXPECT_TRUE(mscReadAheadRead(6, buf, 4));
+
+    // then
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(6 + i, buf[i * BLOCK_SIZE]);
+    }
+    EXPECT_EQ(2, commandCount[SDCARD_COMMAND_READ_MULTIPLE_BLOCK]);
+}
+
+TEST_F(ReadAheadTest, TestWriteInvalidatesWindow)
+{
+    // given
+    uint8_t buf[BLOCK_SIZE];
+    EXPECT_TRUE(mscReadAheadRead(0, buf, 1));
+    EXPECT_TRUE(mscReadAheadRead(1, buf, 1));
+    EXPECT_EQ(1, readCommands());
+
+    // when
+    cardWriteBlock(3, 0xAA);
+    mscReadAheadInvalidate(3, 1);
+
+    // then
+    EXPECT_TRUE(mscReadAheadRead(2, buf, 1));
+    EXPECT_EQ(2, buf[0]);
+    EXPECT_TRUE(mscReadAheadRead(3, buf, 1));
+    EXPECT_EQ(0xAA, buf[0]);
+    EXPECT_EQ(2, readCommands());
+
+    // and
+    // a write outside the window leaves it intact
+    mscReadAheadInvalidate(100, 8);
+    EXPECT_TRUE(mscReadAheadRead(4, buf, 1));
+    EXPECT_EQ(2, readCommands());
+}
+
+TEST_F(ReadAheadTest, TestWindowClampedAtEndOfCard)
+{
+    // given
+    uint8_t buf[BLOCK_SIZE];
+    EXPECT_TRUE(mscReadAheadRead(CARD_BLOCKS - 3, buf, 1));
+
+    // when
+    EXPECT_TRUE(mscReadAheadRead(CARD_BLOCKS - 2, buf, 1));
+    EXPECT_TRUE(mscReadAheadRead(CARD_BLOCKS - 1, buf, 1));
+
+    // then
+    EXPECT_EQ(CARD_BLOCKS - 1, buf[0]);
+    EXPECT_EQ(3, blocksTransferred);
+}
+
+TEST_F(ReadAheadTest, TestReadFailureReported)
+{
+    // given
+    uint8_t buf[BLOCK_SIZE];
+    cardFails = true;
+
+    // then
+    EXPECT_FALSE(mscReadAheadRead(0, buf, 1));
+    EXPECT_FALSE(mscReadAheadRead(50, buf, 1));
+
+    // and
+    // nothing stale is served once the card recovers
+    cardFails = false;
+    EXPECT_TRUE(mscReadAheadRead(0, buf, 1));
+    EXPECT_EQ(0, buf[0]);
+}
@@ -0,0 +1,495 @@
+#!/usr/bin/env python3
+#
+# This file is part of Betaflight.
+#
+# Betaflight is free software. You can redistribute this software
+# and/or modify this software under the terms of the GNU General
+# Public License as published by the Free Software Foundation,
+# either version 3 of the License, or (at your option) any later
+# version.
+#
+# Betaflight is distributed in the hope that they will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this software.
+#
+# If not, see <http://www.gnu.org/licenses/>.
+
+"""Profile guided placement of hot code.
+
+Reads a function level profile of the SITL build and the map file of a
+target build, and writes
+
+  - a linker script placing the hottest functions, by time per byte, in the
+    free space of the fast code memory of the MCU (ITCM RAM on F7/H7, CCM RAM
+    on F3), next to the FAST_CODE / CCM_CODE functions;
+  - a make fragment with the files to compile speed optimised, as they take a
+    noticeable share of the run time, and the files to compile size
+    optimised, as the profile never executed them. The hardware code of the
+    target, its drivers and interrupt handlers, is not what SITL runs and is
+    never size optimised from the profile.
+
+The placement is by section name, so it survives link time optimisation: the
+linker script is given before the linker script of the target and claims the
+'-ffunction-sections' sections of the hot functions before '.text' does.
+
+The profile is either written by the SITL build made with
+OPTIONS=SITL_PROFILE (resolved with the SITL map file), or the output of
+'perf report --stdio --no-children' for the SITL executable.
+
+Build the target with HOT_CODE_PROFILE=<make fragment> to apply it, see
+src/main/target/SITL/README.md.
+"""
+
+import argparse
+import bisect
+import re
+import sys
+from collections import defaultdict, namedtuple
+
+# memory regions holding fast code and the output section of the fixed placement in them
+FAST_CODE_REGIONS = (
+    ('ITCM_RAM', '.tcm_code'),
+    ('CCM', '.ccm_code'),
+)
+
+HOT_CODE_SECTION = '.hot_code'
+
+# keep some of the region free for alignment and the veneers of calls to and from flash
+DEFAULT_RESERVE = 512
+# functions called less often are not hot, whatever time they took (waiting in init() for instance)
+DEFAULT_MIN_CALLS = 100
+# share of the run time above which a file is compiled speed optimised
+DEFAULT_SPEED_SHARE = 0.005
+
+# the SITL build has its own drivers, the profile says nothing about these files of the target
+HARDWARE_SOURCES = ('drivers/', 'startup/', 'target/')
+
+# sections not loaded into memory, listed at address 0 which is where ITCM RAM starts
+NOT_ALLOCATED_SECTIONS = ('.debug', '.comment', '.ARM.attributes', '.stab')
+
+# parts of a function that GCC has split out into their own section, never moved
+TEXT_SUBSECTIONS = ('unlikely.', 'startup.', 'hot.', 'exit.')
+
+Region = namedtuple('Region', 'name origin length')
+OutputSection = namedtuple('OutputSection', 'name address size load_address')
+InputSection = namedtuple('InputSection', 'output name address size source')
+
+
+class MapFile(object):
+    """The parts of a GNU ld map file needed for the placement."""
+
+    def __init__(self):
+        self.regions = []
+        self.output_sections = []
+        self.input_sections = []
+        self.objects = []           # object files given to the linker
+        self.symbols = {}           # name -> address
+
+    def region(self, name):
+        for region in self.regions:
+            if region.name == name:
+                return region
+        return None
+
+    def region_at(self, address):
+        for region in self.regions:
+            if region.origin <= address < region.origin + region.length:
+                return region
+        return None
+
+    def output_section(self, name):
+        for section in self.output_sections:
+            if section.name == name:
+                return section
+        return None
+
+
+MAP_REGION_RE = re.compile(r'^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)')
+MAP_SECTION_RE = re.compile(r'^(\s*)(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(.*))?$')
+MAP_ADDRESS_RE = re.compile(r'^\s+0x[0-9a-fA-F]+\s+0x[0-9a-fA-F]+')
+MAP_SYMBOL_RE = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_$][\w.$]*)\s*$')
+MAP_LOAD_ADDRESS_RE = re.compile(r'load address 0x([0-9a-fA-F]+)')
+MAP_LOAD_RE = re.compile(r'^LOAD\s+(\S+)')
+OBJECT_RE = re.compile(r'(?:^|/)obj/main/[^/]+/(.+)\.o$')
+
+
+def source_file(object_path):
+    """Path below src/main of the source of an object, or None for libraries and LTO partitions."""
+    match = OBJECT_RE.search(object_path.strip()) if object_path else None
+    if not match:
+        return None
+    return match.group(1) + '.c'
+
+
+def parse_map(lines):
+    result = MapFile()
+    state = None
+    output = None
+    pending = None
+
+    for line in lines:
+        line = line.rstrip('\n')
+
+        if line.startswith('Memory Configuration'):
+            state = 'memory'
+            continue
+        if line.startswith('Linker script and memory map'):
+            state = 'map'
+            continue
+        if line.startswith('Discarded input sections') or line.startswith('Cross Reference Table'):
+            state = None
+            continue
+
+        if state == 'memory':
+            match = MAP_REGION_RE.match(line)
+            if match and match.group(1) != '*default*':
+                result.regions.append(Region(match.group(1), int(match.group(2), 16), int(match.group(3), 16)))
+            continue
+
+        if state != 'map' or not line.strip():
+            continue
+
+        match = MAP_LOAD_RE.match(line)
+        if match:
+            result.objects.append(match.group(1))
+            continue
+
+        # long section names are followed by the address on the next line
+        if pending is not None:
+            indent, name = pending
+            pending = None
+            if MAP_ADDRESS_RE.match(line):
+                line = '%s%s %s' % (indent, name, line.strip())
+
+        match = MAP_SECTION_RE.match(line)
+        if match:
+            indent, name, address, size, rest = match.groups()
+            address = int(address, 16)
+            size = int(size, 16)
+            rest = (rest or '').strip()
+            if not indent:
+                output = name
+                load_address = MAP_LOAD_ADDRESS_RE.search(rest)
+                result.output_sections.append(OutputSection(name, address, size, int(load_address.group(1), 16) if load_address else None))
+            elif output is not None and not name.startswith('*'):
+                result.input_sections.append(InputSection(output, name, address, size, rest))
+            continue
+
+        match = MAP_SYMBOL_RE.match(line)
+        if match:
+            result.symbols.setdefault(match.group(2), int(match.group(1), 16))
+            continue
+
+        stripped = line.strip()
+        if stripped.startswith('.') and ' ' not in stripped:
+            pending = (line[:len(line) - len(line.lstrip())], stripped)
+
+    return result
+
+
+def function_name(section_name):
+    """Function of a '-ffunction-sections' code section, without the suffix of clones, or None."""
+    if not section_name.startswith('.text.'):
+        return None
+    name = section_name[len('.text.'):]
+    if name.startswith(TEXT_SUBSECTIONS):
+        return None
+    # C names have no dots, the rest is added by GCC ('.constprop.0', '.lto_priv.0', ...)
+    return name.split('.')[0]
+
+
+class Profile(object):
+    """Time spent per function of the SITL build, and the files it was built from."""
+
+    def __init__(self):
+        self.weights = defaultdict(float)       # (file, function) -> weight
+        self.files = set()
+
+
+def sitl_functions(sitl_map):
+    """Code sections of the SITL build as (address, size, file, function), sorted by address."""
+    functions = []
+    for section in sitl_map.input_sections:
+        if not section.name.startswith('.text.') or not section.size:
+            continue
+        source = source_file(section.source)
+        if not source:
+            continue
+        # split out parts, like the '.text.startup.main' of main(), are time of the function
+        name = function_name(section.name) or section.name.split('.')[-1]
+        functions.append((section.address, section.size, source, name))
+    functions.sort()
+    return functions
+
+
+PROFILE_ANCHOR_RE = re.compile(r'^anchor\s+(\S+)\s+(0x[0-9a-fA-F]+)')
+PROFILE_ENTRY_RE = re.compile(r'^(0x[0-9a-fA-F]+)\s+(\d+)\s+(\d+)')
+
+
+def parse_sitl_profile(lines, sitl_map, warn, min_calls=DEFAULT_MIN_CALLS):
+    profile = Profile()
+    functions = sitl_functions(sitl_map)
+    if not functions:
+        raise ValueError('no code sections of src/main in the SITL map file, build it without LTO')
+    starts = [function[0] for function in functions]
+    profile.files = set(function[2] for function in functions)
+
+    offset = None
+    for line in lines:
+        line = line.strip()
+        if not line or line.startswith('#'):
+            continue
+
+        match = PROFILE_ANCHOR_RE.match(line)
+        if match:
+            anchor = sitl_map.symbols.get(match.group(1))
+            if anchor is None:
+                raise ValueError('anchor %s is not in the SITL map file' % match.group(1))
+            # the executable is position independent, the anchor gives the load offset
+            offset = int(match.group(2), 16) - anchor
+            continue
+
+        match = PROFILE_ENTRY_RE.match(line)
+        if not match:
+            warn('unrecognised profile line: %s' % line)
+            continue
+        if offset is None:
+            raise ValueError('the profile has no anchor')
+
+        if int(match.group(2)) < min_calls:
+            continue
+
+        address = int(match.group(1), 16) - offset
+        index = bisect.bisect_right(starts, address) - 1
+        if index < 0 or address >= functions[index][0] + functions[index][1]:
+            continue
+        _, _, source, name = functions[index]
+        profile.weights[(source, name)] += int(match.group(3))
+
+    return profile
+
+
+PERF_LINE_RE = re.compile(r'^\s*((?:[\d.]+%\s+)+).*\[\.\]\s+(\S+)')
+
+
+def parse_perf_report(lines, sitl_map, warn):
+    profile = Profile()
+    files_by_function = defaultdict(set)
+    for _, _, source, name in sitl_functions(sitl_map):
+        files_by_function[name].add(source)
+        profile.files.add(source)
+    if not profile.files:
+        raise ValueError('no code sections of src/main in the SITL map file, build it without LTO')
+
+    for line in lines:
+        match = PERF_LINE_RE.match(line)
+        if not match:
+            continue
+        # with children the last percentage is the self time
+        share = float(match.group(1).split()[-1].rstrip('%'))
+        name = match.group(2).split('.')[0]
+        files = files_by_function.get(name)
+        if not files:
+            continue
+        if len(files) > 1:
+            warn('%s is in %s, the samples can not be attributed' % (name, ', '.join(sorted(files))))
+            continue
+        profile.weights[(next(iter(files)), name)] += share
+
+    return profile
+
+
+Candidate = namedtuple('Candidate', 'name size weight')
+
+
+class Placement(object):
+
+    def __init__(self):
+        self.region = None
+        self.load_region = None
+        self.budget = 0
+        self.functions = []         # candidates placed, most time per byte first
+        self.speed_files = []
+        self.size_files = []
+
+
+def fast_code_memory(target_map):
+    """The fast code region and the output section of the fixed placement in it, or (None, None)."""
+    for region_name, section_name in FAST_CODE_REGIONS:
+        region = target_map.region(region_name)
+        section = target_map.output_section(section_name)
+        if region and section:
+            return region, section
+    return None, None
+
+
+def free_space(target_map, region):
+    """Free space of the region, the functions placed by an earlier run count as free."""
+    used = 0
+    for section in target_map.output_sections:
+        if section.name == HOT_CODE_SECTION or section.name.startswith(NOT_ALLOCATED_SECTIONS):
+            continue
+        if region.origin <= section.address < region.origin + region.length:
+            used += section.size
+    return region.length - used
+
+
+def place(profile, target_map, warn, budget=None, reserve=DEFAULT_RESERVE, speed_share=DEFAULT_SPEED_SHARE):
+    placement = Placement()
+
+    # functions are moved by name, static functions of the same name would all be moved
+    files_by_function = defaultdict(set)
+    weights = defaultdict(float)
+    for (source, name), weight in profile.weights.items():
+        files_by_function[name].add(source)
+        weights[name] += weight
+
+    region, fixed_section = fast_code_memory(target_map)
+    if region:
+        placement.region = region
+        if fixed_section.load_address is not None:
+            placement.load_region = target_map.region_at(fixed_section.load_address)
+        if budget is None:
+            budget = free_space(target_map, region) - reserve
+        placement.budget = max(budget, 0)
+
+        sizes = defaultdict(int)
+        for section in target_map.input_sections:
+            name = function_name(section.name)
+            if name and weights.get(name, 0) > 0:
+                sizes[name] += section.size
+
+        candidates = []
+        for name, size in sizes.items():
+            if len(files_by_function[name]) > 1:
+                warn('%s is in %s, not moved' % (name, ', '.join(sorted(files_by_function[name]))))
+            elif size:
+                candidates.append(Candidate(name, size, weights[name]))
+
+        # the region is small, filling it by time per byte is close enough to the optimum
+        candidates.sort(key=lambda candidate: (-candidate.weight / candidate.size, candidate.name))
+        remaining = placement.budget
+        for candidate in candidates:
+            if candidate.size <= remaining:
+                placement.functions.append(candidate)
+                remaining -= candidate.size
+
+    # only files in both builds have been measured by the profile
+    target_files = set(filter(None, (source_file(path) for path in target_map.objects)))
+    target_files.update(filter(None, (source_file(section.source) for section in target_map.input_sections)))
+
+    total = sum(profile.weights.values())
+    file_weights = defaultdict(float)
+    for (source, _), weight in profile.weights.items():
+        file_weights[source] += weight
+
+    for source in sorted(target_files & profile.files):
+        weight = file_weights.get(source, 0)
+        if total > 0 and weight / total >= speed_share:
+            placement.speed_files.append(source)
+        elif weight == 0 and not source.startswith(HARDWARE_SOURCES):
+            placement.size_files.append(source)
+
+    return placement
+
+
+GENERATED = 'Generated by src/utils/hot_code_placement.py, do not edit.'
+
+
+def linker_script(placement):
+    used = sum(candidate.size for candidate in placement.functions)
+    lines = [
+        '/* %s */' % GENERATED,
+        '/* %s: %d of %d bytes */' % (placement.region.name, used, placement.budget),
+        '',
+        'SECTIONS',
+        '{',
+        '  hot_code = LOADADDR(%s);' % HOT_CODE_SECTION,
+        '  %s :' % HOT_CODE_SECTION,
+        '  {',
+        '    . = ALIGN(4);',
+        '    hot_code_start = .;',
+    ]
+    for candidate in placement.functions:
+        lines.append('    *(.text.%s .text.%s.*)' % (candidate.name, candidate.name))
+    lines.extend([
+        '    . = ALIGN(4);',
+        '    hot_code_end = .;',
+        '  } >%s%s' % (placement.region.name, ' AT >%s' % placement.load_region.name if placement.load_region else ''),
+        '}',
+        'INSERT AFTER %s;' % dict(FAST_CODE_REGIONS)[placement.region.name],
+        '',
+    ])
+    return '\n'.join(lines)
+
+
+def make_fragment(placement, linker_script_path):
+    lines = [
+        '# %s' % GENERATED,
+        '',
+    ]
+    if linker_script_path:
+        lines.append('HOT_CODE_LD_SCRIPT := %s' % linker_script_path)
+        lines.append('')
+
+    lines.append('PROFILED_SPEED_OPTIMISED_SRC := \\')
+    lines.extend('            %s \\' % source for source in placement.speed_files)
+    lines.append('')
+    lines.append('PROFILED_SIZE_OPTIMISED_SRC := \\')
+    lines.extend('            %s \\' % source for source in placement.size_files)
+    lines.append('')
+
+    return '\n'.join(lines)
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--sitl-map', required=True, help='map file of the SITL build')
+    profile_source = parser.add_mutually_exclusive_group(required=True)
+    profile_source.add_argument('--profile', help='profile written by the SITL build made with OPTIONS=SITL_PROFILE')
+    profile_source.add_argument('--perf', help="output of 'perf report --stdio --no-children'")
+    parser.add_argument('--min-calls', type=int, default=DEFAULT_MIN_CALLS, help='calls for a function of the SITL profile to count (default %(default)d)')
+    parser.add_argument('--target-map', required=True, help='map file of the target build')
+    parser.add_argument('--budget', type=int, help='bytes of fast code memory to use, default the free space of the region')
+    parser.add_argument('--reserve', type=int, default=DEFAULT_RESERVE, help='bytes of the region to keep free (default %(default)d)')
+    parser.add_argument('--speed-share', type=float, default=DEFAULT_SPEED_SHARE, help='share of the run time for a file to be compiled speed optimised (default %(default)s)')
+    parser.add_argument('-o', '--output', required=True, help='make fragment to write, the linker script is written next to it')
+    args = parser.parse_args(argv)
+
+    def warn(message):
+        sys.stderr.write('warning: %s\n' % message)
+
+    with open(args.sitl_map) as f:
+        sitl_map = parse_map(f)
+    with open(args.target_map) as f:
+        target_map = parse_map(f)
+
+    if args.profile:
+        with open(args.profile) as f:
+            profile = parse_sitl_profile(f, sitl_map, warn, args.min_calls)
+    else:
+        with open(args.perf) as f:
+            profile = parse_perf_report(f, sitl_map, warn)
+
+    placement = place(profile, target_map, warn, args.budget, args.reserve, args.speed_share)
+
+    linker_script_path = None
+    if placement.region:
+        linker_script_path = re.sub(r'\.mk$', '', args.output) + '.ld'
+        with open(linker_script_path, 'w') as f:
+            f.write(linker_script(placement))
+    else:
+        warn('no fast code memory in %s, only the optimisation classes are written' % args.target_map)
+
+    with open(args.output, 'w') as f:
+        f.write(make_fragment(placement, linker_script_path))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
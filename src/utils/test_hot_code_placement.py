@@ -0,0 +1,366 @@
+#!/usr/bin/env python3
+#
+# This file is part of Betaflight.
+#
+# Betaflight is free software. You can redistribute this software
+# and/or modify this software under the terms of the GNU General
+# Public License as published by the Free Software Foundation,
+# either version 3 of the License, or (at your option) any later
+# version.
+#
+# Betaflight is distributed in the hope that they will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this software.
+#
+# If not, see <http://www.gnu.org/licenses/>.
+
+# Run with 'make test-utils'.
+
+import os
+import shutil
+import tempfile
+import unittest
+
+import hot_code_placement as hcp
+
+# SITL built without LTO, the map file attributes every function to its file
+SITL_MAP = """\
+Discarded input sections
+
+ .text.unused   0x0000000000000000       0x10 ./obj/main/SITL/fc/core.o
+
+Memory Configuration
+
+Name             Origin             Length             Attributes
+*default*        0x0000000000000000 0xffffffffffffffff
+
+Linker script and memory map
+
+LOAD ./obj/main/SITL/main.o
+LOAD ./obj/main/SITL/flight/pid.o
+LOAD ./obj/main/SITL/flight/mixer.o
+LOAD ./obj/main/SITL/common/filter.o
+LOAD ./obj/main/SITL/cli/cli.o
+LOAD ./obj/main/SITL/drivers/serial_tcp.o
+LOAD ./obj/main/SITL/drivers/dshot.o
+
+.text           0x0000000000011000     0x2000
+ *(.text.unlikely .text.*_unlikely .text.unlikely.*)
+ .text.unlikely.pidController
+                0x0000000000011000       0x40 ./obj/main/SITL/flight/pid.o
+ *(.text.startup .text.startup.*)
+ .text.startup.main
+                0x0000000000011040       0x80 ./obj/main/SITL/main.o
+                0x0000000000011040                main
+ *(.text .stub .text.*)
+ .text.pidController
+                0x0000000000011100      0x400 ./obj/main/SITL/flight/pid.o
+                0x0000000000011100                pidController
+ .text.updateState
+                0x0000000000011500       0x40 ./obj/main/SITL/flight/pid.o
+ .text.mixTable
+                0x0000000000011600      0x200 ./obj/main/SITL/flight/mixer.o
+                0x0000000000011600                mixTable
+ .text.updateState
+                0x0000000000011800       0x40 ./obj/main/SITL/flight/mixer.o
+ .text.pt1FilterApply
+                0x0000000000011900       0x20 ./obj/main/SITL/common/filter.o
+                0x0000000000011900                pt1FilterApply
+ .text.biquadFilterApply
+                0x0000000000011920       0x60 ./obj/main/SITL/common/filter.o
+                0x0000000000011920                biquadFilterApply
+ .text.cliProcess
+                0x0000000000011a00      0x300 ./obj/main/SITL/cli/cli.o
+                0x0000000000011a00                cliProcess
+ .text.tcpReceive
+                0x0000000000011d00       0x80 ./obj/main/SITL/drivers/serial_tcp.o
+                0x0000000000011d00                tcpReceive
+ .text.dshotCommandWrite
+                0x0000000000011d80       0x80 ./obj/main/SITL/drivers/dshot.o
+                0x0000000000011d80                dshotCommandWrite
+ .text          0x0000000000011e00       0x80 /usr/lib/gcc/x86_64-linux-gnu/12/crtbegin.o
+"""
+
+# the SITL executable was loaded at 0x555555554000
+SITL_PROFILE = """\
+# betaflight SITL function profile: address calls self_time_ns
+anchor main 0x555555565040
+0x555555565040 1 90000000
+0x555555565100 8000 5000000
+0x555555565600 8000 3000000
+0x555555565900 48000 1000000
+0x555555565920 24000 2000000
+0x555555565500 8000 400000
+0x555555565800 8000 400000
+0x7f0000001000 100 9999
+"""
+
+PERF_REPORT = """\
+# Children      Self  Command          Shared Object         Symbol
+# ........  ........  ...............  ....................  ..........................
+#
+    90.00%    40.00%  betaflight_SITL  betaflight_SITL.elf   [.] pidController
+    30.00%    30.00%  betaflight_SITL  betaflight_SITL.elf   [.] mixTable
+    20.00%    20.00%  betaflight_SITL  betaflight_SITL.elf   [.] biquadFilterApply.constprop.0
+     5.00%     5.00%  betaflight_SITL  betaflight_SITL.elf   [.] updateState
+     5.00%     5.00%  betaflight_SITL  libc.so.6             [.] __memcpy_avx_unaligned
+"""
+
+# F7 build with LTO, the code comes from the LTO partitions and the files only from the LOAD lines
+TARGET_MAP = """\
+Memory Configuration
+
+Name             Origin             Length             Attributes
+ITCM_RAM         0x00000000         0x00004000         xr
+AXIM_FLASH       0x08000000         0x00002800         xr
+AXIM_FLASH1      0x08008000         0x00078000         xr
+RAM              0x20000000         0x00040000         xrw
+*default*        0x00000000         0xffffffff
+
+Linker script and memory map
+
+LOAD ./obj/main/STM32F7X2/main.o
+LOAD ./obj/main/STM32F7X2/flight/pid.o
+LOAD ./obj/main/STM32F7X2/flight/mixer.o
+LOAD ./obj/main/STM32F7X2/common/filter.o
+LOAD ./obj/main/STM32F7X2/cli/cli.o
+LOAD ./obj/main/STM32F7X2/drivers/pwm_output_dshot.o
+LOAD ./obj/main/STM32F7X2/drivers/dshot.o
+
+.isr_vector     0x08000000      0x1f8
+ .isr_vector    0x08000000      0x1f8 ./obj/main/STM32F7X2/startup/startup_stm32f722xx.o
+
+.text           0x08008000     0x9000
+ .text.pidController
+                0x08008000      0x300 /tmp/ccQ1x2yZ.ltrans0.ltrans.o
+ .text.mixTable
+                0x08008300      0x180 /tmp/ccQ1x2yZ.ltrans0.ltrans.o
+ .text.updateState.lto_priv.0
+                0x08008480       0x30 /tmp/ccQ1x2yZ.ltrans0.ltrans.o
+ .text.pt1FilterApply
+                0x080084c0       0x20 /tmp/ccQ1x2yZ.ltrans1.ltrans.o
+ .text.biquadFilterApply
+                0x080084e0       0x40 /tmp/ccQ1x2yZ.ltrans1.ltrans.o
+ .text.biquadFilterApply.constprop.0
+                0x08008520       0x20 /tmp/ccQ1x2yZ.ltrans1.ltrans.o
+ .text.cliProcess
+                0x08008540      0x280 /tmp/ccQ1x2yZ.ltrans2.ltrans.o
+
+.tcm_code       0x00000000     0x3c00 load address 0x08011000
+                0x00000000                tcm_code_start = .
+ .tcm_code      0x00000000     0x3c00 /tmp/ccQ1x2yZ.ltrans0.ltrans.o
+                0x00003c00                tcm_code_end = .
+
+.data           0x20000000      0x800 load address 0x08014c00
+ .data          0x20000000      0x800 /tmp/ccQ1x2yZ.ltrans0.ltrans.o
+
+.debug_info     0x00000000    0x9a000
+ .debug_info    0x00000000    0x9a000 /tmp/ccQ1x2yZ.ltrans0.ltrans.o
+
+.ARM.attributes
+                0x00000000       0x2e
+ .ARM.attributes
+                0x00000000       0x2e /tmp/ccQ1x2yZ.ltrans0.ltrans.o
+"""
+
+# F4 build, no fast code memory
+TARGET_MAP_NO_ITCM = """\
+Memory Configuration
+
+Name             Origin             Length             Attributes
+FLASH            0x08000000         0x00100000         xr
+RAM              0x20000000         0x00020000         xrw
+*default*        0x00000000         0xffffffff
+
+Linker script and memory map
+
+LOAD ./obj/main/STM32F405/flight/pid.o
+LOAD ./obj/main/STM32F405/cli/cli.o
+
+.text           0x08000000     0x9000
+ .text.pidController
+                0x08000000      0x300 /tmp/ccQ1x2yZ.ltrans0.ltrans.o
+"""
+
+
+class HotCodePlacementTest(unittest.TestCase):
+
+    def setUp(self):
+        self.warnings = []
+        self.sitl_map = hcp.parse_map(SITL_MAP.splitlines())
+
+    def warn(self, message):
+        self.warnings.append(message)
+
+    def sitl_profile(self):
+        return hcp.parse_sitl_profile(SITL_PROFILE.splitlines(), self.sitl_map, self.warn)
+
+    def test_map_is_parsed(self):
+        # when
+        target_map = hcp.parse_map(TARGET_MAP.splitlines())
+
+        # then
+        self.assertEqual(hcp.Region('ITCM_RAM', 0, 0x4000), target_map.region('ITCM_RAM'))
+        self.assertEqual(hcp.OutputSection('.tcm_code', 0, 0x3c00, 0x08011000), target_map.output_section('.tcm_code'))
+        self.assertEqual('AXIM_FLASH1', target_map.region_at(0x08011000).name)
+        self.assertIn('./obj/main/STM32F7X2/cli/cli.o', target_map.objects)
+        section = [section for section in target_map.input_sections if section.name == '.text.biquadFilterApply.constprop.0'][0]
+        self.assertEqual(('.text', 0x08008520, 0x20), (section.output, section.address, section.size))
+        self.assertEqual(0x11040, self.sitl_map.symbols['main'])
+
+    def test_sitl_profile_is_attributed_to_functions(self):
+        # when
+        profile = self.sitl_profile()
+
+        # then
+        self.assertEqual(5000000, profile.weights[('flight/pid.c', 'pidController')])
+        self.assertEqual(3000000, profile.weights[('flight/mixer.c', 'mixTable')])
+        self.assertEqual(2000000, profile.weights[('common/filter.c', 'biquadFilterApply')])
+        self.assertEqual(400000, profile.weights[('flight/pid.c', 'updateState')])
+        self.assertEqual(400000, profile.weights[('flight/mixer.c', 'updateState')])
+        # functions called only a few times and libraries are not part of the profile
+        self.assertNotIn(('main.c', 'main'), profile.weights)
+        self.assertEqual(6, len(profile.weights))
+        self.assertEqual(set(['main.c', 'flight/pid.c', 'flight/mixer.c', 'common/filter.c', 'cli/cli.c', 'drivers/serial_tcp.c', 'drivers/dshot.c']), profile.files)
+
+    def test_profile_without_anchor_is_rejected(self):
+        # given
+        lines = [line for line in SITL_PROFILE.splitlines() if not line.startswith('anchor')]
+
+        # then
+        with self.assertRaises(ValueError):
+            hcp.parse_sitl_profile(lines, self.sitl_map, self.warn)
+
+    def test_perf_report_is_attributed_to_functions(self):
+        # when
+        profile = hcp.parse_perf_report(PERF_REPORT.splitlines(), self.sitl_map, self.warn)
+
+        # then
+        self.assertEqual(40.0, profile.weights[('flight/pid.c', 'pidController')])
+        self.assertEqual(30.0, profile.weights[('flight/mixer.c', 'mixTable')])
+        self.assertEqual(20.0, profile.weights[('common/filter.c', 'biquadFilterApply')])
+        # updateState is in two files and can not be attributed
+        self.assertEqual(3, len(profile.weights))
+        self.assertEqual(1, len(self.warnings))
+        self.assertIn('updateState', self.warnings[0])
+
+    def test_hottest_functions_per_byte_fill_the_free_space(self):
+        # given
+        target_map = hcp.parse_map(TARGET_MAP.splitlines())
+
+        # when
+        placement = hcp.place(self.sitl_profile(), target_map, self.warn)
+
+        # then
+        # 16K of ITCM RAM, 15K used by FAST_CODE and 512 bytes reserved
+        self.assertEqual(512, placement.budget)
+        self.assertEqual('ITCM_RAM', placement.region.name)
+        self.assertEqual('AXIM_FLASH1', placement.load_region.name)
+        # pidController has the most time but does not fit after the functions with more time per byte
+        self.assertEqual(['pt1FilterApply', 'biquadFilterApply', 'mixTable'], [candidate.name for candidate in placement.functions])
+        self.assertEqual(0x60, placement.functions[1].size)
+        # static functions of the same name in several files are never moved
+        self.assertTrue(any('updateState' in warning for warning in self.warnings))
+
+    def test_budget_can_be_given(self):
+        # given
+        target_map = hcp.parse_map(TARGET_MAP.splitlines())
+
+        # when
+        placement = hcp.place(self.sitl_profile(), target_map, self.warn, budget=0x1000)
+
+        # then
+        self.assertEqual(['pt1FilterApply', 'biquadFilterApply', 'mixTable', 'pidController'], [candidate.name for candidate in placement.functions])
+
+    def test_placement_is_stable_when_run_on_a_placed_build(self):
+        # given
+        placed_map = TARGET_MAP.replace(''' .text.mixTable
+                0x08008300      0x180 /tmp/ccQ1x2yZ.ltrans0.ltrans.o
+''', '').replace('.tcm_code       0x00000000     0x3c00 load address 0x08011000', '''\
+.hot_code       0x00003c00      0x200 load address 0x08014c00
+ .text.mixTable
+                0x00003c00      0x180 /tmp/ccQ1x2yZ.ltrans0.ltrans.o
+
+.tcm_code       0x00000000     0x3c00 load address 0x08011000''')
+        target_map = hcp.parse_map(placed_map.splitlines())
+
+        # when
+        placement = hcp.place(self.sitl_profile(), target_map, self.warn)
+
+        # then
+        self.assertEqual(512, placement.budget)
+        self.assertEqual(['pt1FilterApply', 'biquadFilterApply', 'mixTable'], [candidate.name for candidate in placement.functions])
+
+    def test_files_are_classified_by_their_share_of_the_run_time(self):
+        # given
+        target_map = hcp.parse_map(TARGET_MAP.splitlines())
+
+        # when
+        placement = hcp.place(self.sitl_profile(), target_map, self.warn)
+
+        # then
+        self.assertEqual(['common/filter.c', 'flight/mixer.c', 'flight/pid.c'], placement.speed_files)
+        # files not in both builds were not measured, the drivers of the target are not the ones SITL runs
+        self.assertEqual(['cli/cli.c', 'main.c'], placement.size_files)
+        self.assertNotIn('drivers/dshot.c', placement.speed_files)
+
+    def test_linker_script_claims_the_sections_after_the_fixed_placement(self):
+        # given
+        target_map = hcp.parse_map(TARGET_MAP.splitlines())
+        placement = hcp.place(self.sitl_profile(), target_map, self.warn)
+
+        # when
+        script = hcp.linker_script(placement)
+
+        # then
+        self.assertIn('    *(.text.biquadFilterApply .text.biquadFilterApply.*)\n', script)
+        self.assertIn('    *(.text.mixTable .text.mixTable.*)\n', script)
+        self.assertNotIn('pidController', script)
+        self.assertIn('  } >ITCM_RAM AT >AXIM_FLASH1\n', script)
+        self.assertTrue(script.endswith('INSERT AFTER .tcm_code;\n'))
+
+    def test_only_optimisation_classes_without_fast_code_memory(self):
+        # given
+        target_map = hcp.parse_map(TARGET_MAP_NO_ITCM.splitlines())
+        placement = hcp.place(self.sitl_profile(), target_map, self.warn)
+
+        # when
+        fragment = hcp.make_fragment(placement, None)
+
+        # then
+        self.assertIsNone(placement.region)
+        self.assertEqual([], placement.functions)
+        self.assertNotIn('HOT_CODE_LD_SCRIPT', fragment)
+        self.assertIn('PROFILED_SPEED_OPTIMISED_SRC := \\\n            flight/pid.c \\\n', fragment)
+        self.assertIn('PROFILED_SIZE_OPTIMISED_SRC := \\\n            cli/cli.c \\\n', fragment)
+
+    def test_tool_writes_make_fragment_and_linker_script(self):
+        # given
+        directory = tempfile.mkdtemp()
+        self.addCleanup(shutil.rmtree, directory)
+        paths = {}
+        for name, content in (('sitl.map', SITL_MAP), ('profile.txt', SITL_PROFILE), ('target.map', TARGET_MAP)):
+            paths[name] = os.path.join(directory, name)
+            with open(paths[name], 'w') as f:
+                f.write(content)
+        output = os.path.join(directory, 'STM32F7X2_hot_code.mk')
+
+        # when
+        result = hcp.main(['--sitl-map', paths['sitl.map'], '--profile', paths['profile.txt'], '--target-map', paths['target.map'], '-o', output])
+
+        # then
+        self.assertEqual(0, result)
+        with open(output) as f:
+            fragment = f.read()
+        linker_script_path = os.path.join(directory, 'STM32F7X2_hot_code.ld')
+        self.assertIn('HOT_CODE_LD_SCRIPT := %s\n' % linker_script_path, fragment)
+        with open(linker_script_path) as f:
+            self.assertIn('hot_code_start = .;', f.read())
+
+
+if __name__ == '__main__':
+    unittest.main()